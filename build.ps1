@@ -6,9 +6,28 @@ $sources = @(
     "main.cpp",
     "scanner/token.cpp",
     "scanner/scanner.cpp",
+    "scanner/source_buffer.cpp",
+    "scanner/symbol_table.cpp",
+    "scanner/char_scan.cpp",
+    "parser/arena.cpp",
     "parser/ast.cpp",
     "parser/parser.cpp",
-    "visitors/codegen.cpp"
+    "visitors/codegen.cpp",
+    "visitors/optimizer.cpp",
+    "visitors/regalloc.cpp",
+    "visitors/peephole.cpp",
+    "visitors/induction.cpp",
+    "visitors/vectorizer.cpp",
+    "visitors/cfg.cpp",
+    "visitors/sccp.cpp",
+    "visitors/liveness.cpp",
+    "visitors/gvn.cpp",
+    "visitors/licm.cpp",
+    "ir/ir.cpp",
+    "ir/ir_builder.cpp",
+    "ir/ir_passes.cpp",
+    "ir/ir_codegen.cpp",
+    "support/time_report.cpp"
 )
 
 $compileCmd = "g++ -std=c++17 -Wall -Wextra -g -o compiler.exe " + ($sources -join " ")
@@ -0,0 +1,207 @@
+#include "ir.h"
+#include <algorithm>
+
+const char* irOpName(IROp op) {
+    switch (op) {
+        case IROp::Const:      return "const";
+        case IROp::Param:      return "param";
+        case IROp::StrAddr:    return "straddr";
+        case IROp::Add:        return "add";
+        case IROp::Sub:        return "sub";
+        case IROp::Mul:        return "mul";
+        case IROp::Div:        return "div";
+        case IROp::Mod:        return "mod";
+        case IROp::Eq:         return "eq";
+        case IROp::Ne:         return "ne";
+        case IROp::Lt:         return "lt";
+        case IROp::Gt:         return "gt";
+        case IROp::Le:         return "le";
+        case IROp::Ge:         return "ge";
+        case IROp::Neg:        return "neg";
+        case IROp::Convert:    return "convert";
+        case IROp::Phi:        return "phi";
+        case IROp::Call:       return "call";
+        case IROp::LoadElem:   return "loadelem";
+        case IROp::StoreElem:  return "storeelem";
+        case IROp::Br:         return "br";
+        case IROp::CondBr:     return "condbr";
+        case IROp::Ret:        return "ret";
+    }
+    return "?";
+}
+
+// ========== INSTRUCCIONES ==========
+
+bool IRInstr::isPure() const {
+    switch (op) {
+        case IROp::Call:
+        case IROp::StoreElem:
+        case IROp::Br:
+        case IROp::CondBr:
+        case IROp::Ret:
+            return false;
+        case IROp::Div:
+        case IROp::Mod:
+            // Una división entera por cero tiene que seguir fallando
+            return type == DataType::FLOAT;
+        default:
+            return true;
+    }
+}
+
+void IRInstr::addOperand(IRInstr* value) {
+    operands.push_back(value);
+    value->users.push_back(this);
+}
+
+// Quita una aparición de user de la lista de usuarios de value
+static void removeUser(IRInstr* value, IRInstr* user) {
+    auto it = find(value->users.begin(), value->users.end(), user);
+    if (it != value->users.end()) value->users.erase(it);
+}
+
+void IRInstr::setOperand(size_t index, IRInstr* value) {
+    removeUser(operands[index], this);
+    operands[index] = value;
+    value->users.push_back(this);
+}
+
+void IRInstr::removeOperand(size_t index) {
+    removeUser(operands[index], this);
+    operands.erase(operands.begin() + index);
+}
+
+void IRInstr::dropOperands() {
+    for (IRInstr* operand : operands) {
+        removeUser(operand, this);
+    }
+    operands.clear();
+}
+
+// ========== BLOQUES Y FUNCIONES ==========
+
+int IRBlock::predIndex(IRBlock* pred) const {
+    for (size_t i = 0; i < preds.size(); i++) {
+        if (preds[i] == pred) return i;
+    }
+    return -1;
+}
+
+IRBlock* IRFunction::newBlock() {
+    blocks.push_back(make_unique<IRBlock>(nextBlockId++));
+    return blocks.back().get();
+}
+
+unique_ptr<IRInstr> IRFunction::newInstr(IROp op, DataType type) {
+    return make_unique<IRInstr>(op, type, nextValueId++);
+}
+
+IRInstr* IRFunction::intConst(DataType type, long value) {
+    constants.push_back(newInstr(IROp::Const, type));
+    constants.back()->intValue = value;
+    return constants.back().get();
+}
+
+IRInstr* IRFunction::floatConst(float value) {
+    constants.push_back(newInstr(IROp::Const, DataType::FLOAT));
+    constants.back()->floatValue = value;
+    return constants.back().get();
+}
+
+void IRFunction::replaceAllUses(IRInstr* from, IRInstr* to) {
+    // Copia: setOperand modifica from->users
+    vector<IRInstr*> users = from->users;
+    for (IRInstr* user : users) {
+        for (size_t i = 0; i < user->operands.size(); i++) {
+            if (user->operands[i] == from) user->setOperand(i, to);
+        }
+    }
+}
+
+void IRFunction::addEdge(IRBlock* pred, IRBlock* succ) {
+    pred->succs.push_back(succ);
+    succ->preds.push_back(pred);
+}
+
+// ========== IMPRESIÓN (--dump-ir) ==========
+
+static string valueName(const IRInstr* value) {
+    if (value->op == IROp::Const) {
+        if (value->type == DataType::FLOAT) return to_string(value->floatValue);
+        return to_string(value->intValue);
+    }
+    return "%" + to_string(value->id);
+}
+
+static string blockName(const IRBlock* block) {
+    return "b" + to_string(block->id);
+}
+
+void IRModule::print(ostream& out) const {
+    for (const auto& func : functions) {
+        out << "function " << func->name << "(";
+        for (size_t i = 0; i < func->paramTypes.size(); i++) {
+            out << (i ? ", " : "") << dataTypeToString(func->paramTypes[i]);
+        }
+        out << ") -> " << dataTypeToString(func->returnType) << " {" << endl;
+
+        for (const IRArray& array : func->arrays) {
+            out << "  array " << array.name << ": " << dataTypeToString(array.type)
+                << "[" << array.elementCount << "]" << endl;
+        }
+
+        for (const auto& block : func->blocks) {
+            out << blockName(block.get()) << ":";
+            if (!block->preds.empty()) {
+                out << "  ; preds:";
+                for (IRBlock* pred : block->preds) out << " " << blockName(pred);
+            }
+            out << endl;
+
+            for (const auto& instr : block->instrs) {
+                out << "  ";
+                if (instr->type != DataType::VOID) {
+                    out << "%" << instr->id << " = ";
+                }
+                out << irOpName(instr->op);
+                if (instr->type != DataType::VOID) {
+                    out << " " << dataTypeToString(instr->type);
+                }
+
+                switch (instr->op) {
+                    case IROp::Param:
+                    case IROp::StrAddr:
+                        out << " " << instr->intValue;
+                        break;
+                    case IROp::Call:
+                        out << " " << instr->name;
+                        break;
+                    case IROp::LoadElem:
+                    case IROp::StoreElem:
+                        out << " " << func->arrays[instr->slot].name;
+                        break;
+                    case IROp::Convert:
+                        out << " from " << dataTypeToString(instr->operandType);
+                        break;
+                    default:
+                        break;
+                }
+
+                for (size_t i = 0; i < instr->operands.size(); i++) {
+                    out << (i ? ", " : " ") << valueName(instr->operands[i]);
+                    if (instr->op == IROp::Phi) {
+                        out << " [" << blockName(block->preds[i]) << "]";
+                    }
+                }
+
+                if (instr->op == IROp::Br) {
+                    out << " " << blockName(instr->targets[0]);
+                } else if (instr->op == IROp::CondBr) {
+                    out << ", " << blockName(instr->targets[0]) << ", " << blockName(instr->targets[1]);
+                }
+                out << endl;
+            }
+        }
+        out << "}" << endl << endl;
+    }
+}
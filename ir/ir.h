@@ -0,0 +1,145 @@
+#ifndef IR_H
+#define IR_H
+
+#include "../parser/ast.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <iostream>
+
+using namespace std;
+
+// ========== REPRESENTACIÓN INTERMEDIA (SSA) ==========
+// IR de tres direcciones entre el AST y la generación de código:
+//   - IRFunction: lista de bloques básicos; el primero es la entrada
+//   - IRBlock: instrucciones en orden, las phi al principio y un único
+//     terminador (br / condbr / ret) al final; guarda sus predecesores y
+//     sucesores (el CFG)
+//   - IRInstr: cada instrucción que produce un valor ES ese valor SSA
+//     (%id); los operandos apuntan directamente a otras instrucciones
+// Los tipos son los mismos DataType del AST (INT, LONG, UNSIGNED_INT,
+// FLOAT; VOID para instrucciones sin resultado). Las direcciones (strings)
+// son LONG.
+
+enum class IROp : uint8_t {
+    // Valores
+    Const,      // Constante entera (intValue) o float (floatValue)
+    Param,      // Parámetro número intValue
+    StrAddr,    // Dirección de un string de IRModule::strings (intValue)
+
+    // Aritmética (operandos y resultado del mismo tipo)
+    Add, Sub, Mul, Div, Mod,
+
+    // Comparaciones: operandos de tipo operandType, resultado INT (0/1)
+    Eq, Ne, Lt, Gt, Le, Ge,
+
+    Neg,        // -x
+    Convert,    // Conversión de operandType a type
+    Phi,        // Un operando por predecesor, en el mismo orden que preds
+    Call,       // name(operandos...)
+
+    // Arrays del frame: slot = índice en IRFunction::arrays,
+    // operando 0 = índice lineal del elemento
+    LoadElem,   // slot[op0]
+    StoreElem,  // slot[op0] = op1
+
+    // Terminadores
+    Br,         // targets[0]
+    CondBr,     // op0 != 0 ? targets[0] : targets[1]
+    Ret         // op0 (opcional)
+};
+
+const char* irOpName(IROp op);
+
+struct IRBlock;
+
+struct IRInstr {
+    IROp op;
+    DataType type;              // Tipo del resultado (VOID si no produce valor)
+    int id;                     // Número del valor (%id)
+    IRBlock* block;
+    vector<IRInstr*> operands;
+    vector<IRInstr*> users;     // Instrucciones que usan este valor
+
+    long intValue = 0;                      // Const entero / Param / StrAddr
+    float floatValue = 0;                   // Const float
+    string_view name;                       // Call
+    int slot = -1;                          // LoadElem / StoreElem
+    DataType operandType = DataType::VOID;  // Comparaciones / Convert
+    IRBlock* targets[2] = {nullptr, nullptr};
+
+    // Phi trivial eliminada durante la construcción: apunta a su reemplazo
+    IRInstr* replacement = nullptr;
+
+    IRInstr(IROp op, DataType type, int id) : op(op), type(type), id(id), block(nullptr) {}
+
+    bool isTerminator() const { return op == IROp::Br || op == IROp::CondBr || op == IROp::Ret; }
+    bool isComparison() const { return op >= IROp::Eq && op <= IROp::Ge; }
+    // Se puede borrar si nadie usa su resultado
+    bool isPure() const;
+    bool isConst() const { return op == IROp::Const; }
+
+    void addOperand(IRInstr* value);
+    void setOperand(size_t index, IRInstr* value);
+    void removeOperand(size_t index);
+    void dropOperands();
+};
+
+struct IRBlock {
+    int id;
+    vector<unique_ptr<IRInstr>> instrs;
+    vector<IRBlock*> preds;
+    vector<IRBlock*> succs;
+
+    explicit IRBlock(int id) : id(id) {}
+
+    IRInstr* terminator() const {
+        return !instrs.empty() && instrs.back()->isTerminator() ? instrs.back().get() : nullptr;
+    }
+    int predIndex(IRBlock* pred) const;
+};
+
+// Array local (vive en el stack frame)
+struct IRArray {
+    string_view name;
+    DataType type;
+    vector<int> dimensions;
+    int elementCount;
+};
+
+struct IRFunction {
+    string_view name;
+    DataType returnType;
+    vector<DataType> paramTypes;
+    vector<unique_ptr<IRBlock>> blocks;
+    vector<IRArray> arrays;
+    vector<unique_ptr<IRInstr>> constants;  // Las constantes no viven en ningún bloque
+    int nextValueId = 0;
+    int nextBlockId = 0;
+
+    IRBlock* entry() const { return blocks.front().get(); }
+    IRBlock* newBlock();
+
+    // Crea una instrucción sin insertarla en ningún bloque
+    unique_ptr<IRInstr> newInstr(IROp op, DataType type);
+
+    // Constantes (se materializan como inmediatos donde se usan)
+    IRInstr* intConst(DataType type, long value);
+    IRInstr* floatConst(float value);
+
+    // Reemplaza todos los usos de from por to
+    static void replaceAllUses(IRInstr* from, IRInstr* to);
+
+    // Agrega la arista pred -> succ al CFG
+    static void addEdge(IRBlock* pred, IRBlock* succ);
+};
+
+struct IRModule {
+    vector<unique_ptr<IRFunction>> functions;
+    vector<string_view> strings;  // Literales de string (sin comillas, tal cual el fuente)
+
+    void print(ostream& out) const;
+};
+
+#endif
@@ -0,0 +1,696 @@
+#include "ir_builder.h"
+#include <algorithm>
+
+// Formatos que usa printf cuando el primer argumento no es un string
+// (mismos que fmt_int / fmt_float de CodeGen, escritos como en el fuente)
+static const string_view FMT_INT = "%d\\n";
+static const string_view FMT_FLOAT = "%.2f\\n";
+
+unique_ptr<IRModule> IRBuilder::build(Program* program) {
+    auto result = make_unique<IRModule>();
+    module = result.get();
+
+    int symbolCount = program->symbols->size();
+    signatures.reserve(symbolCount);
+    scalarVars.reserve(symbolCount);
+    arrayVars.reserve(symbolCount);
+
+    // Firmas primero: una función puede llamar a otra declarada más abajo
+    for (auto& stmt : program->statements) {
+        if (FunctionDecl* decl = nodeCast<FunctionDecl>(stmt.get())) {
+            FunctionSig& sig = signatures[decl->symbol];
+            sig.returnType = decl->returnType;
+            sig.paramTypes.clear();
+            for (auto& param : decl->parameters) {
+                sig.paramTypes.push_back(param.type);
+            }
+        }
+    }
+
+    // Las declaraciones globales no se soportan (igual que en CodeGen)
+    for (auto& stmt : program->statements) {
+        if (FunctionDecl* decl = nodeCast<FunctionDecl>(stmt.get())) {
+            visitFunctionDecl(decl);
+        }
+    }
+
+    return result;
+}
+
+// ========== BLOQUES ==========
+
+IRBlock* IRBuilder::createBlock() {
+    IRBlock* block = func->newBlock();
+    sealed.push_back(false);
+    startOrder.push_back(-1);
+    return block;
+}
+
+// El bloque pasa a ser el punto de inserción; el orden en que se empiezan
+// los bloques es el orden final (el cuerpo de un loop antes de su salida)
+void IRBuilder::startBlock(IRBlock* block) {
+    if (startOrder[block->id] < 0) {
+        startOrder[block->id] = *max_element(startOrder.begin(), startOrder.end()) + 1;
+    }
+    current = block;
+}
+
+void IRBuilder::sealBlock(IRBlock* block) {
+    auto it = incompletePhis.find(block->id);
+    if (it != incompletePhis.end()) {
+        vector<pair<int, IRInstr*>> phis = move(it->second);
+        incompletePhis.erase(it);
+        for (auto& [var, phi] : phis) {
+            addPhiOperands(var, phi);
+        }
+    }
+    sealed[block->id] = true;
+}
+
+// Después de un return el código que sigue es inalcanzable: va a un
+// bloque nuevo sin predecesores (lo borra el pase de bloques muertos)
+void IRBuilder::ensureOpenBlock() {
+    if (current->terminator()) {
+        IRBlock* unreachable = createBlock();
+        sealBlock(unreachable);
+        startBlock(unreachable);
+    }
+}
+
+// ========== INSTRUCCIONES ==========
+
+IRInstr* IRBuilder::append(unique_ptr<IRInstr> instr) {
+    instr->block = current;
+    current->instrs.push_back(move(instr));
+    return current->instrs.back().get();
+}
+
+IRInstr* IRBuilder::emit(IROp op, DataType type, IRInstr* a, IRInstr* b) {
+    unique_ptr<IRInstr> instr = func->newInstr(op, type);
+    if (a) instr->addOperand(a);
+    if (b) instr->addOperand(b);
+    return append(move(instr));
+}
+
+IRInstr* IRBuilder::emitCompare(IROp op, IRInstr* a, IRInstr* b) {
+    DataType type = promote(a->type, b->type);
+    IRInstr* left = convert(a, type);
+    IRInstr* right = convert(b, type);
+    IRInstr* compare = emit(op, DataType::INT, left, right);
+    compare->operandType = type;
+    return compare;
+}
+
+IRInstr* IRBuilder::convert(IRInstr* value, DataType to) {
+    if (value->type == to || to == DataType::VOID || to == DataType::UNKNOWN ||
+        value->type == DataType::VOID || value->type == DataType::UNKNOWN) {
+        return value;
+    }
+    IRInstr* conversion = emit(IROp::Convert, to, value);
+    conversion->operandType = value->type;
+    return conversion;
+}
+
+// Valor 0/1 equivalente a "value != 0"
+IRInstr* IRBuilder::truthValue(IRInstr* value) {
+    if (value->isComparison()) return value;
+    return emitCompare(IROp::Ne, value, zeroOf(value->type));
+}
+
+IRInstr* IRBuilder::zeroOf(DataType type) {
+    if (type == DataType::FLOAT) return func->floatConst(0);
+    if (type == DataType::VOID || type == DataType::UNKNOWN) type = DataType::INT;
+    return func->intConst(type, 0);
+}
+
+void IRBuilder::branch(IRBlock* target) {
+    IRInstr* br = emit(IROp::Br, DataType::VOID);
+    br->targets[0] = target;
+    IRFunction::addEdge(current, target);
+}
+
+void IRBuilder::condBranch(IRInstr* condition, IRBlock* ifTrue, IRBlock* ifFalse) {
+    // condbr compara contra 0 entero: un float pasa antes por "!= 0.0"
+    if (condition->type == DataType::FLOAT) {
+        condition = truthValue(condition);
+    }
+    IRInstr* br = emit(IROp::CondBr, DataType::VOID, condition);
+    br->targets[0] = ifTrue;
+    br->targets[1] = ifFalse;
+    IRFunction::addEdge(current, ifTrue);
+    IRFunction::addEdge(current, ifFalse);
+}
+
+// Índice lineal de arr[i][j]...: ((i * d1) + j) * d2 + ...
+IRInstr* IRBuilder::elementIndex(IRArray& array, ExprList& indices) {
+    IRInstr* index = convert(visit(indices[0].get()), DataType::INT);
+    for (size_t k = 1; k < indices.size() && k < array.dimensions.size(); k++) {
+        IRInstr* scaled = emit(IROp::Mul, DataType::INT, index,
+                               func->intConst(DataType::INT, array.dimensions[k]));
+        IRInstr* next = convert(visit(indices[k].get()), DataType::INT);
+        index = emit(IROp::Add, DataType::INT, scaled, next);
+    }
+    return index;
+}
+
+IRInstr* IRBuilder::assignScalar(SymbolId symbol, Expr* valueExpr) {
+    IRInstr* value = visit(valueExpr);
+    if (int* var = scalarVars.find(symbol)) {
+        value = convert(value, varTypes[*var]);
+        writeVariable(*var, current, value);
+    }
+    return value;
+}
+
+IRInstr* IRBuilder::assignElement(SymbolId symbol, ExprList& indices, Expr* valueExpr) {
+    // Como CodeGen: primero el valor, después la dirección
+    IRInstr* value = visit(valueExpr);
+    if (int* slot = arrayVars.find(symbol)) {
+        IRArray& array = func->arrays[*slot];
+        IRInstr* index = elementIndex(array, indices);
+        value = convert(value, array.type);
+        IRInstr* store = emit(IROp::StoreElem, DataType::VOID, index, value);
+        store->slot = *slot;
+    }
+    return value;
+}
+
+DataType IRBuilder::promote(DataType a, DataType b) {
+    if (a == DataType::FLOAT || b == DataType::FLOAT) return DataType::FLOAT;
+    if (a == DataType::LONG || b == DataType::LONG) return DataType::LONG;
+    if (a == DataType::UNSIGNED_INT || b == DataType::UNSIGNED_INT) return DataType::UNSIGNED_INT;
+    return DataType::INT;
+}
+
+// ========== SSA (BRAUN ET AL.) ==========
+
+static long defKey(int var, IRBlock* block) {
+    return ((long)block->id << 32) | (unsigned)var;
+}
+
+// Una phi eliminada puede seguir en currentDef: seguir sus reemplazos
+static IRInstr* resolve(IRInstr* value) {
+    while (value->replacement) value = value->replacement;
+    return value;
+}
+
+void IRBuilder::writeVariable(int var, IRBlock* block, IRInstr* value) {
+    currentDef[defKey(var, block)] = value;
+}
+
+IRInstr* IRBuilder::readVariable(int var, IRBlock* block) {
+    auto it = currentDef.find(defKey(var, block));
+    if (it != currentDef.end()) {
+        return resolve(it->second);
+    }
+    return readVariableRecursive(var, block);
+}
+
+IRInstr* IRBuilder::readVariableRecursive(int var, IRBlock* block) {
+    IRInstr* value;
+    if (!sealed[block->id]) {
+        // Todavía faltan predecesores: phi incompleta
+        value = newPhi(block, varTypes[var]);
+        incompletePhis[block->id].push_back({var, value});
+    } else if (block->preds.size() == 1) {
+        value = readVariable(var, block->preds[0]);
+    } else if (block->preds.empty()) {
+        // Entrada o bloque inalcanzable: la variable no tiene valor
+        value = zeroOf(varTypes[var]);
+    } else {
+        // Romper ciclos: la phi se registra antes de leer los predecesores
+        IRInstr* phi = newPhi(block, varTypes[var]);
+        writeVariable(var, block, phi);
+        value = addPhiOperands(var, phi);
+    }
+    writeVariable(var, block, value);
+    return value;
+}
+
+IRInstr* IRBuilder::newPhi(IRBlock* block, DataType type) {
+    unique_ptr<IRInstr> phi = func->newInstr(IROp::Phi, type);
+    phi->block = block;
+
+    // Las phi van al principio del bloque
+    size_t position = 0;
+    while (position < block->instrs.size() && block->instrs[position]->op == IROp::Phi) {
+        position++;
+    }
+    block->instrs.insert(block->instrs.begin() + position, move(phi));
+    return block->instrs[position].get();
+}
+
+IRInstr* IRBuilder::addPhiOperands(int var, IRInstr* phi) {
+    for (IRBlock* pred : phi->block->preds) {
+        phi->addOperand(readVariable(var, pred));
+    }
+    return tryRemoveTrivialPhi(phi);
+}
+
+// Una phi cuyos operandos son todos el mismo valor (o ella misma) se
+// reemplaza por ese valor; puede volver triviales a las phi que la usan
+IRInstr* IRBuilder::tryRemoveTrivialPhi(IRInstr* phi) {
+    IRInstr* same = nullptr;
+    for (IRInstr* operand : phi->operands) {
+        if (operand == same || operand == phi) continue;
+        if (same) return phi;
+        same = operand;
+    }
+    if (!same) {
+        same = zeroOf(phi->type);
+    }
+
+    vector<IRInstr*> users;
+    for (IRInstr* user : phi->users) {
+        if (user != phi) users.push_back(user);
+    }
+
+    IRFunction::replaceAllUses(phi, same);
+    phi->dropOperands();
+    phi->replacement = same;
+
+    IRBlock* block = phi->block;
+    for (size_t i = 0; i < block->instrs.size(); i++) {
+        if (block->instrs[i].get() == phi) {
+            removedPhis.push_back(move(block->instrs[i]));
+            block->instrs.erase(block->instrs.begin() + i);
+            break;
+        }
+    }
+
+    for (IRInstr* user : users) {
+        if (user->op == IROp::Phi && !user->replacement && sealed[user->block->id]) {
+            tryRemoveTrivialPhi(user);
+        }
+    }
+
+    // `same` puede ser una de esas phi (la del header de un loop que solo
+    // se leía a sí misma): devolver lo que quedó en su lugar
+    return resolve(same);
+}
+
+// ========== EXPRESIONES ==========
+
+IRInstr* IRBuilder::visitIntLiteral(IntLiteral* node) {
+    return func->intConst(DataType::INT, node->value);
+}
+
+IRInstr* IRBuilder::visitFloatLiteral(FloatLiteral* node) {
+    return func->floatConst(node->value);
+}
+
+IRInstr* IRBuilder::visitLongLiteral(LongLiteral* node) {
+    return func->intConst(DataType::LONG, node->value);
+}
+
+IRInstr* IRBuilder::visitStringLiteral(StringLiteral* node) {
+    IRInstr* address = emit(IROp::StrAddr, DataType::LONG);
+    address->intValue = module->strings.size();
+    module->strings.push_back(node->value);
+    return address;
+}
+
+IRInstr* IRBuilder::visitVariable(Variable* node) {
+    if (int* var = scalarVars.find(node->symbol)) {
+        return readVariable(*var, current);
+    }
+    // Globales / desconocidas: CodeGen tampoco genera nada
+    return zeroOf(DataType::INT);
+}
+
+IRInstr* IRBuilder::visitBinaryOp(BinaryOp* node) {
+    TokenType op = node->op.type;
+
+    // && y ||: cortocircuito con una phi en el bloque de salida
+    if (op == TokenType::AND || op == TokenType::OR) {
+        IRInstr* left = truthValue(visit(node->left.get()));
+        IRBlock* leftEnd = current;
+        IRBlock* rightBlock = createBlock();
+        IRBlock* end = createBlock();
+
+        if (op == TokenType::AND) {
+            condBranch(left, rightBlock, end);
+        } else {
+            condBranch(left, end, rightBlock);
+        }
+        sealBlock(rightBlock);
+        startBlock(rightBlock);
+        IRInstr* right = truthValue(visit(node->right.get()));
+        IRBlock* rightEnd = current;
+        branch(end);
+        sealBlock(end);
+        startBlock(end);
+
+        IRInstr* phi = newPhi(end, DataType::INT);
+        for (IRBlock* pred : end->preds) {
+            if (pred == leftEnd) {
+                phi->addOperand(func->intConst(DataType::INT, op == TokenType::OR ? 1 : 0));
+            } else if (pred == rightEnd) {
+                phi->addOperand(right);
+            }
+        }
+        return phi;
+    }
+
+    // Como CodeGen: primero el operando derecho
+    IRInstr* right = visit(node->right.get());
+    IRInstr* left = visit(node->left.get());
+
+    // x << n / x >> n: los deja el optimizer en lugar de x * 2^n y x / 2^n
+    // (sin TokenType propio); en el IR vuelven a ser Mul / Div
+    IntLiteral* amount = nodeCast<IntLiteral>(node->right.get());
+    if (amount && (node->op.lexeme == "<<" || node->op.lexeme == ">>")) {
+        DataType type = promote(left->type, DataType::INT);
+        IRInstr* factor = convert(func->intConst(DataType::INT, 1 << amount->value), type);
+        return emit(node->op.lexeme == "<<" ? IROp::Mul : IROp::Div, type, convert(left, type), factor);
+    }
+
+    IROp irOp;
+    switch (op) {
+        case TokenType::EQ: return emitCompare(IROp::Eq, left, right);
+        case TokenType::NE: return emitCompare(IROp::Ne, left, right);
+        case TokenType::LT: return emitCompare(IROp::Lt, left, right);
+        case TokenType::GT: return emitCompare(IROp::Gt, left, right);
+        case TokenType::LE: return emitCompare(IROp::Le, left, right);
+        case TokenType::GE: return emitCompare(IROp::Ge, left, right);
+        case TokenType::PLUS:     irOp = IROp::Add; break;
+        case TokenType::MINUS:    irOp = IROp::Sub; break;
+        case TokenType::MULTIPLY: irOp = IROp::Mul; break;
+        case TokenType::DIVIDE:   irOp = IROp::Div; break;
+        case TokenType::MODULO:   irOp = IROp::Mod; break;
+        default:
+            return left;
+    }
+
+    DataType type = promote(left->type, right->type);
+    if (irOp == IROp::Mod && type == DataType::FLOAT) {
+        type = DataType::INT;
+    }
+    return emit(irOp, type, convert(left, type), convert(right, type));
+}
+
+IRInstr* IRBuilder::visitUnaryOp(UnaryOp* node) {
+    IRInstr* operand = visit(node->operand.get());
+    if (node->op.type == TokenType::MINUS) {
+        DataType type = promote(operand->type, DataType::INT);
+        return emit(IROp::Neg, type, convert(operand, type));
+    }
+    if (node->op.type == TokenType::NOT) {
+        return emitCompare(IROp::Eq, operand, zeroOf(operand->type));
+    }
+    return operand;
+}
+
+IRInstr* IRBuilder::visitCastExpr(CastExpr* node) {
+    return convert(visit(node->expr.get()), node->targetType);
+}
+
+IRInstr* IRBuilder::visitTernaryExpr(TernaryExpr* node) {
+    IRInstr* condition = visit(node->condition.get());
+    IRBlock* trueBlock = createBlock();
+    IRBlock* falseBlock = createBlock();
+    IRBlock* end = createBlock();
+    condBranch(condition, trueBlock, falseBlock);
+
+    sealBlock(trueBlock);
+    startBlock(trueBlock);
+    IRInstr* trueValue = visit(node->exprTrue.get());
+    IRBlock* trueEnd = current;
+
+    sealBlock(falseBlock);
+    startBlock(falseBlock);
+    IRInstr* falseValue = visit(node->exprFalse.get());
+    IRBlock* falseEnd = current;
+
+    // Convertir cada rama al tipo común antes de saltar a la salida
+    DataType type = promote(trueValue->type, falseValue->type);
+    current = trueEnd;
+    trueValue = convert(trueValue, type);
+    branch(end);
+    current = falseEnd;
+    falseValue = convert(falseValue, type);
+    branch(end);
+
+    sealBlock(end);
+    startBlock(end);
+    IRInstr* phi = newPhi(end, type);
+    phi->addOperand(trueValue);
+    phi->addOperand(falseValue);
+    return phi;
+}
+
+IRInstr* IRBuilder::visitCallExpr(CallExpr* node) {
+    if (node->functionName == "printf") {
+        // Igual que CodeGen: el formato y a lo sumo un valor
+        if (node->arguments.empty()) {
+            return zeroOf(DataType::INT);
+        }
+
+        IRInstr* format;
+        IRInstr* value = nullptr;
+        if (StringLiteral* literal = nodeCast<StringLiteral>(node->arguments[0].get())) {
+            format = visitStringLiteral(literal);
+            if (node->arguments.size() > 1) {
+                value = visit(node->arguments[1].get());
+            }
+        } else {
+            value = visit(node->arguments[0].get());
+            format = emit(IROp::StrAddr, DataType::LONG);
+            format->intValue = module->strings.size();
+            module->strings.push_back(value->type == DataType::FLOAT ? FMT_FLOAT : FMT_INT);
+        }
+
+        IRInstr* call = emit(IROp::Call, DataType::INT, format, value);
+        call->name = node->functionName;
+        return call;
+    }
+
+    FunctionSig* sig = signatures.find(node->functionSymbol);
+    vector<IRInstr*> args;
+    for (size_t i = 0; i < node->arguments.size() && i < 6; i++) {
+        IRInstr* arg = visit(node->arguments[i].get());
+        if (sig && i < sig->paramTypes.size()) {
+            arg = convert(arg, sig->paramTypes[i]);
+        }
+        args.push_back(arg);
+    }
+
+    IRInstr* call = emit(IROp::Call, sig ? sig->returnType : DataType::INT);
+    call->name = node->functionName;
+    for (IRInstr* arg : args) {
+        call->addOperand(arg);
+    }
+    return call;
+}
+
+IRInstr* IRBuilder::visitArrayAccess(ArrayAccess* node) {
+    int* slot = arrayVars.find(node->arraySymbol);
+    if (!slot) {
+        cerr << "Error: " << node->arrayName << " is not an array" << endl;
+        return zeroOf(DataType::INT);
+    }
+
+    IRArray& array = func->arrays[*slot];
+    IRInstr* load = emit(IROp::LoadElem, array.type, elementIndex(array, node->indices));
+    load->slot = *slot;
+    return load;
+}
+
+IRInstr* IRBuilder::visitAssignExpr(AssignExpr* node) {
+    if (node->isArrayAssign) {
+        return assignElement(node->varSymbol, node->indices, node->value.get());
+    }
+    return assignScalar(node->varSymbol, node->value.get());
+}
+
+// ========== STATEMENTS ==========
+
+void IRBuilder::visitVarDecl(VarDecl* node) {
+    if (node->isArray) {
+        IRArray array;
+        array.name = node->name;
+        array.type = node->type;
+        array.dimensions.assign(node->dimensions.begin(), node->dimensions.end());
+        array.elementCount = 1;
+        for (int dim : array.dimensions) array.elementCount *= dim;
+
+        arrayVars[node->symbol] = func->arrays.size();
+        scalarVars.erase(node->symbol);
+        func->arrays.push_back(array);
+        return;
+    }
+
+    IRInstr* value = node->initializer ? visit(node->initializer.get()) : nullptr;
+
+    int var = varTypes.size();
+    varTypes.push_back(node->type);
+    scalarVars[node->symbol] = var;
+    arrayVars.erase(node->symbol);
+
+    if (value) {
+        writeVariable(var, current, convert(value, node->type));
+    }
+}
+
+void IRBuilder::visitAssignStmt(AssignStmt* node) {
+    ensureOpenBlock();
+    if (node->isArrayAssign) {
+        assignElement(node->varSymbol, node->indices, node->value.get());
+    } else {
+        assignScalar(node->varSymbol, node->value.get());
+    }
+}
+
+void IRBuilder::visitBlock(Block* node) {
+    for (auto& stmt : node->statements) {
+        ensureOpenBlock();
+        visit(stmt.get());
+    }
+}
+
+void IRBuilder::visitIfStmt(IfStmt* node) {
+    ensureOpenBlock();
+    IRInstr* condition = visit(node->condition.get());
+
+    IRBlock* thenBlock = createBlock();
+    IRBlock* elseBlock = node->elseBranch ? createBlock() : nullptr;
+    IRBlock* merge = createBlock();
+    condBranch(condition, thenBlock, elseBlock ? elseBlock : merge);
+
+    sealBlock(thenBlock);
+    startBlock(thenBlock);
+    visit(node->thenBranch.get());
+    ensureOpenBlock();
+    branch(merge);
+
+    if (elseBlock) {
+        sealBlock(elseBlock);
+        startBlock(elseBlock);
+        visit(node->elseBranch.get());
+        ensureOpenBlock();
+        branch(merge);
+    }
+
+    sealBlock(merge);
+    startBlock(merge);
+}
+
+void IRBuilder::visitWhileStmt(WhileStmt* node) {
+    ensureOpenBlock();
+    IRBlock* header = createBlock();
+    branch(header);
+    startBlock(header);  // Sin sellar: falta el salto hacia atrás
+
+    IRInstr* condition = visit(node->condition.get());
+    IRBlock* body = createBlock();
+    IRBlock* exit = createBlock();
+    condBranch(condition, body, exit);
+    sealBlock(body);
+    sealBlock(exit);
+
+    startBlock(body);
+    visit(node->body.get());
+    ensureOpenBlock();
+    branch(header);
+    sealBlock(header);
+
+    startBlock(exit);
+}
+
+void IRBuilder::visitForStmt(ForStmt* node) {
+    ensureOpenBlock();
+    if (node->initializer) {
+        visit(node->initializer.get());
+        ensureOpenBlock();
+    }
+
+    IRBlock* header = createBlock();
+    branch(header);
+    startBlock(header);
+
+    IRBlock* body = createBlock();
+    IRBlock* exit = createBlock();
+    if (node->condition) {
+        condBranch(visit(node->condition.get()), body, exit);
+    } else {
+        branch(body);
+    }
+    sealBlock(body);
+    sealBlock(exit);
+
+    startBlock(body);
+    visit(node->body.get());
+    ensureOpenBlock();
+    if (node->increment) {
+        visit(node->increment.get());
+    }
+    branch(header);
+    sealBlock(header);
+
+    startBlock(exit);
+}
+
+void IRBuilder::visitReturnStmt(ReturnStmt* node) {
+    ensureOpenBlock();
+    IRInstr* value = node->value ? visit(node->value.get()) : nullptr;
+
+    IRInstr* ret = emit(IROp::Ret, DataType::VOID);
+    if (func->returnType != DataType::VOID) {
+        ret->addOperand(value ? convert(value, func->returnType) : zeroOf(func->returnType));
+    }
+}
+
+void IRBuilder::visitExprStmt(ExprStmt* node) {
+    ensureOpenBlock();
+    visit(node->expression.get());
+}
+
+void IRBuilder::visitFunctionDecl(FunctionDecl* node) {
+    module->functions.push_back(make_unique<IRFunction>());
+    func = module->functions.back().get();
+    func->name = node->name;
+    func->returnType = node->returnType;
+
+    varTypes.clear();
+    scalarVars.clear();
+    arrayVars.clear();
+    currentDef.clear();
+    incompletePhis.clear();
+    sealed.clear();
+    startOrder.clear();
+
+    IRBlock* entry = createBlock();
+    sealBlock(entry);
+    startBlock(entry);
+
+    // Parámetros: cada uno es una variable con un valor inicial
+    for (size_t i = 0; i < node->parameters.size() && i < 6; i++) {
+        Param& param = node->parameters[i];
+        func->paramTypes.push_back(param.type);
+
+        IRInstr* value = emit(IROp::Param, param.type);
+        value->intValue = i;
+
+        int var = varTypes.size();
+        varTypes.push_back(param.type);
+        scalarVars[param.symbol] = var;
+        arrayVars.erase(param.symbol);
+        writeVariable(var, entry, value);
+    }
+
+    visit(node->body.get());
+
+    // Sin return al final: devolver (0 si la función no es void)
+    if (!current->terminator()) {
+        IRInstr* ret = emit(IROp::Ret, DataType::VOID);
+        if (func->returnType != DataType::VOID) {
+            ret->addOperand(zeroOf(func->returnType));
+        }
+    }
+
+    // Ordenar los bloques en el orden en que se empezaron
+    stable_sort(func->blocks.begin(), func->blocks.end(),
+                [&](const unique_ptr<IRBlock>& a, const unique_ptr<IRBlock>& b) {
+                    return startOrder[a->id] < startOrder[b->id];
+                });
+}
@@ -0,0 +1,104 @@
+#ifndef IR_BUILDER_H
+#define IR_BUILDER_H
+
+#include "ir.h"
+#include "../parser/ast_visitor.h"
+#include <unordered_map>
+
+using namespace std;
+
+// ========== AST -> IR (SSA) ==========
+// Baja el AST (ya optimizado) a IR en forma SSA usando la construcción
+// directa de Braun et al. ("Simple and Efficient Construction of SSA
+// Form"): cada variable escalar se lee/escribe por bloque, las phi se
+// crean al leer una variable en un bloque con varios predecesores y las
+// phi triviales se eliminan en el momento. Un bloque se "sella" cuando
+// ya se conocen todos sus predecesores (los headers de loop, después de
+// bajar el salto hacia atrás).
+//
+// La semántica sigue a CodeGen: printf usa el formato y un solo valor,
+// las variables globales no se soportan, los arrays viven en el frame.
+class IRBuilder : public StaticVisitor<IRBuilder, IRInstr*, void> {
+public:
+    unique_ptr<IRModule> build(Program* program);
+
+    // Visit methods - Expresiones (devuelven el valor SSA)
+    IRInstr* visitIntLiteral(IntLiteral* node);
+    IRInstr* visitFloatLiteral(FloatLiteral* node);
+    IRInstr* visitLongLiteral(LongLiteral* node);
+    IRInstr* visitStringLiteral(StringLiteral* node);
+    IRInstr* visitVariable(Variable* node);
+    IRInstr* visitBinaryOp(BinaryOp* node);
+    IRInstr* visitUnaryOp(UnaryOp* node);
+    IRInstr* visitCastExpr(CastExpr* node);
+    IRInstr* visitTernaryExpr(TernaryExpr* node);
+    IRInstr* visitCallExpr(CallExpr* node);
+    IRInstr* visitArrayAccess(ArrayAccess* node);
+    IRInstr* visitAssignExpr(AssignExpr* node);
+
+    // Visit methods - Statements
+    void visitVarDecl(VarDecl* node);
+    void visitAssignStmt(AssignStmt* node);
+    void visitBlock(Block* node);
+    void visitIfStmt(IfStmt* node);
+    void visitWhileStmt(WhileStmt* node);
+    void visitForStmt(ForStmt* node);
+    void visitReturnStmt(ReturnStmt* node);
+    void visitExprStmt(ExprStmt* node);
+    void visitFunctionDecl(FunctionDecl* node);
+
+private:
+    struct FunctionSig {
+        DataType returnType;
+        vector<DataType> paramTypes;
+    };
+
+    IRModule* module;
+    IRFunction* func;
+    IRBlock* current;
+
+    SymbolMap<FunctionSig> signatures;  // Funciones del programa
+
+    // Variables escalares de la función: índice -> tipo
+    vector<DataType> varTypes;
+    SymbolMap<int> scalarVars;          // SymbolId -> variable vigente
+    SymbolMap<int> arrayVars;           // SymbolId -> slot en func->arrays
+
+    // Estado de la construcción SSA
+    unordered_map<long, IRInstr*> currentDef;                 // (bloque, variable) -> valor
+    unordered_map<int, vector<pair<int, IRInstr*>>> incompletePhis;
+    vector<bool> sealed;                                      // Por id de bloque
+    vector<int> startOrder;                                   // Orden en que se empezó cada bloque
+    vector<unique_ptr<IRInstr>> removedPhis;                  // Phi triviales (siguen vivas por replacement)
+
+    // Bloques
+    IRBlock* createBlock();
+    void startBlock(IRBlock* block);
+    void sealBlock(IRBlock* block);
+    void ensureOpenBlock();
+
+    // Instrucciones
+    IRInstr* append(unique_ptr<IRInstr> instr);
+    IRInstr* emit(IROp op, DataType type, IRInstr* a = nullptr, IRInstr* b = nullptr);
+    IRInstr* emitCompare(IROp op, IRInstr* a, IRInstr* b);
+    IRInstr* convert(IRInstr* value, DataType to);
+    IRInstr* truthValue(IRInstr* value);
+    IRInstr* zeroOf(DataType type);
+    void branch(IRBlock* target);
+    void condBranch(IRInstr* condition, IRBlock* ifTrue, IRBlock* ifFalse);
+    IRInstr* elementIndex(IRArray& array, ExprList& indices);
+    IRInstr* assignScalar(SymbolId symbol, Expr* value);
+    IRInstr* assignElement(SymbolId symbol, ExprList& indices, Expr* value);
+
+    // SSA (Braun et al.)
+    void writeVariable(int var, IRBlock* block, IRInstr* value);
+    IRInstr* readVariable(int var, IRBlock* block);
+    IRInstr* readVariableRecursive(int var, IRBlock* block);
+    IRInstr* newPhi(IRBlock* block, DataType type);
+    IRInstr* addPhiOperands(int var, IRInstr* phi);
+    IRInstr* tryRemoveTrivialPhi(IRInstr* phi);
+
+    static DataType promote(DataType a, DataType b);
+};
+
+#endif
@@ -0,0 +1,567 @@
+#include "ir_codegen.h"
+#include "../visitors/codegen.h"
+#include <climits>
+#include <cstring>
+
+static const char* INT_ARG_REGS[] = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
+static const int MAX_FLOAT_ARGS = 8;
+
+void IRCodeGen::generate(IRModule* irModule) {
+    module = irModule;
+
+    // Literales de string del módulo
+    for (size_t i = 0; i < module->strings.size(); i++) {
+        string label = "str_const_" + to_string(i);
+        rodataSection << "    " << label << ": db " << CodeGen::nasmStringLiteral(module->strings[i]) << "\n";
+        stringLabels.push_back(label);
+    }
+
+    // Header de .text
+    output << "    extern printf\n";
+    output << "    global main\n";
+    output << "\n";
+    flushText();
+
+    for (auto& function : module->functions) {
+        generateFunction(function.get());
+        flushText();
+    }
+}
+
+string IRCodeGen::getOutput() {
+    string rodata = rodataSection.str();
+    size_t total = rodata.size() + 64;
+    for (const string& chunk : textChunks) total += chunk.size();
+
+    string result;
+    result.reserve(total);
+    result += "section .data\n\n";
+    result += "section .rodata\n" + rodata + "\n";
+    result += "section .bss\n\n";
+    result += "section .text\n";
+    for (const string& chunk : textChunks) result += chunk;
+    return result;
+}
+
+void IRCodeGen::emit(const string& code) {
+    output << "    " << code << "\n";
+}
+
+void IRCodeGen::emitLabel(const string& label) {
+    output << label << ":\n";
+}
+
+void IRCodeGen::flushText() {
+    textChunks.push_back(peephole.optimize(output.str()));
+    output.str("");
+}
+
+// ========== FUNCIONES ==========
+
+void IRCodeGen::layoutFrame() {
+    valueSlot.assign(func->nextValueId, 0);
+    phiInSlot.assign(func->nextValueId, 0);
+    fusedCompare.assign(func->nextValueId, false);
+
+    int offset = 0;
+    for (auto& block : func->blocks) {
+        for (auto& instr : block->instrs) {
+            if (instr->type == DataType::VOID) continue;
+            offset += 8;
+            valueSlot[instr->id] = offset;
+            if (instr->op == IROp::Phi) {
+                offset += 8;
+                phiInSlot[instr->id] = offset;
+            }
+        }
+
+        // cmp + jcc: la comparación solo alimenta al condbr de su bloque.
+        // Las igualdades float necesitan mirar PF, se quedan con setcc.
+        IRInstr* terminator = block->terminator();
+        if (terminator && terminator->op == IROp::CondBr) {
+            IRInstr* condition = terminator->operands[0];
+            bool floatEquality = condition->operandType == DataType::FLOAT &&
+                                 (condition->op == IROp::Eq || condition->op == IROp::Ne);
+            if (condition->isComparison() && condition->block == block.get() &&
+                condition->users.size() == 1 && !floatEquality) {
+                fusedCompare[condition->id] = true;
+            }
+        }
+    }
+
+    arrayOffset.clear();
+    for (IRArray& array : func->arrays) {
+        offset += array.elementCount * elementSize(array.type);
+        offset = (offset + 7) / 8 * 8;
+        arrayOffset.push_back(offset);
+    }
+
+    frameSize = (offset + 15) / 16 * 16;
+}
+
+void IRCodeGen::generateFunction(IRFunction* function) {
+    func = function;
+    layoutFrame();
+
+    blockLabels.clear();
+    for (auto& block : func->blocks) {
+        blockLabels.resize(max((int)blockLabels.size(), block->id + 1));
+        blockLabels[block->id] = "irb_" + to_string(labelCounter++);
+    }
+
+    // Registros de los parámetros (SysV: enteros y floats por separado)
+    paramRegs.clear();
+    int intArgs = 0, floatArgs = 0;
+    for (DataType type : func->paramTypes) {
+        if (type == DataType::FLOAT) {
+            paramRegs.push_back(floatArgs < MAX_FLOAT_ARGS ? "xmm" + to_string(floatArgs++) : "");
+        } else {
+            paramRegs.push_back(intArgs < 6 ? INT_ARG_REGS[intArgs++] : "");
+        }
+    }
+
+    emitLabel(string(func->name));
+    emit("push rbp");
+    emit("mov rbp, rsp");
+    if (frameSize > 0) {
+        emit("sub rsp, " + to_string(frameSize));
+    }
+
+    for (size_t i = 0; i < func->blocks.size(); i++) {
+        IRBlock* block = func->blocks[i].get();
+        IRBlock* next = i + 1 < func->blocks.size() ? func->blocks[i + 1].get() : nullptr;
+        if (i > 0) emitLabel(blockLabels[block->id]);
+
+        for (auto& instr : block->instrs) {
+            if (instr->isTerminator()) {
+                generateTerminator(block, instr.get(), next);
+            } else {
+                generateInstr(instr.get());
+            }
+        }
+    }
+}
+
+// ========== OPERANDOS ==========
+
+string IRCodeGen::sized(const string& reg64, DataType type) {
+    return type == DataType::LONG ? reg64 : CodeGen::reg32(reg64);
+}
+
+int IRCodeGen::elementSize(DataType type) {
+    return type == DataType::LONG ? 8 : 4;
+}
+
+string IRCodeGen::slot(IRInstr* value) const {
+    return "[rbp - " + to_string(valueSlot[value->id]) + "]";
+}
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Las constantes float se escriben con sus bits exactos (un plegado puede
+// dar valores que to_string no representa)
+string IRCodeGen::floatLabel(float value) {
+    uint32_t bits = floatBits(value);
+    auto it = floatLabels.find(bits);
+    if (it != floatLabels.end()) return it->second;
+
+    string label = "float_const_" + to_string(floatLabels.size());
+    rodataSection << "    " << label << ": dd " << bits << "  ; " << to_string(value) << "\n";
+    floatLabels[bits] = label;
+    return label;
+}
+
+static bool fitsImm32(long value) {
+    return value >= INT_MIN && value <= INT_MAX;
+}
+
+string IRCodeGen::intOperand(IRInstr* value) {
+    if (value->isConst()) {
+        if (value->type != DataType::LONG) return to_string((int)value->intValue);
+        if (fitsImm32(value->intValue)) return to_string(value->intValue);
+        emit("mov rcx, " + to_string(value->intValue));
+        return "rcx";
+    }
+    if (value->op == IROp::StrAddr) {
+        emit("lea rcx, [" + stringLabels[value->intValue] + "]");
+        return "rcx";
+    }
+    return slot(value);
+}
+
+string IRCodeGen::floatOperand(IRInstr* value) {
+    if (value->isConst()) return "[" + floatLabel(value->floatValue) + "]";
+    return slot(value);
+}
+
+void IRCodeGen::loadInt(IRInstr* value, const string& reg64, DataType type) {
+    string reg = sized(reg64, type);
+    if (value->isConst()) {
+        long constant = type == DataType::LONG ? value->intValue : (int)value->intValue;
+        emit("mov " + reg + ", " + to_string(constant));
+    } else if (value->op == IROp::StrAddr) {
+        emit("lea " + reg64 + ", [" + stringLabels[value->intValue] + "]");
+    } else {
+        emit("mov " + reg + ", " + slot(value));
+    }
+}
+
+void IRCodeGen::loadFloat(IRInstr* value, const string& xmm) {
+    emit("movss " + xmm + ", " + floatOperand(value));
+}
+
+void IRCodeGen::loadRaw(IRInstr* value) {
+    if (value->isConst()) {
+        if (value->type == DataType::FLOAT) {
+            emit("mov eax, " + to_string(floatBits(value->floatValue)));
+        } else {
+            loadInt(value, "rax", value->type);
+        }
+    } else if (value->op == IROp::StrAddr) {
+        emit("lea rax, [" + stringLabels[value->intValue] + "]");
+    } else {
+        emit("mov rax, " + slot(value));
+    }
+}
+
+void IRCodeGen::storeResult(IRInstr* instr, const string& reg64) {
+    emit("mov " + slot(instr) + ", " + sized(reg64, instr->type));
+}
+
+// ========== COMPARACIONES ==========
+
+// Deja los flags listos para el código de condición de conditionCode()
+void IRCodeGen::emitCompare(IRInstr* compare) {
+    IRInstr* a = compare->operands[0];
+    IRInstr* b = compare->operands[1];
+
+    if (compare->operandType == DataType::FLOAT) {
+        // a < b se evalúa como b > a: "above" es falso con NaN
+        if (compare->op == IROp::Lt || compare->op == IROp::Le) swap(a, b);
+        loadFloat(a, "xmm0");
+        emit("ucomiss xmm0, " + floatOperand(b));
+        return;
+    }
+
+    loadInt(a, "rax", compare->operandType);
+    string operand = intOperand(b);
+    emit("cmp " + sized("rax", compare->operandType) + ", " + operand);
+}
+
+static string negateCondition(const string& cc) {
+    static const char* pairs[][2] = {
+        {"e", "ne"}, {"l", "ge"}, {"g", "le"}, {"b", "ae"}, {"a", "be"}
+    };
+    for (auto& pair : pairs) {
+        if (cc == pair[0]) return pair[1];
+        if (cc == pair[1]) return pair[0];
+    }
+    return cc;
+}
+
+string IRCodeGen::conditionCode(IRInstr* compare, bool negate) {
+    string cc;
+    if (compare->operandType == DataType::FLOAT) {
+        switch (compare->op) {
+            case IROp::Eq: cc = "e"; break;
+            case IROp::Ne: cc = "ne"; break;
+            case IROp::Lt:
+            case IROp::Gt: cc = "a"; break;
+            default:       cc = "ae"; break;
+        }
+    } else {
+        bool isUnsigned = compare->operandType == DataType::UNSIGNED_INT;
+        switch (compare->op) {
+            case IROp::Eq: cc = "e"; break;
+            case IROp::Ne: cc = "ne"; break;
+            case IROp::Lt: cc = isUnsigned ? "b" : "l"; break;
+            case IROp::Gt: cc = isUnsigned ? "a" : "g"; break;
+            case IROp::Le: cc = isUnsigned ? "be" : "le"; break;
+            default:       cc = isUnsigned ? "ae" : "ge"; break;
+        }
+    }
+    return negate ? negateCondition(cc) : cc;
+}
+
+// ========== INSTRUCCIONES ==========
+
+void IRCodeGen::generateInstr(IRInstr* instr) {
+    DataType type = instr->type;
+    IRInstr* a = instr->operands.empty() ? nullptr : instr->operands[0];
+    IRInstr* b = instr->operands.size() > 1 ? instr->operands[1] : nullptr;
+
+    switch (instr->op) {
+        case IROp::Const:
+        case IROp::StrAddr:
+            // Se materializan en cada uso
+            break;
+
+        case IROp::Param: {
+            const string& reg = paramRegs[instr->intValue];
+            if (reg.empty()) break;
+            if (type == DataType::FLOAT) {
+                emit("movss " + slot(instr) + ", " + reg);
+            } else {
+                storeResult(instr, reg);
+            }
+            break;
+        }
+
+        case IROp::Phi:
+            // Copia del slot de entrada (lo escribió el predecesor)
+            emit("mov rax, [rbp - " + to_string(phiInSlot[instr->id]) + "]");
+            emit("mov " + slot(instr) + ", rax");
+            break;
+
+        case IROp::Add:
+        case IROp::Sub:
+        case IROp::Mul: {
+            if (type == DataType::FLOAT) {
+                const char* mnemonic = instr->op == IROp::Add ? "addss" : instr->op == IROp::Sub ? "subss" : "mulss";
+                loadFloat(a, "xmm0");
+                emit(string(mnemonic) + " xmm0, " + floatOperand(b));
+                emit("movss " + slot(instr) + ", xmm0");
+                break;
+            }
+            const char* mnemonic = instr->op == IROp::Add ? "add" : instr->op == IROp::Sub ? "sub" : "imul";
+            loadInt(a, "rax", type);
+            string operand = intOperand(b);
+            emit(string(mnemonic) + " " + sized("rax", type) + ", " + operand);
+            storeResult(instr, "rax");
+            break;
+        }
+
+        case IROp::Div:
+        case IROp::Mod:
+            if (type == DataType::FLOAT) {
+                loadFloat(a, "xmm0");
+                emit("divss xmm0, " + floatOperand(b));
+                emit("movss " + slot(instr) + ", xmm0");
+                break;
+            }
+            loadInt(b, "rcx", type);
+            loadInt(a, "rax", type);
+            if (type == DataType::UNSIGNED_INT) {
+                emit("xor edx, edx");
+                emit("div ecx");
+            } else if (type == DataType::LONG) {
+                emit("cqo");
+                emit("idiv rcx");
+            } else {
+                emit("cdq");
+                emit("idiv ecx");
+            }
+            storeResult(instr, instr->op == IROp::Div ? "rax" : "rdx");
+            break;
+
+        case IROp::Neg:
+            if (type == DataType::FLOAT) {
+                loadFloat(a, "xmm0");
+                emit("movss xmm1, [" + floatLabel(-0.0f) + "]");
+                emit("xorps xmm0, xmm1");
+                emit("movss " + slot(instr) + ", xmm0");
+                break;
+            }
+            loadInt(a, "rax", type);
+            emit("neg " + sized("rax", type));
+            storeResult(instr, "rax");
+            break;
+
+        case IROp::Eq:
+        case IROp::Ne:
+        case IROp::Lt:
+        case IROp::Gt:
+        case IROp::Le:
+        case IROp::Ge:
+            if (fusedCompare[instr->id]) break;  // Lo genera el condbr
+            emitCompare(instr);
+            if (instr->operandType == DataType::FLOAT && instr->op == IROp::Eq) {
+                emit("sete al");
+                emit("setnp cl");
+                emit("and al, cl");
+            } else if (instr->operandType == DataType::FLOAT && instr->op == IROp::Ne) {
+                emit("setne al");
+                emit("setp cl");
+                emit("or al, cl");
+            } else {
+                emit("set" + conditionCode(instr, false) + " al");
+            }
+            emit("movzx eax, al");
+            storeResult(instr, "rax");
+            break;
+
+        case IROp::Convert: {
+            DataType from = instr->operandType;
+            if (type == DataType::FLOAT) {
+                // UNSIGNED_INT: mov de 32 bits extiende con ceros, se convierte en 64
+                loadInt(a, "rax", from);
+                emit(from == DataType::INT ? "cvtsi2ss xmm0, eax" : "cvtsi2ss xmm0, rax");
+                emit("movss " + slot(instr) + ", xmm0");
+            } else if (from == DataType::FLOAT) {
+                loadFloat(a, "xmm0");
+                emit(type == DataType::INT ? "cvttss2si eax, xmm0" : "cvttss2si rax, xmm0");
+                storeResult(instr, "rax");
+            } else if (type == DataType::LONG && from == DataType::INT) {
+                loadInt(a, "rax", from);
+                emit("movsxd rax, eax");
+                storeResult(instr, "rax");
+            } else {
+                // Truncar, extender con ceros o reinterpretar el signo
+                loadInt(a, "rax", from == DataType::LONG ? type : from);
+                storeResult(instr, "rax");
+            }
+            break;
+        }
+
+        case IROp::Call: {
+            if (instr->name == "printf") {
+                loadInt(a, "rdi", DataType::LONG);
+                if (!b) {
+                    emit("xor eax, eax");
+                } else if (b->type == DataType::FLOAT) {
+                    loadFloat(b, "xmm0");
+                    emit("cvtss2sd xmm0, xmm0");
+                    emit("mov eax, 1");  // 1 registro XMM usado
+                } else {
+                    loadInt(b, "rax", b->type);
+                    if (b->type == DataType::INT) {
+                        emit("movsxd rsi, eax");
+                    } else {
+                        emit("mov rsi, rax");
+                    }
+                    emit("xor eax, eax");
+                }
+                emit("call printf");
+            } else {
+                int intArgs = 0, floatArgs = 0;
+                for (IRInstr* arg : instr->operands) {
+                    if (arg->type == DataType::FLOAT) {
+                        if (floatArgs < MAX_FLOAT_ARGS) loadFloat(arg, "xmm" + to_string(floatArgs++));
+                    } else if (intArgs < 6) {
+                        loadInt(arg, INT_ARG_REGS[intArgs++], arg->type);
+                    }
+                }
+                emit("call " + string(instr->name));
+            }
+
+            if (type == DataType::FLOAT) {
+                emit("movss " + slot(instr) + ", xmm0");
+            } else if (type != DataType::VOID) {
+                storeResult(instr, "rax");
+            }
+            break;
+        }
+
+        case IROp::LoadElem: {
+            IRArray& array = func->arrays[instr->slot];
+            loadInt(a, "rax", DataType::INT);
+            emit("movsxd rax, eax");
+            string address = "[rbp + rax*" + to_string(elementSize(array.type)) +
+                             " - " + to_string(arrayOffset[instr->slot]) + "]";
+            if (type == DataType::FLOAT) {
+                emit("movss xmm0, " + address);
+                emit("movss " + slot(instr) + ", xmm0");
+            } else {
+                emit("mov " + sized("rcx", type) + ", " + address);
+                storeResult(instr, "rcx");
+            }
+            break;
+        }
+
+        case IROp::StoreElem: {
+            IRArray& array = func->arrays[instr->slot];
+            loadInt(a, "rax", DataType::INT);
+            emit("movsxd rax, eax");
+            string address = "[rbp + rax*" + to_string(elementSize(array.type)) +
+                             " - " + to_string(arrayOffset[instr->slot]) + "]";
+            if (array.type == DataType::FLOAT) {
+                loadFloat(b, "xmm0");
+                emit("movss " + address + ", xmm0");
+            } else {
+                loadInt(b, "rcx", array.type);
+                emit("mov " + address + ", " + sized("rcx", array.type));
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// ========== TERMINADORES ==========
+
+// El predecesor escribe los slots de entrada de las phi del sucesor
+void IRCodeGen::emitPhiMoves(IRBlock* from, IRBlock* to) {
+    int index = to->predIndex(from);
+    for (auto& instr : to->instrs) {
+        if (instr->op != IROp::Phi) break;
+        loadRaw(instr->operands[index]);
+        emit("mov [rbp - " + to_string(phiInSlot[instr->id]) + "], rax");
+    }
+}
+
+void IRCodeGen::emitJump(const string& jcc, IRBlock* target, IRBlock* next) {
+    if (jcc == "jmp" && target == next) return;
+    emit(jcc + " " + blockLabels[target->id]);
+}
+
+void IRCodeGen::generateTerminator(IRBlock* block, IRInstr* instr, IRBlock* next) {
+    switch (instr->op) {
+        case IROp::Br:
+            emitPhiMoves(block, instr->targets[0]);
+            emitJump("jmp", instr->targets[0], next);
+            break;
+
+        case IROp::CondBr: {
+            IRBlock* ifTrue = instr->targets[0];
+            IRBlock* ifFalse = instr->targets[1];
+            // Escribir las phi de los dos lados es seguro: cada camino que
+            // llega al sucesor pasa por un predecesor que las reescribe
+            emitPhiMoves(block, ifTrue);
+            emitPhiMoves(block, ifFalse);
+
+            IRInstr* condition = instr->operands[0];
+            string cc;
+            if (fusedCompare[condition->id]) {
+                emitCompare(condition);
+                cc = conditionCode(condition, false);
+            } else {
+                loadInt(condition, "rax", condition->type);
+                emit("test " + sized("rax", condition->type) + ", " + sized("rax", condition->type));
+                cc = "ne";
+            }
+
+            if (ifFalse == next) {
+                emitJump("j" + cc, ifTrue, next);
+            } else if (ifTrue == next) {
+                emitJump("j" + negateCondition(cc), ifFalse, next);
+            } else {
+                emitJump("j" + cc, ifTrue, next);
+                emitJump("jmp", ifFalse, next);
+            }
+            break;
+        }
+
+        case IROp::Ret:
+            if (!instr->operands.empty()) {
+                IRInstr* value = instr->operands[0];
+                if (value->type == DataType::FLOAT) {
+                    loadFloat(value, "xmm0");
+                } else {
+                    loadInt(value, "rax", value->type);
+                }
+            }
+            emit("mov rsp, rbp");
+            emit("pop rbp");
+            emit("ret");
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef IR_CODEGEN_H
+#define IR_CODEGEN_H
+
+#include "ir.h"
+#include "../visitors/peephole.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <unordered_map>
+
+using namespace std;
+
+// ========== IR -> x86-64 (NASM) ==========
+// Selección de instrucciones directa desde el IR en SSA:
+//   - Cada valor tiene un slot de 8 bytes en el frame ([rbp - N]); las
+//     constantes y las direcciones de strings no, se materializan donde
+//     se usan (inmediatos, float_const_N en .rodata, lea)
+//   - Las phi se resuelven con copias en dos fases: cada predecesor
+//     escribe el slot de entrada de la phi antes de saltar y la phi lo
+//     copia a su slot al principio del bloque (evita el problema del swap)
+//   - Una comparación cuyo único uso es el condbr de su bloque se fusiona
+//     con el salto (cmp + jcc, sin setcc)
+//   - Los saltos al bloque siguiente se omiten
+// Las secciones de salida son las mismas que arma CodeGen.
+class IRCodeGen {
+public:
+    void generate(IRModule* module);
+    string getOutput();
+    const PeepholeOptimizer& peepholeOptimizer() const { return peephole; }
+
+private:
+    stringstream output;
+    stringstream rodataSection;
+    vector<string> textChunks;
+    PeepholeOptimizer peephole;
+
+    IRModule* module;
+    IRFunction* func;
+    int labelCounter = 0;
+
+    vector<string> stringLabels;                   // Por índice en module->strings
+    unordered_map<uint32_t, string> floatLabels;   // Bits del float -> etiqueta
+
+    // Estado de la función actual (indexado por id de valor / bloque)
+    vector<int> valueSlot;
+    vector<int> phiInSlot;
+    vector<bool> fusedCompare;
+    vector<string> blockLabels;
+    vector<int> arrayOffset;
+    vector<string> paramRegs;                      // Registro de cada parámetro
+    int frameSize;
+
+    // Helpers
+    void emit(const string& code);
+    void emitLabel(const string& label);
+    void flushText();
+
+    void generateFunction(IRFunction* function);
+    void layoutFrame();
+    void generateInstr(IRInstr* instr);
+    void generateTerminator(IRBlock* block, IRInstr* instr, IRBlock* next);
+    void emitPhiMoves(IRBlock* from, IRBlock* to);
+    void emitJump(const string& jcc, IRBlock* target, IRBlock* next);
+
+    // Operandos
+    string slot(IRInstr* value) const;
+    string floatLabel(float value);
+    string intOperand(IRInstr* value);             // Inmediato o [rbp - N]
+    string floatOperand(IRInstr* value);           // [float_const_N] o [rbp - N]
+    void loadInt(IRInstr* value, const string& reg64, DataType type);
+    void loadFloat(IRInstr* value, const string& xmm);
+    void loadRaw(IRInstr* value);                  // Los 64 bits del valor en rax
+    void storeResult(IRInstr* instr, const string& reg64);
+
+    // Comparaciones
+    void emitCompare(IRInstr* compare);
+    static string conditionCode(IRInstr* compare, bool negate);
+
+    static string sized(const string& reg64, DataType type);
+    static int elementSize(DataType type);
+};
+
+#endif
@@ -0,0 +1,354 @@
+#include "ir_passes.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+void IROptimizer::run(IRModule* module) {
+    for (auto& func : module->functions) {
+        run(func.get());
+    }
+}
+
+void IROptimizer::run(IRFunction* func) {
+    bool changed = true;
+    while (changed) {
+        changed = foldConstants(func);
+        removeUnreachableBlocks(func);
+        changed = simplifyPhis(func) || changed;
+        compact(func);
+    }
+    mergeBlocks(func);
+    removeDeadCode(func);
+}
+
+// ========== PLEGADO DE CONSTANTES ==========
+
+// Valor entero con el ancho del tipo (INT con signo, UNSIGNED_INT sin signo)
+static long normalize(DataType type, unsigned long value) {
+    if (type == DataType::INT) return (int)value;
+    if (type == DataType::UNSIGNED_INT) return (unsigned)value;
+    return (long)value;
+}
+
+static bool allConstant(IRInstr* instr) {
+    if (instr->operands.empty()) return false;
+    for (IRInstr* operand : instr->operands) {
+        if (!operand->isConst()) return false;
+    }
+    return true;
+}
+
+// Calcula el resultado de una instrucción con operandos constantes.
+// Devuelve nullptr si no se puede (división por cero, overflow de idiv...)
+static IRInstr* evaluate(IRFunction* func, IRInstr* instr) {
+    IRInstr* a = instr->operands[0];
+    IRInstr* b = instr->operands.size() > 1 ? instr->operands[1] : nullptr;
+    DataType type = instr->type;
+
+    if (instr->isComparison()) {
+        bool result;
+        if (instr->operandType == DataType::FLOAT) {
+            float x = a->floatValue, y = b->floatValue;
+            switch (instr->op) {
+                case IROp::Eq: result = x == y; break;
+                case IROp::Ne: result = x != y; break;
+                case IROp::Lt: result = x < y; break;
+                case IROp::Gt: result = x > y; break;
+                case IROp::Le: result = x <= y; break;
+                default:       result = x >= y; break;
+            }
+        } else if (instr->operandType == DataType::UNSIGNED_INT) {
+            unsigned x = a->intValue, y = b->intValue;
+            switch (instr->op) {
+                case IROp::Eq: result = x == y; break;
+                case IROp::Ne: result = x != y; break;
+                case IROp::Lt: result = x < y; break;
+                case IROp::Gt: result = x > y; break;
+                case IROp::Le: result = x <= y; break;
+                default:       result = x >= y; break;
+            }
+        } else {
+            long x = a->intValue, y = b->intValue;
+            switch (instr->op) {
+                case IROp::Eq: result = x == y; break;
+                case IROp::Ne: result = x != y; break;
+                case IROp::Lt: result = x < y; break;
+                case IROp::Gt: result = x > y; break;
+                case IROp::Le: result = x <= y; break;
+                default:       result = x >= y; break;
+            }
+        }
+        return func->intConst(DataType::INT, result);
+    }
+
+    if (instr->op == IROp::Convert) {
+        DataType from = instr->operandType;
+        if (type == DataType::FLOAT) {
+            if (from == DataType::UNSIGNED_INT) return func->floatConst((unsigned)a->intValue);
+            return func->floatConst(a->intValue);
+        }
+        if (from == DataType::FLOAT) {
+            // cvttss2si: fuera de rango no se pliega
+            if (!(fabs(a->floatValue) < 2147483648.0f)) return nullptr;
+            return func->intConst(type, normalize(type, (long)a->floatValue));
+        }
+        return func->intConst(type, normalize(type, a->intValue));
+    }
+
+    if (type == DataType::FLOAT) {
+        float x = a->floatValue;
+        float y = b ? b->floatValue : 0;
+        switch (instr->op) {
+            case IROp::Add: return func->floatConst(x + y);
+            case IROp::Sub: return func->floatConst(x - y);
+            case IROp::Mul: return func->floatConst(x * y);
+            case IROp::Div: return func->floatConst(x / y);
+            case IROp::Neg: return func->floatConst(-x);
+            default:        return nullptr;
+        }
+    }
+
+    unsigned long x = a->intValue;
+    unsigned long y = b ? b->intValue : 0;
+    switch (instr->op) {
+        case IROp::Add: return func->intConst(type, normalize(type, x + y));
+        case IROp::Sub: return func->intConst(type, normalize(type, x - y));
+        case IROp::Mul: return func->intConst(type, normalize(type, x * y));
+        case IROp::Neg: return func->intConst(type, normalize(type, 0 - x));
+        case IROp::Div:
+        case IROp::Mod: {
+            long dividend = a->intValue, divisor = b->intValue;
+            if (divisor == 0) return nullptr;
+            long result;
+            if (type == DataType::UNSIGNED_INT) {
+                unsigned ux = dividend, uy = divisor;
+                result = instr->op == IROp::Div ? ux / uy : ux % uy;
+            } else {
+                long minValue = type == DataType::INT ? INT_MIN : LONG_MIN;
+                if (dividend == minValue && divisor == -1) return nullptr;
+                result = instr->op == IROp::Div ? dividend / divisor : dividend % divisor;
+            }
+            return func->intConst(type, normalize(type, result));
+        }
+        default:
+            return nullptr;
+    }
+}
+
+bool IROptimizer::foldConstants(IRFunction* func) {
+    bool changed = false;
+    for (auto& block : func->blocks) {
+        for (auto& instr : block->instrs) {
+            if (instr->op == IROp::CondBr) {
+                IRInstr* condition = instr->operands[0];
+                IRBlock* taken = instr->targets[0];
+                IRBlock* dropped = instr->targets[1];
+                if (!condition->isConst() || taken == dropped) continue;
+                if (condition->intValue == 0) swap(taken, dropped);
+
+                removeEdge(block.get(), dropped);
+                instr->dropOperands();
+                instr->op = IROp::Br;
+                instr->targets[0] = taken;
+                instr->targets[1] = nullptr;
+                branchesFolded++;
+                changed = true;
+                continue;
+            }
+
+            if (instr->op == IROp::Phi || instr->op == IROp::Call ||
+                instr->op == IROp::LoadElem || instr->op == IROp::StoreElem ||
+                instr->isTerminator() || instr->replacement || !allConstant(instr.get())) {
+                continue;
+            }
+
+            IRInstr* folded = evaluate(func, instr.get());
+            if (!folded) continue;
+
+            IRFunction::replaceAllUses(instr.get(), folded);
+            instr->dropOperands();
+            instr->replacement = folded;
+            constantsFolded++;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// Una phi con un solo valor distinto (sin contarse a sí misma) es ese valor
+bool IROptimizer::simplifyPhis(IRFunction* func) {
+    bool changed = false;
+    for (auto& block : func->blocks) {
+        for (auto& instr : block->instrs) {
+            if (instr->op != IROp::Phi) break;
+            if (instr->replacement) continue;
+
+            IRInstr* same = nullptr;
+            bool trivial = true;
+            for (IRInstr* operand : instr->operands) {
+                if (operand == instr.get() || operand == same) continue;
+                if (same) { trivial = false; break; }
+                same = operand;
+            }
+            if (!trivial || !same) continue;
+
+            IRFunction::replaceAllUses(instr.get(), same);
+            instr->dropOperands();
+            instr->replacement = same;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+// ========== CFG ==========
+
+void IROptimizer::removeEdge(IRBlock* pred, IRBlock* succ) {
+    int index = succ->predIndex(pred);
+    if (index < 0) return;
+
+    for (auto& instr : succ->instrs) {
+        if (instr->op != IROp::Phi) break;
+        if (index < (int)instr->operands.size()) instr->removeOperand(index);
+    }
+    succ->preds.erase(succ->preds.begin() + index);
+
+    auto it = find(pred->succs.begin(), pred->succs.end(), succ);
+    if (it != pred->succs.end()) pred->succs.erase(it);
+}
+
+void IROptimizer::removeUnreachableBlocks(IRFunction* func) {
+    vector<bool> reachable(func->nextBlockId, false);
+    vector<IRBlock*> worklist = {func->entry()};
+    reachable[func->entry()->id] = true;
+    while (!worklist.empty()) {
+        IRBlock* block = worklist.back();
+        worklist.pop_back();
+        for (IRBlock* succ : block->succs) {
+            if (!reachable[succ->id]) {
+                reachable[succ->id] = true;
+                worklist.push_back(succ);
+            }
+        }
+    }
+
+    bool anyDead = false;
+    for (auto& block : func->blocks) {
+        if (reachable[block->id]) continue;
+        anyDead = true;
+        // Copia: removeEdge modifica succs
+        vector<IRBlock*> succs = block->succs;
+        for (IRBlock* succ : succs) {
+            removeEdge(block.get(), succ);
+        }
+        for (auto& instr : block->instrs) {
+            instr->dropOperands();
+        }
+    }
+    if (!anyDead) return;
+
+    // Las instrucciones de un bloque muerto solo las usaban bloques muertos
+    for (auto& block : func->blocks) {
+        if (!reachable[block->id]) {
+            instrsRemoved += block->instrs.size();
+            blocksRemoved++;
+        }
+    }
+    func->blocks.erase(remove_if(func->blocks.begin(), func->blocks.end(),
+                                 [&](const unique_ptr<IRBlock>& block) { return !reachable[block->id]; }),
+                       func->blocks.end());
+}
+
+// b: ...; br s   +   s (único predecesor b)   ->   b: ...; (instrucciones de s)
+void IROptimizer::mergeBlocks(IRFunction* func) {
+    vector<bool> merged(func->nextBlockId, false);
+    for (auto& block : func->blocks) {
+        if (merged[block->id]) continue;
+        while (true) {
+            IRInstr* terminator = block->terminator();
+            if (!terminator || terminator->op != IROp::Br) break;
+            IRBlock* succ = terminator->targets[0];
+            if (succ == block.get() || succ == func->entry() || succ->preds.size() != 1) break;
+
+            // Con un solo predecesor una phi es su único operando
+            for (auto& instr : succ->instrs) {
+                if (instr->op != IROp::Phi) break;
+                IRFunction::replaceAllUses(instr.get(), instr->operands[0]);
+                instr->dropOperands();
+            }
+            auto& instrs = succ->instrs;
+            instrs.erase(remove_if(instrs.begin(), instrs.end(),
+                                   [](const unique_ptr<IRInstr>& instr) { return instr->op == IROp::Phi; }),
+                         instrs.end());
+
+            block->instrs.pop_back();
+            for (auto& instr : instrs) {
+                instr->block = block.get();
+                block->instrs.push_back(move(instr));
+            }
+            instrs.clear();
+
+            // Los sucesores de s pasan a serlo de b (mismo índice en preds)
+            block->succs = succ->succs;
+            for (IRBlock* next : block->succs) {
+                replace(next->preds.begin(), next->preds.end(), succ, block.get());
+            }
+            succ->succs.clear();
+            succ->preds.clear();
+            merged[succ->id] = true;
+            blocksMerged++;
+        }
+    }
+
+    func->blocks.erase(remove_if(func->blocks.begin(), func->blocks.end(),
+                                 [&](const unique_ptr<IRBlock>& block) { return merged[block->id]; }),
+                       func->blocks.end());
+}
+
+void IROptimizer::compact(IRFunction* func) {
+    for (auto& block : func->blocks) {
+        auto& instrs = block->instrs;
+        instrs.erase(remove_if(instrs.begin(), instrs.end(),
+                               [](const unique_ptr<IRInstr>& instr) { return instr->replacement != nullptr; }),
+                     instrs.end());
+    }
+}
+
+// ========== CÓDIGO MUERTO ==========
+
+void IROptimizer::removeDeadCode(IRFunction* func) {
+    vector<bool> live(func->nextValueId, false);
+    vector<IRInstr*> worklist;
+    for (auto& block : func->blocks) {
+        for (auto& instr : block->instrs) {
+            if (!instr->isPure()) {
+                live[instr->id] = true;
+                worklist.push_back(instr.get());
+            }
+        }
+    }
+    while (!worklist.empty()) {
+        IRInstr* instr = worklist.back();
+        worklist.pop_back();
+        for (IRInstr* operand : instr->operands) {
+            if (!live[operand->id]) {
+                live[operand->id] = true;
+                worklist.push_back(operand);
+            }
+        }
+    }
+
+    for (auto& block : func->blocks) {
+        for (auto& instr : block->instrs) {
+            if (!live[instr->id]) instr->dropOperands();
+        }
+    }
+    for (auto& block : func->blocks) {
+        auto& instrs = block->instrs;
+        size_t before = instrs.size();
+        instrs.erase(remove_if(instrs.begin(), instrs.end(),
+                               [&](const unique_ptr<IRInstr>& instr) { return !live[instr->id]; }),
+                     instrs.end());
+        instrsRemoved += before - instrs.size();
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef IR_PASSES_H
+#define IR_PASSES_H
+
+#include "ir.h"
+
+using namespace std;
+
+// ========== PASES SOBRE EL IR ==========
+// Limpieza básica después de construir el SSA:
+//   - Plegado de constantes (aritmética, comparaciones, conversiones) y de
+//     saltos condicionales con condición constante
+//   - Simplificación de phi triviales (todos los operandos iguales)
+//   - Eliminación de bloques inalcanzables y fusión de un bloque con su
+//     único sucesor cuando este no tiene otro predecesor
+//   - Eliminación de código muerto (mark & sweep desde las instrucciones
+//     con efectos: calls, stores, terminadores, divisiones enteras)
+// Los pases de optimización más grandes se agregan acá.
+class IROptimizer {
+public:
+    // Estadísticas acumuladas de todas las funciones
+    int constantsFolded = 0;
+    int branchesFolded = 0;
+    int blocksRemoved = 0;
+    int blocksMerged = 0;
+    int instrsRemoved = 0;
+
+    void run(IRModule* module);
+    void run(IRFunction* func);
+
+private:
+    bool foldConstants(IRFunction* func);
+    bool simplifyPhis(IRFunction* func);
+    void removeUnreachableBlocks(IRFunction* func);
+    void mergeBlocks(IRFunction* func);
+    void removeDeadCode(IRFunction* func);
+
+    // Saca la arista pred -> succ y el operando correspondiente de las phi
+    static void removeEdge(IRBlock* pred, IRBlock* succ);
+
+    // Borra de los bloques las instrucciones reemplazadas (replacement != nullptr)
+    static void compact(IRFunction* func);
+};
+
+#endif
@@ -1,23 +1,27 @@
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "scanner/source_buffer.h"
 #include "scanner/scanner.h"
+#include "scanner/symbol_table.h"
+#include "scanner/char_scan.h"
 #include "parser/parser.h"
 #include "visitors/codegen.h"
 #include "visitors/optimizer.h"  //  NUEVO - Incluir el optimizador
+#include "ir/ir_builder.h"
+#include "ir/ir_passes.h"
+#include "ir/ir_codegen.h"
+#include "support/time_report.h"
 
 using namespace std;
 
-string readFile(string filename) {
-    ifstream file(filename);
-    if (!file.is_open()) {
+void readFile(string filename, SourceBuffer& source) {
+    if (!source.open(filename)) {
         cerr << "Error: Could not open file " << filename << endl;
         exit(1);
     }
-
-    stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
 }
 
 void writeFile(string filename, string content) {
@@ -31,55 +35,258 @@ void writeFile(string filename, string content) {
     file.close();
 }
 
+// Instrucciones eliminadas por cada patrón del peephole
+void printPeepholeStats(const PeepholeOptimizer& peephole) {
+    cout << "  Peephole: " << peephole.totalRemoved() << " instructions removed" << endl;
+    for (const auto& pattern : peephole.stats()) {
+        if (pattern.matches == 0) continue;
+        cout << "    " << pattern.name << ": " << pattern.removed << " removed ("
+             << pattern.matches << " matches)" << endl;
+    }
+}
+
+// Streambuf que descarta todo (para silenciar cout con --time-report=json)
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+};
+
 int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        cerr << "Usage: " << argv[0] << " <input.c> [output.asm]" << endl;
+    // Opciones: --time-report (tabla) o --time-report=json,
+    // --ir (backend por el IR en SSA), --dump-ir (imprime el IR),
+    // --unroll=N (factor máximo de desenrollado parcial: 1, 2, 4 u 8) y
+    // --unroll-report (decisión de desenrollado de cada for),
+    // --target=sse2|avx2 (ancho de los loops vectorizados: 4 u 8 carriles),
+    // --inline-size=N y --inline-sites=N (umbrales del inlining, 0 = sin inlining),
+    // --specialize=N (copias por patrón de argumentos constantes, < 2 = ninguna)
+    bool timeReport = false;
+    bool timeReportJson = false;
+    bool useIR = false;
+    bool dumpIR = false;
+    int unrollFactor = 4;
+    bool unrollReport = false;
+    bool targetAVX2 = false;
+    int inlineSize = 40;
+    int inlineSites = 3;
+    int specializations = 2;
+    vector<string> positional;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--time-report") {
+            timeReport = true;
+        } else if (arg == "--time-report=json") {
+            timeReport = true;
+            timeReportJson = true;
+        } else if (arg == "--ir") {
+            useIR = true;
+        } else if (arg == "--dump-ir") {
+            useIR = true;
+            dumpIR = true;
+        } else if (arg.rfind("--unroll=", 0) == 0) {
+            string factor = arg.substr(9);
+            if (factor != "1" && factor != "2" && factor != "4" && factor != "8") {
+                cerr << "Error: --unroll expects 1, 2, 4 or 8" << endl;
+                return 1;
+            }
+            unrollFactor = stoi(factor);
+        } else if (arg == "--unroll-report") {
+            unrollReport = true;
+        } else if (arg == "--target=sse2" || arg == "--target=avx2") {
+            targetAVX2 = arg == "--target=avx2";
+        } else if (arg.rfind("--target=", 0) == 0) {
+            cerr << "Error: --target expects sse2 or avx2" << endl;
+            return 1;
+        } else if (arg.rfind("--inline-size=", 0) == 0 || arg.rfind("--inline-sites=", 0) == 0 ||
+                   arg.rfind("--specialize=", 0) == 0) {
+            string value = arg.substr(arg.find('=') + 1);
+            if (value.empty() || value.find_first_not_of("0123456789") != string::npos) {
+                cerr << "Error: " << arg.substr(0, arg.find('=')) << " expects a non-negative number" << endl;
+                return 1;
+            }
+            if (arg.rfind("--inline-size=", 0) == 0) {
+                inlineSize = stoi(value);
+            } else if (arg.rfind("--specialize=", 0) == 0) {
+                specializations = stoi(value);
+            } else {
+                inlineSites = stoi(value);
+            }
+        } else if (arg.rfind("--", 0) == 0) {
+            cerr << "Error: Unknown option " << arg << endl;
+            return 1;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    if (positional.empty()) {
+        cerr << "Usage: " << argv[0] << " [--time-report[=json]] [--ir] [--dump-ir] [--unroll=N] [--unroll-report] [--target=sse2|avx2] [--inline-size=N] [--inline-sites=N] [--specialize=N] <input.c> [output.asm]" << endl;
         return 1;
     }
 
-    string inputFile = argv[1];
-    string outputFile = argc >= 3 ? argv[2] : "output.asm";
+    string inputFile = positional[0];
+    string outputFile = positional.size() >= 2 ? positional[1] : "output.asm";
+
+    // En modo JSON solo el reporte va a stdout
+    NullBuffer nullBuffer;
+    streambuf* coutBuffer = cout.rdbuf();
+    if (timeReportJson) cout.rdbuf(&nullBuffer);
+
+    TimeReport report;
 
     cout << "Compiling " << inputFile << "..." << endl;
 
-    // 1. Leer archivo fuente
-    string source = readFile(inputFile);
+    // 1. Leer archivo fuente (mapeado en memoria, vive hasta el final de main
+    //    porque los lexemas de los tokens apuntan dentro del buffer)
+    report.startPhase("read");
+    SourceBuffer source;
+    readFile(inputFile, source);
+    report.sourceBytes = source.size();
 
-    // 2. Análisis léxico (Scanner)
-    cout << "Phase 1: Lexical analysis..." << endl;
-    Scanner scanner(source);
-    vector<Token> tokens = scanner.scanTokens();
+    // 1.5. Solo con --time-report: pasada de escaneo aislada para medir el
+    //      lexer por separado (el parser vuelve a escanear en streaming)
+    if (timeReport) {
+        report.startPhase("scan");
+        SymbolTable scanSymbols;
+        Scanner scanOnly(source.view(), scanSymbols);
+        while (scanOnly.nextToken().type != TokenType::END_OF_FILE) {}
+        report.tokens = scanOnly.tokensScanned();
+    }
 
-    cout << "  Tokens generated: " << tokens.size() << endl;
+    // 2-3. Análisis léxico y sintáctico en streaming: el parser pide los
+    //      tokens al scanner bajo demanda a través de un buffer circular
+    cout << "Phase 1-2: Lexical and syntax analysis (streaming)..." << endl;
+    report.startPhase("parse");
+    auto parseStart = chrono::steady_clock::now();
+    // Los identificadores se internan al escanearlos; la tabla vive tanto
+    // como el AST porque los nodos guardan SymbolIds
+    SymbolTable symbols;
+    Scanner scanner(source.view(), symbols);
 
     // Debug: Mostrar tokens (opcional - descomentar para debug)
     /*
-    for (const Token& token : tokens) {
+    SymbolTable debugSymbols;
+    for (const Token& token : Scanner(source.view(), debugSymbols).scanTokens()) {
         cout << "  " << token.toString() << endl;
     }
     */
 
-    // 3. Análisis sintáctico (Parser)
-    cout << "Phase 2: Syntax analysis..." << endl;
-    Parser parser(tokens);
+    Parser parser(scanner);
     unique_ptr<Program> ast = parser.parse();
+    double parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - parseStart).count();
+    report.endPhase();
 
+    cout << "  Tokens scanned: " << scanner.tokensScanned();
+    if (parseSeconds > 0) {
+        cout << " (" << (long)(scanner.tokensScanned() / parseSeconds) << " tokens/s, "
+             << (long)(source.size() / parseSeconds / 1e6) << " MB/s, scan+parse)";
+    }
+    cout << endl;
+    cout << "  Distinct identifiers: " << symbols.size() << endl;
+    cout << "  Lexer fast path: " << charScanBackend() << endl;
     cout << "  AST built successfully" << endl;
+    const Arena& arena = *ast->arena;
+    report.astNodes = arena.nodesAllocated();
+    report.arenaBytes = arena.bytesAllocated();
+    report.arenaChunks = arena.chunkCount();
+    report.arenaChunkSeconds = arena.chunkAllocSeconds();
+    if (timeReport) report.countNodes(ast.get());
 
     // 3.5. Optimización (Optimizer)  NUEVO
     cout << "Phase 2.5: Optimization..." << endl;
+    report.startPhase("optimize");
+    auto optimizeStart = chrono::steady_clock::now();
     Optimizer optimizer;
+    optimizer.maxUnrollFactor = unrollFactor;
+    optimizer.inlineSizeThreshold = inlineSize;
+    optimizer.inlineCallSites = inlineSites;
+    optimizer.maxSpecializations = specializations;
     optimizer.optimize(ast.get());
+    double optimizeSeconds = chrono::duration<double>(chrono::steady_clock::now() - optimizeStart).count();
+    cout << "  Optimization time: " << optimizeSeconds * 1000 << " ms" << endl;
+    cout << "  Inlining: " << optimizer.inlinedCalls << " call sites inlined ("
+         << optimizer.inlinedFunctions << " functions eligible)" << endl;
+    cout << "  Interprocedural: " << optimizer.constantArguments << " constant arguments, "
+         << optimizer.specializedClones << " specialized copies, "
+         << optimizer.removedFunctions << " dead functions removed" << endl;
+    cout << "  Constant propagation: " << optimizer.constantsPropagated << " expressions folded, "
+         << optimizer.unreachableStatements << " unreachable statements removed" << endl;
+    cout << "  Common subexpressions: " << optimizer.reusedExpressions << " reused, "
+         << optimizer.valueTemporaries << " temporaries" << endl;
+    cout << "  Loop-invariant code motion: " << optimizer.hoistedExpressions << " expressions hoisted, "
+         << optimizer.splitIndices << " 2D indices split" << endl;
+    cout << "  Dead code: " << optimizer.deadStores << " dead stores, "
+         << optimizer.deadExpressions << " unused expressions, "
+         << optimizer.unusedLocals << " unused locals removed" << endl;
+    cout << "  Tail recursion: " << optimizer.tailRecursiveCalls << " self calls turned into loops" << endl;
+    if (unrollReport) {
+        cout << "  Unroll report (" << optimizer.unrollReport.size() << " loops):" << endl;
+        for (const string& decision : optimizer.unrollReport) {
+            cout << "    " << decision << endl;
+        }
+    }
 
-    // 4. Generación de código (CodeGen)
-    cout << "Phase 3: Code generation..." << endl;
-    CodeGen codegen;
-    codegen.generate(ast.get());
+    string asmCode;
+    if (useIR) {
+        // 4. AST -> IR en SSA, pases sobre el IR y selección de instrucciones
+        cout << "Phase 3: IR construction and optimization..." << endl;
+        report.startPhase("ir");
+        IRBuilder irBuilder;
+        unique_ptr<IRModule> irModule = irBuilder.build(ast.get());
+        IROptimizer irOptimizer;
+        irOptimizer.run(irModule.get());
 
-    string asmCode = codegen.getOutput();
+        int blockCount = 0, instrCount = 0;
+        for (auto& func : irModule->functions) {
+            blockCount += func->blocks.size();
+            for (auto& block : func->blocks) instrCount += block->instrs.size();
+        }
+        cout << "  IR: " << irModule->functions.size() << " functions, " << blockCount
+             << " blocks, " << instrCount << " instructions" << endl;
+        cout << "  IR passes: " << irOptimizer.constantsFolded << " constants folded, "
+             << irOptimizer.branchesFolded << " branches folded, "
+             << irOptimizer.blocksRemoved << " blocks removed, "
+             << irOptimizer.blocksMerged << " blocks merged, "
+             << irOptimizer.instrsRemoved << " dead instructions removed" << endl;
+        if (dumpIR) irModule->print(cout);
+
+        cout << "Phase 4: Code generation (from IR)..." << endl;
+        report.startPhase("codegen");
+        IRCodeGen irCodegen;
+        irCodegen.generate(irModule.get());
+        printPeepholeStats(irCodegen.peepholeOptimizer());
+        asmCode = irCodegen.getOutput();
+    } else {
+        // 4. Generación de código (CodeGen)
+        cout << "Phase 3: Code generation..." << endl;
+        report.startPhase("codegen");
+        CodeGen codegen;
+        codegen.useAVX2 = targetAVX2;
+        codegen.generate(ast.get());
+        const RegisterAllocator& regAlloc = codegen.registerAllocator();
+        cout << "  Register allocation: " << regAlloc.varsInRegisters << " variables in registers, "
+             << regAlloc.varsSpilled << " in memory" << endl;
+        cout << "  Expression temporaries: " << codegen.tempsInRegisters << " in registers, "
+             << codegen.tempsSpilled << " spilled to stack" << endl;
+        cout << "  Strength reduction: " << codegen.stridedAccessCount << " array accesses on pointers, "
+             << codegen.countersRemoved << " loop counters removed" << endl;
+        cout << "  Vectorizer: " << codegen.vectorizedLoops << " loops vectorized ("
+             << (targetAVX2 ? "avx2, 8" : "sse2, 4") << " lanes)" << endl;
+        cout << "  Tail calls: " << codegen.tailCalls << " lowered to jmp" << endl;
+        printPeepholeStats(codegen.peepholeOptimizer());
+        asmCode = codegen.getOutput();
+    }
+
+    report.asmLines = count(asmCode.begin(), asmCode.end(), '\n');
 
     // 5. Escribir archivo ensamblador
+    report.startPhase("write");
     writeFile(outputFile, asmCode);
+    report.endPhase();
+
+    // 6. Liberar el AST: la arena suelta sus bloques de una vez
+    report.startPhase("teardown");
+    ast.reset();
+    report.endPhase();
 
     cout << "Success! Assembly code written to " << outputFile << endl;
     cout << "\nTo assemble and link:" << endl;
@@ -87,5 +294,12 @@ int main(int argc, char* argv[]) {
     cout << "  gcc output.o -o program -no-pie" << endl;
     cout << "  ./program" << endl;
 
+    if (timeReportJson) {
+        cout.rdbuf(coutBuffer);
+        report.printJson(cout);
+    } else if (timeReport) {
+        report.print(cout);
+    }
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,38 @@
+#include "arena.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+Arena::Arena()
+    : cursor(nullptr), limit(nullptr), bytesUsed(0), nodeCount(0), chunkSeconds(0) {}
+
+Arena::~Arena() {
+    // Liberar el AST completo: un free por chunk
+    for (char* chunk : chunks) {
+        free(chunk);
+    }
+}
+
+void* Arena::allocateSlow(size_t size, size_t align) {
+    auto start = chrono::steady_clock::now();
+
+    // Objetos grandes (listas muy largas) reciben su propio chunk
+    size_t chunkSize = CHUNK_SIZE;
+    if (size + align > chunkSize) chunkSize = size + align;
+
+    char* chunk = static_cast<char*>(malloc(chunkSize));
+    if (!chunk) throw bad_alloc();
+    chunks.push_back(chunk);
+
+    cursor = chunk;
+    limit = chunk + chunkSize;
+    chunkSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    return allocate(size, align);
+}
+
+string_view Arena::copyString(string_view text) {
+    char* memory = static_cast<char*>(allocate(text.size(), 1));
+    memcpy(memory, text.data(), text.size());
+    return string_view(memory, text.size());
+}
@@ -0,0 +1,151 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cassert>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+// Deleter vacío: la memoria de los nodos la libera el Arena en bloque
+struct ArenaDelete {
+    void operator()(const void*) const {}
+};
+
+// Puntero a un nodo del AST (mismo uso que unique_ptr: get(), move, nullptr)
+template <typename T>
+using NodePtr = unique_ptr<T, ArenaDelete>;
+
+// ========== ARENA (BUMP ALLOCATOR) PARA EL AST ==========
+// Todos los nodos del AST se crean dentro de un Arena que pertenece al
+// Program. Reservar un nodo es mover un puntero dentro del chunk actual, y
+// liberar el árbol completo es liberar los chunks: O(chunks), sin recorrer
+// el árbol. Por eso los nodos NUNCA ejecutan su destructor y no deben poseer
+// memoria del heap: los nombres son string_view y las listas son NodeList
+// (que también viven en el Arena).
+class Arena {
+private:
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    vector<char*> chunks;
+    char* cursor;           // Siguiente byte libre del chunk actual
+    char* limit;            // Fin del chunk actual
+
+    size_t bytesUsed;       // Bytes entregados (incluye padding de alineación)
+    size_t nodeCount;       // Nodos del AST creados con make()
+    double chunkSeconds;    // Tiempo total pidiendo chunks al sistema
+
+    void* allocateSlow(size_t size, size_t align);
+
+public:
+    Arena();
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t align) {
+        size_t padding = (align - (reinterpret_cast<size_t>(cursor) & (align - 1))) & (align - 1);
+        if (cursor && size + padding <= static_cast<size_t>(limit - cursor)) {
+            void* result = cursor + padding;
+            cursor += size + padding;
+            bytesUsed += size + padding;
+            return result;
+        }
+        return allocateSlow(size, align);
+    }
+
+    // Crea un nodo del AST dentro del arena
+    template <typename T, typename... Args>
+    NodePtr<T> make(Args&&... args);
+
+    // Copia un string dentro del arena (para nombres sintetizados)
+    string_view copyString(string_view text);
+
+    size_t nodesAllocated() const { return nodeCount; }
+    size_t bytesAllocated() const { return bytesUsed; }
+    size_t chunkCount() const { return chunks.size(); }
+    double chunkAllocSeconds() const { return chunkSeconds; }
+};
+
+template <typename T, typename... Args>
+NodePtr<T> Arena::make(Args&&... args) {
+    void* memory = allocate(sizeof(T), alignof(T));
+    nodeCount++;
+    return NodePtr<T>(new (memory) T(forward<Args>(args)...));
+}
+
+// ========== LISTA RESPALDADA POR EL ARENA ==========
+// Reemplazo mínimo de vector<> para los hijos de los nodos. Al crecer pide
+// un bloque nuevo al Arena; el bloque anterior queda en el arena hasta el
+// final (nunca se libera individualmente).
+template <typename T>
+class NodeList {
+private:
+    Arena* arena;
+    T* items;
+    size_t count;
+    size_t capacity;
+
+    void grow() {
+        assert(arena && "NodeList sin arena");
+        size_t newCapacity = capacity ? capacity * 2 : 4;
+        T* newItems = static_cast<T*>(arena->allocate(sizeof(T) * newCapacity, alignof(T)));
+        for (size_t i = 0; i < count; i++) {
+            new (&newItems[i]) T(move(items[i]));
+        }
+        items = newItems;
+        capacity = newCapacity;
+    }
+
+public:
+    NodeList() : arena(nullptr), items(nullptr), count(0), capacity(0) {}
+    explicit NodeList(Arena* arena) : arena(arena), items(nullptr), count(0), capacity(0) {}
+
+    NodeList(const NodeList&) = delete;
+    NodeList& operator=(const NodeList&) = delete;
+
+    NodeList(NodeList&& other) noexcept
+        : arena(other.arena), items(other.items), count(other.count), capacity(other.capacity) {
+        other.items = nullptr;
+        other.count = other.capacity = 0;
+    }
+
+    NodeList& operator=(NodeList&& other) noexcept {
+        arena = other.arena;
+        items = other.items;
+        count = other.count;
+        capacity = other.capacity;
+        other.items = nullptr;
+        other.count = other.capacity = 0;
+        return *this;
+    }
+
+    void push_back(T&& value) {
+        if (count == capacity) grow();
+        new (&items[count++]) T(move(value));
+    }
+
+    void push_back(const T& value) {
+        if (count == capacity) grow();
+        new (&items[count++]) T(value);
+    }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](size_t index) { return items[index]; }
+    const T& operator[](size_t index) const { return items[index]; }
+    T& back() { return items[count - 1]; }
+
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+};
+
+#endif
@@ -13,10 +13,37 @@ string dataTypeToString(DataType type) {
     }
 }
 
+const char* nodeKindName(NodeKind kind) {
+    switch (kind) {
+        case NodeKind::IntLiteral: return "IntLiteral";
+        case NodeKind::FloatLiteral: return "FloatLiteral";
+        case NodeKind::LongLiteral: return "LongLiteral";
+        case NodeKind::StringLiteral: return "StringLiteral";
+        case NodeKind::Variable: return "Variable";
+        case NodeKind::BinaryOp: return "BinaryOp";
+        case NodeKind::UnaryOp: return "UnaryOp";
+        case NodeKind::CastExpr: return "CastExpr";
+        case NodeKind::TernaryExpr: return "TernaryExpr";
+        case NodeKind::CallExpr: return "CallExpr";
+        case NodeKind::ArrayAccess: return "ArrayAccess";
+        case NodeKind::AssignExpr: return "AssignExpr";
+        case NodeKind::VarDecl: return "VarDecl";
+        case NodeKind::AssignStmt: return "AssignStmt";
+        case NodeKind::Block: return "Block";
+        case NodeKind::IfStmt: return "IfStmt";
+        case NodeKind::WhileStmt: return "WhileStmt";
+        case NodeKind::ForStmt: return "ForStmt";
+        case NodeKind::ReturnStmt: return "ReturnStmt";
+        case NodeKind::ExprStmt: return "ExprStmt";
+        case NodeKind::FunctionDecl: return "FunctionDecl";
+    }
+    return "Unknown";
+}
+
 // ========== EXPRESIONES ==========
 
 // IntLiteral
-IntLiteral::IntLiteral(int value) : value(value) {
+IntLiteral::IntLiteral(int value) : Expr(KIND), value(value) {
     inferredType = DataType::INT;
 }
 
@@ -25,7 +52,7 @@ void IntLiteral::accept(Visitor* visitor) {
 }
 
 // FloatLiteral
-FloatLiteral::FloatLiteral(float value) : value(value) {
+FloatLiteral::FloatLiteral(float value) : Expr(KIND), value(value) {
     inferredType = DataType::FLOAT;
 }
 
@@ -34,7 +61,7 @@ void FloatLiteral::accept(Visitor* visitor) {
 }
 
 // LongLiteral
-LongLiteral::LongLiteral(long value) : value(value) {
+LongLiteral::LongLiteral(long value) : Expr(KIND), value(value) {
     inferredType = DataType::LONG;
 }
 
@@ -43,7 +70,7 @@ void LongLiteral::accept(Visitor* visitor) {
 }
 
 // StringLiteral
-StringLiteral::StringLiteral(string value) : value(value) {
+StringLiteral::StringLiteral(string_view value) : Expr(KIND), value(value) {
     inferredType = DataType::UNKNOWN; // Strings no tienen tipo numérico
 }
 
@@ -52,31 +79,31 @@ void StringLiteral::accept(Visitor* visitor) {
 }
 
 // Variable
-Variable::Variable(string name) : name(name) {}
+Variable::Variable(string_view name, SymbolId symbol) : Expr(KIND), name(name), symbol(symbol) {}
 
 void Variable::accept(Visitor* visitor) {
     visitor->visitVariable(this);
 }
 
 // BinaryOp
-BinaryOp::BinaryOp(unique_ptr<Expr> left, Token op, unique_ptr<Expr> right)
-    : left(move(left)), op(op), right(move(right)) {}
+BinaryOp::BinaryOp(ExprPtr left, Token op, ExprPtr right)
+    : Expr(KIND), left(move(left)), op(op), right(move(right)) {}
 
 void BinaryOp::accept(Visitor* visitor) {
     visitor->visitBinaryOp(this);
 }
 
 // UnaryOp
-UnaryOp::UnaryOp(Token op, unique_ptr<Expr> operand)
-    : op(op), operand(move(operand)) {}
+UnaryOp::UnaryOp(Token op, ExprPtr operand)
+    : Expr(KIND), op(op), operand(move(operand)) {}
 
 void UnaryOp::accept(Visitor* visitor) {
     visitor->visitUnaryOp(this);
 }
 
 // CastExpr
-CastExpr::CastExpr(DataType targetType, unique_ptr<Expr> expr)
-    : targetType(targetType), expr(move(expr)) {
+CastExpr::CastExpr(DataType targetType, ExprPtr expr)
+    : Expr(KIND), targetType(targetType), expr(move(expr)) {
     inferredType = targetType;
 }
 
@@ -85,35 +112,35 @@ void CastExpr::accept(Visitor* visitor) {
 }
 
 // TernaryExpr
-TernaryExpr::TernaryExpr(unique_ptr<Expr> condition, unique_ptr<Expr> exprTrue, unique_ptr<Expr> exprFalse)
-    : condition(move(condition)), exprTrue(move(exprTrue)), exprFalse(move(exprFalse)) {}
+TernaryExpr::TernaryExpr(ExprPtr condition, ExprPtr exprTrue, ExprPtr exprFalse)
+    : Expr(KIND), condition(move(condition)), exprTrue(move(exprTrue)), exprFalse(move(exprFalse)) {}
 
 void TernaryExpr::accept(Visitor* visitor) {
     visitor->visitTernaryExpr(this);
 }
 
 // CallExpr
-CallExpr::CallExpr(string functionName, vector<unique_ptr<Expr>> arguments)
-    : functionName(functionName), arguments(move(arguments)) {}
+CallExpr::CallExpr(string_view functionName, SymbolId functionSymbol, ExprList arguments)
+    : Expr(KIND), functionName(functionName), functionSymbol(functionSymbol), arguments(move(arguments)) {}
 
 void CallExpr::accept(Visitor* visitor) {
     visitor->visitCallExpr(this);
 }
 
 // ArrayAccess
-ArrayAccess::ArrayAccess(string arrayName, vector<unique_ptr<Expr>> indices)
-    : arrayName(arrayName), indices(move(indices)) {}
+ArrayAccess::ArrayAccess(string_view arrayName, SymbolId arraySymbol, ExprList indices)
+    : Expr(KIND), arrayName(arrayName), arraySymbol(arraySymbol), indices(move(indices)) {}
 
 void ArrayAccess::accept(Visitor* visitor) {
     visitor->visitArrayAccess(this);
 }
 
 // AssignExpr
-AssignExpr::AssignExpr(string varName, unique_ptr<Expr> value)
-    : varName(varName), value(move(value)), isArrayAssign(false) {}
+AssignExpr::AssignExpr(string_view varName, SymbolId varSymbol, ExprPtr value)
+    : Expr(KIND), varName(varName), varSymbol(varSymbol), value(move(value)), isArrayAssign(false) {}
 
-AssignExpr::AssignExpr(string varName, vector<unique_ptr<Expr>> indices, unique_ptr<Expr> value)
-    : varName(varName), indices(move(indices)), value(move(value)), isArrayAssign(true) {}
+AssignExpr::AssignExpr(string_view varName, SymbolId varSymbol, ExprList indices, ExprPtr value)
+    : Expr(KIND), varName(varName), varSymbol(varSymbol), indices(move(indices)), value(move(value)), isArrayAssign(true) {}
 
 void AssignExpr::accept(Visitor* visitor) {
     visitor->visitAssignExpr(this);
@@ -122,57 +149,57 @@ void AssignExpr::accept(Visitor* visitor) {
 // ========== STATEMENTS ==========
 
 // VarDecl (simple)
-VarDecl::VarDecl(DataType type, string name, unique_ptr<Expr> initializer)
-    : type(type), name(name), initializer(move(initializer)), isArray(false) {}
+VarDecl::VarDecl(DataType type, string_view name, SymbolId symbol, ExprPtr initializer)
+    : Stmt(KIND), type(type), name(name), symbol(symbol), initializer(move(initializer)), isArray(false) {}
 
 // VarDecl (array)
-VarDecl::VarDecl(DataType type, string name, vector<int> dimensions)
-    : type(type), name(name), isArray(true), dimensions(dimensions) {}
+VarDecl::VarDecl(DataType type, string_view name, SymbolId symbol, NodeList<int> dimensions)
+    : Stmt(KIND), type(type), name(name), symbol(symbol), isArray(true), dimensions(move(dimensions)) {}
 
 void VarDecl::accept(Visitor* visitor) {
     visitor->visitVarDecl(this);
 }
 
 // AssignStmt (simple)
-AssignStmt::AssignStmt(string varName, unique_ptr<Expr> value)
-    : varName(varName), value(move(value)), isArrayAssign(false) {}
+AssignStmt::AssignStmt(string_view varName, SymbolId varSymbol, ExprPtr value)
+    : Stmt(KIND), varName(varName), varSymbol(varSymbol), value(move(value)), isArrayAssign(false) {}
 
 // AssignStmt (array)
-AssignStmt::AssignStmt(string varName, vector<unique_ptr<Expr>> indices, unique_ptr<Expr> value)
-    : varName(varName), indices(move(indices)), value(move(value)), isArrayAssign(true) {}
+AssignStmt::AssignStmt(string_view varName, SymbolId varSymbol, ExprList indices, ExprPtr value)
+    : Stmt(KIND), varName(varName), varSymbol(varSymbol), indices(move(indices)), value(move(value)), isArrayAssign(true) {}
 
 void AssignStmt::accept(Visitor* visitor) {
     visitor->visitAssignStmt(this);
 }
 
 // Block
-Block::Block(vector<unique_ptr<Stmt>> statements)
-    : statements(move(statements)) {}
+Block::Block(StmtList statements)
+    : Stmt(KIND), statements(move(statements)) {}
 
 void Block::accept(Visitor* visitor) {
     visitor->visitBlock(this);
 }
 
 // IfStmt
-IfStmt::IfStmt(unique_ptr<Expr> condition, unique_ptr<Stmt> thenBranch, unique_ptr<Stmt> elseBranch)
-    : condition(move(condition)), thenBranch(move(thenBranch)), elseBranch(move(elseBranch)) {}
+IfStmt::IfStmt(ExprPtr condition, StmtPtr thenBranch, StmtPtr elseBranch)
+    : Stmt(KIND), condition(move(condition)), thenBranch(move(thenBranch)), elseBranch(move(elseBranch)) {}
 
 void IfStmt::accept(Visitor* visitor) {
     visitor->visitIfStmt(this);
 }
 
 // WhileStmt
-WhileStmt::WhileStmt(unique_ptr<Expr> condition, unique_ptr<Stmt> body)
-    : condition(move(condition)), body(move(body)) {}
+WhileStmt::WhileStmt(ExprPtr condition, StmtPtr body)
+    : Stmt(KIND), condition(move(condition)), body(move(body)) {}
 
 void WhileStmt::accept(Visitor* visitor) {
     visitor->visitWhileStmt(this);
 }
 
 // ForStmt
-ForStmt::ForStmt(unique_ptr<Stmt> initializer, unique_ptr<Expr> condition, 
-                 unique_ptr<Expr> increment, unique_ptr<Stmt> body)
-    : initializer(move(initializer)), condition(move(condition)), 
+ForStmt::ForStmt(StmtPtr initializer, ExprPtr condition, 
+                 ExprPtr increment, StmtPtr body)
+    : Stmt(KIND), initializer(move(initializer)), condition(move(condition)), 
       increment(move(increment)), body(move(body)) {}
 
 void ForStmt::accept(Visitor* visitor) {
@@ -180,31 +207,31 @@ void ForStmt::accept(Visitor* visitor) {
 }
 
 // ReturnStmt
-ReturnStmt::ReturnStmt(unique_ptr<Expr> value)
-    : value(move(value)) {}
+ReturnStmt::ReturnStmt(ExprPtr value)
+    : Stmt(KIND), value(move(value)) {}
 
 void ReturnStmt::accept(Visitor* visitor) {
     visitor->visitReturnStmt(this);
 }
 
 // ExprStmt
-ExprStmt::ExprStmt(unique_ptr<Expr> expression)
-    : expression(move(expression)) {}
+ExprStmt::ExprStmt(ExprPtr expression)
+    : Stmt(KIND), expression(move(expression)) {}
 
 void ExprStmt::accept(Visitor* visitor) {
     visitor->visitExprStmt(this);
 }
 
 // FunctionDecl
-FunctionDecl::FunctionDecl(DataType returnType, string name, 
-                           vector<pair<DataType, string>> parameters, 
-                           unique_ptr<Block> body)
-    : returnType(returnType), name(name), parameters(parameters), body(move(body)) {}
+FunctionDecl::FunctionDecl(DataType returnType, string_view name, SymbolId symbol,
+                           ParamList parameters, 
+                           NodePtr<Block> body)
+    : Stmt(KIND), returnType(returnType), name(name), symbol(symbol), parameters(move(parameters)), body(move(body)) {}
 
 void FunctionDecl::accept(Visitor* visitor) {
     visitor->visitFunctionDecl(this);
 }
 
 // Program
-Program::Program(vector<unique_ptr<Stmt>> statements)
-    : statements(move(statements)) {}
\ No newline at end of file
+Program::Program(unique_ptr<Arena> arena, StmtList statements, SymbolTable* symbols)
+    : arena(move(arena)), statements(move(statements)), symbols(symbols) {}
\ No newline at end of file
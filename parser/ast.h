@@ -2,14 +2,28 @@
 #define AST_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include "arena.h"
 #include "../scanner/token.h"
 
 using namespace std;
 
 // Forward declarations
 class Visitor;
+class Expr;
+class Stmt;
+
+// Todos los nodos viven en el Arena del Program (ver arena.h). Los nombres
+// (string_view) apuntan al SourceBuffer o a copias dentro del Arena, así que
+// el SourceBuffer debe vivir mientras se use el AST. Cada nombre va junto a
+// su SymbolId (ver symbol_table.h), que es lo que usan las tablas de símbolos.
+typedef NodePtr<Expr> ExprPtr;
+typedef NodePtr<Stmt> StmtPtr;
+typedef NodeList<ExprPtr> ExprList;
+typedef NodeList<StmtPtr> StmtList;
 
 // ========== TIPOS DE DATOS ==========
 enum class DataType {
@@ -23,9 +37,39 @@ enum class DataType {
 
 string dataTypeToString(DataType type);
 
+// ========== TIPO DE NODO ==========
+// Cada nodo guarda su tipo concreto: los pases despachan con un switch
+// (o con StaticVisitor, ver ast_visitor.h) en lugar de dynamic_cast.
+enum class NodeKind : uint8_t {
+    // Expresiones
+    IntLiteral, FloatLiteral, LongLiteral, StringLiteral,
+    Variable, BinaryOp, UnaryOp, CastExpr, TernaryExpr,
+    CallExpr, ArrayAccess, AssignExpr,
+
+    // Statements
+    VarDecl, AssignStmt, Block, IfStmt, WhileStmt, ForStmt,
+    ReturnStmt, ExprStmt, FunctionDecl
+};
+
+const int NODE_KIND_COUNT = (int)NodeKind::FunctionDecl + 1;
+
+// Nombre del tipo de nodo ("BinaryOp", "ForStmt", ...)
+const char* nodeKindName(NodeKind kind);
+
+// Parámetro de función: (tipo, nombre)
+struct Param {
+    DataType type;
+    string_view name;
+    SymbolId symbol;
+};
+
+typedef NodeList<Param> ParamList;
+
 // ========== CLASE BASE PARA EXPRESIONES ==========
 class Expr {
 public:
+    const NodeKind kind;
+    explicit Expr(NodeKind kind) : kind(kind) {}
     virtual ~Expr() = default;
     virtual void accept(Visitor* visitor) = 0;
     DataType inferredType = DataType::UNKNOWN;
@@ -34,6 +78,8 @@ public:
 // ========== CLASE BASE PARA STATEMENTS ==========
 class Stmt {
 public:
+    const NodeKind kind;
+    explicit Stmt(NodeKind kind) : kind(kind) {}
     virtual ~Stmt() = default;
     virtual void accept(Visitor* visitor) = 0;
 };
@@ -43,6 +89,7 @@ public:
 // Literales numéricos
 class IntLiteral : public Expr {
 public:
+    static const NodeKind KIND = NodeKind::IntLiteral;
     int value;
     IntLiteral(int value);
     void accept(Visitor* visitor) override;
@@ -50,6 +97,7 @@ public:
 
 class FloatLiteral : public Expr {
 public:
+    static const NodeKind KIND = NodeKind::FloatLiteral;
     float value;
     FloatLiteral(float value);
     void accept(Visitor* visitor) override;
@@ -57,6 +105,7 @@ public:
 
 class LongLiteral : public Expr {
 public:
+    static const NodeKind KIND = NodeKind::LongLiteral;
     long value;
     LongLiteral(long value);
     void accept(Visitor* visitor) override;
@@ -65,91 +114,105 @@ public:
 // String literal
 class StringLiteral : public Expr {
 public:
-    string value;
-    StringLiteral(string value);
+    static const NodeKind KIND = NodeKind::StringLiteral;
+    string_view value;
+    StringLiteral(string_view value);
     void accept(Visitor* visitor) override;
 };
 
 // Variable (identificador)
 class Variable : public Expr {
 public:
-    string name;
-    Variable(string name);
+    static const NodeKind KIND = NodeKind::Variable;
+    string_view name;
+    SymbolId symbol;
+    Variable(string_view name, SymbolId symbol);
     void accept(Visitor* visitor) override;
 };
 
 // Operación binaria: +, -, *, /, ==, <, >, etc.
 class BinaryOp : public Expr {
 public:
-    unique_ptr<Expr> left;
+    static const NodeKind KIND = NodeKind::BinaryOp;
+    ExprPtr left;
     Token op;
-    unique_ptr<Expr> right;
+    ExprPtr right;
+    int registerNeed = 0;  // Número de Sethi-Ullman (0 = sin calcular, ver regalloc.h)
     
-    BinaryOp(unique_ptr<Expr> left, Token op, unique_ptr<Expr> right);
+    BinaryOp(ExprPtr left, Token op, ExprPtr right);
     void accept(Visitor* visitor) override;
 };
 
 // Operación unaria: -, !
 class UnaryOp : public Expr {
 public:
+    static const NodeKind KIND = NodeKind::UnaryOp;
     Token op;
-    unique_ptr<Expr> operand;
+    ExprPtr operand;
     
-    UnaryOp(Token op, unique_ptr<Expr> operand);
+    UnaryOp(Token op, ExprPtr operand);
     void accept(Visitor* visitor) override;
 };
 
 // Casting explícito: (float)x, (int)y
 class CastExpr : public Expr {
 public:
+    static const NodeKind KIND = NodeKind::CastExpr;
     DataType targetType;
-    unique_ptr<Expr> expr;
+    ExprPtr expr;
     
-    CastExpr(DataType targetType, unique_ptr<Expr> expr);
+    CastExpr(DataType targetType, ExprPtr expr);
     void accept(Visitor* visitor) override;
 };
 
 // Operador ternario: condition ? exprTrue : exprFalse
 class TernaryExpr : public Expr {
 public:
-    unique_ptr<Expr> condition;
-    unique_ptr<Expr> exprTrue;
-    unique_ptr<Expr> exprFalse;
+    static const NodeKind KIND = NodeKind::TernaryExpr;
+    ExprPtr condition;
+    ExprPtr exprTrue;
+    ExprPtr exprFalse;
     
-    TernaryExpr(unique_ptr<Expr> condition, unique_ptr<Expr> exprTrue, unique_ptr<Expr> exprFalse);
+    TernaryExpr(ExprPtr condition, ExprPtr exprTrue, ExprPtr exprFalse);
     void accept(Visitor* visitor) override;
 };
 
 // Llamada a función: suma(a, b)
 class CallExpr : public Expr {
 public:
-    string functionName;
-    vector<unique_ptr<Expr>> arguments;
+    static const NodeKind KIND = NodeKind::CallExpr;
+    string_view functionName;
+    SymbolId functionSymbol;
+    ExprList arguments;
     
-    CallExpr(string functionName, vector<unique_ptr<Expr>> arguments);
+    CallExpr(string_view functionName, SymbolId functionSymbol, ExprList arguments);
     void accept(Visitor* visitor) override;
 };
 
 // Acceso a array: arr[i] o matriz[i][j]
 class ArrayAccess : public Expr {
 public:
-    string arrayName;
-    vector<unique_ptr<Expr>> indices; // Para multidimensional
+    static const NodeKind KIND = NodeKind::ArrayAccess;
+    string_view arrayName;
+    SymbolId arraySymbol;
+    ExprList indices; // Para multidimensional
     
-    ArrayAccess(string arrayName, vector<unique_ptr<Expr>> indices);
+    ArrayAccess(string_view arrayName, SymbolId arraySymbol, ExprList indices);
     void accept(Visitor* visitor) override;
 };
 
 // Asignación como expresión: i = i + 1 (retorna el valor asignado)
 class AssignExpr : public Expr {
 public:
-    string varName;
-    unique_ptr<Expr> value;
+    static const NodeKind KIND = NodeKind::AssignExpr;
+    string_view varName;
+    SymbolId varSymbol;
+    ExprPtr value;
     bool isArrayAssign;
-    vector<unique_ptr<Expr>> indices;
+    ExprList indices;
     
-    AssignExpr(string varName, unique_ptr<Expr> value);
-    AssignExpr(string varName, vector<unique_ptr<Expr>> indices, unique_ptr<Expr> value);
+    AssignExpr(string_view varName, SymbolId varSymbol, ExprPtr value);
+    AssignExpr(string_view varName, SymbolId varSymbol, ExprList indices, ExprPtr value);
     void accept(Visitor* visitor) override;
 };
 
@@ -158,118 +221,147 @@ public:
 // Declaración de variable: int x; float y = 3.14;
 class VarDecl : public Stmt {
 public:
+    static const NodeKind KIND = NodeKind::VarDecl;
     DataType type;
-    string name;
-    unique_ptr<Expr> initializer; // Puede ser nullptr
+    string_view name;
+    SymbolId symbol;
+    ExprPtr initializer; // Puede ser nullptr
     
     // Para arrays
     bool isArray;
-    vector<int> dimensions; // [3][4] -> {3, 4}
-    vector<unique_ptr<Expr>> arrayInitializer; // {1, 2, 3}
+    NodeList<int> dimensions; // [3][4] -> {3, 4}
+    ExprList arrayInitializer; // {1, 2, 3}
     
-    VarDecl(DataType type, string name, unique_ptr<Expr> initializer = nullptr);
-    VarDecl(DataType type, string name, vector<int> dimensions); // Array
+    VarDecl(DataType type, string_view name, SymbolId symbol, ExprPtr initializer = nullptr);
+    VarDecl(DataType type, string_view name, SymbolId symbol, NodeList<int> dimensions); // Array
     void accept(Visitor* visitor) override;
 };
 
 // Asignación: x = 10; arr[i] = 5;
 class AssignStmt : public Stmt {
 public:
-    string varName;
-    unique_ptr<Expr> value;
+    static const NodeKind KIND = NodeKind::AssignStmt;
+    string_view varName;
+    SymbolId varSymbol;
+    ExprPtr value;
     
     // Para arrays
     bool isArrayAssign;
-    vector<unique_ptr<Expr>> indices;
+    ExprList indices;
     
-    AssignStmt(string varName, unique_ptr<Expr> value);
-    AssignStmt(string varName, vector<unique_ptr<Expr>> indices, unique_ptr<Expr> value);
+    AssignStmt(string_view varName, SymbolId varSymbol, ExprPtr value);
+    AssignStmt(string_view varName, SymbolId varSymbol, ExprList indices, ExprPtr value);
     void accept(Visitor* visitor) override;
 };
 
 // Bloque de código: { ... }
 class Block : public Stmt {
 public:
-    vector<unique_ptr<Stmt>> statements;
+    static const NodeKind KIND = NodeKind::Block;
+    StmtList statements;
     
-    Block(vector<unique_ptr<Stmt>> statements);
+    Block(StmtList statements);
     void accept(Visitor* visitor) override;
 };
 
 // If-else
 class IfStmt : public Stmt {
 public:
-    unique_ptr<Expr> condition;
-    unique_ptr<Stmt> thenBranch;
-    unique_ptr<Stmt> elseBranch; // Puede ser nullptr
+    static const NodeKind KIND = NodeKind::IfStmt;
+    ExprPtr condition;
+    StmtPtr thenBranch;
+    StmtPtr elseBranch; // Puede ser nullptr
     
-    IfStmt(unique_ptr<Expr> condition, unique_ptr<Stmt> thenBranch, unique_ptr<Stmt> elseBranch = nullptr);
+    IfStmt(ExprPtr condition, StmtPtr thenBranch, StmtPtr elseBranch = nullptr);
     void accept(Visitor* visitor) override;
 };
 
 // While loop
 class WhileStmt : public Stmt {
 public:
-    unique_ptr<Expr> condition;
-    unique_ptr<Stmt> body;
+    static const NodeKind KIND = NodeKind::WhileStmt;
+    ExprPtr condition;
+    StmtPtr body;
     
-    WhileStmt(unique_ptr<Expr> condition, unique_ptr<Stmt> body);
+    WhileStmt(ExprPtr condition, StmtPtr body);
     void accept(Visitor* visitor) override;
 };
 
 // For loop
 class ForStmt : public Stmt {
 public:
-    unique_ptr<Stmt> initializer; // int i = 0
-    unique_ptr<Expr> condition;   // i < 10
-    unique_ptr<Expr> increment;   // i++
-    unique_ptr<Stmt> body;
+    static const NodeKind KIND = NodeKind::ForStmt;
+    StmtPtr initializer; // int i = 0
+    ExprPtr condition;   // i < 10
+    ExprPtr increment;   // i++
+    StmtPtr body;
     
-    ForStmt(unique_ptr<Stmt> initializer, unique_ptr<Expr> condition, 
-            unique_ptr<Expr> increment, unique_ptr<Stmt> body);
+    ForStmt(StmtPtr initializer, ExprPtr condition, 
+            ExprPtr increment, StmtPtr body);
     void accept(Visitor* visitor) override;
 };
 
 // Return statement
 class ReturnStmt : public Stmt {
 public:
-    unique_ptr<Expr> value; // Puede ser nullptr para void
+    static const NodeKind KIND = NodeKind::ReturnStmt;
+    ExprPtr value; // Puede ser nullptr para void
     
-    ReturnStmt(unique_ptr<Expr> value = nullptr);
+    ReturnStmt(ExprPtr value = nullptr);
     void accept(Visitor* visitor) override;
 };
 
 // Expression statement: printf(...); suma(a,b);
 class ExprStmt : public Stmt {
 public:
-    unique_ptr<Expr> expression;
+    static const NodeKind KIND = NodeKind::ExprStmt;
+    ExprPtr expression;
     
-    ExprStmt(unique_ptr<Expr> expression);
+    ExprStmt(ExprPtr expression);
     void accept(Visitor* visitor) override;
 };
 
 // Declaración de función
 class FunctionDecl : public Stmt {
 public:
+    static const NodeKind KIND = NodeKind::FunctionDecl;
     DataType returnType;
-    string name;
-    vector<pair<DataType, string>> parameters; // (tipo, nombre)
-    unique_ptr<Block> body;
+    string_view name;
+    SymbolId symbol;
+    ParamList parameters; // (tipo, nombre)
+    NodePtr<Block> body;
     
-    FunctionDecl(DataType returnType, string name, 
-                 vector<pair<DataType, string>> parameters, 
-                 unique_ptr<Block> body);
+    FunctionDecl(DataType returnType, string_view name, SymbolId symbol,
+                 ParamList parameters, 
+                 NodePtr<Block> body);
     void accept(Visitor* visitor) override;
 };
 
 // Programa completo
 class Program {
 public:
-    vector<unique_ptr<Stmt>> statements; // Funciones y declaraciones globales
+    // Dueño de la memoria de todos los nodos. Se declara primero para que
+    // se destruya al final: al liberar el Program se libera el árbol entero.
+    unique_ptr<Arena> arena;
+    StmtList statements; // Funciones y declaraciones globales
+    SymbolTable* symbols; // Nombres internados (no es dueño)
     
-    Program(vector<unique_ptr<Stmt>> statements);
+    Program(unique_ptr<Arena> arena, StmtList statements, SymbolTable* symbols);
 };
 
+// ========== CASTS POR KIND ==========
+// Equivalentes a dynamic_cast que solo comparan el tag del nodo:
+//   if (Variable* var = nodeCast<Variable>(expr)) { ... }
+template<typename T, typename Base>
+inline bool nodeIs(const Base* node) {
+    return node && node->kind == T::KIND;
+}
+
+template<typename T, typename Base>
+inline T* nodeCast(Base* node) {
+    return nodeIs<T>(node) ? static_cast<T*>(node) : nullptr;
+}
+
 // ========== VISITOR PATTERN ==========
 class Visitor {
 public:
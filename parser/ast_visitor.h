@@ -0,0 +1,61 @@
+#ifndef AST_VISITOR_H
+#define AST_VISITOR_H
+
+#include "ast.h"
+
+// ========== VISITOR ESTÁTICO (CRTP) ==========
+// Alternativa a Visitor/accept() sin llamadas virtuales: visit() hace un
+// switch sobre node->kind y llama directamente al método visitXxx de la
+// clase derivada, que el compilador puede inlinear.
+//
+//   class MiPase : public StaticVisitor<MiPase> {
+//   public:
+//       void visitIntLiteral(IntLiteral* node) { ... }
+//       ...
+//   };
+//
+// La clase derivada debe implementar todos los visitXxx que se alcancen.
+// ExprResult / StmtResult permiten que los visitXxx devuelvan un valor.
+template<typename Derived, typename ExprResult = void, typename StmtResult = void>
+class StaticVisitor {
+private:
+    Derived* self() { return static_cast<Derived*>(this); }
+
+public:
+    ExprResult visit(Expr* node) {
+        switch (node->kind) {
+            case NodeKind::IntLiteral:    return self()->visitIntLiteral(static_cast<IntLiteral*>(node));
+            case NodeKind::FloatLiteral:  return self()->visitFloatLiteral(static_cast<FloatLiteral*>(node));
+            case NodeKind::LongLiteral:   return self()->visitLongLiteral(static_cast<LongLiteral*>(node));
+            case NodeKind::StringLiteral: return self()->visitStringLiteral(static_cast<StringLiteral*>(node));
+            case NodeKind::Variable:      return self()->visitVariable(static_cast<Variable*>(node));
+            case NodeKind::BinaryOp:      return self()->visitBinaryOp(static_cast<BinaryOp*>(node));
+            case NodeKind::UnaryOp:       return self()->visitUnaryOp(static_cast<UnaryOp*>(node));
+            case NodeKind::CastExpr:      return self()->visitCastExpr(static_cast<CastExpr*>(node));
+            case NodeKind::TernaryExpr:   return self()->visitTernaryExpr(static_cast<TernaryExpr*>(node));
+            case NodeKind::CallExpr:      return self()->visitCallExpr(static_cast<CallExpr*>(node));
+            case NodeKind::ArrayAccess:   return self()->visitArrayAccess(static_cast<ArrayAccess*>(node));
+            case NodeKind::AssignExpr:    return self()->visitAssignExpr(static_cast<AssignExpr*>(node));
+            default: break;
+        }
+        return ExprResult();
+    }
+
+    StmtResult visit(Stmt* node) {
+        switch (node->kind) {
+            case NodeKind::VarDecl:       return self()->visitVarDecl(static_cast<VarDecl*>(node));
+            case NodeKind::AssignStmt:    return self()->visitAssignStmt(static_cast<AssignStmt*>(node));
+            case NodeKind::Block:         return self()->visitBlock(static_cast<Block*>(node));
+            case NodeKind::IfStmt:        return self()->visitIfStmt(static_cast<IfStmt*>(node));
+            case NodeKind::WhileStmt:     return self()->visitWhileStmt(static_cast<WhileStmt*>(node));
+            case NodeKind::ForStmt:       return self()->visitForStmt(static_cast<ForStmt*>(node));
+            case NodeKind::ReturnStmt:    return self()->visitReturnStmt(static_cast<ReturnStmt*>(node));
+            case NodeKind::ExprStmt:      return self()->visitExprStmt(static_cast<ExprStmt*>(node));
+            case NodeKind::FunctionDecl:  return self()->visitFunctionDecl(static_cast<FunctionDecl*>(node));
+            default: break;
+        }
+        return StmtResult();
+    }
+};
+
+#endif
@@ -1,19 +1,25 @@
 #include "parser.h"
 #include <iostream>
 
-Parser::Parser(vector<Token> tokens) : tokens(tokens), current(0) {}
+Parser::Parser(Scanner& scanner)
+    : scanner(scanner), current(0), scanned(0), arena(make_unique<Arena>()) {}
 
 // ========== HELPERS ==========
 
-Token Parser::peek() {
-    return tokens[current];
+const Token& Parser::peek(int offset) {
+    // Traer del scanner los tokens que falten hasta current + offset
+    while (scanned <= current + offset) {
+        window[scanned & (LOOKAHEAD - 1)] = scanner.nextToken();
+        scanned++;
+    }
+    return window[(current + offset) & (LOOKAHEAD - 1)];
 }
 
-Token Parser::previous() {
-    return tokens[current - 1];
+const Token& Parser::previous() {
+    return window[(current - 1) & (LOOKAHEAD - 1)];
 }
 
-Token Parser::advance() {
+const Token& Parser::advance() {
     if (!isAtEnd()) current++;
     return previous();
 }
@@ -27,7 +33,7 @@ bool Parser::check(TokenType type) {
     return peek().type == type;
 }
 
-bool Parser::match(vector<TokenType> types) {
+bool Parser::match(initializer_list<TokenType> types) {
     for (TokenType type : types) {
         if (check(type)) {
             advance();
@@ -37,14 +43,14 @@ bool Parser::match(vector<TokenType> types) {
     return false;
 }
 
-Token Parser::consume(TokenType type, string message) {
+const Token& Parser::consume(TokenType type, string message) {
     if (check(type)) return advance();
     error(message);
     throw runtime_error(message);
 }
 
 void Parser::error(string message) {
-    Token token = peek();
+    const Token& token = peek();
     cerr << "Parse error at line " << token.line << ": " << message << endl;
 }
 
@@ -72,7 +78,12 @@ void Parser::synchronize() {
     }
 }
 
-DataType Parser::tokenToDataType(Token token) {
+bool Parser::isTypeToken(TokenType type) {
+    return type == TokenType::INT || type == TokenType::FLOAT ||
+           type == TokenType::LONG || type == TokenType::UNSIGNED;
+}
+
+DataType Parser::tokenToDataType(const Token& token) {
     switch(token.type) {
         case TokenType::INT: return DataType::INT;
         case TokenType::FLOAT: return DataType::FLOAT;
@@ -91,7 +102,7 @@ DataType Parser::tokenToDataType(Token token) {
 // ========== MAIN PARSE ==========
 
 unique_ptr<Program> Parser::parse() {
-    vector<unique_ptr<Stmt>> statements;
+    StmtList statements(arena.get());
     
     while (!isAtEnd()) {
         try {
@@ -101,12 +112,12 @@ unique_ptr<Program> Parser::parse() {
         }
     }
     
-    return make_unique<Program>(move(statements));
+    return make_unique<Program>(move(arena), move(statements), &scanner.symbolTable());
 }
 
 // ========== DECLARATIONS ==========
 
-unique_ptr<Stmt> Parser::declaration() {
+StmtPtr Parser::declaration() {
     // Verificar si es declaración de tipo
     if (match({TokenType::INT, TokenType::FLOAT, TokenType::LONG, TokenType::UNSIGNED})) {
         Token typeToken = previous();
@@ -118,7 +129,7 @@ unique_ptr<Stmt> Parser::declaration() {
         if (check(TokenType::LPAREN)) {
             advance(); // consume '('
             
-            vector<pair<DataType, string>> parameters;
+            ParamList parameters(arena.get());
             
             // Parsear parámetros
             if (!check(TokenType::RPAREN)) {
@@ -126,7 +137,7 @@ unique_ptr<Stmt> Parser::declaration() {
                     Token paramTypeToken = advance();
                     DataType paramType = tokenToDataType(paramTypeToken);
                     Token paramName = consume(TokenType::IDENTIFIER, "Expected parameter name.");
-                    parameters.push_back({paramType, paramName.lexeme});
+                    parameters.push_back({paramType, paramName.lexeme, paramName.symbol});
                 } while (match({TokenType::COMMA}));
             }
             
@@ -134,24 +145,24 @@ unique_ptr<Stmt> Parser::declaration() {
             
             // Cuerpo de la función
             consume(TokenType::LBRACE, "Expected '{' before function body.");
-            unique_ptr<Block> body = block();
+            NodePtr<Block> body = block();
             
-            return make_unique<FunctionDecl>(type, name.lexeme, parameters, move(body));
+            return arena->make<FunctionDecl>(type, name.lexeme, name.symbol, move(parameters), move(body));
         }
         
         // Es una variable o array
         // Es un array?
         if (match({TokenType::LBRACKET})) {
-            vector<int> dimensions;
+            NodeList<int> dimensions(arena.get());
             
             // Parsear dimensiones: [3][4]
             do {
                 Token sizeToken = consume(TokenType::INT_LITERAL, "Expected array size.");
-                dimensions.push_back(stoi(sizeToken.lexeme));
+                dimensions.push_back(stoi(string(sizeToken.lexeme)));
                 consume(TokenType::RBRACKET, "Expected ']'.");
             } while (match({TokenType::LBRACKET}));
             
-            unique_ptr<VarDecl> varDecl = make_unique<VarDecl>(type, name.lexeme, dimensions);
+            NodePtr<VarDecl> varDecl = arena->make<VarDecl>(type, name.lexeme, name.symbol, move(dimensions));
             
             // Inicializador de array? = {1, 2, 3}
             if (match({TokenType::ASSIGN})) {
@@ -171,13 +182,13 @@ unique_ptr<Stmt> Parser::declaration() {
         }
         
         // Variable simple con inicializador opcional
-        unique_ptr<Expr> initializer = nullptr;
+        ExprPtr initializer = nullptr;
         if (match({TokenType::ASSIGN})) {
             initializer = expression();
         }
         
         consume(TokenType::SEMICOLON, "Expected ';' after variable declaration.");
-        return make_unique<VarDecl>(type, name.lexeme, move(initializer));
+        return arena->make<VarDecl>(type, name.lexeme, name.symbol, move(initializer));
     }
     
     // Si no es declaración, es un statement
@@ -186,7 +197,7 @@ unique_ptr<Stmt> Parser::declaration() {
 
 // ========== STATEMENTS ==========
 
-unique_ptr<Stmt> Parser::statement() {
+StmtPtr Parser::statement() {
     if (match({TokenType::IF})) return ifStatement();
     if (match({TokenType::WHILE})) return whileStatement();
     if (match({TokenType::FOR})) return forStatement();
@@ -196,102 +207,62 @@ unique_ptr<Stmt> Parser::statement() {
     return exprStatement();
 }
 
-unique_ptr<Stmt> Parser::exprStatement() {
-    // Manejo especial para asignaciones
-    if (check(TokenType::IDENTIFIER)) {
-        Token name = peek();
-        int savedPos = current;
-        advance();
-        
-        // Asignación a variable: x = expr;
-        if (match({TokenType::ASSIGN, TokenType::PLUSEQ, TokenType::MINUSEQ})) {
-            Token op = previous();
-            unique_ptr<Expr> value = expression();
-            
-            // Manejar += y -=
-            if (op.type == TokenType::PLUSEQ) {
-                value = make_unique<BinaryOp>(
-                    make_unique<Variable>(name.lexeme),
-                    Token(TokenType::PLUS, "+", op.line, op.column),
-                    move(value)
-                );
-            } else if (op.type == TokenType::MINUSEQ) {
-                value = make_unique<BinaryOp>(
-                    make_unique<Variable>(name.lexeme),
-                    Token(TokenType::MINUS, "-", op.line, op.column),
-                    move(value)
-                );
-            }
-            
-            consume(TokenType::SEMICOLON, "Expected ';' after assignment.");
-            return make_unique<AssignStmt>(name.lexeme, move(value));
-        }
-        
-        // Asignación a array: arr[i] = expr;
-        if (check(TokenType::LBRACKET)) {
-            vector<unique_ptr<Expr>> indices;
-            
-            while (match({TokenType::LBRACKET})) {
-                indices.push_back(expression());
-                consume(TokenType::RBRACKET, "Expected ']'.");
-            }
-            
-            if (match({TokenType::ASSIGN})) {
-                unique_ptr<Expr> value = expression();
-                consume(TokenType::SEMICOLON, "Expected ';' after assignment.");
-                return make_unique<AssignStmt>(name.lexeme, move(indices), move(value));
-            }
+StmtPtr Parser::exprStatement() {
+    ExprPtr expr = expression();
+    consume(TokenType::SEMICOLON, "Expected ';' after expression.");
+
+    // Una asignación al nivel de statement (x = expr; arr[i] = expr;)
+    // se representa como AssignStmt en lugar de ExprStmt
+    if (AssignExpr* assign = nodeCast<AssignExpr>(expr.get())) {
+        if (assign->isArrayAssign) {
+            return arena->make<AssignStmt>(assign->varName, assign->varSymbol, move(assign->indices), move(assign->value));
         }
-        
-        // No es asignación, retroceder
-        current = savedPos;
+        return arena->make<AssignStmt>(assign->varName, assign->varSymbol, move(assign->value));
     }
-    
-    unique_ptr<Expr> expr = expression();
-    consume(TokenType::SEMICOLON, "Expected ';' after expression.");
-    return make_unique<ExprStmt>(move(expr));
+
+    return arena->make<ExprStmt>(move(expr));
 }
 
-unique_ptr<Stmt> Parser::ifStatement() {
+StmtPtr Parser::ifStatement() {
     consume(TokenType::LPAREN, "Expected '(' after 'if'.");
-    unique_ptr<Expr> condition = expression();
+    ExprPtr condition = expression();
     consume(TokenType::RPAREN, "Expected ')' after if condition.");
     
-    unique_ptr<Stmt> thenBranch = statement();
-    unique_ptr<Stmt> elseBranch = nullptr;
+    StmtPtr thenBranch = statement();
+    StmtPtr elseBranch = nullptr;
     
     if (match({TokenType::ELSE})) {
         elseBranch = statement();
     }
     
-    return make_unique<IfStmt>(move(condition), move(thenBranch), move(elseBranch));
+    return arena->make<IfStmt>(move(condition), move(thenBranch), move(elseBranch));
 }
 
-unique_ptr<Stmt> Parser::whileStatement() {
+StmtPtr Parser::whileStatement() {
     consume(TokenType::LPAREN, "Expected '(' after 'while'.");
-    unique_ptr<Expr> condition = expression();
+    ExprPtr condition = expression();
     consume(TokenType::RPAREN, "Expected ')' after while condition.");
     
-    unique_ptr<Stmt> body = statement();
+    StmtPtr body = statement();
     
-    return make_unique<WhileStmt>(move(condition), move(body));
+    return arena->make<WhileStmt>(move(condition), move(body));
 }
-unique_ptr<Stmt> Parser::forStatement() {
+StmtPtr Parser::forStatement() {
     consume(TokenType::LPAREN, "Expected '(' after 'for'.");
 
     // Initializer: int i = 0 o i = 0
-    unique_ptr<Stmt> initializer = nullptr;
+    StmtPtr initializer = nullptr;
     if (match({TokenType::INT, TokenType::FLOAT, TokenType::LONG, TokenType::UNSIGNED})) {
         Token typeToken = previous();
         DataType type = tokenToDataType(typeToken);
         Token name = consume(TokenType::IDENTIFIER, "Expected variable name.");
 
-        unique_ptr<Expr> init = nullptr;
+        ExprPtr init = nullptr;
         if (match({TokenType::ASSIGN})) {
             init = expression();
         }
         consume(TokenType::SEMICOLON, "Expected ';' after for initializer.");
-        initializer = make_unique<VarDecl>(type, name.lexeme, move(init));
+        initializer = arena->make<VarDecl>(type, name.lexeme, name.symbol, move(init));
     } else if (!check(TokenType::SEMICOLON)) {
         initializer = exprStatement();
     } else {
@@ -299,64 +270,73 @@ unique_ptr<Stmt> Parser::forStatement() {
     }
 
     // Condition: i < 10
-    unique_ptr<Expr> condition = nullptr;
+    ExprPtr condition = nullptr;
     if (!check(TokenType::SEMICOLON)) {
         condition = expression();
     }
     consume(TokenType::SEMICOLON, "Expected ';' after for condition.");
 
     // Increment: i++ (expresión normal)
-    unique_ptr<Expr> increment = nullptr;
+    ExprPtr increment = nullptr;
     if (!check(TokenType::RPAREN)) {
         increment = expression();
     }
     consume(TokenType::RPAREN, "Expected ')' after for clauses.");
 
-    unique_ptr<Stmt> body = statement();
+    StmtPtr body = statement();
 
-    return make_unique<ForStmt>(move(initializer), move(condition), move(increment), move(body));
+    return arena->make<ForStmt>(move(initializer), move(condition), move(increment), move(body));
 }
 
-unique_ptr<Stmt> Parser::returnStatement() {
-    unique_ptr<Expr> value = nullptr;
+StmtPtr Parser::returnStatement() {
+    ExprPtr value = nullptr;
     
     if (!check(TokenType::SEMICOLON)) {
         value = expression();
     }
     
     consume(TokenType::SEMICOLON, "Expected ';' after return value.");
-    return make_unique<ReturnStmt>(move(value));
+    return arena->make<ReturnStmt>(move(value));
 }
 
-unique_ptr<Block> Parser::block() {
-    vector<unique_ptr<Stmt>> statements;
+NodePtr<Block> Parser::block() {
+    StmtList statements(arena.get());
     
     while (!check(TokenType::RBRACE) && !isAtEnd()) {
         statements.push_back(declaration());
     }
     
     consume(TokenType::RBRACE, "Expected '}' after block.");
-    return make_unique<Block>(move(statements));
+    return arena->make<Block>(move(statements));
 }
 
 // ========== EXPRESSIONS (Precedencia descendente) ==========
 
-unique_ptr<Expr> Parser::expression() {
+ExprPtr Parser::expression() {
     return assignment();
 }
 
-unique_ptr<Expr> Parser::assignment() {
+ExprPtr Parser::assignment() {
     // Primero intentar parsear una expresión de menor precedencia
-    unique_ptr<Expr> expr = ternary();
+    ExprPtr expr = ternary();
     
     // Si encontramos un ASSIGN, entonces es una asignación
     // En C, las asignaciones son expresiones que retornan el valor asignado
     if (match({TokenType::ASSIGN, TokenType::PLUSEQ, TokenType::MINUSEQ})) {
         Token op = previous();
-        unique_ptr<Expr> value = assignment(); // Asociatividad a la derecha
+        ExprPtr value = assignment(); // Asociatividad a la derecha
+        
+        // Asignación a array: arr[i] = expr (solo '=')
+        if (ArrayAccess* arrAccess = nodeCast<ArrayAccess>(expr.get())) {
+            if (op.type != TokenType::ASSIGN) {
+                error("Compound assignment to array elements is not supported.");
+                throw runtime_error("Compound assignment to array elements is not supported.");
+            }
+            return arena->make<AssignExpr>(arrAccess->arrayName, arrAccess->arraySymbol, move(arrAccess->indices), move(value));
+        }
         
         // Verificar que el lado izquierdo es una variable
-        Variable* var = dynamic_cast<Variable*>(expr.get());
+        Variable* var = nodeCast<Variable>(expr.get());
         if (!var) {
             error("Left side of assignment must be a variable.");
             throw runtime_error("Left side of assignment must be a variable.");
@@ -364,36 +344,28 @@ unique_ptr<Expr> Parser::assignment() {
         
         // Manejar += y -=
         if (op.type == TokenType::PLUSEQ) {
-            value = make_unique<BinaryOp>(
-                make_unique<Variable>(var->name),
+            value = arena->make<BinaryOp>(
+                arena->make<Variable>(var->name, var->symbol),
                 Token(TokenType::PLUS, "+", op.line, op.column),
                 move(value)
             );
         } else if (op.type == TokenType::MINUSEQ) {
-            value = make_unique<BinaryOp>(
-                make_unique<Variable>(var->name),
+            value = arena->make<BinaryOp>(
+                arena->make<Variable>(var->name, var->symbol),
                 Token(TokenType::MINUS, "-", op.line, op.column),
                 move(value)
             );
         }
         
         // Crear una expresión de asignación que retorna el valor asignado
-        return make_unique<AssignExpr>(var->name, move(value));
-    }
-    
-    // Verificar si es asignación a array: arr[i] = expr
-    if (ArrayAccess* arrAccess = dynamic_cast<ArrayAccess*>(expr.get())) {
-        if (match({TokenType::ASSIGN})) {
-            unique_ptr<Expr> value = assignment();
-            return make_unique<AssignExpr>(arrAccess->arrayName, move(arrAccess->indices), move(value));
-        }
+        return arena->make<AssignExpr>(var->name, var->symbol, move(value));
     }
     
     return expr;
 }
 
-unique_ptr<Expr> Parser::ternary() {
-    unique_ptr<Expr> expr = logicalOr();
+ExprPtr Parser::ternary() {
+    ExprPtr expr = logicalOr();
     
     // Operador ternario: condition ? exprTrue : exprFalse
     // Por ahora lo omitimos hasta tener el token '?'
@@ -402,155 +374,155 @@ unique_ptr<Expr> Parser::ternary() {
     return expr;
 }
 
-unique_ptr<Expr> Parser::logicalOr() {
-    unique_ptr<Expr> expr = logicalAnd();
+ExprPtr Parser::logicalOr() {
+    ExprPtr expr = logicalAnd();
     
     while (match({TokenType::OR})) {
         Token op = previous();
-        unique_ptr<Expr> right = logicalAnd();
-        expr = make_unique<BinaryOp>(move(expr), op, move(right));
+        ExprPtr right = logicalAnd();
+        expr = arena->make<BinaryOp>(move(expr), op, move(right));
     }
     
     return expr;
 }
 
-unique_ptr<Expr> Parser::logicalAnd() {
-    unique_ptr<Expr> expr = equality();
+ExprPtr Parser::logicalAnd() {
+    ExprPtr expr = equality();
     
     while (match({TokenType::AND})) {
         Token op = previous();
-        unique_ptr<Expr> right = equality();
-        expr = make_unique<BinaryOp>(move(expr), op, move(right));
+        ExprPtr right = equality();
+        expr = arena->make<BinaryOp>(move(expr), op, move(right));
     }
     
     return expr;
 }
 
-unique_ptr<Expr> Parser::equality() {
-    unique_ptr<Expr> expr = comparison();
+ExprPtr Parser::equality() {
+    ExprPtr expr = comparison();
     
     while (match({TokenType::EQ, TokenType::NE})) {
         Token op = previous();
-        unique_ptr<Expr> right = comparison();
-        expr = make_unique<BinaryOp>(move(expr), op, move(right));
+        ExprPtr right = comparison();
+        expr = arena->make<BinaryOp>(move(expr), op, move(right));
     }
     
     return expr;
 }
 
-unique_ptr<Expr> Parser::comparison() {
-    unique_ptr<Expr> expr = term();
+ExprPtr Parser::comparison() {
+    ExprPtr expr = term();
     
     while (match({TokenType::LT, TokenType::GT, TokenType::LE, TokenType::GE})) {
         Token op = previous();
-        unique_ptr<Expr> right = term();
-        expr = make_unique<BinaryOp>(move(expr), op, move(right));
+        ExprPtr right = term();
+        expr = arena->make<BinaryOp>(move(expr), op, move(right));
     }
     
     return expr;
 }
 
-unique_ptr<Expr> Parser::term() {
-    unique_ptr<Expr> expr = factor();
+ExprPtr Parser::term() {
+    ExprPtr expr = factor();
     
     while (match({TokenType::PLUS, TokenType::MINUS})) {
         Token op = previous();
-        unique_ptr<Expr> right = factor();
-        expr = make_unique<BinaryOp>(move(expr), op, move(right));
+        ExprPtr right = factor();
+        expr = arena->make<BinaryOp>(move(expr), op, move(right));
     }
     
     return expr;
 }
 
-unique_ptr<Expr> Parser::factor() {
-    unique_ptr<Expr> expr = unary();
+ExprPtr Parser::factor() {
+    ExprPtr expr = unary();
     
     while (match({TokenType::MULTIPLY, TokenType::DIVIDE, TokenType::MODULO})) {
         Token op = previous();
-        unique_ptr<Expr> right = unary();
-        expr = make_unique<BinaryOp>(move(expr), op, move(right));
+        ExprPtr right = unary();
+        expr = arena->make<BinaryOp>(move(expr), op, move(right));
     }
     
     return expr;
 }
 
-unique_ptr<Expr> Parser::unary() {
+ExprPtr Parser::unary() {
     if (match({TokenType::MINUS, TokenType::NOT})) {
         Token op = previous();
-        unique_ptr<Expr> right = unary();
-        return make_unique<UnaryOp>(op, move(right));
+        ExprPtr right = unary();
+        return arena->make<UnaryOp>(op, move(right));
     }
     
     return cast();
 }
 
-unique_ptr<Expr> Parser::cast() {
-    // Casting: (float)x, (int)y
-    if (check(TokenType::LPAREN)) {
-        int savedPos = current;
-        advance(); // consume '('
+ExprPtr Parser::cast() {
+    // Casting: (float)x, (int)y, (unsigned int)z
+    // Se decide mirando hacia adelante, sin retroceder en el stream de tokens
+    if (check(TokenType::LPAREN) && isTypeToken(peek(1).type)) {
+        int closeOffset = 2;
+        if (peek(1).type == TokenType::UNSIGNED && peek(2).type == TokenType::INT) {
+            closeOffset = 3;
+        }
         
-        // Verificar si es un tipo
-        if (match({TokenType::INT, TokenType::FLOAT, TokenType::LONG, TokenType::UNSIGNED})) {
-            Token typeToken = previous();
+        if (peek(closeOffset).type == TokenType::RPAREN) {
+            advance(); // consume '('
+            Token typeToken = advance();
             DataType targetType = tokenToDataType(typeToken);
+            consume(TokenType::RPAREN, "Expected ')' after cast type.");
             
-            if (match({TokenType::RPAREN})) {
-                unique_ptr<Expr> expr = cast();
-                return make_unique<CastExpr>(targetType, move(expr));
-            }
+            ExprPtr expr = cast();
+            return arena->make<CastExpr>(targetType, move(expr));
         }
-        
-        // No es un cast, retroceder
-        current = savedPos;
     }
     
     return postfix();
 }
 
-unique_ptr<Expr> Parser::postfix() {
-    unique_ptr<Expr> expr = primary();
+ExprPtr Parser::postfix() {
+    ExprPtr expr = primary();
     
     // Array access: arr[i][j]
-    if (Variable* var = dynamic_cast<Variable*>(expr.get())) {
+    if (Variable* var = nodeCast<Variable>(expr.get())) {
         if (check(TokenType::LBRACKET)) {
-            string arrayName = var->name;
-            vector<unique_ptr<Expr>> indices;
+            string_view arrayName = var->name;
+            SymbolId arraySymbol = var->symbol;
+            ExprList indices(arena.get());
             
             while (match({TokenType::LBRACKET})) {
                 indices.push_back(expression());
                 consume(TokenType::RBRACKET, "Expected ']'.");
             }
             
-            return make_unique<ArrayAccess>(arrayName, move(indices));
+            return arena->make<ArrayAccess>(arrayName, arraySymbol, move(indices));
         }
     }
     
     return expr;
 }
 
-unique_ptr<Expr> Parser::primary() {
+ExprPtr Parser::primary() {
     // Literales numéricos
     if (match({TokenType::INT_LITERAL})) {
-        return make_unique<IntLiteral>(stoi(previous().lexeme));
+        return arena->make<IntLiteral>(stoi(string(previous().lexeme)));
     }
     
     if (match({TokenType::FLOAT_LITERAL})) {
-        return make_unique<FloatLiteral>(stof(previous().lexeme));
+        return arena->make<FloatLiteral>(stof(string(previous().lexeme)));
     }
     
     if (match({TokenType::LONG_LITERAL})) {
-        string lexeme = previous().lexeme;
+        string lexeme(previous().lexeme);
         // Remover el sufijo 'L'
         if (lexeme.back() == 'L' || lexeme.back() == 'l') {
             lexeme.pop_back();
         }
-        return make_unique<LongLiteral>(stol(lexeme));
+        return arena->make<LongLiteral>(stol(lexeme));
     }
     
     // String literal
     if (match({TokenType::STRING_LITERAL})) {
-        return make_unique<StringLiteral>(previous().lexeme);
+        return arena->make<StringLiteral>(previous().lexeme);
     }
     
     // Identificadores (variables o llamadas a función)
@@ -561,11 +533,12 @@ unique_ptr<Expr> Parser::primary() {
         // Si es PRINTF, cambiar el lexeme a "printf"
         if (name.type == TokenType::PRINTF) {
             name.lexeme = "printf";
+            name.symbol = scanner.symbolTable().intern(name.lexeme);
         }
         
         // Llamada a función
         if (match({TokenType::LPAREN})) {
-            vector<unique_ptr<Expr>> arguments;
+            ExprList arguments(arena.get());
             
             if (!check(TokenType::RPAREN)) {
                 do {
@@ -574,16 +547,16 @@ unique_ptr<Expr> Parser::primary() {
             }
             
             consume(TokenType::RPAREN, "Expected ')' after arguments.");
-            return make_unique<CallExpr>(name.lexeme, move(arguments));
+            return arena->make<CallExpr>(name.lexeme, name.symbol, move(arguments));
         }
         
         // Variable simple
-        return make_unique<Variable>(name.lexeme);
+        return arena->make<Variable>(name.lexeme, name.symbol);
     }
     
     // Expresiones entre paréntesis
     if (match({TokenType::LPAREN})) {
-        unique_ptr<Expr> expr = expression();
+        ExprPtr expr = expression();
         consume(TokenType::RPAREN, "Expected ')' after expression.");
         return expr;
     }
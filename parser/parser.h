@@ -7,59 +7,72 @@
 #include <vector>
 #include <memory>
 #include <stdexcept>
+#include <initializer_list>
 
 using namespace std;
 
 class Parser {
 private:
-    vector<Token> tokens;
-    int current;
+    // Buffer circular de tokens: el parser los pide al scanner bajo demanda,
+    // así la memoria de tokens es O(LOOKAHEAD) y no O(archivo).
+    // Debe ser potencia de 2; retiene el token anterior más LOOKAHEAD - 1
+    // tokens hacia adelante (el parser nunca mira más de 3 adelante).
+    static const int LOOKAHEAD = 8;
+
+    Scanner& scanner;
+    Token window[LOOKAHEAD];
+    long current;   // Índice absoluto del token actual
+    long scanned;   // Cantidad de tokens ya pedidos al scanner
+
+    // Arena donde se crean los nodos; parse() lo entrega al Program
+    unique_ptr<Arena> arena;
     
     // Helpers para navegar tokens
-    Token peek();
-    Token previous();
-    Token advance();
+    const Token& peek(int offset = 0);
+    const Token& previous();
+    const Token& advance();
     bool isAtEnd();
     bool check(TokenType type);
-    bool match(vector<TokenType> types);
-    Token consume(TokenType type, string message);
+    bool match(initializer_list<TokenType> types);
+    const Token& consume(TokenType type, string message);
+    bool isTypeToken(TokenType type);
     
     // Convertir TokenType a DataType
-    DataType tokenToDataType(Token token);
+    DataType tokenToDataType(const Token& token);
     
     // Parsing de declaraciones y statements
-    unique_ptr<Stmt> declaration();
-    unique_ptr<Stmt> varDeclaration();
-    unique_ptr<Stmt> functionDeclaration();
-    unique_ptr<Stmt> statement();
-    unique_ptr<Stmt> exprStatement();
-    unique_ptr<Stmt> ifStatement();
-    unique_ptr<Stmt> whileStatement();
-    unique_ptr<Stmt> forStatement();
-    unique_ptr<Stmt> returnStatement();
-    unique_ptr<Block> block();
+    StmtPtr declaration();
+    StmtPtr varDeclaration();
+    StmtPtr functionDeclaration();
+    StmtPtr statement();
+    StmtPtr exprStatement();
+    StmtPtr ifStatement();
+    StmtPtr whileStatement();
+    StmtPtr forStatement();
+    StmtPtr returnStatement();
+    NodePtr<Block> block();
     
     // Parsing de expresiones (por precedencia)
-    unique_ptr<Expr> expression();
-    unique_ptr<Expr> assignment();
-    unique_ptr<Expr> ternary();
-    unique_ptr<Expr> logicalOr();
-    unique_ptr<Expr> logicalAnd();
-    unique_ptr<Expr> equality();
-    unique_ptr<Expr> comparison();
-    unique_ptr<Expr> term();
-    unique_ptr<Expr> factor();
-    unique_ptr<Expr> unary();
-    unique_ptr<Expr> cast();
-    unique_ptr<Expr> postfix();
-    unique_ptr<Expr> primary();
+    ExprPtr expression();
+    ExprPtr assignment();
+    ExprPtr ternary();
+    ExprPtr logicalOr();
+    ExprPtr logicalAnd();
+    ExprPtr equality();
+    ExprPtr comparison();
+    ExprPtr term();
+    ExprPtr factor();
+    ExprPtr unary();
+    ExprPtr cast();
+    ExprPtr postfix();
+    ExprPtr primary();
     
     // Error handling
     void error(string message);
     void synchronize();
 
 public:
-    Parser(vector<Token> tokens);
+    Parser(Scanner& scanner);
     unique_ptr<Program> parse();
 };
 
@@ -0,0 +1,122 @@
+#!/bin/bash
+
+# Test de escalabilidad: el tiempo de compilación debe crecer linealmente
+# con la cantidad de funciones y literales (float y string) del programa.
+#
+# Uso: ./run_scaling.sh [tamaños...]   (por defecto: 500 1000 2000 4000 8000)
+
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+NC='\033[0m' # No Color
+
+# Máximo permitido entre el costo por función del tamaño mayor y el menor
+MAX_RATIO=3
+
+echo "=========================================="
+echo "   C Compiler - Scaling Test"
+echo "=========================================="
+echo ""
+
+# Compilar el compilador si no existe
+if [ ! -f "./compiler" ]; then
+    echo "Compilando el compilador..."
+    make
+    if [ $? -ne 0 ]; then
+        echo -e "${RED}Error al compilar el compilador${NC}"
+        exit 1
+    fi
+    echo ""
+fi
+
+sizes=("$@")
+if [ ${#sizes[@]} -eq 0 ]; then
+    sizes=(500 1000 2000 4000 8000)
+fi
+
+workdir=$(mktemp -d)
+trap 'rm -rf "$workdir"' EXIT
+
+# Genera un programa con N funciones; cada una tiene 4 literales float y
+# 4 literales string (cada literal agrega una constante a .rodata)
+generate_program() {
+    local n=$1
+    local file=$2
+    {
+        echo "#include <stdio.h>"
+        echo ""
+        for ((i = 0; i < n; i++)); do
+            echo "int func_$i(int x) {"
+            echo "    float a = 1.5;"
+            echo "    float b = a * 2.25;"
+            echo "    float c = b + 0.75;"
+            echo "    float d = c - 3.5;"
+            echo "    printf(\"func_$i a=%d\\n\", x);"
+            echo "    printf(\"func_$i b=%d\\n\", x + 1);"
+            echo "    printf(\"func_$i c=%d\\n\", x + 2);"
+            echo "    printf(\"func_$i d=%d\\n\", x + 3);"
+            echo "    return x + $i;"
+            echo "}"
+            echo ""
+        done
+        # main llama a todas y usa cada resultado, para que el optimizer no
+        # elimine ninguna función. Sale con 0: sum(1 + i) = n + n(n-1)/2
+        echo "int main() {"
+        echo "    int total;"
+        echo "    total = 0;"
+        for ((i = 0; i < n; i++)); do
+            echo "    total = total + func_$i(1);"
+        done
+        echo "    return total - $(( n + n * (n - 1) / 2 ));"
+        echo "}"
+    } > "$file"
+}
+
+first_cost=""
+last_cost=""
+
+printf "%10s %12s %16s\n" "functions" "time (ms)" "us per function"
+for n in "${sizes[@]}"; do
+    src="$workdir/scale_$n.c"
+    generate_program $n "$src"
+
+    start=$(date +%s%N)
+    # Sin inlining: si no, las N funciones terminan dentro de main y el
+    # optimizer las borra como funciones muertas
+    ./compiler --inline-size=0 "$src" "$workdir/scale_$n.asm" > /dev/null 2>&1
+    status=$?
+    end=$(date +%s%N)
+
+    if [ $status -ne 0 ]; then
+        echo -e "${RED}FAIL (compiler error with $n functions)${NC}"
+        exit 1
+    fi
+
+    emitted=$(grep -c '^func_[0-9]*:' "$workdir/scale_$n.asm")
+    if [ "$emitted" -ne $n ]; then
+        echo -e "${RED}FAIL (only $emitted of $n functions emitted)${NC}"
+        exit 1
+    fi
+
+    elapsed_us=$(( (end - start) / 1000 ))
+    cost=$(( elapsed_us / n ))
+    printf "%10d %12d %16d\n" $n $(( elapsed_us / 1000 )) $cost
+
+    if [ -z "$first_cost" ]; then
+        first_cost=$cost
+    fi
+    last_cost=$cost
+done
+echo ""
+
+# Si el costo por función crece con el tamaño, la compilación es superlineal
+if [ "$first_cost" -lt 1 ]; then
+    first_cost=1
+fi
+
+if [ $last_cost -le $(( first_cost * MAX_RATIO )) ]; then
+    echo -e "${GREEN}PASS: compile time grows linearly (${first_cost}us -> ${last_cost}us per function)${NC}"
+    exit 0
+else
+    echo -e "${RED}FAIL: cost per function grew from ${first_cost}us to ${last_cost}us${NC}"
+    exit 1
+fi
@@ -62,6 +62,29 @@ run_test() {
     fi
 }
 
+# Función para revisar el ensamblador generado: el patrón tiene que aparecer
+run_asm_test() {
+    local test_file=$1
+    local pattern=$2
+    local test_name=$(basename $test_file .c)
+
+    echo -n "Checking $test_name for '$pattern'... "
+
+    ./compiler $test_file output.asm > /dev/null 2>&1
+    if [ $? -ne 0 ]; then
+        echo -e "${RED}FAIL (compiler error)${NC}"
+        return 1
+    fi
+
+    if grep -q "$pattern" output.asm; then
+        echo -e "${GREEN}PASS${NC}"
+        return 0
+    else
+        echo -e "${RED}FAIL (not in output.asm)${NC}"
+        return 1
+    fi
+}
+
 # Contadores
 total=0
 passed=0
@@ -114,6 +137,16 @@ for test in tests/optimization/*.c; do
 done
 echo ""
 
+echo "=== Generated Assembly ==="
+for check in "tests/optimization/opt10.c pslld" "tests/optimization/opt10.c mulps"; do
+    run_asm_test $check
+    if [ $? -eq 0 ]; then
+        passed=$((passed + 1))
+    fi
+    total=$((total + 1))
+done
+echo ""
+
 # Limpiar archivos temporales
 rm -f output.asm output.o program
 
@@ -0,0 +1,301 @@
+#include "char_scan.h"
+
+#if !defined(CHARSCAN_SCALAR) && (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define CHARSCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// ========== VERSIÓN ESCALAR ==========
+// Referencia y fallback: también procesa las colas de menos de un bloque.
+
+static inline bool isIdentChar(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_';
+}
+
+static size_t skipWhitespaceScalar(const char* data, size_t pos, size_t end,
+                                   int& newlines, size_t& lastNewline) {
+    while (pos < end) {
+        char c = data[pos];
+        if (c == '\n') {
+            newlines++;
+            lastNewline = pos;
+        } else if (c != ' ' && c != '\t' && c != '\r') {
+            break;
+        }
+        pos++;
+    }
+    return pos;
+}
+
+static size_t skipBlockCommentScalar(const char* data, size_t pos, size_t end,
+                                     int& newlines, size_t& lastNewline) {
+    while (pos < end) {
+        if (data[pos] == '*' && pos + 1 < end && data[pos + 1] == '/') {
+            return pos + 2;
+        }
+        if (data[pos] == '\n') {
+            newlines++;
+            lastNewline = pos;
+        }
+        pos++;
+    }
+    return end;
+}
+
+static size_t findLineEndScalar(const char* data, size_t pos, size_t end) {
+    while (pos < end && data[pos] != '\n') pos++;
+    return pos;
+}
+
+static size_t skipIdentifierScalar(const char* data, size_t pos, size_t end) {
+    while (pos < end && isIdentChar((unsigned char)data[pos])) pos++;
+    return pos;
+}
+
+static size_t skipDigitsScalar(const char* data, size_t pos, size_t end) {
+    while (pos < end && data[pos] >= '0' && data[pos] <= '9') pos++;
+    return pos;
+}
+
+#ifdef CHARSCAN_X86
+
+// Suma los '\n' marcados en 'mask' (bit i = byte pos + i)
+static inline void countNewlines(unsigned mask, size_t pos, int& newlines, size_t& lastNewline) {
+    if (mask) {
+        newlines += __builtin_popcount(mask);
+        lastNewline = pos + 31 - __builtin_clz(mask);
+    }
+}
+
+// Bits de los bytes anteriores al bit n (n < 32)
+static inline unsigned bitsBelow(unsigned n) {
+    return (1u << n) - 1;
+}
+
+// ========== SSE2 (16 bytes por paso) ==========
+// SSE2 es parte de x86-64, así que no hace falta detectarlo.
+
+// Byte a byte: 0xFF si lo <= c < lo + n (comparación sin signo vía desplazamiento)
+static inline __m128i inRange16(__m128i v, char lo, char n) {
+    __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8((char)(-128 - lo)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8((char)(-128 + n)));
+}
+
+static size_t skipWhitespaceSSE2(const char* data, size_t pos, size_t end,
+                                 int& newlines, size_t& lastNewline) {
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    while (pos + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + pos));
+        __m128i isLf = _mm_cmpeq_epi8(v, lf);
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, space), _mm_cmpeq_epi8(v, tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(v, cr), isLf));
+        unsigned wsMask = (unsigned)_mm_movemask_epi8(ws);
+        unsigned lfMask = (unsigned)_mm_movemask_epi8(isLf);
+
+        if (wsMask != 0xFFFF) {
+            unsigned n = __builtin_ctz(~wsMask);
+            countNewlines(lfMask & bitsBelow(n), pos, newlines, lastNewline);
+            return pos + n;
+        }
+        countNewlines(lfMask, pos, newlines, lastNewline);
+        pos += 16;
+    }
+    return skipWhitespaceScalar(data, pos, end, newlines, lastNewline);
+}
+
+static size_t skipBlockCommentSSE2(const char* data, size_t pos, size_t end,
+                                   int& newlines, size_t& lastNewline) {
+    const __m128i star = _mm_set1_epi8('*');
+    const __m128i slash = _mm_set1_epi8('/');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    // Se lee también el byte siguiente al bloque (para ver el '/' de "*/")
+    while (pos + 17 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + pos));
+        __m128i next = _mm_loadu_si128((const __m128i*)(data + pos + 1));
+        unsigned closeMask = (unsigned)_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(v, star), _mm_cmpeq_epi8(next, slash)));
+        unsigned lfMask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, lf));
+
+        if (closeMask) {
+            unsigned n = __builtin_ctz(closeMask);
+            countNewlines(lfMask & bitsBelow(n), pos, newlines, lastNewline);
+            return pos + n + 2;
+        }
+        countNewlines(lfMask, pos, newlines, lastNewline);
+        pos += 16;
+    }
+    return skipBlockCommentScalar(data, pos, end, newlines, lastNewline);
+}
+
+static size_t findLineEndSSE2(const char* data, size_t pos, size_t end) {
+    const __m128i lf = _mm_set1_epi8('\n');
+    while (pos + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + pos));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, lf));
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 16;
+    }
+    return findLineEndScalar(data, pos, end);
+}
+
+static size_t skipIdentifierSSE2(const char* data, size_t pos, size_t end) {
+    const __m128i lowerBit = _mm_set1_epi8(0x20);
+    const __m128i underscore = _mm_set1_epi8('_');
+
+    while (pos + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + pos));
+        // (c | 0x20) convierte A-Z en a-z sin tocar a-z
+        __m128i letter = inRange16(_mm_or_si128(v, lowerBit), 'a', 26);
+        __m128i digit = inRange16(v, '0', 10);
+        __m128i ident = _mm_or_si128(_mm_or_si128(letter, digit), _mm_cmpeq_epi8(v, underscore));
+        unsigned mask = (unsigned)_mm_movemask_epi8(ident);
+        if (mask != 0xFFFF) return pos + __builtin_ctz(~mask);
+        pos += 16;
+    }
+    return skipIdentifierScalar(data, pos, end);
+}
+
+static size_t skipDigitsSSE2(const char* data, size_t pos, size_t end) {
+    while (pos + 16 <= end) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + pos));
+        unsigned mask = (unsigned)_mm_movemask_epi8(inRange16(v, '0', 10));
+        if (mask != 0xFFFF) return pos + __builtin_ctz(~mask);
+        pos += 16;
+    }
+    return skipDigitsScalar(data, pos, end);
+}
+
+// ========== AVX2 (32 bytes por paso) ==========
+// Solo para los tramos que suelen ser largos (espacios, comentarios).
+
+__attribute__((target("avx2")))
+static size_t skipWhitespaceAVX2(const char* data, size_t pos, size_t end,
+                                 int& newlines, size_t& lastNewline) {
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    while (pos + 32 <= end) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + pos));
+        __m256i isLf = _mm256_cmpeq_epi8(v, lf);
+        __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, space), _mm256_cmpeq_epi8(v, tab)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(v, cr), isLf));
+        unsigned wsMask = (unsigned)_mm256_movemask_epi8(ws);
+        unsigned lfMask = (unsigned)_mm256_movemask_epi8(isLf);
+
+        if (wsMask != 0xFFFFFFFFu) {
+            unsigned n = __builtin_ctz(~wsMask);
+            countNewlines(lfMask & bitsBelow(n), pos, newlines, lastNewline);
+            return pos + n;
+        }
+        countNewlines(lfMask, pos, newlines, lastNewline);
+        pos += 32;
+    }
+    return skipWhitespaceSSE2(data, pos, end, newlines, lastNewline);
+}
+
+__attribute__((target("avx2")))
+static size_t skipBlockCommentAVX2(const char* data, size_t pos, size_t end,
+                                   int& newlines, size_t& lastNewline) {
+    const __m256i star = _mm256_set1_epi8('*');
+    const __m256i slash = _mm256_set1_epi8('/');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    while (pos + 33 <= end) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + pos));
+        __m256i next = _mm256_loadu_si256((const __m256i*)(data + pos + 1));
+        unsigned closeMask = (unsigned)_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(v, star), _mm256_cmpeq_epi8(next, slash)));
+        unsigned lfMask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lf));
+
+        if (closeMask) {
+            unsigned n = __builtin_ctz(closeMask);
+            countNewlines(lfMask & bitsBelow(n), pos, newlines, lastNewline);
+            return pos + n + 2;
+        }
+        countNewlines(lfMask, pos, newlines, lastNewline);
+        pos += 32;
+    }
+    return skipBlockCommentSSE2(data, pos, end, newlines, lastNewline);
+}
+
+__attribute__((target("avx2")))
+static size_t findLineEndAVX2(const char* data, size_t pos, size_t end) {
+    const __m256i lf = _mm256_set1_epi8('\n');
+    while (pos + 32 <= end) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(data + pos));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lf));
+        if (mask) return pos + __builtin_ctz(mask);
+        pos += 32;
+    }
+    return findLineEndSSE2(data, pos, end);
+}
+
+#endif // CHARSCAN_X86
+
+// ========== SELECCIÓN DE IMPLEMENTACIÓN ==========
+
+struct CharScanOps {
+    size_t (*skipWhitespace)(const char*, size_t, size_t, int&, size_t&);
+    size_t (*skipBlockComment)(const char*, size_t, size_t, int&, size_t&);
+    size_t (*findLineEnd)(const char*, size_t, size_t);
+    const char* name;
+};
+
+static CharScanOps selectCharScanOps() {
+#ifdef CHARSCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {skipWhitespaceAVX2, skipBlockCommentAVX2, findLineEndAVX2, "avx2"};
+    }
+    return {skipWhitespaceSSE2, skipBlockCommentSSE2, findLineEndSSE2, "sse2"};
+#else
+    return {skipWhitespaceScalar, skipBlockCommentScalar, findLineEndScalar, "scalar"};
+#endif
+}
+
+// Se elige una sola vez, al cargar el programa
+static const CharScanOps charScanOps = selectCharScanOps();
+
+size_t skipWhitespaceRun(const char* data, size_t pos, size_t end,
+                         int& newlines, size_t& lastNewline) {
+    return charScanOps.skipWhitespace(data, pos, end, newlines, lastNewline);
+}
+
+size_t skipBlockComment(const char* data, size_t pos, size_t end,
+                        int& newlines, size_t& lastNewline) {
+    return charScanOps.skipBlockComment(data, pos, end, newlines, lastNewline);
+}
+
+size_t findLineEnd(const char* data, size_t pos, size_t end) {
+    return charScanOps.findLineEnd(data, pos, end);
+}
+
+// Identificadores y números suelen ser cortos: un bloque SSE2 los cubre
+// casi siempre, así que no vale la pena despachar a AVX2.
+size_t skipIdentifierChars(const char* data, size_t pos, size_t end) {
+#ifdef CHARSCAN_X86
+    return skipIdentifierSSE2(data, pos, end);
+#else
+    return skipIdentifierScalar(data, pos, end);
+#endif
+}
+
+size_t skipDigitChars(const char* data, size_t pos, size_t end) {
+#ifdef CHARSCAN_X86
+    return skipDigitsSSE2(data, pos, end);
+#else
+    return skipDigitsScalar(data, pos, end);
+#endif
+}
+
+const char* charScanBackend() {
+    return charScanOps.name;
+}
@@ -0,0 +1,42 @@
+#ifndef CHAR_SCAN_H
+#define CHAR_SCAN_H
+
+#include <cstddef>
+
+using namespace std;
+
+// ========== CLASIFICACIÓN DE CARACTERES EN BLOQUE ==========
+// Funciones que el Scanner usa para consumir tramos largos de un solo golpe
+// (espacios, comentarios, colas de identificadores, dígitos). En x86-64
+// procesan 16 bytes por paso con SSE2, o 32 con AVX2 si la CPU lo soporta
+// (se detecta una vez en tiempo de ejecución). En otras plataformas, o
+// compilando con -DCHARSCAN_SCALAR, se usa la versión escalar.
+//
+// Todas reciben el buffer, la posición inicial y el final (exclusivo), y
+// nunca leen fuera de [pos, end).
+
+// Salta ' ', '\t', '\r' y '\n'. Devuelve la posición del primer carácter que
+// no es espacio. Suma a 'newlines' los saltos de línea encontrados y guarda
+// en 'lastNewline' la posición del último (si hubo alguno).
+size_t skipWhitespaceRun(const char* data, size_t pos, size_t end,
+                         int& newlines, size_t& lastNewline);
+
+// Busca el cierre "*/" de un comentario de bloque. Devuelve la posición justo
+// después del cierre (o 'end' si no está cerrado) y cuenta los saltos de
+// línea igual que skipWhitespaceRun.
+size_t skipBlockComment(const char* data, size_t pos, size_t end,
+                        int& newlines, size_t& lastNewline);
+
+// Posición del siguiente '\n' (o 'end'). Para comentarios // y directivas #
+size_t findLineEnd(const char* data, size_t pos, size_t end);
+
+// Salta [A-Za-z0-9_]*
+size_t skipIdentifierChars(const char* data, size_t pos, size_t end);
+
+// Salta [0-9]*
+size_t skipDigitChars(const char* data, size_t pos, size_t end);
+
+// "avx2", "sse2" o "scalar": implementación elegida para los tramos largos
+const char* charScanBackend();
+
+#endif
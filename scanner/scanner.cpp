@@ -1,34 +1,88 @@
 #include "scanner.h"
+#include "char_scan.h"
 #include <cctype>
 
-Scanner::Scanner(string source) : source(source), start(0), current(0), line(1), column(1) {
-    initKeywords();
+// ========== PALABRAS RESERVADAS ==========
+// Reconocimiento sin tablas: se despacha por longitud y luego por el primer
+// carácter, de modo que cada identificador se compara como máximo contra una
+// palabra reservada. Es constexpr, no reserva memoria ni construye nada en
+// tiempo de ejecución.
+static constexpr TokenType keywordType(string_view text) {
+    switch (text.size()) {
+        case 2:
+            if (text == "if") return TokenType::IF;
+            break;
+        case 3:
+            if (text[0] == 'i') { if (text == "int") return TokenType::INT; }
+            else if (text[0] == 'f') { if (text == "for") return TokenType::FOR; }
+            break;
+        case 4:
+            if (text[0] == 'l') { if (text == "long") return TokenType::LONG; }
+            else if (text[0] == 'e') { if (text == "else") return TokenType::ELSE; }
+            break;
+        case 5:
+            if (text[0] == 'f') { if (text == "float") return TokenType::FLOAT; }
+            else if (text[0] == 'w') { if (text == "while") return TokenType::WHILE; }
+            break;
+        case 6:
+            if (text[0] == 'r') { if (text == "return") return TokenType::RETURN; }
+            else if (text[0] == 'p') { if (text == "printf") return TokenType::PRINTF; }
+            break;
+        case 7:
+            if (text == "include") return TokenType::INCLUDE;
+            break;
+        case 8:
+            if (text == "unsigned") return TokenType::UNSIGNED;
+            break;
+    }
+    return TokenType::IDENTIFIER;
 }
 
-void Scanner::initKeywords() {
-    keywords["int"] = TokenType::INT;
-    keywords["float"] = TokenType::FLOAT;
-    keywords["long"] = TokenType::LONG;
-    keywords["unsigned"] = TokenType::UNSIGNED;
-    keywords["if"] = TokenType::IF;
-    keywords["else"] = TokenType::ELSE;
-    keywords["while"] = TokenType::WHILE;
-    keywords["for"] = TokenType::FOR;
-    keywords["return"] = TokenType::RETURN;
-    keywords["printf"] = TokenType::PRINTF;
-    keywords["include"] = TokenType::INCLUDE;
-}
+// Verificación en tiempo de compilación del despacho
+static_assert(keywordType("int") == TokenType::INT, "keyword int");
+static_assert(keywordType("float") == TokenType::FLOAT, "keyword float");
+static_assert(keywordType("long") == TokenType::LONG, "keyword long");
+static_assert(keywordType("unsigned") == TokenType::UNSIGNED, "keyword unsigned");
+static_assert(keywordType("if") == TokenType::IF, "keyword if");
+static_assert(keywordType("else") == TokenType::ELSE, "keyword else");
+static_assert(keywordType("while") == TokenType::WHILE, "keyword while");
+static_assert(keywordType("for") == TokenType::FOR, "keyword for");
+static_assert(keywordType("return") == TokenType::RETURN, "keyword return");
+static_assert(keywordType("printf") == TokenType::PRINTF, "keyword printf");
+static_assert(keywordType("include") == TokenType::INCLUDE, "keyword include");
+static_assert(keywordType("fort") == TokenType::IDENTIFIER, "not a keyword");
+static_assert(keywordType("i") == TokenType::IDENTIFIER, "not a keyword");
 
-vector<Token> Scanner::scanTokens() {
-    while (!isAtEnd()) {
+Scanner::Scanner(string_view source, SymbolTable& symbols)
+    : source(source), symbols(symbols), hasPending(false), tokenCount(0),
+      start(0), current(0), line(1), column(1) {}
+
+Token Scanner::nextToken() {
+    // Avanzar hasta que scanToken() produzca un token (espacios y
+    // comentarios no producen ninguno)
+    hasPending = false;
+    while (!hasPending && !isAtEnd()) {
         start = current;
         scanToken();
     }
-    
-    tokens.push_back(Token(TokenType::END_OF_FILE, "", line, column));
+
+    tokenCount++;
+    if (hasPending) return pending;
+    return Token(TokenType::END_OF_FILE, "", line, column);
+}
+
+vector<Token> Scanner::scanTokens() {
+    vector<Token> tokens;
+    do {
+        tokens.push_back(nextToken());
+    } while (tokens.back().type != TokenType::END_OF_FILE);
     return tokens;
 }
 
+long Scanner::tokensScanned() const {
+    return tokenCount;
+}
+
 bool Scanner::isAtEnd() {
     return current >= source.length();
 }
@@ -58,27 +112,25 @@ bool Scanner::match(char expected) {
 }
 
 void Scanner::addToken(TokenType type) {
-    string text = source.substr(start, current - start);
-    tokens.push_back(Token(type, text, line, column - text.length()));
+    string_view text = source.substr(start, current - start);
+    addToken(type, text);
 }
 
-void Scanner::addToken(TokenType type, string lexeme) {
-    tokens.push_back(Token(type, lexeme, line, column - lexeme.length()));
+void Scanner::addToken(TokenType type, string_view lexeme) {
+    pending = Token(type, lexeme, line, column - lexeme.length());
+    hasPending = true;
 }
 
 void Scanner::scanToken() {
     char c = advance();
     
     switch (c) {
-        // Espacios en blanco
+        // Espacios en blanco (se consume todo el tramo de una vez)
         case ' ':
         case '\r':
         case '\t':
-            break;
-            
         case '\n':
-            line++;
-            column = 1;
+            skipWhitespace();
             break;
             
         // Delimitadores simples
@@ -108,21 +160,10 @@ void Scanner::scanToken() {
         case '/':
             if (match('/')) {
                 // Comentario de línea
-                while (peek() != '\n' && !isAtEnd()) advance();
+                skipToLineEnd();
             } else if (match('*')) {
                 // Comentario de bloque
-                while (!isAtEnd()) {
-                    if (peek() == '*' && peekNext() == '/') {
-                        advance(); // consume '*'
-                        advance(); // consume '/'
-                        break;
-                    }
-                    if (peek() == '\n') {
-                        line++;
-                        column = 0;
-                    }
-                    advance();
-                }
+                skipComment();
             } else {
                 addToken(TokenType::DIVIDE);
             }
@@ -166,7 +207,7 @@ void Scanner::scanToken() {
             
         case '#':
             // Procesar directivas de preprocesador (#include)
-            while (peek() != '\n' && !isAtEnd()) advance();
+            skipToLineEnd();
             break;
             
         default:
@@ -183,17 +224,16 @@ void Scanner::scanToken() {
 }
 
 void Scanner::identifier() {
-    while (isAlphaNumeric(peek())) advance();
+    advanceTo(skipIdentifierChars(source.data(), current, source.size()), 0, 0);
     
-    string text = source.substr(start, current - start);
-    
-    // Verificar si es palabra reservada
-    TokenType type = TokenType::IDENTIFIER;
-    if (keywords.find(text) != keywords.end()) {
-        type = keywords[text];
-    }
+    string_view text = source.substr(start, current - start);
     
+    // Verificar si es palabra reservada; si no, internar el nombre
+    TokenType type = keywordType(text);
     addToken(type, text);
+    if (type == TokenType::IDENTIFIER) {
+        pending.symbol = symbols.intern(text);
+    }
 }
 
 void Scanner::number() {
@@ -201,13 +241,13 @@ void Scanner::number() {
     bool isLong = false;
     
     // Parte entera
-    while (isDigit(peek())) advance();
+    advanceTo(skipDigitChars(source.data(), current, source.size()), 0, 0);
     
     // Parte decimal
     if (peek() == '.' && isDigit(peekNext())) {
         isFloat = true;
         advance(); // consume '.'
-        while (isDigit(peek())) advance();
+        advanceTo(skipDigitChars(source.data(), current, source.size()), 0, 0);
     }
     
     // Sufijo L para long
@@ -216,7 +256,7 @@ void Scanner::number() {
         advance();
     }
     
-    string text = source.substr(start, current - start);
+    string_view text = source.substr(start, current - start);
     
     if (isFloat) {
         addToken(TokenType::FLOAT_LITERAL, text);
@@ -245,7 +285,7 @@ void Scanner::scanString() {
     advance();
     
     // Extraer el valor sin las comillas
-    string value = source.substr(start + 1, current - start - 2);
+    string_view value = source.substr(start + 1, current - start - 2);
     addToken(TokenType::STRING_LITERAL, value);
 }
 
@@ -261,4 +301,37 @@ bool Scanner::isAlpha(char c) {
 
 bool Scanner::isAlphaNumeric(char c) {
     return isAlpha(c) || isDigit(c);
-}
\ No newline at end of file
+}
+
+// ========== CONSUMO EN BLOQUE ==========
+
+// Mueve 'current' hasta 'pos' actualizando línea y columna. Si en el tramo
+// hubo saltos de línea, la columna se cuenta desde el último.
+void Scanner::advanceTo(size_t pos, int newlines, size_t lastNewline) {
+    if (newlines > 0) {
+        line += newlines;
+        column = pos - lastNewline;
+    } else {
+        column += pos - current;
+    }
+    current = pos;
+}
+
+void Scanner::skipWhitespace() {
+    // El primer espacio ya lo consumió scanToken(): se reescanea desde start
+    int newlines = 0;
+    size_t lastNewline = 0;
+    size_t end = skipWhitespaceRun(source.data(), start, source.size(), newlines, lastNewline);
+    advanceTo(end, newlines, lastNewline);
+}
+
+void Scanner::skipComment() {
+    int newlines = 0;
+    size_t lastNewline = 0;
+    size_t end = skipBlockComment(source.data(), current, source.size(), newlines, lastNewline);
+    advanceTo(end, newlines, lastNewline);
+}
+
+void Scanner::skipToLineEnd() {
+    advanceTo(findLineEnd(source.data(), current, source.size()), 0, 0);
+}
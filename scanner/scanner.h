@@ -3,23 +3,23 @@
 
 #include "token.h"
 #include <string>
+#include <string_view>
 #include <vector>
-#include <map>
 
 using namespace std;
 
 class Scanner {
 private:
-    string source;           // Código fuente completo
-    vector<Token> tokens;    // Lista de tokens generados
+    string_view source;      // Código fuente completo (vista al SourceBuffer)
+    SymbolTable& symbols;    // Donde se internan los identificadores
+    Token pending;           // Último token reconocido por scanToken()
+    bool hasPending;         // true si scanToken() produjo un token
+    long tokenCount;         // Tokens entregados hasta ahora (incluye EOF)
     int start;               // Inicio del lexema actual
     int current;             // Posición actual en el source
     int line;                // Línea actual
     int column;              // Columna actual
     
-    // Mapa de palabras reservadas
-    map<string, TokenType> keywords;
-    
     // Métodos auxiliares
     bool isAtEnd();
     char advance();
@@ -28,7 +28,7 @@ private:
     bool match(char expected);
     
     void addToken(TokenType type);
-    void addToken(TokenType type, string lexeme);
+    void addToken(TokenType type, string_view lexeme);
     
     void scanToken();
     void identifier();
@@ -39,14 +39,25 @@ private:
     bool isAlpha(char c);
     bool isAlphaNumeric(char c);
     
-    void skipWhitespace();
-    void skipComment();
-    
-    void initKeywords();
+    // Consumo de tramos en bloque (ver char_scan.h)
+    void skipWhitespace();   // Espacios y saltos de línea desde 'start'
+    void skipComment();      // Cuerpo de un comentario /* ... */
+    void skipToLineEnd();    // Resto de la línea (// y #), sin el '\n'
+    void advanceTo(size_t pos, int newlines, size_t lastNewline);
 
 public:
-    Scanner(string source);
+    Scanner(string_view source, SymbolTable& symbols);
+
+    // Modo streaming: devuelve el siguiente token bajo demanda.
+    // Al llegar al final devuelve END_OF_FILE indefinidamente.
+    Token nextToken();
+
+    // Escanea todo el archivo de una vez (útil para depurar)
     vector<Token> scanTokens();
+
+    long tokensScanned() const;
+
+    SymbolTable& symbolTable() { return symbols; }
 };
 
 #endif
\ No newline at end of file
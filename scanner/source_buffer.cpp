@@ -0,0 +1,82 @@
+#include "source_buffer.h"
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+SourceBuffer::SourceBuffer() : data(""), length(0), mapped(false) {}
+
+SourceBuffer::~SourceBuffer() {
+    release();
+}
+
+void SourceBuffer::release() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(const_cast<char*>(data), length);
+    }
+#endif
+    data = "";
+    length = 0;
+    mapped = false;
+    fallback.clear();
+}
+
+bool SourceBuffer::open(const string& filename) {
+    release();
+
+#ifndef _WIN32
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        if (st.st_size == 0) {
+            // Archivo vacío: mmap no acepta longitud 0
+            ::close(fd);
+            return true;
+        }
+
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) {
+            ::close(fd);
+            // El parser consume el archivo de principio a fin: pedir al kernel
+            // lectura anticipada agresiva para solapar la E/S con el parsing
+            madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(addr);
+            length = st.st_size;
+            mapped = true;
+            return true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    // Fallback: leer el archivo completo a memoria
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return false;
+
+    stringstream buffer;
+    buffer << file.rdbuf();
+    fallback = buffer.str();
+    data = fallback.data();
+    length = fallback.size();
+    return true;
+}
+
+string_view SourceBuffer::view() const {
+    return string_view(data, length);
+}
+
+size_t SourceBuffer::size() const {
+    return length;
+}
+
+bool SourceBuffer::isMapped() const {
+    return mapped;
+}
@@ -0,0 +1,39 @@
+#ifndef SOURCE_BUFFER_H
+#define SOURCE_BUFFER_H
+
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+// ========== BUFFER DEL CÓDIGO FUENTE ==========
+// Mapea el archivo fuente en memoria (mmap) una sola vez. Los lexemas de los
+// tokens son string_views que apuntan dentro de este buffer, por lo que el
+// SourceBuffer debe vivir durante toda la compilación.
+// Si mmap no está disponible (Windows) o falla, se lee el archivo a un string.
+class SourceBuffer {
+private:
+    const char* data;   // Inicio del contenido (mapeado o del fallback)
+    size_t length;      // Tamaño en bytes
+    bool mapped;        // true si data proviene de mmap
+    string fallback;    // Copia en memoria cuando no se pudo mapear
+
+    void release();
+
+public:
+    SourceBuffer();
+    ~SourceBuffer();
+
+    // No copiable: los string_view de los tokens apuntan a este buffer
+    SourceBuffer(const SourceBuffer&) = delete;
+    SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+    // Abre y mapea el archivo. Retorna false si no se pudo abrir.
+    bool open(const string& filename);
+
+    string_view view() const;
+    size_t size() const;
+    bool isMapped() const;
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "symbol_table.h"
+
+// Capacidad inicial de la tabla hash (potencia de 2)
+static const size_t INITIAL_SLOTS = 1024;
+
+SymbolTable::SymbolTable() : slots(INITIAL_SLOTS, Slot{0, NO_SYMBOL}) {
+    names.reserve(INITIAL_SLOTS / 2);
+}
+
+// FNV-1a de 32 bits
+uint32_t SymbolTable::hashName(string_view name) {
+    uint32_t hash = 2166136261u;
+    for (char c : name) {
+        hash ^= (unsigned char)c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+SymbolId SymbolTable::lookup(string_view name) const {
+    uint32_t hash = hashName(name);
+    size_t mask = slots.size() - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        const Slot& slot = slots[i];
+        if (slot.id == NO_SYMBOL) return NO_SYMBOL;
+        if (slot.hash == hash && names[slot.id] == name) return slot.id;
+    }
+}
+
+SymbolId SymbolTable::intern(string_view name) {
+    uint32_t hash = hashName(name);
+    size_t mask = slots.size() - 1;
+    size_t i = hash & mask;
+
+    // Sondeo lineal hasta encontrar el nombre o un hueco
+    while (slots[i].id != NO_SYMBOL) {
+        if (slots[i].hash == hash && names[slots[i].id] == name) {
+            return slots[i].id;
+        }
+        i = (i + 1) & mask;
+    }
+
+    SymbolId id = (SymbolId)names.size();
+    names.push_back(name);
+    slots[i] = Slot{hash, id};
+
+    // Mantener el factor de carga por debajo de 1/2
+    if (names.size() * 2 > slots.size()) grow();
+    return id;
+}
+
+SymbolId SymbolTable::internCopy(string_view name) {
+    SymbolId id = lookup(name);
+    if (id != NO_SYMBOL) return id;
+    ownedNames.emplace_back(name);
+    return intern(ownedNames.back());
+}
+
+void SymbolTable::grow() {
+    vector<Slot> oldSlots = move(slots);
+    slots.assign(oldSlots.size() * 2, Slot{0, NO_SYMBOL});
+    size_t mask = slots.size() - 1;
+
+    for (const Slot& slot : oldSlots) {
+        if (slot.id == NO_SYMBOL) continue;
+        size_t i = slot.hash & mask;
+        while (slots[i].id != NO_SYMBOL) i = (i + 1) & mask;
+        slots[i] = slot;
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+// Identificador denso de un nombre internado: 0, 1, 2, ...
+typedef int SymbolId;
+const SymbolId NO_SYMBOL = -1;
+
+// ========== TABLA DE SÍMBOLOS (INTERNING) ==========
+// Cada identificador distinto se guarda una sola vez y recibe un SymbolId.
+// El hash se calcula solo al internar (en el scanner); después el parser,
+// el optimizer y el codegen trabajan con enteros.
+class SymbolTable {
+private:
+    struct Slot {
+        uint32_t hash;
+        SymbolId id;     // NO_SYMBOL = slot libre
+    };
+
+    vector<Slot> slots;          // Open addressing, tamaño potencia de 2
+    vector<string_view> names;   // id -> nombre
+    deque<string> ownedNames;    // Nombres que no vienen del SourceBuffer
+
+    static uint32_t hashName(string_view name);
+    void grow();
+
+public:
+    SymbolTable();
+
+    // Interna un nombre que vive tanto como la tabla (SourceBuffer)
+    SymbolId intern(string_view name);
+
+    // Igual que intern(), pero copia el nombre si es nuevo
+    SymbolId internCopy(string_view name);
+
+    // Busca sin insertar; NO_SYMBOL si no existe
+    SymbolId lookup(string_view name) const;
+
+    string_view name(SymbolId id) const { return names[id]; }
+    int size() const { return (int)names.size(); }
+};
+
+// ========== MAPA PLANO SYMBOLID -> VALOR ==========
+// Vector indexado por SymbolId: find/insert O(1) sin comparar strings.
+// clear() es O(1): se invalida todo subiendo la generación.
+template<typename T>
+class SymbolMap {
+private:
+    vector<T> values;
+    vector<uint32_t> stamps;     // Generación en la que se escribió cada id
+    uint32_t generation;
+
+    void ensure(SymbolId id) {
+        if ((size_t)id >= values.size()) {
+            size_t newSize = values.size() * 2;
+            if (newSize <= (size_t)id) newSize = id + 1;
+            values.resize(newSize);
+            stamps.resize(newSize, 0);
+        }
+    }
+
+public:
+    SymbolMap() : generation(1) {}
+
+    // Reserva espacio para todos los símbolos conocidos
+    void reserve(int symbolCount) {
+        if (symbolCount > 0) ensure(symbolCount - 1);
+    }
+
+    bool contains(SymbolId id) const {
+        return id >= 0 && (size_t)id < stamps.size() && stamps[id] == generation;
+    }
+
+    T* find(SymbolId id) {
+        return contains(id) ? &values[id] : nullptr;
+    }
+
+    // Inserta un valor por defecto si el id no estaba
+    T& operator[](SymbolId id) {
+        ensure(id);
+        if (stamps[id] != generation) {
+            values[id] = T();
+            stamps[id] = generation;
+        }
+        return values[id];
+    }
+
+    void erase(SymbolId id) {
+        if (contains(id)) stamps[id] = 0;
+    }
+
+    void clear() {
+        if (++generation == 0) {
+            // Desborde (muy improbable): reiniciar las marcas
+            fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    }
+};
+
+// ========== CONJUNTO PLANO DE SYMBOLIDS ==========
+// Igual que SymbolMap pero sin valores (solo las marcas de generación).
+class SymbolSet {
+private:
+    vector<uint32_t> stamps;
+    uint32_t generation;
+
+public:
+    SymbolSet() : generation(1) {}
+
+    void reserve(int symbolCount) {
+        if ((size_t)symbolCount > stamps.size()) stamps.resize(symbolCount, 0);
+    }
+
+    bool contains(SymbolId id) const {
+        return id >= 0 && (size_t)id < stamps.size() && stamps[id] == generation;
+    }
+
+    void insert(SymbolId id) {
+        if ((size_t)id >= stamps.size()) {
+            stamps.resize(max(stamps.size() * 2, (size_t)id + 1), 0);
+        }
+        stamps[id] = generation;
+    }
+
+    void erase(SymbolId id) {
+        if (contains(id)) stamps[id] = 0;
+    }
+
+    void clear() {
+        if (++generation == 0) {
+            fill(stamps.begin(), stamps.end(), 0);
+            generation = 1;
+        }
+    }
+};
+
+#endif
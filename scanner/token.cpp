@@ -1,15 +1,15 @@
 #include "token.h"
 
 // Constructor
-Token::Token(TokenType type, string lexeme, int line, int column) 
-    : type(type), lexeme(lexeme), line(line), column(column) {}
+Token::Token(TokenType type, string_view lexeme, int line, int column) 
+    : type(type), lexeme(lexeme), line(line), column(column), symbol(NO_SYMBOL) {}
 
 // Constructor por defecto
-Token::Token() : type(TokenType::UNKNOWN), lexeme(""), line(0), column(0) {}
+Token::Token() : type(TokenType::UNKNOWN), lexeme(""), line(0), column(0), symbol(NO_SYMBOL) {}
 
 // Convierte el token a string para debugging
 string Token::toString() const {
-    return "Token(" + typeToString(type) + ", \"" + lexeme + "\", " + 
+    return "Token(" + typeToString(type) + ", \"" + string(lexeme) + "\", " + 
            to_string(line) + ":" + to_string(column) + ")";
 }
 
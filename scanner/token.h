@@ -2,7 +2,9 @@
 #define TOKEN_H
 
 #include <string>
+#include <string_view>
 #include <iostream>
+#include "symbol_table.h"
 
 using namespace std;
 
@@ -44,12 +46,13 @@ enum class TokenType {
 class Token {
 public:
     TokenType type;
-    string lexeme;
+    string_view lexeme;  // Apunta al SourceBuffer (o a un literal estático)
     int line;
     int column;
+    SymbolId symbol;     // Solo IDENTIFIER: id internado en la SymbolTable
     
     // Constructor
-    Token(TokenType type, string lexeme, int line, int column);
+    Token(TokenType type, string_view lexeme, int line, int column);
     
     // Constructor por defecto
     Token();
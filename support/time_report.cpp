@@ -0,0 +1,243 @@
+#include "time_report.h"
+#include <ctime>
+#include <iomanip>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+// ========== MEDICIÓN ==========
+
+double TimeReport::cpuSecondsNow() {
+#ifndef _WIN32
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+long TimeReport::peakRssKB() {
+#ifndef _WIN32
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;  // En Linux ya viene en KB
+    }
+#endif
+    return 0;
+}
+
+void TimeReport::startPhase(const string& name) {
+    if (phaseOpen) endPhase();
+    phases.push_back({name, 0, 0});
+    phaseOpen = true;
+    wallStart = chrono::steady_clock::now();
+    cpuStart = cpuSecondsNow();
+}
+
+void TimeReport::endPhase() {
+    if (!phaseOpen) return;
+    Phase& phase = phases.back();
+    phase.wallSeconds = chrono::duration<double>(chrono::steady_clock::now() - wallStart).count();
+    phase.cpuSeconds = cpuSecondsNow() - cpuStart;
+    phaseOpen = false;
+}
+
+double TimeReport::phaseWall(const string& name) const {
+    for (const Phase& phase : phases) {
+        if (phase.name == name) return phase.wallSeconds;
+    }
+    return 0;
+}
+
+// ========== CONTEO DE NODOS ==========
+
+void TimeReport::countNodes(Program* program) {
+    for (auto& stmt : program->statements) {
+        countStmt(stmt.get());
+    }
+}
+
+void TimeReport::countExpr(Expr* expr) {
+    if (!expr) return;
+    nodeKindCounts[(int)expr->kind]++;
+
+    switch (expr->kind) {
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            countExpr(binOp->left.get());
+            countExpr(binOp->right.get());
+            break;
+        }
+        case NodeKind::UnaryOp:
+            countExpr(static_cast<UnaryOp*>(expr)->operand.get());
+            break;
+        case NodeKind::CastExpr:
+            countExpr(static_cast<CastExpr*>(expr)->expr.get());
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            countExpr(ternary->condition.get());
+            countExpr(ternary->exprTrue.get());
+            countExpr(ternary->exprFalse.get());
+            break;
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) countExpr(arg.get());
+            break;
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) countExpr(index.get());
+            break;
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            for (auto& index : assign->indices) countExpr(index.get());
+            countExpr(assign->value.get());
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void TimeReport::countStmt(Stmt* stmt) {
+    if (!stmt) return;
+    nodeKindCounts[(int)stmt->kind]++;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            countExpr(varDecl->initializer.get());
+            for (auto& init : varDecl->arrayInitializer) countExpr(init.get());
+            break;
+        }
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            for (auto& index : assign->indices) countExpr(index.get());
+            countExpr(assign->value.get());
+            break;
+        }
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) countStmt(s.get());
+            break;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            countExpr(ifStmt->condition.get());
+            countStmt(ifStmt->thenBranch.get());
+            countStmt(ifStmt->elseBranch.get());
+            break;
+        }
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            countExpr(whileStmt->condition.get());
+            countStmt(whileStmt->body.get());
+            break;
+        }
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            countStmt(forStmt->initializer.get());
+            countExpr(forStmt->condition.get());
+            countExpr(forStmt->increment.get());
+            countStmt(forStmt->body.get());
+            break;
+        }
+        case NodeKind::ReturnStmt:
+            countExpr(static_cast<ReturnStmt*>(stmt)->value.get());
+            break;
+        case NodeKind::ExprStmt:
+            countExpr(static_cast<ExprStmt*>(stmt)->expression.get());
+            break;
+        case NodeKind::FunctionDecl:
+            countStmt(static_cast<FunctionDecl*>(stmt)->body.get());
+            break;
+        default:
+            break;
+    }
+}
+
+// ========== SALIDA ==========
+
+// Elementos por segundo (0 si la fase no tomó tiempo medible)
+static double perSecond(long count, double seconds) {
+    return seconds > 0 ? count / seconds : 0;
+}
+
+void TimeReport::print(ostream& out) const {
+    double totalWall = 0, totalCpu = 0;
+
+    out << "\n===== Time report =====" << endl;
+    out << left << setw(12) << "Phase" << right << setw(14) << "Wall (ms)" << setw(14) << "CPU (ms)" << endl;
+    out << fixed << setprecision(3);
+    for (const Phase& phase : phases) {
+        out << left << setw(12) << phase.name << right
+            << setw(14) << phase.wallSeconds * 1000
+            << setw(14) << phase.cpuSeconds * 1000 << endl;
+        totalWall += phase.wallSeconds;
+        totalCpu += phase.cpuSeconds;
+    }
+    out << left << setw(12) << "total" << right
+        << setw(14) << totalWall * 1000 << setw(14) << totalCpu * 1000 << endl;
+    out << "(parse includes scanning: the parser pulls tokens from the scanner)" << endl;
+
+    out << setprecision(0);
+    out << "\nThroughput:" << endl;
+    out << "  scan:    " << perSecond(tokens, phaseWall("scan")) << " tokens/s, "
+        << perSecond(sourceBytes, phaseWall("scan")) / 1e6 << " MB/s" << endl;
+    out << "  parse:   " << perSecond(astNodes, phaseWall("parse")) << " AST nodes/s" << endl;
+    out << "  codegen: " << perSecond(asmLines, phaseWall("codegen")) << " asm lines/s" << endl;
+
+    out << "\nCounts: " << sourceBytes << " bytes, " << tokens << " tokens, "
+        << astNodes << " AST nodes, " << asmLines << " asm lines" << endl;
+    out << "AST arena: " << arenaBytes / 1024 << " KB in " << arenaChunks << " chunks ("
+        << setprecision(3) << arenaChunkSeconds * 1000 << " ms in chunk allocation)" << endl;
+
+    out << "\nAST node kinds (after parse):" << endl;
+    for (int i = 0; i < NODE_KIND_COUNT; i++) {
+        if (nodeKindCounts[i] == 0) continue;
+        out << "  " << left << setw(14) << nodeKindName((NodeKind)i) << right
+            << setw(10) << nodeKindCounts[i] << endl;
+    }
+
+    out << "\nPeak RSS: " << peakRssKB() << " KB" << endl;
+    out.unsetf(ios::floatfield);
+    out << setprecision(6);
+}
+
+void TimeReport::printJson(ostream& out) const {
+    out << fixed << setprecision(6);
+    out << "{\n";
+    out << "  \"phases\": [\n";
+    for (size_t i = 0; i < phases.size(); i++) {
+        const Phase& phase = phases[i];
+        out << "    {\"name\": \"" << phase.name << "\", \"wall_seconds\": " << phase.wallSeconds
+            << ", \"cpu_seconds\": " << phase.cpuSeconds << "}"
+            << (i + 1 < phases.size() ? "," : "") << "\n";
+    }
+    out << "  ],\n";
+    out << "  \"parse_includes_scan\": true,\n";
+
+    out << "  \"counts\": {\"source_bytes\": " << sourceBytes << ", \"tokens\": " << tokens
+        << ", \"ast_nodes\": " << astNodes << ", \"asm_lines\": " << asmLines << "},\n";
+    out << "  \"arena\": {\"bytes\": " << arenaBytes << ", \"chunks\": " << arenaChunks
+        << ", \"chunk_alloc_seconds\": " << arenaChunkSeconds << "},\n";
+
+    out << setprecision(1);
+    out << "  \"throughput\": {\"tokens_per_second\": " << perSecond(tokens, phaseWall("scan"))
+        << ", \"scan_bytes_per_second\": " << perSecond(sourceBytes, phaseWall("scan"))
+        << ", \"ast_nodes_per_second\": " << perSecond(astNodes, phaseWall("parse"))
+        << ", \"asm_lines_per_second\": " << perSecond(asmLines, phaseWall("codegen")) << "},\n";
+
+    out << "  \"node_kinds\": {";
+    bool first = true;
+    for (int i = 0; i < NODE_KIND_COUNT; i++) {
+        if (nodeKindCounts[i] == 0) continue;
+        out << (first ? "" : ", ") << "\"" << nodeKindName((NodeKind)i) << "\": " << nodeKindCounts[i];
+        first = false;
+    }
+    out << "},\n";
+
+    out << "  \"peak_rss_kb\": " << peakRssKB() << "\n";
+    out << "}" << endl;
+    out.unsetf(ios::floatfield);
+    out << setprecision(6);
+}
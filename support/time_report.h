@@ -0,0 +1,60 @@
+#ifndef TIME_REPORT_H
+#define TIME_REPORT_H
+
+#include "../parser/ast.h"
+#include <string>
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+using namespace std;
+
+// ========== REPORTE DE TIEMPOS (--time-report) ==========
+// Mide tiempo real (wall) y de CPU por fase, y junta los contadores
+// necesarios para calcular el throughput de cada fase.
+class TimeReport {
+public:
+    struct Phase {
+        string name;
+        double wallSeconds;
+        double cpuSeconds;
+    };
+
+    // Contadores que llena main
+    long sourceBytes = 0;
+    long tokens = 0;
+    long astNodes = 0;
+    long asmLines = 0;
+    long nodeKindCounts[NODE_KIND_COUNT] = {};
+
+    // Estadísticas de la arena del AST
+    long arenaBytes = 0;
+    long arenaChunks = 0;
+    double arenaChunkSeconds = 0;
+
+    // Abre una fase; la fase anterior (si había) se cierra sola
+    void startPhase(const string& name);
+    void endPhase();
+
+    // Cuenta los nodos del AST por tipo (recorre todo el árbol)
+    void countNodes(Program* program);
+
+    void print(ostream& out) const;
+    void printJson(ostream& out) const;
+
+    // Pico de memoria residente del proceso, en KB (0 si no se puede medir)
+    static long peakRssKB();
+
+private:
+    vector<Phase> phases;
+    bool phaseOpen = false;
+    chrono::steady_clock::time_point wallStart;
+    double cpuStart = 0;
+
+    static double cpuSecondsNow();
+    double phaseWall(const string& name) const;
+    void countExpr(Expr* expr);
+    void countStmt(Stmt* stmt);
+};
+
+#endif
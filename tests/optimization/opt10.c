@@ -0,0 +1,32 @@
+// Optimización 10: Vectorización de a[i] * 4
+// La reducción de fuerza deja a[i] * 4 como a[i] << 2 antes de vectorizar:
+// el loop de enteros tiene que salir con pslld y el de floats con mulps
+#include <stdio.h>
+
+int main() {
+    int a[20];
+    int c[20];
+    float x[20];
+    float y[20];
+    int i;
+
+    for (i = 0; i < 20; i = i + 1) {
+        a[i] = i - 5;
+        x[i] = (float)i * 0.25;
+    }
+
+    for (i = 0; i < 20; i = i + 1) {
+        c[i] = a[i] * 4;
+    }
+
+    for (i = 0; i < 20; i = i + 1) {
+        y[i] = x[i] * 4;
+    }
+
+    printf("%d\n", c[0]);
+    printf("%d\n", c[19]);
+    printf("%.2f\n", y[3]);
+    printf("%.2f\n", y[18]);
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+// Optimización 11: Recursión de cola con acumulador long
+// fact(n - 1, acc * n) se convierte en un loop que reasigna los
+// parámetros: acc tiene que guardarse con sus 64 bits
+#include <stdio.h>
+
+long fact(long n, long acc) {
+    if (n <= 1) {
+        return acc;
+    }
+
+    return fact(n - 1, acc * n);
+}
+
+int main() {
+    long values[2];
+
+    values[0] = fact(20, 1);
+    values[1] = values[0] / 1000;
+
+    printf("%ld\n", fact(20, 1));
+    printf("%ld\n", values[1]);
+    printf("%ld\n", fact(5, 1));
+
+    return 0;
+}
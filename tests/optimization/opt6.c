@@ -0,0 +1,37 @@
+// Optimización 6: Value numbering
+// (float)i se calcula una vez por vuelta; arr[i] * arr[i] se reusa,
+// salvo después de escribir arr[i]
+#include <stdio.h>
+
+int main() {
+    float a[40];
+    float b[40];
+    int arr[10];
+    int i;
+    int x;
+    int y;
+    int z;
+
+    for (i = 0; i < 40; i = i + 1) {
+        a[i] = (float)i * 0.5;
+        b[i] = 40.0 - (float)i;
+    }
+
+    for (i = 0; i < 10; i = i + 1) {
+        arr[i] = i + 1;
+    }
+
+    i = 3;
+    x = arr[i] * arr[i];
+    y = arr[i] * arr[i] + 1;
+    arr[i] = 7;
+    z = arr[i] * arr[i];
+
+    printf("%.2f\n", a[3]);
+    printf("%.2f\n", b[3]);
+    printf("%d\n", x);
+    printf("%d\n", y);
+    printf("%d\n", z);
+
+    return 0;
+}
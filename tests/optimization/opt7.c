@@ -0,0 +1,62 @@
+// Optimización 7: Propagación de constantes condicional
+// Un valor es constante solo si lo es por todos los caminos que llegan:
+// en el merge de un if y por el back-edge de un loop
+#include <stdio.h>
+
+int merge(int n) {
+    int x;
+    int y;
+    int z;
+
+    x = 4;
+    if (n > 0) {
+        y = x + 1;
+        z = 10;
+    } else {
+        y = 5;
+        z = 20;
+    }
+
+    // y vale 5 por las dos ramas; z no es constante
+    return y * 100 + z;
+}
+
+int loop(int n) {
+    int i;
+    int k;
+    int c;
+    int s;
+
+    i = 0;
+    k = 1;
+    c = 7;
+    s = 0;
+    while (i < n) {
+        // c se reasigna con el mismo valor: sigue constante; k no
+        s = s + c + k;
+        c = 7;
+        k = k + 1;
+        i = i + 1;
+    }
+
+    return s * 10 + k;
+}
+
+int main() {
+    int flag;
+
+    printf("%d\n", merge(3));
+    printf("%d\n", merge(0));
+    printf("%d\n", loop(4));
+    printf("%d\n", loop(0));
+
+    // Rama que nunca se ejecuta
+    flag = 0;
+    if (flag > 0) {
+        printf("%d\n", 1);
+    } else {
+        printf("%d\n", 2);
+    }
+
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Optimización 8: Eliminación de código muerto con liveness
+// x = 1 no se lee: las dos ramas del if la sobrescriben. y = 5 sí se
+// lee cuando el if no entra, así que se mantiene
+#include <stdio.h>
+
+int pick(int n) {
+    int x;
+    int y;
+    int unused;
+
+    x = 1;
+    y = 5;
+    unused = n * 3;
+    if (n > 0) {
+        x = 2;
+        y = 6;
+    } else {
+        x = 3;
+    }
+
+    return x * 10 + y;
+}
+
+int blocks(int n) {
+    int total;
+
+    total = 0;
+    if (n > 0) {
+        int a;
+        a = n + 1;
+        total = total + a;
+    } else {
+        int b;
+        b = n - 1;
+        total = total + b;
+    }
+
+    return total;
+}
+
+int main() {
+    printf("%d\n", pick(4));
+    printf("%d\n", pick(0));
+    printf("%d\n", blocks(4));
+    printf("%d\n", blocks(0));
+
+    return 0;
+}
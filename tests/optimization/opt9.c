@@ -0,0 +1,53 @@
+// Optimización 9: Código invariante fuera de los loops
+// 100 / d no cambia en el loop pero no se puede sacar: con n = 0 el
+// cuerpo no corre y d puede ser 0. En m[i][j] dentro del while, i * 5 se
+// calcula una vez por fila
+#include <stdio.h>
+
+int divide(int n, int d) {
+    int s;
+    int i;
+
+    s = 0;
+    for (i = 0; i < n; i = i + 1) {
+        s = s + 100 / d + i;
+    }
+
+    return s;
+}
+
+int grid(int rows) {
+    int m[4][5];
+    int i;
+    int j;
+    int s;
+
+    for (i = 0; i < rows; i = i + 1) {
+        for (j = 0; j < 5; j = j + 1) {
+            m[i][j] = i * 10 + j;
+        }
+    }
+
+    s = 0;
+    for (i = 0; i < rows; i = i + 1) {
+        j = 0;
+        while (j < 5) {
+            s = s + m[i][j] * (j + 1);
+            j = j + 1;
+        }
+    }
+
+    return s;
+}
+
+int main() {
+    int k;
+
+    // Argumentos que cambian en cada vuelta: divide(0, 0), divide(3, 5)
+    for (k = 0; k < 2; k = k + 1) {
+        printf("%d\n", divide(k * 3, k * 5));
+        printf("%d\n", grid(k * 2 + 2));
+    }
+
+    return 0;
+}
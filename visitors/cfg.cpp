@@ -0,0 +1,189 @@
+#include "cfg.h"
+
+// ========== LOCALES ==========
+
+void LocalSlots::clear() {
+    slots.clear();
+    entries.clear();
+}
+
+void LocalSlots::declareFunction(FunctionDecl* func, const SymbolSet& globals) {
+    clear();
+    globalSymbols = &globals;
+    for (const Param& param : func->parameters) {
+        declare(param.symbol, param.type, nullptr);
+    }
+    declareLocals(func->body.get());
+}
+
+void LocalSlots::declare(SymbolId symbol, DataType type, const VarDecl* array) {
+    if (globalSymbols && globalSymbols->contains(symbol)) return;
+    vector<int> shape;
+    if (array) shape.assign(array->dimensions.begin(), array->dimensions.end());
+
+    if (int* slot = slots.find(symbol)) {
+        // Locales con el mismo nombre en distintos scopes comparten símbolo
+        Slot& entry = entries[*slot];
+        if (entry.type != type || entry.isArray != (array != nullptr) || entry.dimensions != shape) {
+            entry.consistent = false;
+        }
+        return;
+    }
+    slots[symbol] = (int)entries.size();
+    entries.push_back({type, array != nullptr, true, move(shape)});
+}
+
+void LocalSlots::declareLocals(Stmt* stmt) {
+    if (!stmt) return;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            declare(varDecl->symbol, varDecl->type, varDecl->isArray ? varDecl : nullptr);
+            break;
+        }
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                declareLocals(s.get());
+            }
+            break;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            declareLocals(ifStmt->thenBranch.get());
+            declareLocals(ifStmt->elseBranch.get());
+            break;
+        }
+        case NodeKind::WhileStmt:
+            declareLocals(static_cast<WhileStmt*>(stmt)->body.get());
+            break;
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            declareLocals(forStmt->initializer.get());
+            declareLocals(forStmt->body.get());
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+int LocalSlots::slotOf(SymbolId symbol) {
+    int* slot = slots.find(symbol);
+    return slot && entries[*slot].consistent ? *slot : -1;
+}
+
+// ========== GRAFO ==========
+
+void ControlFlowGraph::clear() {
+    blocks.clear();
+    nodeBlocks.clear();
+    locals.clear();
+}
+
+void ControlFlowGraph::build(FunctionDecl* func, const SymbolSet& globals) {
+    clear();
+    locals.declareFunction(func, globals);
+    int entry = newBlock();
+    if (func->body) add(func->body.get(), entry);
+}
+
+int ControlFlowGraph::blockOf(const void* node) const {
+    auto it = nodeBlocks.find(node);
+    return it != nodeBlocks.end() ? it->second : -1;
+}
+
+int ControlFlowGraph::newBlock() {
+    blocks.emplace_back();
+    return (int)blocks.size() - 1;
+}
+
+void ControlFlowGraph::link(int from, int to) {
+    if (from >= 0) blocks[from].next[0] = to;
+}
+
+int ControlFlowGraph::add(Stmt* stmt, int current) {
+    if (!stmt) return current;
+    nodeBlocks[stmt] = current;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl:
+        case NodeKind::AssignStmt:
+        case NodeKind::ExprStmt:
+            blocks[current].actions.push_back({stmt, nullptr});
+            return current;
+
+        case NodeKind::ReturnStmt:
+            blocks[current].actions.push_back({stmt, nullptr});
+            return -1;
+
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                // Lo que sigue a un return queda en un bloque sin predecesores
+                if (current < 0) current = newBlock();
+                current = add(s.get(), current);
+            }
+            return current;
+
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            int thenBlock = newBlock();
+            int elseBlock = newBlock();
+            blocks[current].condition = ifStmt->condition.get();
+            blocks[current].next[0] = thenBlock;
+            blocks[current].next[1] = elseBlock;
+            nodeBlocks[ifStmt->condition.get()] = current;
+
+            int thenEnd = add(ifStmt->thenBranch.get(), thenBlock);
+            int elseEnd = add(ifStmt->elseBranch.get(), elseBlock);
+            if (thenEnd < 0 && elseEnd < 0) return -1;
+            int join = newBlock();
+            link(thenEnd, join);
+            link(elseEnd, join);
+            return join;
+        }
+
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            int header = newBlock();
+            int body = newBlock();
+            int exit = newBlock();
+            link(current, header);
+            blocks[header].condition = whileStmt->condition.get();
+            blocks[header].next[0] = body;
+            blocks[header].next[1] = exit;
+            nodeBlocks[whileStmt->condition.get()] = header;
+
+            link(add(whileStmt->body.get(), body), header);
+            return exit;
+        }
+
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            current = add(forStmt->initializer.get(), current);
+            int header = newBlock();
+            int body = newBlock();
+            int exit = newBlock();
+            link(current, header);
+            blocks[header].next[0] = body;
+            if (forStmt->condition) {
+                blocks[header].condition = forStmt->condition.get();
+                blocks[header].next[1] = exit;
+                nodeBlocks[forStmt->condition.get()] = header;
+            }
+
+            int bodyEnd = add(forStmt->body.get(), body);
+            if (bodyEnd >= 0) {
+                int increment = newBlock();
+                link(bodyEnd, increment);
+                if (forStmt->increment) {
+                    blocks[increment].actions.push_back({nullptr, forStmt->increment.get()});
+                }
+                link(increment, header);
+            }
+            return exit;
+        }
+
+        default:
+            return current;
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef CFG_H
+#define CFG_H
+
+#include "../parser/ast.h"
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ========== LOCALES DE UNA FUNCIÓN ==========
+// Parámetros y locales de una función numerados en slots 0, 1, 2..., para
+// los análisis que guardan un estado por variable. Las globales no tienen
+// slot. Locales con el mismo nombre en distintos scopes comparten símbolo:
+// si se declaran con otro tipo u otra forma (escalar o array, dimensiones)
+// el slot queda inconsistente y slotOf() no lo devuelve.
+class LocalSlots {
+public:
+    // Parámetros y locales de la función (descarta la anterior)
+    void declareFunction(FunctionDecl* func, const SymbolSet& globals);
+
+    // Una declaración más (array: su VarDecl; nullptr si es escalar)
+    void declare(SymbolId symbol, DataType type, const VarDecl* array);
+    void clear();
+
+    // Slot del símbolo (-1 si no es local o es inconsistente)
+    int slotOf(SymbolId symbol);
+
+    int size() const { return (int)entries.size(); }
+    DataType type(int slot) const { return entries[slot].type; }
+    bool isArray(int slot) const { return entries[slot].isArray; }
+    const vector<int>& dimensions(int slot) const { return entries[slot].dimensions; }
+
+private:
+    struct Slot {
+        DataType type;
+        bool isArray;
+        bool consistent;
+        vector<int> dimensions;
+    };
+
+    SymbolMap<int> slots;
+    vector<Slot> entries;
+    const SymbolSet* globalSymbols = nullptr;
+
+    void declareLocals(Stmt* stmt);
+};
+
+// ========== GRAFO DE CONTROL ==========
+// Bloques básicos de una función, armados sobre el AST (sin copiarlo): cada
+// bloque es una lista de statements simples (VarDecl, AssignStmt, ExprStmt,
+// ReturnStmt o el incremento de un for) y termina, si corresponde, en un
+// salto condicional. Los if, while y for se parten así:
+//
+//   if:    cond -> then / else -> join
+//   while: header(cond) -> body -> header, header -> exit
+//   for:   init; header(cond) -> body -> increment -> header, header -> exit
+//
+// Lo usan los análisis de flujo de datos de una función (ConstantPropagation
+// hacia adelante, LivenessAnalysis hacia atrás), con las variables
+// numeradas en locals.
+class ControlFlowGraph {
+public:
+    // Statement simple o incremento de un for (stmt == nullptr)
+    struct Action {
+        Stmt* stmt;
+        Expr* expr;
+    };
+
+    struct BasicBlock {
+        vector<Action> actions;
+        Expr* condition = nullptr;   // Salto condicional al final (o nada)
+        int next[2] = {-1, -1};      // Verdadero / falso; sin condición solo next[0]
+    };
+
+    // blocks[0] es la entrada
+    vector<BasicBlock> blocks;
+
+    // Parámetros y locales de la función
+    LocalSlots locals;
+
+    // Arma el grafo del cuerpo de la función (descarta el anterior)
+    void build(FunctionDecl* func, const SymbolSet& globals);
+    void clear();
+
+    // Bloque de un statement o de una condición (-1 si no está en el grafo)
+    int blockOf(const void* node) const;
+
+private:
+    unordered_map<const void*, int> nodeBlocks;
+
+    int newBlock();
+    void link(int from, int to);
+
+    // Agrega el statement desde el bloque `current`; devuelve el bloque
+    // donde sigue el control (-1 después de un return)
+    int add(Stmt* stmt, int current);
+};
+
+#endif
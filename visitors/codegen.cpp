@@ -1,10 +1,27 @@
 #include "codegen.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
 CodeGen::CodeGen() : stackOffset(0), labelCounter(0), lastExprWasFloat(false) {}
 
 string CodeGen::getOutput() {
-    return output.str();
+    // Concatenar todas las secciones una sola vez
+    string data = dataSection.str();
+    string rodata = rodataSection.str();
+    string bss = bssSection.str();
+
+    size_t total = data.size() + rodata.size() + bss.size() + 64;
+    for (const string& chunk : textChunks) total += chunk.size();
+
+    string result;
+    result.reserve(total);
+    result += "section .data\n" + data + "\n";
+    result += "section .rodata\n" + rodata + "\n";
+    result += "section .bss\n" + bss + "\n";
+    result += "section .text\n";
+    for (const string& chunk : textChunks) result += chunk;
+    return result;
 }
 
 string CodeGen::newLabel(string prefix) {
@@ -19,19 +36,156 @@ void CodeGen::emitLabel(string label) {
     output << label << ":\n";
 }
 
+// Pasa el código acumulado en output a la sección .text (después del peephole)
+void CodeGen::flushText() {
+    textChunks.push_back(peephole.optimize(output.str()));
+    output.str("");
+}
+
+// ========== STACK DE REGISTROS ==========
+
+// Scratch para valores intermedios: los que RegisterAllocator no asignó en
+// esta función. rsi/rdi solo se usan al preparar un call, y las expresiones
+// con calls nunca guardan valores en registros (ver registerNeed).
+void CodeGen::resetScratchRegs() {
+    const vector<string>& used = regAlloc.usedRegisters();
+    auto isFree = [&](const string& reg) { return find(used.begin(), used.end(), reg) == used.end(); };
+
+    intScratch.clear();
+    for (const char* reg : {"rsi", "rdi", "r8", "r9", "r10", "r11"}) {
+        if (isFree(reg)) intScratch.push_back(reg);
+    }
+    floatScratch.clear();
+    for (int n = 2; n < 16; n++) {
+        string reg = "xmm" + to_string(n);
+        if (isFree(reg)) floatScratch.push_back(reg);
+    }
+    intScratchUsed = 0;
+    floatScratchUsed = 0;
+    while (!regStack.empty()) regStack.pop();
+}
+
 string CodeGen::allocReg(DataType type) {
-    // Para float usamos registros XMM, para enteros usamos RAX
-    if (type == DataType::FLOAT) {
-        lastExprWasFloat = true;
-        return "xmm0";
+    bool isFloat = type == DataType::FLOAT;
+    vector<string>& pool = isFloat ? floatScratch : intScratch;
+    size_t& used = isFloat ? floatScratchUsed : intScratchUsed;
+    if (used == pool.size()) return "";
+
+    regStack.push(pool[used++]);
+    return regStack.top();
+}
+
+void CodeGen::freeReg(string reg) {
+    // Se liberan en orden inverso (es un stack)
+    regStack.pop();
+    if (reg.rfind("xmm", 0) == 0) {
+        floatScratchUsed--;
     } else {
-        lastExprWasFloat = false;
-        return "rax";
+        intScratchUsed--;
     }
 }
 
-void CodeGen::freeReg(string reg) {
-    // Por simplicidad, no gestionamos pool de registros
+string CodeGen::saveTemp(bool isFloat, int need) {
+    string reg;
+    if (need < RegisterAllocator::UNBOUNDED_NEED) {
+        reg = allocReg(isFloat ? DataType::FLOAT : DataType::LONG);
+    }
+    if (reg.empty()) {
+        tempsSpilled++;
+        if (isFloat) {
+            emit("sub rsp, 8");
+            emit("movss [rsp], xmm0");
+        } else {
+            emit("push rax");
+        }
+        return "";
+    }
+    tempsInRegisters++;
+    emit(isFloat ? "movaps " + reg + ", xmm0" : "mov " + reg + ", rax");
+    return reg;
+}
+
+string CodeGen::tempOperand(const string& saved, bool isFloat, const string& scratch) {
+    if (saved.empty()) {
+        if (isFloat) {
+            emit("movss " + scratch + ", [rsp]");
+            emit("add rsp, 8");
+        } else {
+            emit("pop " + scratch);
+        }
+        return scratch;
+    }
+    freeReg(saved);
+    return saved;
+}
+
+void CodeGen::restoreTemp(const string& saved, bool isFloat, const string& target) {
+    string value = tempOperand(saved, isFloat, target);
+    if (value != target) {
+        emit((isFloat ? "movaps " : "mov ") + target + ", " + value);
+    }
+}
+
+// ========== VARIABLES EN REGISTROS ==========
+
+string CodeGen::varOperand(const VarInfo& var) {
+    if (var.reg.empty()) {
+        return "[rbp - " + to_string(var.offset) + "]";
+    }
+    if (var.type == DataType::FLOAT || var.type == DataType::LONG) {
+        return var.reg;
+    }
+    return reg32(var.reg);
+}
+
+// Nombre de 32 bits de un registro de 64 (rbx -> ebx, r12 -> r12d)
+string CodeGen::reg32(const string& reg) {
+    if (reg[1] >= '0' && reg[1] <= '9') {
+        return reg + "d";
+    }
+    return "e" + reg.substr(1);
+}
+
+// Operandos de "db" para un literal tal cual está en el fuente:
+// "hola\n" -> "hola", 10, 0
+string CodeGen::nasmStringLiteral(string_view escaped) {
+    string nasmStr = "";
+    bool hasNewline = false;
+
+    // Procesar caracteres especiales
+    for (size_t i = 0; i < escaped.length(); i++) {
+        if (escaped[i] == '\\' && i + 1 < escaped.length()) {
+            if (escaped[i+1] == 'n') {
+                // Newline - lo manejamos después del string
+                hasNewline = true;
+                i++;  // Saltar el
+                continue;
+            } else if (escaped[i+1] == '\\') {
+                nasmStr += "\\\\";
+                i++;  // Saltar el segundo '\'
+            } else if (escaped[i+1] == '"') {
+                nasmStr += "\\\"";
+                i++;  // Saltar el '"'
+            } else if (escaped[i+1] == 't') {
+                nasmStr += "\\t";
+                i++;
+            } else {
+                nasmStr += escaped[i];
+            }
+        } else if (escaped[i] == '"') {
+            nasmStr += "\\\"";
+        } else {
+            nasmStr += escaped[i];
+        }
+    }
+
+    // Construir los operandos NASM
+    string result = "\"" + nasmStr + "\"";
+    if (hasNewline) {
+        result += ", 10";  // Agregar newline como byte separado
+    }
+    result += ", 0";
+    return result;
 }
 
 void CodeGen::emitTypeConversion(DataType from, DataType to, string reg) {
@@ -67,10 +221,15 @@ void CodeGen::emitFunctionProlog(string funcName, int stackSize) {
     }
 }
 
-void CodeGen::emitFunctionEpilog() {
+// exit: "ret", o "jmp f" para un tail call (f reusa el lugar del frame)
+void CodeGen::emitFunctionEpilog(const string& exit) {
+    // Restaurar los callee-saved que usan las variables en registros
+    for (auto& saved : savedRegs) {
+        emit("mov " + saved.first + ", [rbp - " + to_string(saved.second) + "]");
+    }
     emit("mov rsp, rbp");
     emit("pop rbp");
-    emit("ret");
+    emit(exit);
 }
 
 int CodeGen::calculateArrayOffset(vector<int>& dimensions, int dimIndex) {
@@ -81,117 +240,512 @@ int CodeGen::calculateArrayOffset(vector<int>& dimensions, int dimIndex) {
     return offset;
 }
 
-void CodeGen::generate(Program* program) {
-    // Header del archivo ensamblador
-    output << "section .data\n";
-    output << "    fmt_int: db \"%d\", 10, 0\n";
-    output << "    fmt_float: db \"%.2f\", 10, 0\n";
-    output << "    fmt_long: db \"%ld\", 10, 0\n";
-    output << "\n";
+// ========== ELEMENTOS DE ARRAYS ==========
 
-    output << "section .bss\n";
-    output << "\n";
+static int elementSize(DataType type) {
+    return type == DataType::LONG ? 8 : 4;
+}
+
+// "[rbp + rax*4 - 40]": evalúa los índices y deja el índice lineal en rax
+string CodeGen::emitElementAddress(VarInfo* array, ExprList& indices) {
+    if (indices.size() == 1) {
+        visit(indices[0].get());
+    } else {
+        // arr[i][j] en arr[3][4] = arr[i * 4 + j]
+        visit(indices[0].get());
+        emit("imul rax, " + to_string(array->dimensions[1]));
+        string saved = saveTemp(false, RegisterAllocator::registerNeed(indices[1].get()));
+
+        visit(indices[1].get());
+        emit("add rax, " + tempOperand(saved, false, "rcx"));
+    }
+    return "[rbp + rax*" + to_string(elementSize(array->type)) + " - " + to_string(array->offset) + "]";
+}
+
+// Operando de un acceso reducido por emitStridedPointers: "[rsi + 8]"
+string CodeGen::stridedOperand(const void* node) {
+    auto it = stridedAccesses.find(node);
+    if (it == stridedAccesses.end()) return "";
+
+    const string& pointer = it->second.first;
+    int displacement = it->second.second;
+    if (displacement > 0) return "[" + pointer + " + " + to_string(displacement) + "]";
+    if (displacement < 0) return "[" + pointer + " - " + to_string(-displacement) + "]";
+    return "[" + pointer + "]";
+}
 
-    output << "section .text\n";
+void CodeGen::emitElementLoad(DataType type, const string& address) {
+    if (type == DataType::FLOAT) {
+        emit("movss xmm0, " + address);
+        lastExprWasFloat = true;
+    } else if (type == DataType::LONG) {
+        emit("mov rax, " + address);
+        lastExprWasFloat = false;
+    } else {
+        emit("movsxd rax, dword " + address);
+        lastExprWasFloat = false;
+    }
+}
+
+// Reducción de fuerza de un for ya inicializado. Los accesos con los mismos
+// términos variables (arr[i + 1] y arr[i - 1]) comparten un puntero que se
+// calcula una vez acá y avanza `stride` bytes por iteración; cada acceso
+// queda como [puntero + desplazamiento]. Si el contador solo se usa en esos
+// accesos y en la condición "i op N", también se calcula el puntero final
+// y la condición del loop pasa a compararlos (lftrPointer ? lftrEnd).
+// pointers: (registro, stride) de cada puntero, para avanzarlos y liberarlos.
+bool CodeGen::emitStridedPointers(ForStmt* node, vector<pair<string, int>>& pointers, string& lftrPointer, string& lftrEnd) {
+    pointers.clear();
+    lftrPointer.clear();
+    lftrEnd.clear();
+
+    InductionAnalysis::Loop loop;
+    if (!induction.analyze(node, loop)) return false;
+
+    VarInfo* counter = localVars.find(loop.counter);
+    if (!counter || counter->isArray || counter->type != DataType::INT) return false;
+
+    // Un grupo por arreglo + términos variables de cada índice
+    struct Group {
+        VarInfo* array;
+        vector<InductionAnalysis::IndexTerm> terms;  // Solo usesCounter / var
+        vector<const InductionAnalysis::Access*> accesses;
+    };
+    vector<Group> groups;
+    bool allStrided = true;
+
+    for (const InductionAnalysis::Access& access : loop.accesses) {
+        VarInfo* array = localVars.find(access.array);
+        bool valid = array && array->isArray && array->dimensions.size() == access.indices.size();
+        for (const InductionAnalysis::IndexTerm& term : access.indices) {
+            if (!valid || !term.var || term.usesCounter) continue;
+            VarInfo* var = localVars.find(term.var->symbol);
+            valid = var && !var->isArray && var->type != DataType::FLOAT;
+        }
+        if (!valid) {
+            allStrided = false;
+            continue;
+        }
+
+        Group* group = nullptr;
+        for (Group& candidate : groups) {
+            if (candidate.array != array) continue;
+            bool same = true;
+            for (size_t k = 0; k < access.indices.size(); k++) {
+                const InductionAnalysis::IndexTerm& a = candidate.terms[k];
+                const InductionAnalysis::IndexTerm& b = access.indices[k];
+                if (a.usesCounter != b.usesCounter || (a.var == nullptr) != (b.var == nullptr) ||
+                    (a.var && a.var->symbol != b.var->symbol)) {
+                    same = false;
+                }
+            }
+            if (same) {
+                group = &candidate;
+                break;
+            }
+        }
+        if (!group) {
+            groups.push_back({array, access.indices, {}});
+            group = &groups.back();
+        }
+        group->accesses.push_back(&access);
+    }
+
+    // Dirección de los términos variables de un grupo; el contador vale rax
+    // o `bound` (para el puntero final)
+    auto emitBase = [&](const Group& group, const string& reg, const int* bound) {
+        auto emitTerm = [&](const InductionAnalysis::IndexTerm& term) {
+            if (term.usesCounter && bound) {
+                emit("mov rax, " + to_string(*bound));
+            } else if (term.var) {
+                visit(term.var);
+            } else {
+                emit("xor eax, eax");
+            }
+        };
+        emitTerm(group.terms[0]);
+        if (group.terms.size() == 2) {
+            emit("imul rax, " + to_string(group.array->dimensions[1]));
+            emit("mov " + reg + ", rax");
+            emitTerm(group.terms[1]);
+            emit("add rax, " + reg);
+        }
+        emit("lea " + reg + ", [rbp + rax*" + to_string(elementSize(group.array->type)) +
+             " - " + to_string(group.array->offset) + "]");
+    };
+
+    for (const Group& group : groups) {
+        string reg = allocReg(DataType::LONG);
+        if (reg.empty()) {
+            allStrided = false;
+            break;
+        }
+        int size = elementSize(group.array->type);
+        int cols = group.terms.size() == 2 ? group.array->dimensions[1] : 1;
+        int perCounter = group.terms[0].usesCounter ? cols : 0;
+        if (group.terms.size() == 2 && group.terms[1].usesCounter) perCounter++;
+        pointers.push_back({reg, perCounter * size * loop.step});
+        emitBase(group, reg, nullptr);
+
+        for (const InductionAnalysis::Access* access : group.accesses) {
+            int constant = access->indices[0].constant;
+            if (access->indices.size() == 2) {
+                constant = constant * cols + access->indices[1].constant;
+            }
+            stridedAccesses[access->node] = {reg, constant * size};
+            stridedAccessCount++;
+        }
+    }
+
+    // Reemplazo de la condición: el contador deja de existir
+    TokenType op = loop.compareOp;
+    bool lftrOp = op == TokenType::LT || op == TokenType::LE || op == TokenType::GT ||
+                  op == TokenType::GE || op == TokenType::NE;
+    if (loop.counterOnlyIndexes && allStrided && lftrOp && !pointers.empty()) {
+        lftrEnd = allocReg(DataType::LONG);
+        if (!lftrEnd.empty()) {
+            lftrPointer = pointers[0].first;
+            emitBase(groups[0], lftrEnd, &loop.bound);
+            countersRemoved++;
+        }
+    }
+    return !pointers.empty();
+}
+
+void CodeGen::generate(Program* program) {
+    // Constantes fijas (formatos de printf)
+    rodataSection << "    fmt_int: db \"%d\", 10, 0\n";
+    rodataSection << "    fmt_float: db \"%.2f\", 10, 0\n";
+    rodataSection << "    fmt_long: db \"%ld\", 10, 0\n";
+
+    // Header de .text
     output << "    extern printf\n";
     output << "    global main\n";
     output << "\n";
+    flushText();
+
+    // Las tablas de símbolos se indexan por SymbolId
+    int symbolCount = program->symbols->size();
+    localVars.reserve(symbolCount);
+    globalVars.reserve(symbolCount);
+    functions.reserve(symbolCount);
 
     // Generar código para cada declaración
     for (auto& stmt : program->statements) {
-        stmt->accept(this);
+        visit(stmt.get());
+        flushText();
+    }
+}
+
+// ========== VECTORIZACIÓN ==========
+// Loops de LoopVectorizer (ver vectorizer.h). El contador vive en rax y el
+// límite en rcx durante el loop vectorial; los valores van en los xmm
+// scratch (ymm con AVX2). Las variables invariantes se replican en un
+// registro antes del loop y las constantes se leen de .rodata.
+
+// Valor constante de una hoja: 5, 2.5, -3
+static bool vectorConstant(Expr* expr, double& value, bool& isFloat) {
+    bool negative = false;
+    if (UnaryOp* unary = nodeCast<UnaryOp>(expr)) {
+        negative = true;
+        expr = unary->operand.get();
+    }
+    if (IntLiteral* literal = nodeCast<IntLiteral>(expr)) {
+        value = literal->value;
+        isFloat = false;
+    } else if (FloatLiteral* literal = nodeCast<FloatLiteral>(expr)) {
+        value = literal->value;
+        isFloat = true;
+    } else {
+        return false;
+    }
+    if (negative) value = -value;
+    return true;
+}
+
+// Potencia de 2 (para multiplicar enteros con un shift)
+static int powerOfTwo(double value) {
+    for (int shift = 0; shift < 31; shift++) {
+        if (value == (double)(1 << shift)) return shift;
+    }
+    return -1;
+}
+
+string CodeGen::vectorReg(const string& reg) {
+    if (useAVX2 && reg.rfind("xmm", 0) == 0) return "ymm" + reg.substr(3);
+    return reg;
+}
+
+// op dst, src (SSE) o vop dst, dst, src (AVX)
+void CodeGen::emitVectorOp(const string& op, const string& dst, const string& src) {
+    if (useAVX2) {
+        emit("v" + op + " " + vectorReg(dst) + ", " + vectorReg(dst) + ", " + vectorReg(src));
+    } else {
+        emit(op + " " + dst + ", " + src);
+    }
+}
+
+void CodeGen::emitVectorMove(const string& op, const string& dst, const string& src) {
+    emit((useAVX2 ? "v" : "") + op + " " + vectorReg(dst) + ", " + vectorReg(src));
+}
+
+// Registros para calcular la expresión (UNBOUNDED_NEED si no se puede)
+int CodeGen::vectorNeed(Expr* expr) {
+    const int unsupported = RegisterAllocator::UNBOUNDED_NEED;
+    double value;
+    bool isFloatConstant;
+    if (vectorConstant(expr, value, isFloatConstant)) {
+        return isFloatConstant && !vectorFloat ? unsupported : 1;
+    }
+
+    BinaryOp* binary = nodeCast<BinaryOp>(expr);
+    if (!binary) return 1;  // Elemento de array o invariante
+
+    TokenType op = binary->op.type;
+    Expr* right = binary->right.get();
+    bool rightIsConstant = vectorConstant(right, value, isFloatConstant);
+    if (!vectorFloat && op == TokenType::DIVIDE) return unsupported;
+    if (!vectorFloat && op == TokenType::MULTIPLY && !useAVX2 &&
+        (!rightIsConstant || powerOfTwo(value) < 0)) {
+        return unsupported;  // SSE2 no tiene pmulld
+    }
+
+    int left = vectorNeed(binary->left.get());
+    int rightNeed = vectorNeed(right);
+    if (left >= unsupported || rightNeed >= unsupported) return unsupported;
+    // Constantes e invariantes se usan directo como operando
+    if (rightIsConstant || nodeCast<Variable>(right)) rightNeed = 0;
+    return max(left, 1 + rightNeed);
+}
+
+// Deja el valor en un operando: un registro propio (owned, hay que
+// liberarlo), un invariante replicado o una constante en memoria
+pair<string, bool> CodeGen::emitVectorExpr(Expr* expr) {
+    double value;
+    bool isFloatConstant;
+    if (vectorConstant(expr, value, isFloatConstant)) {
+        return {emitVectorConstant(value), false};
+    }
+
+    if (Variable* var = nodeCast<Variable>(expr)) {
+        for (auto& broadcast : vectorBroadcasts) {
+            if (broadcast.first == var->symbol) return {broadcast.second, false};
+        }
+    }
+
+    if (ArrayAccess* access = nodeCast<ArrayAccess>(expr)) {
+        VarInfo* array = localVars.find(access->arraySymbol);
+        int offset;
+        LoopVectorizer::counterOffset(access->indices[0].get(), vectorCounter, offset);
+        int displacement = array->offset - offset * 4;
+        string reg = allocReg(DataType::FLOAT);
+        string address = "[rbp + rax*4 " + string(displacement < 0 ? "+ " : "- ") +
+                         to_string(abs(displacement)) + "]";
+        emitVectorMove(vectorFloat ? "movups" : "movdqu", reg, address);
+        return {reg, true};
     }
+
+    BinaryOp* binary = static_cast<BinaryOp*>(expr);
+    TokenType op = binary->op.type;
+    pair<string, bool> left = emitVectorExpr(binary->left.get());
+    if (!left.second) {
+        string reg = allocReg(DataType::FLOAT);
+        emitVectorMove(vectorFloat ? "movaps" : "movdqa", reg, left.first);
+        left = {reg, true};
+    }
+
+    // x << n que dejó la reducción de fuerza: shift en enteros, y en
+    // floats multiplicar por 2^n (igual que el caso escalar)
+    if (op == TokenType::UNKNOWN) {
+        int amount = static_cast<IntLiteral*>(binary->right.get())->value;
+        if (vectorFloat) {
+            emitVectorOp("mulps", left.first, emitVectorConstant(1 << amount));
+        } else {
+            emitVectorOp("pslld", left.first, to_string(amount));
+        }
+        return left;
+    }
+
+    // Enteros por potencia de 2: shift
+    if (!vectorFloat && op == TokenType::MULTIPLY &&
+        vectorConstant(binary->right.get(), value, isFloatConstant) && powerOfTwo(value) >= 0) {
+        emitVectorOp("pslld", left.first, to_string(powerOfTwo(value)));
+        return left;
+    }
+
+    pair<string, bool> right = emitVectorExpr(binary->right.get());
+    string mnemonic;
+    switch (op) {
+        case TokenType::PLUS:     mnemonic = vectorFloat ? "addps" : "paddd"; break;
+        case TokenType::MINUS:    mnemonic = vectorFloat ? "subps" : "psubd"; break;
+        case TokenType::MULTIPLY: mnemonic = vectorFloat ? "mulps" : "pmulld"; break;
+        default:                  mnemonic = "divps"; break;
+    }
+    emitVectorOp(mnemonic, left.first, right.first);
+    if (right.second) freeReg(right.first);
+    return left;
+}
+
+// La constante replicada en todos los carriles; los floats van con sus
+// bits exactos, como en visitFloatLiteral
+string CodeGen::emitVectorConstant(double value) {
+    string element = to_string((int)value);
+    if (vectorFloat) {
+        float single = (float)value;
+        uint32_t bits;
+        memcpy(&bits, &single, sizeof(bits));
+        element = to_string(bits);
+    }
+    string label = newLabel("vec_const_");
+    int lanes = useAVX2 ? 8 : 4;
+    rodataSection << "    align " << lanes * 4 << "\n";
+    rodataSection << "    " << label << ": dd " << element;
+    for (int lane = 1; lane < lanes; lane++) rodataSection << ", " << element;
+    rodataSection << "\n";
+    return "[" + label + "]";
+}
+
+// Loop vectorial antes del for original, que queda como epílogo escalar
+// para las últimas iteraciones (menos que el ancho del vector). Los
+// accesos son movups/movdqu, así que no hace falta un prólogo que alinee.
+bool CodeGen::emitVectorLoop(ForStmt* node) {
+    LoopVectorizer::Loop loop;
+    if (!LoopVectorizer::analyze(node, loop)) return false;
+
+    auto isScalar = [&](Variable* var, DataType type) {
+        VarInfo* info = localVars.find(var->symbol);
+        return info && !info->isArray && info->type == type;
+    };
+    if (!isScalar(loop.counter, DataType::INT)) return false;
+    if (Variable* bound = nodeCast<Variable>(loop.bound)) {
+        if (!isScalar(bound, DataType::INT)) return false;
+    }
+
+    // Todos los arrays 1D locales del mismo tipo (int o float)
+    VarInfo* first = localVars.find(loop.stores[0]->varSymbol);
+    if (!first) return false;
+    DataType type = first->type;
+    if (type != DataType::INT && type != DataType::FLOAT) return false;
+    auto isArray = [&](SymbolId symbol) {
+        VarInfo* info = localVars.find(symbol);
+        return info && info->isArray && info->dimensions.size() == 1 && info->type == type;
+    };
+    for (AssignStmt* store : loop.stores) {
+        if (!isArray(store->varSymbol)) return false;
+    }
+    for (ArrayAccess* load : loop.loads) {
+        if (!isArray(load->arraySymbol)) return false;
+    }
+
+    vectorFloat = type == DataType::FLOAT;
+    vectorCounter = loop.counter->symbol;
+    int need = 0;
+    for (AssignStmt* store : loop.stores) {
+        need = max(need, vectorNeed(store->value.get()));
+    }
+
+    vector<Variable*> invariants;
+    for (Variable* var : loop.invariants) {
+        if (!isScalar(var, type)) return false;
+        bool seen = false;
+        for (Variable* other : invariants) seen = seen || other->symbol == var->symbol;
+        if (!seen) invariants.push_back(var);
+    }
+    if (need + (int)invariants.size() > (int)(floatScratch.size() - floatScratchUsed)) return false;
+
+    int lanes = useAVX2 ? 8 : 4;
+    string labelStart = newLabel("vec_start_");
+    string labelEnd = newLabel("vec_end_");
+
+    // Invariantes replicados en todos los carriles
+    vectorBroadcasts.clear();
+    for (Variable* var : invariants) {
+        string reg = allocReg(DataType::FLOAT);
+        if (vectorFloat) {
+            emit("movss " + reg + ", " + varOperand(*localVars.find(var->symbol)));
+        } else {
+            visit(var);
+            emit("movd " + reg + ", eax");
+        }
+        if (useAVX2) {
+            emit(string(vectorFloat ? "vbroadcastss " : "vpbroadcastd ") + vectorReg(reg) + ", " + reg);
+        } else {
+            emit(string(vectorFloat ? "shufps " : "pshufd ") + reg + ", " + reg + ", 0");
+        }
+        vectorBroadcasts.push_back({var->symbol, reg});
+    }
+
+    // Límite: quedan al menos `lanes` iteraciones mientras i op n - (lanes - 1)
+    bool inclusive = loop.compareOp == TokenType::LE;
+    visit(loop.bound);
+    emit("sub rax, " + to_string(lanes - 1));
+    emit("mov rcx, rax");
+    visit(loop.counter);
+    emit("cmp rax, rcx");
+    emit(string(inclusive ? "jg " : "jge ") + labelEnd);
+
+    emit("align 16");
+    emitLabel(labelStart);
+    for (AssignStmt* store : loop.stores) {
+        pair<string, bool> value = emitVectorExpr(store->value.get());
+        if (!value.second) {
+            string reg = allocReg(DataType::FLOAT);
+            emitVectorMove(vectorFloat ? "movaps" : "movdqa", reg, value.first);
+            value = {reg, true};
+        }
+        VarInfo* array = localVars.find(store->varSymbol);
+        emitVectorMove(vectorFloat ? "movups" : "movdqu",
+                       "[rbp + rax*4 - " + to_string(array->offset) + "]", value.first);
+        freeReg(value.first);
+    }
+    emit("add rax, " + to_string(lanes));
+    emit("cmp rax, rcx");
+    emit(string(inclusive ? "jle " : "jl ") + labelStart);
+    emitLabel(labelEnd);
+
+    // El epílogo escalar sigue desde el contador actualizado
+    emit("mov " + varOperand(*localVars.find(loop.counter->symbol)) + ", eax");
+    if (useAVX2) emit("vzeroupper");
+
+    for (auto it = vectorBroadcasts.rbegin(); it != vectorBroadcasts.rend(); ++it) {
+        freeReg(it->second);
+    }
+    vectorBroadcasts.clear();
+    vectorizedLoops++;
+    return true;
 }
 
 // ========== EXPRESIONES ==========
 
 void CodeGen::visitIntLiteral(IntLiteral* node) {
-    emit("mov eax, " + to_string(node->value));
+    // mov eax pone en cero la parte alta: los negativos necesitan rax
+    // (los generan el constant folding y el desenrollado)
+    emit(string(node->value < 0 ? "mov rax, " : "mov eax, ") + to_string(node->value));
     lastExprWasFloat = false;
 }
 
 void CodeGen::visitFloatLiteral(FloatLiteral* node) {
-    // Para floats, necesitamos declarar constantes en .data
+    // Para floats, declaramos la constante en .rodata, con sus bits exactos
+    // (un plegado puede dar valores que to_string no representa)
     string label = newLabel("float_const_");
-
-    // Agregar a sección .data (hacemos trampa: lo emitimos al inicio)
-    stringstream temp;
-    temp << output.str();
-
-    // Insertar después de "section .data"
-    string currentOutput = output.str();
-    size_t dataPos = currentOutput.find("section .data\n");
-    if (dataPos != string::npos) {
-        size_t insertPos = currentOutput.find("\n", dataPos + 14) + 1;
-        currentOutput.insert(insertPos, "    " + label + ": dd " + to_string(node->value) + "\n");
-        output.str("");
-        output << currentOutput;
-    }
+    uint32_t bits;
+    memcpy(&bits, &node->value, sizeof(bits));
+    rodataSection << "    " << label << ": dd " << bits << "  ; " << to_string(node->value) << "\n";
 
     emit("movss xmm0, [" + label + "]");
     lastExprWasFloat = true;
 }
 
 void CodeGen::visitLongLiteral(LongLiteral* node) {
-    // Limpiar RAX completamente antes de cargar el valor
-    // Esto asegura que los 64 bits estén limpios
-    emit("xor rax, rax");
-    emit("mov eax, " + to_string(node->value));
+    // mov rax con el inmediato de 64 bits (el plegado de long da valores
+    // que no entran en eax)
+    emit("mov rax, " + to_string(node->value));
     lastExprWasFloat = false;
 }
 void CodeGen::visitStringLiteral(StringLiteral* node) {
-    // Para strings, creamos una constante en .data
+    // Para strings, creamos una constante en .rodata
     string label = newLabel("str_const_");
-
-    // Insertar en sección .data
-    string currentOutput = output.str();
-    size_t dataPos = currentOutput.find("section .data\n");
-    if (dataPos != string::npos) {
-        size_t insertPos = currentOutput.find("\n", dataPos + 14) + 1;
-
-        // Construir el string en formato NASM
-        string escaped = node->value;
-        string nasmStr = "";
-        bool hasNewline = false;
-
-        // Procesar caracteres especiales
-        for (size_t i = 0; i < escaped.length(); i++) {
-            if (escaped[i] == '\\' && i + 1 < escaped.length()) {
-                if (escaped[i+1] == 'n') {
-                    // Newline - lo manejamos después del string
-                    hasNewline = true;
-                    i++;  // Saltar el
-                    continue;
-                } else if (escaped[i+1] == '\\') {
-                    nasmStr += "\\\\";
-                    i++;  // Saltar el segundo '\'
-                } else if (escaped[i+1] == '"') {
-                    nasmStr += "\\\"";
-                    i++;  // Saltar el '"'
-                } else if (escaped[i+1] == 't') {
-                    nasmStr += "\\t";
-                    i++;
-                } else {
-                    nasmStr += escaped[i];
-                }
-            } else if (escaped[i] == '"') {
-                nasmStr += "\\\"";
-            } else {
-                nasmStr += escaped[i];
-            }
-        }
-
-        // Construir la declaración NASM
-        string dbLine = "    " + label + ": db \"" + nasmStr + "\"";
-        if (hasNewline) {
-            dbLine += ", 10";  // Agregar newline como byte separado
-        }
-        dbLine += ", 0\n";
-
-        currentOutput.insert(insertPos, dbLine);
-        output.str("");
-        output << currentOutput;
-    }
+    rodataSection << "    " << label << ": db " << nasmStringLiteral(node->value) << "\n";
 
     // Cargar dirección del string en rax
     emit("lea rax, [" + label + "]");
@@ -200,14 +754,17 @@ void CodeGen::visitStringLiteral(StringLiteral* node) {
 
 void CodeGen::visitVariable(Variable* node) {
     // Buscar variable en local o global
-    if (localVars.find(node->name) != localVars.end()) {
-        VarInfo& var = localVars[node->name];
+    if (VarInfo* local = localVars.find(node->symbol)) {
+        VarInfo& var = *local;
 
         if (var.type == DataType::FLOAT) {
-            emit("movss xmm0, [rbp - " + to_string(var.offset) + "]");
+            emit("movss xmm0, " + varOperand(var));
             lastExprWasFloat = true;
         } else if (var.type == DataType::LONG) {
-            emit("mov rax, [rbp - " + to_string(var.offset) + "]");
+            emit("mov rax, " + varOperand(var));
+            lastExprWasFloat = false;
+        } else if (!var.reg.empty()) {
+            emit("movsxd rax, " + varOperand(var));
             lastExprWasFloat = false;
         } else {
             // Cargar y extender directamente desde memoria (más eficiente)
@@ -215,145 +772,265 @@ void CodeGen::visitVariable(Variable* node) {
             emit("movsx rax, eax");
             lastExprWasFloat = false;
         }
-    } else if (globalVars.find(node->name) != globalVars.end()) {
-        VarInfo& var = globalVars[node->name];
-        emit("mov eax, [" + node->name + "]");
+    } else if (globalVars.contains(node->symbol)) {
+        emit("mov eax, [" + string(node->name) + "]");
 
         emit("movsx rax, eax");
         lastExprWasFloat = false;
     }
 }
 
-void CodeGen::visitBinaryOp(BinaryOp* node) {
-    // Evaluar operando derecho primero
-    node->right->accept(this);
-    bool rightWasFloat = lastExprWasFloat;
-
-    // Guardar resultado en stack
-    if (rightWasFloat) {
-        emit("sub rsp, 8");
-        emit("movss [rsp], xmm0");
-    } else {
-        emit("push rax");
+static bool isComparison(TokenType op) {
+    return op == TokenType::EQ || op == TokenType::NE || op == TokenType::LT ||
+           op == TokenType::GT || op == TokenType::LE || op == TokenType::GE;
+}
+
+// Código de condición de una comparación (float: condiciones sin signo de
+// ucomiss). swapped: los operandos se compararon al revés (b ? a).
+static string conditionCode(TokenType op, bool isFloat, bool swapped) {
+    if (swapped) {
+        switch (op) {
+            case TokenType::LT: op = TokenType::GT; break;
+            case TokenType::GT: op = TokenType::LT; break;
+            case TokenType::LE: op = TokenType::GE; break;
+            case TokenType::GE: op = TokenType::LE; break;
+            default: break;
+        }
     }
+    switch (op) {
+        case TokenType::EQ: return "e";
+        case TokenType::NE: return "ne";
+        case TokenType::LT: return isFloat ? "b" : "l";
+        case TokenType::GT: return isFloat ? "a" : "g";
+        case TokenType::LE: return isFloat ? "be" : "le";
+        default:            return isFloat ? "ae" : "ge";
+    }
+}
+
+static string negateCondition(const string& cc) {
+    static const char* pairs[][2] = {
+        {"e", "ne"}, {"l", "ge"}, {"g", "le"}, {"b", "ae"}, {"a", "be"}
+    };
+    for (auto& pair : pairs) {
+        if (cc == pair[0]) return pair[1];
+        if (cc == pair[1]) return pair[0];
+    }
+    return cc;
+}
 
-    // Evaluar operando izquierdo
-    node->left->accept(this);
-    bool leftWasFloat = lastExprWasFloat;
+bool CodeGen::emitOperands(BinaryOp* node, bool& isFloatOp, string& rightOperand) {
+    // Sethi-Ullman: primero el operando que necesita más registros (sin
+    // efectos laterales; si no, el derecho). Su valor queda en el stack de
+    // registros mientras se evalúa el otro.
+    bool leftFirst = RegisterAllocator::evaluatesLeftFirst(node);
+    Expr* first = leftFirst ? node->left.get() : node->right.get();
+    Expr* second = leftFirst ? node->right.get() : node->left.get();
 
-    // Si alguno es float, la operación será float
-    bool isFloatOp = leftWasFloat || rightWasFloat;
+    visit(first);
+    bool firstWasFloat = lastExprWasFloat;
+    string saved = saveTemp(firstWasFloat, RegisterAllocator::registerNeed(second));
 
-    // Recuperar operando derecho
-    if (rightWasFloat) {
-        emit("movss xmm1, [rsp]");
-        emit("add rsp, 8");
+    visit(second);
+    bool leftWasFloat = leftFirst ? firstWasFloat : lastExprWasFloat;
+    bool rightWasFloat = leftFirst ? lastExprWasFloat : firstWasFloat;
+
+    // Si alguno es float, la operación será float
+    isFloatOp = leftWasFloat || rightWasFloat;
+    TokenType op = node->op.type;
+    bool swappable = op == TokenType::PLUS || op == TokenType::MULTIPLY || isComparison(op);
+
+    // Izquierdo en rax/xmm0; el derecho en rcx/xmm1 o en su scratch
+    bool swapped = false;
+    if (!leftFirst) {
+        rightOperand = tempOperand(saved, rightWasFloat, rightWasFloat ? "xmm1" : "rcx");
+    } else if (!saved.empty() && swappable && leftWasFloat == rightWasFloat) {
+        // a op b = b op a (las comparaciones invierten la condición):
+        // el izquierdo se usa desde su registro
+        rightOperand = tempOperand(saved, leftWasFloat, "");
+        swapped = true;
     } else {
-        emit("pop rbx");
-        // Si left es float pero right no, convertir right a float
-        if (isFloatOp && !rightWasFloat) {
-            emit("cvtsi2ss xmm1, ebx");
-        }
+        rightOperand = rightWasFloat ? "xmm1" : "rcx";
+        emit(rightWasFloat ? "movaps xmm1, xmm0" : "mov rcx, rax");
+        restoreTemp(saved, leftWasFloat, leftWasFloat ? "xmm0" : "rax");
+    }
+
+    // Si left es float pero right no, convertir right a float
+    if (isFloatOp && !rightWasFloat) {
+        emit("cvtsi2ss xmm1, " + reg32(rightOperand));
+        rightOperand = "xmm1";
     }
 
     // Si right es float pero left no, convertir left a float
     if (isFloatOp && !leftWasFloat) {
         emit("cvtsi2ss xmm0, eax");
     }
+    return swapped;
+}
+
+void CodeGen::visitBinaryOp(BinaryOp* node) {
+    TokenType op = node->op.type;
+
+    // && y ||: cadena de saltos, el 0/1 se materializa una sola vez al final
+    if (op == TokenType::AND || op == TokenType::OR) {
+        string labelFalse = newLabel("bool_false_");
+        string labelEnd = newLabel("bool_end_");
+        emitCondJump(node, labelFalse, false);
+        emit("mov eax, 1");
+        emit("jmp " + labelEnd);
+        emitLabel(labelFalse);
+        emit("xor eax, eax");
+        emitLabel(labelEnd);
+        lastExprWasFloat = false;
+        return;
+    }
+
+    bool isFloatOp;
+    string rightOperand;
+    bool swapped = emitOperands(node, isFloatOp, rightOperand);
 
     // Realizar operación
-    switch (node->op.type) {
+    switch (op) {
         case TokenType::PLUS:
             if (isFloatOp) {
-                emit("addss xmm0, xmm1");
+                emit("addss xmm0, " + rightOperand);
                 lastExprWasFloat = true;
             } else {
-                emit("add rax, rbx");
+                emit("add rax, " + rightOperand);
                 lastExprWasFloat = false;
             }
             break;
 
         case TokenType::MINUS:
             if (isFloatOp) {
-                emit("subss xmm0, xmm1");
+                emit("subss xmm0, " + rightOperand);
                 lastExprWasFloat = true;
             } else {
-                emit("sub rax, rbx");
+                emit("sub rax, " + rightOperand);
                 lastExprWasFloat = false;
             }
             break;
 
         case TokenType::MULTIPLY:
             if (isFloatOp) {
-                emit("mulss xmm0, xmm1");
+                emit("mulss xmm0, " + rightOperand);
                 lastExprWasFloat = true;
             } else {
-                emit("imul rax, rbx");
+                emit("imul rax, " + rightOperand);
                 lastExprWasFloat = false;
             }
             break;
 
         case TokenType::DIVIDE:
             if (isFloatOp) {
-                emit("divss xmm0, xmm1");
+                emit("divss xmm0, " + rightOperand);
                 lastExprWasFloat = true;
             } else {
                 emit("xor rdx, rdx");  // Clear RDX para división
-                emit("idiv rbx");
+                emit("idiv " + rightOperand);
                 lastExprWasFloat = false;
             }
             break;
 
         // Operadores relacionales
         case TokenType::EQ:
-            emit("cmp rax, rbx");
-            emit("sete al");
-            emit("movzx eax, al");
-            lastExprWasFloat = false;
-            break;
-
         case TokenType::NE:
-            emit("cmp rax, rbx");
-            emit("setne al");
-            emit("movzx eax, al");
-            lastExprWasFloat = false;
-            break;
-
         case TokenType::LT:
-            emit("cmp rax, rbx");
-            emit("setl al");
-            emit("movzx eax, al");
-            lastExprWasFloat = false;
-            break;
-
         case TokenType::GT:
-            emit("cmp rax, rbx");
-            emit("setg al");
-            emit("movzx eax, al");
-            lastExprWasFloat = false;
-            break;
-
         case TokenType::LE:
-            emit("cmp rax, rbx");
-            emit("setle al");
-            emit("movzx eax, al");
-            lastExprWasFloat = false;
-            break;
-
         case TokenType::GE:
-            emit("cmp rax, rbx");
-            emit("setge al");
+            if (isFloatOp) {
+                emit("ucomiss xmm0, " + rightOperand);
+            } else {
+                emit("cmp rax, " + rightOperand);
+            }
+            emit("set" + conditionCode(op, isFloatOp, swapped) + " al");
             emit("movzx eax, al");
             lastExprWasFloat = false;
             break;
 
-        default:
+        // x << n / x >> n: los deja el optimizer en lugar de x * 2^n y
+        // x / 2^n (sin TokenType propio, se reconocen por el lexema). El
+        // optimizer no sabe si x es float: ahí se multiplica / divide.
+        default: {
+            bool shiftLeft = node->op.lexeme == "<<";
+            IntLiteral* amount = nodeCast<IntLiteral>(node->right.get());
+            if ((!shiftLeft && node->op.lexeme != ">>") || !amount) break;
+            if (isFloatOp) {
+                emit("mov ecx, " + to_string(1 << amount->value));
+                emit("cvtsi2ss xmm1, ecx");
+                emit((shiftLeft ? "mulss" : "divss") + string(" xmm0, xmm1"));
+                lastExprWasFloat = true;
+            } else if (shiftLeft) {
+                emit("shl rax, " + to_string(amount->value));
+                lastExprWasFloat = false;
+            } else if (amount->value > 0) {
+                // División con signo: sumar 2^n - 1 si es negativo para
+                // truncar hacia cero como idiv
+                emit("mov rcx, rax");
+                emit("sar rcx, 63");
+                emit("shr rcx, " + to_string(64 - amount->value));
+                emit("add rax, rcx");
+                emit("sar rax, " + to_string(amount->value));
+                lastExprWasFloat = false;
+            }
             break;
+        }
     }
 }
 
+// Salta a `label` si la condición vale jumpIfTrue; si no, sigue de largo.
+// Las comparaciones terminan en cmp + jcc y && / || en una cadena de
+// saltos, sin materializar el 0/1.
+void CodeGen::emitCondJump(Expr* condition, const string& label, bool jumpIfTrue) {
+    if (BinaryOp* binary = nodeCast<BinaryOp>(condition)) {
+        TokenType op = binary->op.type;
+        if (isComparison(op)) {
+            bool isFloatOp;
+            string rightOperand;
+            bool swapped = emitOperands(binary, isFloatOp, rightOperand);
+            if (isFloatOp) {
+                emit("ucomiss xmm0, " + rightOperand);
+            } else {
+                emit("cmp rax, " + rightOperand);
+            }
+            string cc = conditionCode(op, isFloatOp, swapped);
+            emit("j" + (jumpIfTrue ? cc : negateCondition(cc)) + " " + label);
+            return;
+        }
+        if (op == TokenType::AND || op == TokenType::OR) {
+            // a && b salta si a es falso o b es falso; a || b, si alguno es verdadero
+            bool isAnd = op == TokenType::AND;
+            if (jumpIfTrue == !isAnd) {
+                emitCondJump(binary->left.get(), label, jumpIfTrue);
+                emitCondJump(binary->right.get(), label, jumpIfTrue);
+            } else {
+                string labelSkip = newLabel("cond_skip_");
+                emitCondJump(binary->left.get(), labelSkip, !jumpIfTrue);
+                emitCondJump(binary->right.get(), label, jumpIfTrue);
+                emitLabel(labelSkip);
+            }
+            return;
+        }
+    } else if (UnaryOp* unary = nodeCast<UnaryOp>(condition)) {
+        if (unary->op.type == TokenType::NOT) {
+            emitCondJump(unary->operand.get(), label, !jumpIfTrue);
+            return;
+        }
+    } else if (IntLiteral* literal = nodeCast<IntLiteral>(condition)) {
+        if ((literal->value != 0) == jumpIfTrue) {
+            emit("jmp " + label);
+        }
+        return;
+    }
+
+    // Cualquier otra expresión: su valor en rax
+    visit(condition);
+    emit("test rax, rax");
+    emit(string(jumpIfTrue ? "jnz " : "jz ") + label);
+}
+
 void CodeGen::visitUnaryOp(UnaryOp* node) {
-    node->operand->accept(this);
+    visit(node->operand.get());
 
     if (node->op.type == TokenType::MINUS) {
         if (lastExprWasFloat) {
@@ -372,10 +1049,11 @@ void CodeGen::visitUnaryOp(UnaryOp* node) {
 }
 
 void CodeGen::visitCastExpr(CastExpr* node) {
-    node->expr->accept(this);
+    visit(node->expr.get());
 
-    // Obtener tipo origen
-    DataType fromType = node->expr->inferredType;
+    // Tipo origen: el del valor que quedó en rax / xmm0 (inferredType solo
+    // lo tienen los literales y los casts, no una variable)
+    DataType fromType = lastExprWasFloat ? DataType::FLOAT : integerType(node->expr.get());
     DataType toType = node->targetType;
 
     // Realizar la conversión y actualizar el flag
@@ -383,32 +1061,80 @@ void CodeGen::visitCastExpr(CastExpr* node) {
         if (fromType == DataType::INT && toType == DataType::FLOAT) {
             emit("cvtsi2ss xmm0, eax");
             lastExprWasFloat = true;
+        } else if (fromType == DataType::LONG && toType == DataType::FLOAT) {
+            emit("cvtsi2ss xmm0, rax");
+            lastExprWasFloat = true;
         } else if (fromType == DataType::FLOAT && toType == DataType::INT) {
             emit("cvttss2si eax, xmm0");
+            emit("movsxd rax, eax");
+            lastExprWasFloat = false;
+        } else if (fromType == DataType::FLOAT && toType == DataType::LONG) {
+            emit("cvttss2si rax, xmm0");
             lastExprWasFloat = false;
         } else if (fromType == DataType::INT && toType == DataType::LONG) {
             emit("movsx rax, eax");
             lastExprWasFloat = false;
+        } else if (fromType == DataType::LONG && toType == DataType::INT) {
+            emit("movsxd rax, eax");
+            lastExprWasFloat = false;
         }
     }
 }
 
+DataType CodeGen::integerType(Expr* expr) {
+    switch (expr->kind) {
+        case NodeKind::LongLiteral:
+            return DataType::LONG;
+        case NodeKind::CastExpr:
+            return static_cast<CastExpr*>(expr)->targetType;
+        case NodeKind::Variable:
+        case NodeKind::ArrayAccess: {
+            SymbolId symbol = expr->kind == NodeKind::Variable ? static_cast<Variable*>(expr)->symbol
+                                                               : static_cast<ArrayAccess*>(expr)->arraySymbol;
+            VarInfo* var = localVars.find(symbol);
+            if (!var) var = globalVars.find(symbol);
+            return var && var->type == DataType::LONG ? DataType::LONG : DataType::INT;
+        }
+        case NodeKind::CallExpr: {
+            FunctionInfo* func = functions.find(static_cast<CallExpr*>(expr)->functionSymbol);
+            return func && func->returnType == DataType::LONG ? DataType::LONG : DataType::INT;
+        }
+        case NodeKind::UnaryOp:
+            return integerType(static_cast<UnaryOp*>(expr)->operand.get());
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            return integerType(ternary->exprTrue.get()) == DataType::LONG ? DataType::LONG
+                                                                          : integerType(ternary->exprFalse.get());
+        }
+        case NodeKind::BinaryOp: {
+            // Comparaciones, && y || dan 0 o 1; el resto, long si un lado lo es
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            if (isComparison(binary->op.type) || binary->op.type == TokenType::AND ||
+                binary->op.type == TokenType::OR) {
+                return DataType::INT;
+            }
+            if (integerType(binary->left.get()) == DataType::LONG) return DataType::LONG;
+            return integerType(binary->right.get());
+        }
+        default:
+            return DataType::INT;
+    }
+}
+
 void CodeGen::visitTernaryExpr(TernaryExpr* node) {
     string labelFalse = newLabel("ternary_false_");
     string labelEnd = newLabel("ternary_end_");
 
     // Evaluar condición
-    node->condition->accept(this);
-    emit("test rax, rax");
-    emit("jz " + labelFalse);
+    emitCondJump(node->condition.get(), labelFalse, false);
 
     // Rama verdadera
-    node->exprTrue->accept(this);
+    visit(node->exprTrue.get());
     emit("jmp " + labelEnd);
 
     // Rama falsa
     emitLabel(labelFalse);
-    node->exprFalse->accept(this);
+    visit(node->exprFalse.get());
 
     emitLabel(labelEnd);
 }
@@ -419,11 +1145,11 @@ void CodeGen::visitCallExpr(CallExpr* node) {
         if (node->arguments.size() > 0) {
             // El primer argumento es el formato (string)
             // Verificar si es StringLiteral
-            StringLiteral* fmtStr = dynamic_cast<StringLiteral*>(node->arguments[0].get());
+            StringLiteral* fmtStr = nodeCast<StringLiteral>(node->arguments[0].get());
 
             if (fmtStr) {
                 // Es un string literal - usar como formato directamente
-                fmtStr->accept(this);  // Esto carga la dirección del string en rax
+                visit(fmtStr);  // Esto carga la dirección del string en rax
                 emit("mov rdi, rax");  // Primer argumento: formato
 
                 // Si hay más argumentos, pasarlos
@@ -431,7 +1157,7 @@ void CodeGen::visitCallExpr(CallExpr* node) {
                     // CRÍTICO: Guardar rdi antes de evaluar argumentos que puedan ser llamadas a función
                     emit("push rdi");  // Guardar formato en stack
 
-                    node->arguments[1]->accept(this);
+                    visit(node->arguments[1].get());
 
                     // Determinar formato basado en tipo del segundo argumento
                     if (lastExprWasFloat) {
@@ -450,7 +1176,7 @@ void CodeGen::visitCallExpr(CallExpr* node) {
                 }
             } else {
                 // No es string literal - asumir que es un valor numérico
-                node->arguments[0]->accept(this);
+                visit(node->arguments[0].get());
 
                 // Determinar formato basado en tipo
                 if (lastExprWasFloat) {
@@ -470,16 +1196,54 @@ void CodeGen::visitCallExpr(CallExpr* node) {
         }
     } else {
         // Llamada a función normal
+        emitCallArguments(node);
+        emit("call " + string(node->functionName));
+    }
+}
+
+// Pasar argumentos (convención x86-64: rdi, rsi, rdx, rcx, r8, r9)
+void CodeGen::emitCallArguments(CallExpr* node) {
+    vector<string> argRegs = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
+    size_t argCount = min(node->arguments.size(), (size_t)6);
+
+    // Evaluar un argumento compuesto puede pisar registros de argumento
+    // (rcx es scratch, rdx lo usa idiv, un call pisa todos), así que
+    // primero se evalúan los compuestos y se guardan en el stack frame;
+    // el último va directo a su registro. Las hojas solo tocan rax y se
+    // cargan al final (RegisterAllocator recorre en el mismo orden).
+    int lastComplex = -1;
+    for (size_t i = 0; i < argCount; i++) {
+        if (!RegisterAllocator::isLeafArgument(node->arguments[i].get())) lastComplex = i;
+    }
 
-        // Pasar argumentos (convención x86-64: rdi, rsi, rdx, rcx, r8, r9)
-        vector<string> argRegs = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
+    vector<int> argSlots(argCount, 0);
+    int argsOffset = stackOffset;
+    for (size_t i = 0; i < argCount; i++) {
+        Expr* arg = node->arguments[i].get();
+        if (RegisterAllocator::isLeafArgument(arg)) continue;
 
-        for (size_t i = 0; i < node->arguments.size() && i < 6; i++) {
-            node->arguments[i]->accept(this);
+        visit(arg);
+        if ((int)i == lastComplex) {
             emit("mov " + argRegs[i] + ", rax");
+        } else {
+            stackOffset = (stackOffset + 15) / 8 * 8;
+            argSlots[i] = stackOffset;
+            emit("mov [rbp - " + to_string(stackOffset) + "], rax");
         }
-
-        emit("call " + node->functionName);
+    }
+    for (size_t i = 0; i < argCount; i++) {
+        if (argSlots[i] > 0) {
+            emit("mov " + argRegs[i] + ", [rbp - " + to_string(argSlots[i]) + "]");
+        }
+    }
+    frameSize = max(frameSize, stackOffset);
+    stackOffset = argsOffset;
+    for (size_t i = 0; i < argCount; i++) {
+        Expr* arg = node->arguments[i].get();
+        if (!RegisterAllocator::isLeafArgument(arg)) continue;
+
+        visit(arg);
+        emit("mov " + argRegs[i] + ", rax");
     }
 }
 
@@ -487,10 +1251,9 @@ void CodeGen::visitArrayAccess(ArrayAccess* node) {
     // Buscar info del array
     VarInfo* varInfo = nullptr;
 
-    if (localVars.find(node->arrayName) != localVars.end()) {
-        varInfo = &localVars[node->arrayName];
-    } else if (globalVars.find(node->arrayName) != globalVars.end()) {
-        varInfo = &globalVars[node->arrayName];
+    varInfo = localVars.find(node->arraySymbol);
+    if (!varInfo) {
+        varInfo = globalVars.find(node->arraySymbol);
     }
 
     if (!varInfo || !varInfo->isArray) {
@@ -498,59 +1261,12 @@ void CodeGen::visitArrayAccess(ArrayAccess* node) {
         return;
     }
 
-    // Calcular offset para arrays multidimensionales
-    // arr[i][j] en arr[3][4] = arr[i * 4 + j]
-
-    if (node->indices.size() == 1) {
-        // Array 1D simple: arr[i]
-        node->indices[0]->accept(this);
-
-        // Multiplicar por tamaño del tipo
-        int typeSize = 4; // int, float = 4 bytes
-        if (varInfo->type == DataType::LONG) typeSize = 8;
-
-        emit("imul rax, " + to_string(typeSize));
-        emit("mov rbx, rbp");
-        emit("sub rbx, " + to_string(varInfo->offset));
-        emit("add rbx, rax");
-
-        // Cargar valor
-        if (varInfo->type == DataType::FLOAT) {
-            emit("movss xmm0, [rbx]");
-            lastExprWasFloat = true;
-        } else {
-            emit("mov eax, [rbx]");
-            emit("movsx rax, eax");
-            lastExprWasFloat = false;
-        }
-    } else if (node->indices.size() == 2) {
-        // Array 2D: arr[i][j]
-        // offset = (i * cols + j) * typeSize
-
-        node->indices[0]->accept(this);  // i
-        emit("imul rax, " + to_string(varInfo->dimensions[1]));
-        emit("push rax");
-
-        node->indices[1]->accept(this);  // j
-        emit("pop rbx");
-        emit("add rax, rbx");
-
-        int typeSize = 4;
-        if (varInfo->type == DataType::LONG) typeSize = 8;
-
-        emit("imul rax, " + to_string(typeSize));
-        emit("mov rbx, rbp");
-        emit("sub rbx, " + to_string(varInfo->offset));
-        emit("add rbx, rax");
-
-        if (varInfo->type == DataType::FLOAT) {
-            emit("movss xmm0, [rbx]");
-            lastExprWasFloat = true;
-        } else {
-            emit("mov eax, [rbx]");
-            lastExprWasFloat = false;
-        }
+    // Dentro de un for reducido el acceso ya tiene su puntero
+    string address = stridedOperand(node);
+    if (address.empty()) {
+        address = emitElementAddress(varInfo, node->indices);
     }
+    emitElementLoad(varInfo->type, address);
 }
 
 void CodeGen::visitAssignExpr(AssignExpr* node) {
@@ -559,129 +1275,60 @@ void CodeGen::visitAssignExpr(AssignExpr* node) {
         // Similar a AssignStmt pero el resultado debe quedar en rax/xmm0
         
         // Evaluar valor primero
-        node->value->accept(this);
+        visit(node->value.get());
         bool wasFloat = lastExprWasFloat;
         
         // Guardar valor temporalmente
-        if (wasFloat) {
-            emit("sub rsp, 8");
-            emit("movss [rsp], xmm0");
-        } else {
-            emit("push rax");
-        }
+        string saved = saveTemp(wasFloat, RegisterAllocator::indexNeed(node->indices));
         
         // Calcular dirección del array (similar a visitArrayAccess)
-        VarInfo* varInfo = nullptr;
-        if (localVars.find(node->varName) != localVars.end()) {
-            varInfo = &localVars[node->varName];
-        }
+        VarInfo* varInfo = localVars.find(node->varSymbol);
         
         if (!varInfo) {
-            emit("add rsp, 8");  // Limpiar stack
+            restoreTemp(saved, wasFloat, wasFloat ? "xmm0" : "rax");  // Limpiar stack
             return;
         }
         
-        if (node->indices.size() == 1) {
-            // Array 1D
-            node->indices[0]->accept(this);
-            
-            int typeSize = 4;
-            if (varInfo->type == DataType::LONG) typeSize = 8;
-            
-            emit("imul rax, " + to_string(typeSize));
-            emit("mov rbx, rbp");
-            emit("sub rbx, " + to_string(varInfo->offset));
-            emit("add rbx, rax");
-            
-            // Recuperar y almacenar valor
-            if (wasFloat) {
-                emit("movss xmm0, [rsp]");
-                emit("add rsp, 8");
-                emit("movss [rbx], xmm0");
-                lastExprWasFloat = true;
-            } else {
-                emit("pop rax");
-                if (varInfo->type == DataType::FLOAT) {
-                    emit("cvtsi2ss xmm0, rax");
-                    emit("movss [rbx], xmm0");
-                    lastExprWasFloat = true;
-                } else if (varInfo->type == DataType::LONG) {
-                    emit("mov [rbx], rax");
-                    lastExprWasFloat = false;
-                } else {
-                    emit("mov [rbx], eax");
-                    lastExprWasFloat = false;
-                }
-            }
-        } else if (node->indices.size() == 2) {
-            // Array 2D
-            node->indices[0]->accept(this);
-            emit("imul rax, " + to_string(varInfo->dimensions[1]));
-            emit("push rax");
-            
-            node->indices[1]->accept(this);
-            emit("pop rbx");
-            emit("add rax, rbx");
-            
-            int typeSize = 4;
-            if (varInfo->type == DataType::LONG) typeSize = 8;
-            
-            emit("imul rax, " + to_string(typeSize));
-            emit("mov rbx, rbp");
-            emit("sub rbx, " + to_string(varInfo->offset));
-            emit("add rbx, rax");
-            
-            // Recuperar y almacenar valor
-            if (wasFloat) {
-                emit("movss xmm0, [rsp]");
-                emit("add rsp, 8");
-                emit("movss [rbx], xmm0");
+        emit("lea rcx, " + emitElementAddress(varInfo, node->indices));
+
+        // Recuperar y almacenar valor
+        if (wasFloat) {
+            emit("movss [rcx], " + tempOperand(saved, true, "xmm0"));
+            lastExprWasFloat = true;
+        } else {
+            restoreTemp(saved, false, "rax");
+            if (varInfo->type == DataType::FLOAT) {
+                emit("cvtsi2ss xmm0, rax");
+                emit("movss [rcx], xmm0");
                 lastExprWasFloat = true;
+            } else if (varInfo->type == DataType::LONG) {
+                emit("mov [rcx], rax");
+                lastExprWasFloat = false;
             } else {
-                emit("pop rax");
-                if (varInfo->type == DataType::FLOAT) {
-                    emit("cvtsi2ss xmm0, rax");
-                    emit("movss [rbx], xmm0");
-                    lastExprWasFloat = true;
-                } else if (varInfo->type == DataType::LONG) {
-                    emit("mov [rbx], rax");
-                    lastExprWasFloat = false;
-                } else {
-                    emit("mov [rbx], eax");
-                    lastExprWasFloat = false;
-                }
+                emit("mov [rcx], eax");
+                lastExprWasFloat = false;
             }
         }
         
         // Cargar el valor de vuelta para que quede en rax/xmm0
-        if (varInfo->type == DataType::FLOAT) {
-            emit("movss xmm0, [rbx]");
-            lastExprWasFloat = true;
-        } else if (varInfo->type == DataType::LONG) {
-            emit("mov rax, [rbx]");
-            lastExprWasFloat = false;
-        } else {
-            emit("mov eax, [rbx]");
-            emit("movsx rax, eax");
-            lastExprWasFloat = false;
-        }
+        emitElementLoad(varInfo->type, "[rcx]");
     } else {
         // Asignación simple: x = value
-        node->value->accept(this); // Value is in rax/xmm0
+        visit(node->value.get()); // Value is in rax/xmm0
         
-        if (localVars.find(node->varName) != localVars.end()) {
-            VarInfo& var = localVars[node->varName];
+        if (VarInfo* local = localVars.find(node->varSymbol)) {
+            VarInfo& var = *local;
             
             if (var.type == DataType::FLOAT) {
-                emit("movss [rbp - " + to_string(var.offset) + "], xmm0");
+                emit("movss " + varOperand(var) + ", xmm0");
                 // El valor ya está en xmm0
                 lastExprWasFloat = true;
             } else if (var.type == DataType::LONG) {
-                emit("mov [rbp - " + to_string(var.offset) + "], rax");
+                emit("mov " + varOperand(var) + ", rax");
                 // El valor ya está en rax
                 lastExprWasFloat = false;
             } else {
-                emit("mov [rbp - " + to_string(var.offset) + "], eax");
+                emit("mov " + varOperand(var) + ", eax");
                 // El valor ya está en rax (eax)
                 lastExprWasFloat = false;
             }
@@ -705,6 +1352,9 @@ void CodeGen::visitVarDecl(VarDecl* node) {
             size = 8;
         }
 
+        // Las variables con registro asignado no ocupan lugar en el stack
+        string reg = regAlloc.registerFor(node);
+
         if (node->isArray) {
             // Calcular tamaño total del array
             int totalSize = size;
@@ -712,28 +1362,29 @@ void CodeGen::visitVarDecl(VarDecl* node) {
                 totalSize *= dim;
             }
             stackOffset += totalSize;
-        } else {
+        } else if (reg.empty()) {
             stackOffset += size;
         }
 
         VarInfo varInfo;
         varInfo.type = node->type;
         varInfo.offset = stackOffset;
+        varInfo.reg = reg;
         varInfo.isArray = node->isArray;
-        varInfo.dimensions = node->dimensions;
+        varInfo.dimensions.assign(node->dimensions.begin(), node->dimensions.end());
 
-        localVars[node->name] = varInfo;
+        localVars[node->symbol] = varInfo;
 
         // Si hay inicializador
         if (node->initializer) {
-            node->initializer->accept(this);
+            visit(node->initializer.get());
 
             if (node->type == DataType::FLOAT) {
-                emit("movss [rbp - " + to_string(stackOffset) + "], xmm0");
+                emit("movss " + varOperand(varInfo) + ", xmm0");
             } else if (node->type == DataType::LONG) {
-                emit("mov [rbp - " + to_string(stackOffset) + "], rax");
+                emit("mov " + varOperand(varInfo) + ", rax");
             } else {
-                emit("mov [rbp - " + to_string(stackOffset) + "], eax");
+                emit("mov " + varOperand(varInfo) + ", eax");
             }
         }
     }
@@ -744,94 +1395,62 @@ void CodeGen::visitAssignStmt(AssignStmt* node) {
         // Asignación a array: arr[i] = value
 
         // Evaluar valor primero
-        node->value->accept(this);
-        emit("push rax");  // Guardar valor
+        visit(node->value.get());
 
         // Calcular dirección del array
-        VarInfo* varInfo = nullptr;
-        if (localVars.find(node->varName) != localVars.end()) {
-            varInfo = &localVars[node->varName];
-        }
-
-        if (!varInfo) return;
-
-        if (node->indices.size() == 1) {
-            // Array 1D
-            node->indices[0]->accept(this);
-
-            int typeSize = 4;
-            if (varInfo->type == DataType::LONG) typeSize = 8;
-
-            emit("imul rax, " + to_string(typeSize));
-            emit("mov rbx, rbp");
-            emit("sub rbx, " + to_string(varInfo->offset));
-            emit("add rbx, rax");
-
-            emit("pop rax");  // Recuperar valor
-
-            if (varInfo->type == DataType::FLOAT) {
-                emit("movss [rbx], xmm0");
-            } else if (varInfo->type == DataType::LONG) {
-                // Para long, asegurarse de extender correctamente
-                emit("movsx rax, eax");
-                emit("mov [rbx], rax");
-            } else {
-                emit("mov [rbx], eax");
-            }
-        } else if (node->indices.size() == 2) {
-            // Array 2D
-            node->indices[0]->accept(this);
-            emit("imul rax, " + to_string(varInfo->dimensions[1]));
-            emit("push rax");
-
-            node->indices[1]->accept(this);
-            emit("pop rbx");
-            emit("add rax, rbx");
-
-            int typeSize = 4;
-            if (varInfo->type == DataType::LONG) typeSize = 8;
+        VarInfo* varInfo = localVars.find(node->varSymbol);
 
-            emit("imul rax, " + to_string(typeSize));
-            emit("mov rbx, rbp");
-            emit("sub rbx, " + to_string(varInfo->offset));
-            emit("add rbx, rax");
+        if (!varInfo) {
+            return;
+        }
 
-            emit("pop rax");  // Recuperar valor
+        // Dentro de un for reducido el acceso ya tiene su puntero; si no,
+        // la dirección queda en rcx
+        string address = stridedOperand(node);
+        if (address.empty()) {
+            string saved = saveTemp(false, RegisterAllocator::indexNeed(node->indices));  // Guardar valor
+            emit("lea rcx, " + emitElementAddress(varInfo, node->indices));
+            restoreTemp(saved, false, "rax");  // Recuperar valor
+            address = "[rcx]";
+        }
 
-            if (varInfo->type == DataType::FLOAT) {
-                emit("movss [rbx], xmm0");
-            } else if (varInfo->type == DataType::LONG) {
-                // Para long, asegurarse de extender correctamente
-                emit("movsx rax, eax");
-                emit("mov [rbx], rax");
-            } else {
-                emit("mov [rbx], eax");
-            }
+        if (varInfo->type == DataType::FLOAT) {
+            emit("movss " + address + ", xmm0");
+        } else if (varInfo->type == DataType::LONG) {
+            // Para long, extender si el valor viene de un int
+            if (integerType(node->value.get()) != DataType::LONG) emit("movsx rax, eax");
+            emit("mov " + address + ", rax");
+        } else {
+            emit("mov " + address + ", eax");
         }
     } else {
         // Asignación simple: x = value
-        node->value->accept(this);
+        visit(node->value.get());
 
-        if (localVars.find(node->varName) != localVars.end()) {
-            VarInfo& var = localVars[node->varName];
+        if (VarInfo* local = localVars.find(node->varSymbol)) {
+            VarInfo& var = *local;
 
             if (var.type == DataType::FLOAT) {
-                emit("movss [rbp - " + to_string(var.offset) + "], xmm0");
+                emit("movss " + varOperand(var) + ", xmm0");
             } else if (var.type == DataType::LONG) {
                 // Si el valor viene de un int, extenderlo a long
-                emit("movsx rax, eax");
-                emit("mov [rbp - " + to_string(var.offset) + "], rax");
+                if (integerType(node->value.get()) != DataType::LONG) emit("movsx rax, eax");
+                emit("mov " + varOperand(var) + ", rax");
             } else {
-                emit("mov [rbp - " + to_string(var.offset) + "], eax");
+                emit("mov " + varOperand(var) + ", eax");
             }
         }
     }
 }
 
 void CodeGen::visitBlock(Block* node) {
+    int blockOffset = stackOffset;
     for (auto& stmt : node->statements) {
-        stmt->accept(this);
+        visit(stmt.get());
     }
+    // Las locales del bloque ya no se usan: su lugar queda para lo que sigue
+    frameSize = max(frameSize, stackOffset);
+    stackOffset = blockOffset;
 }
 
 void CodeGen::visitIfStmt(IfStmt* node) {
@@ -839,39 +1458,39 @@ void CodeGen::visitIfStmt(IfStmt* node) {
     string labelEnd = newLabel("endif_");
 
     // Evaluar condición
-    node->condition->accept(this);
-    emit("test rax, rax");
-
     if (node->elseBranch) {
-        emit("jz " + labelElse);
-        node->thenBranch->accept(this);
+        emitCondJump(node->condition.get(), labelElse, false);
+        visit(node->thenBranch.get());
         emit("jmp " + labelEnd);
 
         emitLabel(labelElse);
-        node->elseBranch->accept(this);
+        visit(node->elseBranch.get());
         emitLabel(labelEnd);
     } else {
-        emit("jz " + labelEnd);
-        node->thenBranch->accept(this);
+        emitCondJump(node->condition.get(), labelEnd, false);
+        visit(node->thenBranch.get());
         emitLabel(labelEnd);
     }
 }
 
+// Los loops se emiten rotados: la condición se prueba una vez antes de
+// entrar y después al final del cuerpo, con un único salto hacia atrás
+// por iteración. El inicio del cuerpo se alinea a 16 bytes.
 void CodeGen::visitWhileStmt(WhileStmt* node) {
     string labelStart = newLabel("while_start_");
     string labelEnd = newLabel("while_end_");
 
-    emitLabel(labelStart);
+    // Guarda: si la condición es falsa de entrada no se entra
+    emitCondJump(node->condition.get(), labelEnd, false);
 
-    // Evaluar condición
-    node->condition->accept(this);
-    emit("test rax, rax");
-    emit("jz " + labelEnd);
+    emit("align 16");
+    emitLabel(labelStart);
 
     // Cuerpo del while
-    node->body->accept(this);
+    visit(node->body.get());
 
-    emit("jmp " + labelStart);
+    // Condición al final: vuelve al principio mientras sea verdadera
+    emitCondJump(node->condition.get(), labelStart, true);
     emitLabel(labelEnd);
 }
 
@@ -881,101 +1500,177 @@ void CodeGen::visitForStmt(ForStmt* node) {
 
     // Inicializador
     if (node->initializer) {
-        node->initializer->accept(this);
+        visit(node->initializer.get());
     }
 
-    emitLabel(labelStart);
+    // Si se puede, la mayor parte de las iteraciones van en un loop
+    // vectorial y el resto sigue abajo
+    emitVectorLoop(node);
 
-    // Condición
+    // Guarda
     if (node->condition) {
-        node->condition->accept(this);
-        emit("test rax, rax");
-        emit("jz " + labelEnd);
+        emitCondJump(node->condition.get(), labelEnd, false);
     }
 
+    // Punteros de los accesos a arrays afines en el contador
+    vector<pair<string, int>> pointers;
+    string lftrPointer, lftrEnd;
+    emitStridedPointers(node, pointers, lftrPointer, lftrEnd);
+
+    emit("align 16");
+    emitLabel(labelStart);
 
     // Cuerpo
-    node->body->accept(this);
+    visit(node->body.get());
 
-    // Incremento
-    if (node->increment) {
-        node->increment->accept(this);
+    // Incremento (el contador no hace falta si la condición usa los punteros)
+    if (node->increment && lftrEnd.empty()) {
+        visit(node->increment.get());
+    }
+    for (auto& pointer : pointers) {
+        if (pointer.second < 0) {
+            emit("sub " + pointer.first + ", " + to_string(-pointer.second));
+        } else {
+            emit("add " + pointer.first + ", " + to_string(pointer.second));
+        }
     }
 
-    emit("jmp " + labelStart);
+    // Condición al final
+    if (!lftrEnd.empty()) {
+        BinaryOp* compare = nodeCast<BinaryOp>(node->condition.get());
+        emit("cmp " + lftrPointer + ", " + lftrEnd);
+        emit("j" + conditionCode(compare->op.type, true, false) + " " + labelStart);  // Sin signo
+    } else if (node->condition) {
+        emitCondJump(node->condition.get(), labelStart, true);
+    } else {
+        emit("jmp " + labelStart);
+    }
     emitLabel(labelEnd);
+
+    // Liberar en orden inverso (los accesos de un for externo siguen)
+    if (!lftrEnd.empty()) freeReg(lftrEnd);
+    for (auto it = pointers.rbegin(); it != pointers.rend(); ++it) {
+        freeReg(it->first);
+        for (auto access = stridedAccesses.begin(); access != stridedAccesses.end();) {
+            access = access->second.first == it->first ? stridedAccesses.erase(access) : next(access);
+        }
+    }
 }
 
 void CodeGen::visitReturnStmt(ReturnStmt* node) {
+    // Tail call: el callee devuelve su valor directamente a nuestro caller,
+    // así que se desarma el frame y se salta (stack constante)
+    CallExpr* call = nodeCast<CallExpr>(node->value.get());
+    if (call && canTailCall(call)) {
+        emitCallArguments(call);
+        emitFunctionEpilog("jmp " + string(call->functionName));
+        tailCalls++;
+        return;
+    }
+
     if (node->value) {
-        node->value->accept(this);
+        visit(node->value.get());
     }
 
     emitFunctionEpilog();
 }
 
+// El jmp solo vale si el valor de retorno queda donde nuestro caller lo
+// espera (mismo tipo) y todos los argumentos van en registros enteros
+bool CodeGen::canTailCall(CallExpr* call) {
+    FunctionInfo* callee = functions.find(call->functionSymbol);
+    if (!callee || callee->returnType != currentReturnType) return false;
+    if (call->arguments.size() > 6 || call->arguments.size() != callee->paramTypes.size()) return false;
+
+    for (size_t i = 0; i < call->arguments.size(); i++) {
+        DataType type = callee->paramTypes[i];
+        if (type != DataType::INT && type != DataType::LONG) return false;
+        if (Variable* var = nodeCast<Variable>(call->arguments[i].get())) {
+            VarInfo* info = localVars.find(var->symbol);
+            if (!info) info = globalVars.find(var->symbol);
+            if (!info || info->isArray || info->type == DataType::FLOAT) return false;
+        }
+    }
+    return true;
+}
+
 void CodeGen::visitExprStmt(ExprStmt* node) {
-    node->expression->accept(this);
+    visit(node->expression.get());
 }
 
 void CodeGen::visitFunctionDecl(FunctionDecl* node) {
     currentFunction = node->name;
-    localVars.clear();
+    currentReturnType = node->returnType;
+    localVars.clear();  // O(1): solo sube la generación
     stackOffset = 0;
+    frameSize = 0;
+
+    // Intervalos de vida y registros de las variables de la función
+    regAlloc.allocate(node);
+    resetScratchRegs();
 
     // Registrar función
     FunctionInfo funcInfo;
     funcInfo.returnType = node->returnType;
     for (auto& param : node->parameters) {
-        funcInfo.paramTypes.push_back(param.first);
+        funcInfo.paramTypes.push_back(param.type);
     }
-    functions[node->name] = funcInfo;
+    functions[node->symbol] = funcInfo;
 
     // Emitir label de función
-    emitLabel(node->name);
+    emitLabel(string(node->name));
 
     // Prólogo (lo completaremos después de saber el tamaño del stack)
     emit("push rbp");
     emit("mov rbp, rsp");
 
-    // Guardar parámetros en stack
+    // Hueco para "sub rsp, N": se rellena al final sin reescribir la salida
+    flushText();
+    size_t prologueSlot = textChunks.size();
+    textChunks.push_back("");
+
+    // Guardar los callee-saved que vamos a usar (se restauran en el epílogo)
+    savedRegs.clear();
+    for (const string& reg : regAlloc.usedCalleeSaved()) {
+        stackOffset += 8;
+        savedRegs.push_back({reg, stackOffset});
+        emit("mov [rbp - " + to_string(stackOffset) + "], " + reg);
+    }
+
+    // Guardar parámetros en stack (o en su registro asignado)
     vector<string> paramRegs = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
     for (size_t i = 0; i < node->parameters.size() && i < 6; i++) {
         auto& param = node->parameters[i];
 
         int size = 4;
-        if (param.first == DataType::LONG) size = 8;
+        if (param.type == DataType::LONG) size = 8;
 
-        stackOffset += size;
+        string reg = regAlloc.registerForParam(i);
+        if (reg.empty()) {
+            stackOffset += size;
+        }
 
         VarInfo varInfo;
-        varInfo.type = param.first;
+        varInfo.type = param.type;
         varInfo.offset = stackOffset;
+        varInfo.reg = reg;
         varInfo.isArray = false;
-        localVars[param.second] = varInfo;
+        localVars[param.symbol] = varInfo;
 
-        if (param.first == DataType::LONG) {
-            emit("mov [rbp - " + to_string(stackOffset) + "], " + paramRegs[i]);
+        if (param.type == DataType::LONG) {
+            emit("mov " + varOperand(varInfo) + ", " + paramRegs[i]);
         } else {
             // Para registros de 32 bits: rdi->edi, rsi->esi, etc.
-            string reg32;
-            if (paramRegs[i] == "rdi") reg32 = "edi";
-            else if (paramRegs[i] == "rsi") reg32 = "esi";
-            else if (paramRegs[i] == "rdx") reg32 = "edx";
-            else if (paramRegs[i] == "rcx") reg32 = "ecx";
-            else if (paramRegs[i] == "r8") reg32 = "r8d";
-            else if (paramRegs[i] == "r9") reg32 = "r9d";
-
-            emit("mov [rbp - " + to_string(stackOffset) + "], " + reg32);
+            emit("mov " + varOperand(varInfo) + ", " + reg32(paramRegs[i]));
         }
     }
 
     // Cuerpo de la función
-    node->body->accept(this);
+    visit(node->body.get());
 
     // Ahora que sabemos el tamaño total del stack, reservar espacio
     // CRÍTICO: Alinear a 16 bytes considerando que push rbp ya desalineó
-    int stackSize = stackOffset;
+    int stackSize = max(frameSize, stackOffset);
 
     // Después de push rbp, rsp % 16 = 8
     // Necesitamos que después de sub rsp, stackSize: rsp % 16 = 0
@@ -984,22 +1679,9 @@ void CodeGen::visitFunctionDecl(FunctionDecl* node) {
         stackSize = ((stackSize / 16) + 1) * 16;
     }
 
-    // Insertar reserva de stack después de mov rbp, rsp de esta función
-    string currentOutput = output.str();
-    string funcLabel = node->name + ":";
-    size_t funcLabelPos = currentOutput.rfind(funcLabel);
-    if (funcLabelPos != string::npos) {
-        size_t searchStart = funcLabelPos;
-        size_t markerPos = currentOutput.find("mov rbp, rsp", searchStart);
-        if (markerPos != string::npos) {
-            size_t insertPos = currentOutput.find("\n", markerPos) + 1;
-            if (stackSize > 0) {
-                string reserveCode = "    sub rsp, " + to_string(stackSize) + "\n";
-                currentOutput.insert(insertPos, reserveCode);
-                output.str("");
-                output << currentOutput;
-            }
-        }
+    // Rellenar el hueco del prólogo con la reserva de stack
+    if (stackSize > 0) {
+        textChunks[prologueSlot] = "    sub rsp, " + to_string(stackSize) + "\n";
     }
 
     // Si no hubo return explícito
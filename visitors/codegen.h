@@ -2,11 +2,17 @@
 #define CODEGEN_H
 
 #include "../parser/ast.h"
+#include "../parser/ast_visitor.h"
+#include "regalloc.h"
+#include "peephole.h"
+#include "induction.h"
+#include "vectorizer.h"
 #include <string>
-#include <map>
+#include <string_view>
 #include <vector>
 #include <sstream>
 #include <stack>
+#include <unordered_map>
 
 using namespace std;
 
@@ -14,6 +20,7 @@ using namespace std;
 struct VarInfo {
     DataType type;
     int offset;  // Offset desde RBP
+    string reg;  // Registro asignado por RegisterAllocator ("" = en memoria)
     bool isArray;
     vector<int> dimensions;
 };
@@ -25,74 +32,176 @@ struct FunctionInfo {
     int stackSize;
 };
 
-class CodeGen : public Visitor {
+// Usa despacho estático por NodeKind (ver ast_visitor.h)
+class CodeGen : public StaticVisitor<CodeGen> {
 private:
+    // Código de la función (o sentencia global) que se está generando.
+    // emit() escribe aquí; al terminar se pasa a textChunks con flushText().
     stringstream output;
+
+    // Secciones del archivo: solo se agrega al final y se concatenan una
+    // única vez en getOutput(), así el costo total es lineal.
+    stringstream dataSection;    // Variables globales inicializadas
+    stringstream rodataSection;  // Constantes: formatos de printf, floats, strings
+    stringstream bssSection;     // Variables globales sin inicializar
+    vector<string> textChunks;   // .text en trozos; algunos son huecos de prólogo
     
-    // Tablas de símbolos
-    map<string, VarInfo> localVars;     // Variables locales
-    map<string, VarInfo> globalVars;    // Variables globales
-    map<string, FunctionInfo> functions; // Funciones
+    // Tablas de símbolos indexadas por SymbolId (ver symbol_table.h)
+    SymbolMap<VarInfo> localVars;       // Variables locales
+    SymbolMap<VarInfo> globalVars;      // Variables globales
+    SymbolMap<FunctionInfo> functions;  // Funciones
     
     // Estado actual
     string currentFunction;
+    DataType currentReturnType = DataType::INT;
     int stackOffset;
+    // Mayor stackOffset de la función: al salir de un bloque sus locales
+    // (y después de un call los slots de sus argumentos) dejan el lugar a
+    // lo que sigue, y el frame solo reserva el máximo
+    int frameSize = 0;
     int labelCounter;
     
-    // Stack de registros para expresiones
+    // Stack de registros para expresiones: valores intermedios guardados
+    // en registros scratch (el tope es el último reservado)
     stack<string> regStack;
+    vector<string> intScratch;      // Libres en la función actual
+    vector<string> floatScratch;
+    size_t intScratchUsed = 0;
+    size_t floatScratchUsed = 0;
     bool lastExprWasFloat;
+
+    // Registros de las variables locales (ver regalloc.h)
+    RegisterAllocator regAlloc;
+    vector<pair<string, int>> savedRegs;  // Callee-saved guardados: (registro, offset)
+
+    // Limpieza del código de cada función antes de pasarlo a .text
+    PeepholeOptimizer peephole;
+
+    // Reducción de fuerza de los índices de arrays en los for (ver induction.h):
+    // acceso -> (registro puntero, desplazamiento en bytes)
+    InductionAnalysis induction;
+    unordered_map<const void*, pair<string, int>> stridedAccesses;
+
+    // Loop vectorial en curso (ver vectorizer.h)
+    bool vectorFloat = false;
+    SymbolId vectorCounter = NO_SYMBOL;
+    vector<pair<SymbolId, string>> vectorBroadcasts;  // Invariante -> registro replicado
     
     // Helpers
     string newLabel(string prefix = "L");
     void emit(string code);
     void emitLabel(string label);
+    void flushText();
     
     // Gestión de registros
-    string allocReg(DataType type);
+    void resetScratchRegs();
+    string allocReg(DataType type);   // "" si no queda ninguno libre
     void freeReg(string reg);
+
+    // Guarda el resultado actual (rax / xmm0) mientras se evalúa una
+    // expresión que necesita `need` registros: en un scratch del stack de
+    // registros si no la pisa, si no en el stack de la máquina.
+    // tempOperand devuelve dónde leerlo: el scratch (ya liberado, hay que
+    // usarlo en la instrucción siguiente) o `scratch`, donde lo deja el pop.
+    // restoreTemp lo deja en `target`.
+    string saveTemp(bool isFloat, int need);
+    string tempOperand(const string& saved, bool isFloat, const string& scratch);
+    void restoreTemp(const string& saved, bool isFloat, const string& target);
     
+    // Operando de una variable escalar: "[rbp - N]" o su registro,
+    // con el ancho que corresponde al tipo (r12d para int, r12 para long)
+    string varOperand(const VarInfo& var);
+
+    // Evalúa los operandos de una operación binaria: el izquierdo queda en
+    // rax/xmm0 y el derecho en rightOperand. Devuelve true si quedaron al
+    // revés (solo en operaciones conmutativas y comparaciones).
+    bool emitOperands(BinaryOp* node, bool& isFloatOp, string& rightOperand);
+
+    // Condiciones de if/while/for/ternario: cmp + jcc y && / || con saltos
+    void emitCondJump(Expr* condition, const string& label, bool jumpIfTrue);
+
     // Conversión de tipos
     void emitTypeConversion(DataType from, DataType to, string reg);
+
+    // Tipo entero (INT o LONG) del valor de una expresión no float
+    DataType integerType(Expr* expr);
     
     // Gestión de stack frame
     void emitFunctionProlog(string funcName, int stackSize);
-    void emitFunctionEpilog();
+    void emitFunctionEpilog(const string& exit = "ret");
+    void emitCallArguments(CallExpr* node);
+    bool canTailCall(CallExpr* call);
     
     // Helpers para arrays
-    void emitArrayAccess(string arrayName, vector<unique_ptr<Expr>>& indices);
+    void emitArrayAccess(string arrayName, ExprList& indices);
+    string emitElementAddress(VarInfo* array, ExprList& indices);  // Operando indexado por rax
+    string stridedOperand(const void* node);                       // "" si no tiene puntero
+    void emitElementLoad(DataType type, const string& address);
+    bool emitStridedPointers(ForStmt* node, vector<pair<string, int>>& pointers, string& lftrPointer, string& lftrEnd);
     int calculateArrayOffset(vector<int>& dimensions, int dimIndex);
 
+    // Vectorización (SSE2, o AVX2 con useAVX2)
+    bool emitVectorLoop(ForStmt* node);
+    int vectorNeed(Expr* expr);
+    pair<string, bool> emitVectorExpr(Expr* expr);
+    string emitVectorConstant(double value);  // Operando en .rodata, replicado
+    string vectorReg(const string& reg);   // xmm -> ymm con AVX2
+    void emitVectorOp(const string& op, const string& dst, const string& src);
+    void emitVectorMove(const string& op, const string& dst, const string& src);
+
 public:
+    // Valores intermedios de expresiones: guardados en registro / en el stack
+    int tempsInRegisters = 0;
+    int tempsSpilled = 0;
+
+    // Reducción de fuerza: accesos con puntero propio / contadores eliminados
+    int stridedAccessCount = 0;
+    int countersRemoved = 0;
+
+    // Target: AVX2 (8 carriles, --target=avx2) o SSE2 (4 carriles)
+    bool useAVX2 = false;
+    int vectorizedLoops = 0;
+
+    // return f(...) emitidos como jmp f
+    int tailCalls = 0;
+
     CodeGen();
     
     string getOutput();
+    const RegisterAllocator& registerAllocator() const { return regAlloc; }
+    const PeepholeOptimizer& peepholeOptimizer() const { return peephole; }
     void generate(Program* program);
+
+    // Nombre de 32 bits de un registro de 64 (rbx -> ebx, r12 -> r12d)
+    static string reg32(const string& reg);
+
+    // Operandos de "db" para un literal de string tal cual está en el fuente
+    static string nasmStringLiteral(string_view escaped);
     
-    // Visitor methods - Expresiones
-    void visitIntLiteral(IntLiteral* node) override;
-    void visitFloatLiteral(FloatLiteral* node) override;
-    void visitLongLiteral(LongLiteral* node) override;
-    void visitStringLiteral(StringLiteral* node) override;
-    void visitVariable(Variable* node) override;
-    void visitBinaryOp(BinaryOp* node) override;
-    void visitUnaryOp(UnaryOp* node) override;
-    void visitCastExpr(CastExpr* node) override;
-    void visitTernaryExpr(TernaryExpr* node) override;
-    void visitCallExpr(CallExpr* node) override;
-    void visitArrayAccess(ArrayAccess* node) override;
-    void visitAssignExpr(AssignExpr* node) override;
+    // Visit methods - Expresiones
+    void visitIntLiteral(IntLiteral* node);
+    void visitFloatLiteral(FloatLiteral* node);
+    void visitLongLiteral(LongLiteral* node);
+    void visitStringLiteral(StringLiteral* node);
+    void visitVariable(Variable* node);
+    void visitBinaryOp(BinaryOp* node);
+    void visitUnaryOp(UnaryOp* node);
+    void visitCastExpr(CastExpr* node);
+    void visitTernaryExpr(TernaryExpr* node);
+    void visitCallExpr(CallExpr* node);
+    void visitArrayAccess(ArrayAccess* node);
+    void visitAssignExpr(AssignExpr* node);
     
-    // Visitor methods - Statements
-    void visitVarDecl(VarDecl* node) override;
-    void visitAssignStmt(AssignStmt* node) override;
-    void visitBlock(Block* node) override;
-    void visitIfStmt(IfStmt* node) override;
-    void visitWhileStmt(WhileStmt* node) override;
-    void visitForStmt(ForStmt* node) override;
-    void visitReturnStmt(ReturnStmt* node) override;
-    void visitExprStmt(ExprStmt* node) override;
-    void visitFunctionDecl(FunctionDecl* node) override;
+    // Visit methods - Statements
+    void visitVarDecl(VarDecl* node);
+    void visitAssignStmt(AssignStmt* node);
+    void visitBlock(Block* node);
+    void visitIfStmt(IfStmt* node);
+    void visitWhileStmt(WhileStmt* node);
+    void visitForStmt(ForStmt* node);
+    void visitReturnStmt(ReturnStmt* node);
+    void visitExprStmt(ExprStmt* node);
+    void visitFunctionDecl(FunctionDecl* node);
 };
 
 #endif
@@ -0,0 +1,603 @@
+#include "gvn.h"
+#include "vectorizer.h"
+#include <cstring>
+
+// ========== EXPRESIONES PURAS ==========
+
+void PureExpressions::declareFunction(FunctionDecl* func, const SymbolSet& globals) {
+    locals.declareFunction(func, globals);
+}
+
+void PureExpressions::declareTemp(SymbolId symbol, DataType type) {
+    locals.declare(symbol, type, nullptr);
+}
+
+int PureExpressions::slotOf(SymbolId symbol) {
+    int slot = locals.slotOf(symbol);
+    if (slot < 0) return -1;
+    DataType type = locals.type(slot);
+    return type == DataType::INT || type == DataType::FLOAT || type == DataType::LONG ? slot : -1;
+}
+
+const vector<int>* PureExpressions::dimensionsOf(SymbolId array) {
+    int slot = slotOf(array);
+    return slot >= 0 && locals.isArray(slot) ? &locals.dimensions(slot) : nullptr;
+}
+
+// ========== RECORRIDO ==========
+
+void ValueNumbering::run(FunctionDecl* func, Arena* arena, SymbolTable* symbols, const SymbolSet& globals) {
+    this->arena = arena;
+    this->symbols = symbols;
+    functionName = func->name;
+    entries.clear();
+    frames.clear();
+    if (!func->body) return;
+    expressions.declareFunction(func, globals);
+
+    Table table;
+    processBlock(func->body.get(), table);
+}
+
+void ValueNumbering::processBlock(Block* block, Table& table) {
+    StmtList& statements = block->statements;
+    frames.emplace_back();
+    int frame = (int)frames.size() - 1;
+    frames[frame].before.resize(statements.size());
+
+    for (size_t i = 0; i < statements.size(); i++) {
+        processStmt(statements[i].get(), i, table);
+    }
+
+    // Las variables nuevas van antes del statement de su primera aparición
+    Frame done = move(frames[frame]);
+    frames.pop_back();
+    bool inserted = false;
+    for (auto& stmts : done.before) {
+        if (!stmts.empty()) inserted = true;
+    }
+    if (!inserted) return;
+
+    StmtList output(arena);
+    for (size_t i = 0; i < statements.size(); i++) {
+        for (auto& decl : done.before[i]) {
+            output.push_back(move(decl));
+        }
+        output.push_back(move(statements[i]));
+    }
+    block->statements = move(output);
+}
+
+// Rama de un if o cuerpo de un loop: ve lo disponible afuera, pero lo que
+// aparece adentro no sale. Si no es un bloque y hay que declarar algo,
+// pasa a serlo
+void ValueNumbering::processBranch(StmtPtr& branch, const Table& table) {
+    if (!branch) return;
+    Table inner = table;
+    if (Block* block = nodeCast<Block>(branch.get())) {
+        processBlock(block, inner);
+        return;
+    }
+
+    StmtList statements(arena);
+    statements.push_back(move(branch));
+    NodePtr<Block> block = arena->make<Block>(move(statements));
+    processBlock(block.get(), inner);
+    if (block->statements.size() == 1) {
+        branch = move(block->statements[0]);
+    } else {
+        branch = move(block);
+    }
+}
+
+void ValueNumbering::processStmt(Stmt* stmt, size_t index, Table& table) {
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            if (varDecl->initializer && !containsAssign(varDecl->initializer.get())) {
+                scan(varDecl->initializer, table, index, true, -1);
+            }
+            for (auto& element : varDecl->arrayInitializer) {
+                if (!containsAssign(element.get())) scan(element, table, index, true, -1);
+            }
+            break;
+        }
+
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            bool pure = !containsAssign(assign->value.get());
+            for (auto& i : assign->indices) {
+                if (containsAssign(i.get())) pure = false;
+            }
+            if (!pure) break;
+            for (auto& i : assign->indices) {
+                scan(i, table, index, true, -1);
+            }
+            scan(assign->value, table, index, true, -1);
+            break;
+        }
+
+        case NodeKind::ExprStmt: {
+            ExprStmt* exprStmt = static_cast<ExprStmt*>(stmt);
+            if (!containsAssign(exprStmt->expression.get())) {
+                scan(exprStmt->expression, table, index, true, -1);
+            }
+            break;
+        }
+
+        case NodeKind::ReturnStmt: {
+            ReturnStmt* ret = static_cast<ReturnStmt*>(stmt);
+            if (ret->value && !containsAssign(ret->value.get())) {
+                scan(ret->value, table, index, true, -1);
+            }
+            break;
+        }
+
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            if (!containsAssign(ifStmt->condition.get())) {
+                scan(ifStmt->condition, table, index, true, -1);
+            }
+            killAssigned(ifStmt->condition.get(), table);
+            processBranch(ifStmt->thenBranch, table);
+            processBranch(ifStmt->elseBranch, table);
+            break;
+        }
+
+        // La condición se vuelve a evaluar en cada vuelta: solo reusa lo
+        // que el loop no cambia, y no adelanta nada antes del loop
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            killAssigned(stmt, table);
+            if (!containsAssign(whileStmt->condition.get())) {
+                scan(whileStmt->condition, table, index, false, -1);
+            }
+            processBranch(whileStmt->body, table);
+            break;
+        }
+
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            if (forStmt->initializer) processStmt(forStmt->initializer.get(), index, table);
+
+            // Un cuerpo que CodeGen vectoriza se deja como está (una
+            // variable en el medio le cambia la forma)
+            LoopVectorizer::Loop vectorLoop;
+            bool vectorizable = LoopVectorizer::analyze(forStmt, vectorLoop);
+            killAssigned(stmt, table);
+            if (vectorizable) break;
+            if (forStmt->condition && !containsAssign(forStmt->condition.get())) {
+                scan(forStmt->condition, table, index, false, -1);
+            }
+            processBranch(forStmt->body, table);
+            break;
+        }
+
+        case NodeKind::Block: {
+            Table inner = table;
+            processBlock(static_cast<Block*>(stmt), inner);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    killAssigned(stmt, table);
+}
+
+void ValueNumbering::scan(ExprPtr& slot, Table& table, size_t index, bool canDefine, int parent) {
+    Expr* expr = slot.get();
+    if (!expr) return;
+
+    if (isCandidate(expr)) {
+        string key;
+        vector<SymbolId> reads;
+        if (expressions.keyOf(expr, key, reads)) {
+            auto it = table.find(key);
+            if (it != table.end() && !entries[it->second].covered) {
+                reuse(it->second, slot);
+                return;
+            }
+            DataType type = canDefine ? expressions.typeOf(expr) : DataType::UNKNOWN;
+            if (type != DataType::UNKNOWN) {
+                Entry entry;
+                entry.first = &slot;
+                entry.frame = (int)frames.size() - 1;
+                entry.index = index;
+                entry.parent = parent;
+                entry.type = type;
+                entry.reads = move(reads);
+                entries.push_back(move(entry));
+                parent = (int)entries.size() - 1;
+                table[key] = parent;
+            }
+        }
+    }
+
+    switch (expr->kind) {
+        case NodeKind::BinaryOp: {
+            // El lado derecho de && y || puede no evaluarse
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            bool shortCircuit = binary->op.type == TokenType::AND || binary->op.type == TokenType::OR;
+            scan(binary->left, table, index, canDefine, parent);
+            scan(binary->right, table, index, canDefine && !shortCircuit, parent);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            scan(static_cast<UnaryOp*>(expr)->operand, table, index, canDefine, parent);
+            break;
+        case NodeKind::CastExpr:
+            scan(static_cast<CastExpr*>(expr)->expr, table, index, canDefine, parent);
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            scan(ternary->condition, table, index, canDefine, parent);
+            scan(ternary->exprTrue, table, index, false, parent);
+            scan(ternary->exprFalse, table, index, false, parent);
+            break;
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                scan(arg, table, index, canDefine, parent);
+            }
+            break;
+        case NodeKind::ArrayAccess:
+            for (auto& i : static_cast<ArrayAccess*>(expr)->indices) {
+                scan(i, table, index, canDefine, parent);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void ValueNumbering::reuse(int id, ExprPtr& slot) {
+    if (entries[id].temp == NO_SYMBOL) {
+        // Primera repetición: la primera aparición pasa a la variable
+        Entry& entry = entries[id];
+        string name = string(functionName) + ".cse" + to_string(++temporaries);
+        entry.temp = symbols->internCopy(name);
+        expressions.declareTemp(entry.temp, entry.type);
+        string_view tempName = symbols->name(entry.temp);
+        ExprPtr value = move(*entry.first);
+        *entry.first = arena->make<Variable>(tempName, entry.temp);
+        frames[entry.frame].before[entry.index].push_back(
+            arena->make<VarDecl>(entry.type, tempName, entry.temp, move(value)));
+
+        // Lo que estaba adentro ahora se calcula en la declaración: no se
+        // reusa desde ahí (habría que declararlo antes)
+        for (size_t i = id + 1; i < entries.size(); i++) {
+            int p = entries[i].parent;
+            while (p > id) p = entries[p].parent;
+            if (p == id && entries[i].temp == NO_SYMBOL) entries[i].covered = true;
+        }
+    }
+
+    const Entry& entry = entries[id];
+    slot = arena->make<Variable>(symbols->name(entry.temp), entry.temp);
+    reusedExpressions++;
+}
+
+// ========== CLAVES ==========
+
+bool ValueNumbering::isCandidate(Expr* expr) {
+    auto isLeaf = [](Expr* e) {
+        return e->kind == NodeKind::Variable || e->kind == NodeKind::IntLiteral ||
+               e->kind == NodeKind::FloatLiteral || e->kind == NodeKind::LongLiteral;
+    };
+
+    switch (expr->kind) {
+        case NodeKind::ArrayAccess:
+        case NodeKind::CastExpr:
+            return true;
+
+        // Las comparaciones quedan en su salto y x ± y cuesta lo mismo que
+        // leer la variable (i + 1 además es un índice que CodeGen recorre
+        // con un puntero, ver induction.h)
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            switch (binary->op.type) {
+                case TokenType::EQ: case TokenType::NE:
+                case TokenType::LT: case TokenType::GT:
+                case TokenType::LE: case TokenType::GE:
+                case TokenType::AND: case TokenType::OR:
+                    return false;
+                case TokenType::PLUS: case TokenType::MINUS:
+                    return !isLeaf(binary->left.get()) || !isLeaf(binary->right.get());
+                default:
+                    return true;
+            }
+        }
+
+        case NodeKind::UnaryOp:
+            return !isLeaf(static_cast<UnaryOp*>(expr)->operand.get());
+
+        default:
+            return false;
+    }
+}
+
+bool PureExpressions::keyOf(Expr* expr, string& key, vector<SymbolId>& reads) {
+    switch (expr->kind) {
+        case NodeKind::IntLiteral:
+            key += "i" + to_string(static_cast<IntLiteral*>(expr)->value);
+            return true;
+        case NodeKind::LongLiteral:
+            key += "l" + to_string(static_cast<LongLiteral*>(expr)->value);
+            return true;
+        case NodeKind::FloatLiteral: {
+            float value = static_cast<FloatLiteral*>(expr)->value;
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(bits));
+            key += "f" + to_string(bits);
+            return true;
+        }
+
+        case NodeKind::Variable: {
+            SymbolId symbol = static_cast<Variable*>(expr)->symbol;
+            int slot = slotOf(symbol);
+            if (slot < 0 || locals.isArray(slot)) return false;
+            key += "v" + to_string(symbol);
+            reads.push_back(symbol);
+            return true;
+        }
+
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* access = static_cast<ArrayAccess*>(expr);
+            SymbolId symbol = access->arraySymbol;
+            int slot = slotOf(symbol);
+            if (slot < 0 || !locals.isArray(slot)) return false;
+            key += "a" + to_string(symbol);
+            reads.push_back(symbol);
+            for (auto& index : access->indices) {
+                key += "[";
+                if (!keyOf(index.get(), key, reads)) return false;
+                key += "]";
+            }
+            return true;
+        }
+
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            string left, right;
+            if (!keyOf(binary->left.get(), left, reads) || !keyOf(binary->right.get(), right, reads)) {
+                return false;
+            }
+            TokenType op = binary->op.type;
+            bool commutative = op == TokenType::PLUS || op == TokenType::MULTIPLY ||
+                               op == TokenType::EQ || op == TokenType::NE;
+            if (commutative && right < left) swap(left, right);
+            // Los shifts de la reducción de fuerza no tienen token propio
+            key += "(";
+            key += op == TokenType::UNKNOWN ? string(binary->op.lexeme) : to_string((int)op);
+            key += " " + left + " " + right + ")";
+            return true;
+        }
+
+        case NodeKind::UnaryOp: {
+            UnaryOp* unary = static_cast<UnaryOp*>(expr);
+            key += "(u" + to_string((int)unary->op.type) + " ";
+            if (!keyOf(unary->operand.get(), key, reads)) return false;
+            key += ")";
+            return true;
+        }
+
+        case NodeKind::CastExpr: {
+            CastExpr* cast = static_cast<CastExpr*>(expr);
+            key += "(c" + to_string((int)cast->targetType) + " ";
+            if (!keyOf(cast->expr.get(), key, reads)) return false;
+            key += ")";
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+DataType PureExpressions::typeOf(Expr* expr) {
+    switch (expr->kind) {
+        case NodeKind::IntLiteral:
+            return DataType::INT;
+        case NodeKind::LongLiteral:
+            return DataType::LONG;
+        case NodeKind::FloatLiteral:
+            return DataType::FLOAT;
+
+        case NodeKind::Variable: {
+            int slot = slotOf(static_cast<Variable*>(expr)->symbol);
+            return slot >= 0 ? locals.type(slot) : DataType::UNKNOWN;
+        }
+        case NodeKind::ArrayAccess: {
+            int slot = slotOf(static_cast<ArrayAccess*>(expr)->arraySymbol);
+            return slot >= 0 ? locals.type(slot) : DataType::UNKNOWN;
+        }
+
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            switch (binary->op.type) {
+                case TokenType::EQ: case TokenType::NE:
+                case TokenType::LT: case TokenType::GT:
+                case TokenType::LE: case TokenType::GE:
+                case TokenType::AND: case TokenType::OR:
+                    return DataType::INT;
+                case TokenType::UNKNOWN:
+                    return typeOf(binary->left.get());
+                default:
+                    break;
+            }
+            DataType left = typeOf(binary->left.get());
+            DataType right = typeOf(binary->right.get());
+            if (left == DataType::UNKNOWN || right == DataType::UNKNOWN) return DataType::UNKNOWN;
+            if (left == DataType::FLOAT || right == DataType::FLOAT) return DataType::FLOAT;
+            if (left == DataType::LONG || right == DataType::LONG) return DataType::LONG;
+            return DataType::INT;
+        }
+
+        case NodeKind::UnaryOp: {
+            UnaryOp* unary = static_cast<UnaryOp*>(expr);
+            if (unary->op.type == TokenType::NOT) return DataType::INT;
+            return typeOf(unary->operand.get());
+        }
+
+        case NodeKind::CastExpr:
+            return static_cast<CastExpr*>(expr)->targetType;
+
+        default:
+            return DataType::UNKNOWN;
+    }
+}
+
+// ========== ESCRITURAS ==========
+
+void ValueNumbering::kill(SymbolId symbol, Table& table) {
+    for (auto it = table.begin(); it != table.end();) {
+        const vector<SymbolId>& reads = entries[it->second].reads;
+        if (find(reads.begin(), reads.end(), symbol) != reads.end()) {
+            it = table.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void ValueNumbering::killAssigned(Stmt* stmt, Table& table) {
+    if (!stmt) return;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            kill(varDecl->symbol, table);
+            killAssigned(varDecl->initializer.get(), table);
+            for (auto& element : varDecl->arrayInitializer) {
+                killAssigned(element.get(), table);
+            }
+            break;
+        }
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            kill(assign->varSymbol, table);
+            for (auto& index : assign->indices) {
+                killAssigned(index.get(), table);
+            }
+            killAssigned(assign->value.get(), table);
+            break;
+        }
+        case NodeKind::ExprStmt:
+            killAssigned(static_cast<ExprStmt*>(stmt)->expression.get(), table);
+            break;
+        case NodeKind::ReturnStmt:
+            killAssigned(static_cast<ReturnStmt*>(stmt)->value.get(), table);
+            break;
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                killAssigned(s.get(), table);
+            }
+            break;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            killAssigned(ifStmt->condition.get(), table);
+            killAssigned(ifStmt->thenBranch.get(), table);
+            killAssigned(ifStmt->elseBranch.get(), table);
+            break;
+        }
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            killAssigned(whileStmt->condition.get(), table);
+            killAssigned(whileStmt->body.get(), table);
+            break;
+        }
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            killAssigned(forStmt->initializer.get(), table);
+            killAssigned(forStmt->condition.get(), table);
+            killAssigned(forStmt->increment.get(), table);
+            killAssigned(forStmt->body.get(), table);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ValueNumbering::killAssigned(Expr* expr, Table& table) {
+    if (!expr || !containsAssign(expr)) return;
+
+    switch (expr->kind) {
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            kill(assign->varSymbol, table);
+            for (auto& index : assign->indices) {
+                killAssigned(index.get(), table);
+            }
+            killAssigned(assign->value.get(), table);
+            break;
+        }
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            killAssigned(binary->left.get(), table);
+            killAssigned(binary->right.get(), table);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            killAssigned(static_cast<UnaryOp*>(expr)->operand.get(), table);
+            break;
+        case NodeKind::CastExpr:
+            killAssigned(static_cast<CastExpr*>(expr)->expr.get(), table);
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            killAssigned(ternary->condition.get(), table);
+            killAssigned(ternary->exprTrue.get(), table);
+            killAssigned(ternary->exprFalse.get(), table);
+            break;
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                killAssigned(arg.get(), table);
+            }
+            break;
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                killAssigned(index.get(), table);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool ValueNumbering::containsAssign(Expr* expr) {
+    if (!expr) return false;
+
+    switch (expr->kind) {
+        case NodeKind::AssignExpr:
+            return true;
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            return containsAssign(binary->left.get()) || containsAssign(binary->right.get());
+        }
+        case NodeKind::UnaryOp:
+            return containsAssign(static_cast<UnaryOp*>(expr)->operand.get());
+        case NodeKind::CastExpr:
+            return containsAssign(static_cast<CastExpr*>(expr)->expr.get());
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            return containsAssign(ternary->condition.get()) || containsAssign(ternary->exprTrue.get()) ||
+                   containsAssign(ternary->exprFalse.get());
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                if (containsAssign(arg.get())) return true;
+            }
+            return false;
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                if (containsAssign(index.get())) return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
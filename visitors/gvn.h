@@ -0,0 +1,121 @@
+#ifndef GVN_H
+#define GVN_H
+
+#include "../parser/ast.h"
+#include "cfg.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ========== EXPRESIONES PURAS ==========
+// Tipos de las locales de una función (ver LocalSlots) y claves de las
+// expresiones que solo leen locales escalares y arrays locales int, long o
+// float: símbolos, literales y
+// operadores, con los lados de + * == != ordenados. Dos expresiones con la
+// misma clave calculan el mismo valor mientras nadie escriba una variable
+// o un array que leen. Lo usan ValueNumbering y LoopInvariantMotion.
+class PureExpressions {
+public:
+    // Parámetros y locales de la función (descarta la anterior)
+    void declareFunction(FunctionDecl* func, const SymbolSet& globals);
+
+    // Variable nueva creada por un pase
+    void declareTemp(SymbolId symbol, DataType type);
+
+    // Clave de la expresión y lo que lee (false si no es pura o no se
+    // conoce el tipo de algo)
+    bool keyOf(Expr* expr, string& key, vector<SymbolId>& reads);
+    DataType typeOf(Expr* expr);
+
+    // Dimensiones de un array local (nullptr si no se conocen)
+    const vector<int>* dimensionsOf(SymbolId array);
+
+private:
+    LocalSlots locals;
+
+    // Slot de una local int, long o float (-1 si no se conoce su tipo)
+    int slotOf(SymbolId symbol);
+};
+
+// ========== NUMERACIÓN DE VALORES ==========
+// Eliminación de subexpresiones comunes sobre el AST de una función, con
+// las claves de PureExpressions:
+//
+//   x = a[i] * a[i] + k;            int f.cse1 = a[i];
+//   if (n > 0) {              ->    x = f.cse1 * f.cse1 + k;
+//       y = a[i] + 1;               if (n > 0) { y = f.cse1 + 1; }
+//   }
+//
+// La primera aparición pasa a una variable nueva, declarada justo antes
+// del statement que la contiene, y las siguientes la leen. Las
+// expresiones disponibles siguen el árbol de dominancia del AST: lo de un
+// statement vale para los que le siguen en el mismo bloque y para todo lo
+// que anidan, pero no sale de la rama de un if ni del cuerpo de un loop.
+// Antes de un loop se descarta lo que el loop escribe (el back-edge trae
+// otros valores).
+//
+// Solo entran locales escalares y arrays locales (un call puede cambiar
+// las globales). Lo que se evalúa de forma condicional (el lado derecho
+// de && y ||, las ramas de ?:) puede reusar un valor pero no se adelanta:
+// v[i] detrás de i < n no se puede leer antes de la comparación.
+class ValueNumbering {
+public:
+    // Reemplaza las subexpresiones repetidas de la función
+    void run(FunctionDecl* func, Arena* arena, SymbolTable* symbols, const SymbolSet& globals);
+
+    // Apariciones reemplazadas por una variable / variables creadas
+    int reusedExpressions = 0;
+    int temporaries = 0;
+
+private:
+    // Una expresión disponible: dónde apareció primero y, si ya se repitió,
+    // la variable que la guarda
+    struct Entry {
+        ExprPtr* first;
+        int frame;                 // Bloque y statement donde declarar la variable
+        size_t index;
+        int parent;                // Entry de la expresión que la contiene (-1)
+        DataType type;
+        vector<SymbolId> reads;    // Variables y arrays que lee
+        SymbolId temp = NO_SYMBOL;
+        bool covered = false;      // Quedó adentro de otra variable
+    };
+
+    // Clave -> entries
+    typedef unordered_map<string, int> Table;
+
+    // Statements a declarar antes de cada statement de un bloque
+    struct Frame {
+        vector<vector<StmtPtr>> before;
+    };
+
+    Arena* arena = nullptr;
+    SymbolTable* symbols = nullptr;
+    string_view functionName;
+    PureExpressions expressions;
+
+    vector<Entry> entries;
+    vector<Frame> frames;
+
+    // Recorre el bloque con las expresiones disponibles al entrar
+    void processBlock(Block* block, Table& table);
+    void processBranch(StmtPtr& branch, const Table& table);
+    void processStmt(Stmt* stmt, size_t index, Table& table);
+
+    // Reusa o registra las expresiones de `slot` y sus hijos
+    void scan(ExprPtr& slot, Table& table, size_t index, bool canDefine, int parent);
+    void reuse(int entry, ExprPtr& slot);
+
+    // ¿Vale la pena guardar la expresión en una variable?
+    bool isCandidate(Expr* expr);
+
+    // Descarta lo que lee los símbolos que escribe el statement
+    void killAssigned(Stmt* stmt, Table& table);
+    void killAssigned(Expr* expr, Table& table);
+    void kill(SymbolId symbol, Table& table);
+    bool containsAssign(Expr* expr);
+};
+
+#endif
@@ -0,0 +1,226 @@
+#include "induction.h"
+
+// ========== API ==========
+
+// i = i + k, i = i - k, i = k + i  ->  paso (0 si no tiene esa forma)
+static int counterStep(AssignExpr* increment, SymbolId counter) {
+    if (increment->isArrayAssign || increment->varSymbol != counter) return 0;
+    BinaryOp* binary = nodeCast<BinaryOp>(increment->value.get());
+    if (!binary) return 0;
+
+    TokenType op = binary->op.type;
+    Variable* var = nodeCast<Variable>(binary->left.get());
+    IntLiteral* literal = nodeCast<IntLiteral>(binary->right.get());
+    if (!var && op == TokenType::PLUS) {
+        var = nodeCast<Variable>(binary->right.get());
+        literal = nodeCast<IntLiteral>(binary->left.get());
+    }
+    if (!var || !literal || var->symbol != counter) return 0;
+    if (op == TokenType::PLUS) return literal->value;
+    if (op == TokenType::MINUS) return -literal->value;
+    return 0;
+}
+
+bool InductionAnalysis::analyze(ForStmt* loop, Loop& result) {
+    result = Loop();
+    AssignExpr* increment = loop->increment ? nodeCast<AssignExpr>(loop->increment.get()) : nullptr;
+    if (!increment) return false;
+    counter = increment->varSymbol;
+    result.counter = counter;
+    result.step = counterStep(increment, counter);
+    if (result.step == 0) return false;
+
+    // ¿El contador muere con el loop? (declarado en el inicializador)
+    bool counterIsLocal = false;
+    if (loop->initializer) {
+        VarDecl* decl = nodeCast<VarDecl>(loop->initializer.get());
+        counterIsLocal = decl && decl->symbol == counter && !decl->isArray && decl->initializer;
+    }
+
+    assigned.clear();
+    hasCall = false;
+    counterUses = 0;
+    arrayReads.clear();
+    arrayWrites.clear();
+
+    visit(loop->body.get());
+    int bodyUses = counterUses;
+    if (loop->condition) visit(loop->condition.get());
+    if (hasCall || assigned.contains(counter)) return false;
+
+    for (ArrayAccess* read : arrayReads) {
+        if (parseAccess(read, read->arraySymbol, read->indices, result)) {
+            for (const IndexTerm& term : result.accesses.back().indices) {
+                if (term.usesCounter) bodyUses--;
+            }
+        }
+    }
+    for (AssignStmt* write : arrayWrites) {
+        if (parseAccess(write, write->varSymbol, write->indices, result)) {
+            for (const IndexTerm& term : result.accesses.back().indices) {
+                if (term.usesCounter) bodyUses--;
+            }
+        }
+    }
+    if (result.accesses.empty()) return false;
+
+    // Condición "contador op constante"
+    BinaryOp* compare = loop->condition ? nodeCast<BinaryOp>(loop->condition.get()) : nullptr;
+    if (compare) {
+        Variable* var = nodeCast<Variable>(compare->left.get());
+        IntLiteral* literal = nodeCast<IntLiteral>(compare->right.get());
+        if (var && literal && var->symbol == counter) {
+            result.compareOp = compare->op.type;
+            result.bound = literal->value;
+        }
+    }
+    result.counterOnlyIndexes = counterIsLocal && bodyUses == 0 &&
+                                result.compareOp != TokenType::UNKNOWN;
+    return true;
+}
+
+// i, i + k, i - k, k + i, k, v (v invariante)
+bool InductionAnalysis::parseIndex(Expr* index, IndexTerm& term) const {
+    term = IndexTerm();
+    if (IntLiteral* literal = nodeCast<IntLiteral>(index)) {
+        term.constant = literal->value;
+        return true;
+    }
+
+    Variable* var = nodeCast<Variable>(index);
+    if (BinaryOp* binary = nodeCast<BinaryOp>(index)) {
+        TokenType op = binary->op.type;
+        var = nodeCast<Variable>(binary->left.get());
+        IntLiteral* literal = nodeCast<IntLiteral>(binary->right.get());
+        if (!var && op == TokenType::PLUS) {
+            var = nodeCast<Variable>(binary->right.get());
+            literal = nodeCast<IntLiteral>(binary->left.get());
+        }
+        if (!var || !literal || (op != TokenType::PLUS && op != TokenType::MINUS)) return false;
+        term.constant = op == TokenType::PLUS ? literal->value : -literal->value;
+    }
+    if (!var) return false;
+
+    if (var->symbol == counter) {
+        term.usesCounter = true;
+    } else if (assigned.contains(var->symbol)) {
+        return false;
+    }
+    term.var = var;
+    return true;
+}
+
+bool InductionAnalysis::parseAccess(const void* node, SymbolId array, ExprList& indices, Loop& result) {
+    if (indices.empty() || indices.size() > 2) return false;
+
+    Access access;
+    access.node = node;
+    access.array = array;
+    bool strided = false;
+    for (auto& index : indices) {
+        IndexTerm term;
+        if (!parseIndex(index.get(), term)) return false;
+        strided = strided || term.usesCounter;
+        access.indices.push_back(term);
+    }
+    if (!strided) return false;
+
+    result.accesses.push_back(access);
+    return true;
+}
+
+// ========== RECORRIDO ==========
+
+void InductionAnalysis::visitVariable(Variable* node) {
+    if (node->symbol == counter) counterUses++;
+}
+
+void InductionAnalysis::visitBinaryOp(BinaryOp* node) {
+    visit(node->left.get());
+    visit(node->right.get());
+}
+
+void InductionAnalysis::visitUnaryOp(UnaryOp* node) {
+    visit(node->operand.get());
+}
+
+void InductionAnalysis::visitCastExpr(CastExpr* node) {
+    visit(node->expr.get());
+}
+
+void InductionAnalysis::visitTernaryExpr(TernaryExpr* node) {
+    visit(node->condition.get());
+    visit(node->exprTrue.get());
+    visit(node->exprFalse.get());
+}
+
+void InductionAnalysis::visitCallExpr(CallExpr* node) {
+    hasCall = true;
+    for (auto& arg : node->arguments) {
+        visit(arg.get());
+    }
+}
+
+void InductionAnalysis::visitArrayAccess(ArrayAccess* node) {
+    arrayReads.push_back(node);
+    for (auto& index : node->indices) {
+        visit(index.get());
+    }
+}
+
+void InductionAnalysis::visitAssignExpr(AssignExpr* node) {
+    visit(node->value.get());
+    for (auto& index : node->indices) {
+        visit(index.get());
+    }
+    if (!node->isArrayAssign) assigned.insert(node->varSymbol);
+}
+
+void InductionAnalysis::visitVarDecl(VarDecl* node) {
+    if (node->initializer) visit(node->initializer.get());
+    assigned.insert(node->symbol);
+}
+
+void InductionAnalysis::visitAssignStmt(AssignStmt* node) {
+    visit(node->value.get());
+    for (auto& index : node->indices) {
+        visit(index.get());
+    }
+    if (node->isArrayAssign) {
+        arrayWrites.push_back(node);
+    } else {
+        assigned.insert(node->varSymbol);
+    }
+}
+
+void InductionAnalysis::visitBlock(Block* node) {
+    for (auto& stmt : node->statements) {
+        visit(stmt.get());
+    }
+}
+
+void InductionAnalysis::visitIfStmt(IfStmt* node) {
+    visit(node->condition.get());
+    visit(node->thenBranch.get());
+    if (node->elseBranch) visit(node->elseBranch.get());
+}
+
+void InductionAnalysis::visitWhileStmt(WhileStmt* node) {
+    visit(node->condition.get());
+    visit(node->body.get());
+}
+
+void InductionAnalysis::visitForStmt(ForStmt* node) {
+    if (node->initializer) visit(node->initializer.get());
+    if (node->condition) visit(node->condition.get());
+    if (node->increment) visit(node->increment.get());
+    visit(node->body.get());
+}
+
+void InductionAnalysis::visitReturnStmt(ReturnStmt* node) {
+    if (node->value) visit(node->value.get());
+}
+
+void InductionAnalysis::visitExprStmt(ExprStmt* node) {
+    visit(node->expression.get());
+}
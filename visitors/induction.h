@@ -0,0 +1,89 @@
+#ifndef INDUCTION_H
+#define INDUCTION_H
+
+#include "../parser/ast.h"
+#include "../parser/ast_visitor.h"
+#include <vector>
+
+using namespace std;
+
+// ========== VARIABLES DE INDUCCIÓN ==========
+// Análisis de un for cuyo contador avanza con paso constante:
+//
+//   for (int i = a; i < N; i = i + c) { ... v[i + 1] ... m[r][i] ... }
+//
+// Reconoce los accesos a arrays del cuerpo cuyos índices son afines en el
+// contador (i, i + k, i - k, k + i) o invariantes en el loop (constantes o
+// variables que el loop no asigna). CodeGen reemplaza esos accesos por un
+// puntero que avanza `stride` bytes por iteración y, si el contador no se
+// usa para nada más, también reemplaza la condición del loop por una
+// comparación de punteros y deja de incrementar el contador.
+//
+// Loops con calls no se analizan: los punteros viven en registros
+// caller-saved.
+class InductionAnalysis : public StaticVisitor<InductionAnalysis> {
+public:
+    // Un índice: contador o variable invariante (o nada) + constante
+    struct IndexTerm {
+        bool usesCounter = false;
+        Variable* var = nullptr;
+        int constant = 0;
+    };
+
+    // Acceso afín en el contador: ArrayAccess* (lectura) o AssignStmt* (escritura)
+    struct Access {
+        const void* node;
+        SymbolId array;
+        vector<IndexTerm> indices;
+    };
+
+    struct Loop {
+        SymbolId counter = NO_SYMBOL;
+        int step = 0;
+        bool counterOnlyIndexes = false;      // Contador local que solo se usa en accesos y condición
+        TokenType compareOp = TokenType::UNKNOWN;  // Condición "contador op bound"
+        int bound = 0;
+        vector<Access> accesses;
+    };
+
+    // false si el loop no tiene la forma esperada
+    bool analyze(ForStmt* loop, Loop& result);
+
+    // Visit methods - Expresiones
+    void visitIntLiteral(IntLiteral*) {}
+    void visitFloatLiteral(FloatLiteral*) {}
+    void visitLongLiteral(LongLiteral*) {}
+    void visitStringLiteral(StringLiteral*) {}
+    void visitVariable(Variable* node);
+    void visitBinaryOp(BinaryOp* node);
+    void visitUnaryOp(UnaryOp* node);
+    void visitCastExpr(CastExpr* node);
+    void visitTernaryExpr(TernaryExpr* node);
+    void visitCallExpr(CallExpr* node);
+    void visitArrayAccess(ArrayAccess* node);
+    void visitAssignExpr(AssignExpr* node);
+
+    // Visit methods - Statements
+    void visitVarDecl(VarDecl* node);
+    void visitAssignStmt(AssignStmt* node);
+    void visitBlock(Block* node);
+    void visitIfStmt(IfStmt* node);
+    void visitWhileStmt(WhileStmt* node);
+    void visitForStmt(ForStmt* node);
+    void visitReturnStmt(ReturnStmt* node);
+    void visitExprStmt(ExprStmt* node);
+    void visitFunctionDecl(FunctionDecl*) {}
+
+private:
+    SymbolId counter;
+    SymbolSet assigned;              // Escalares asignados o declarados dentro del loop
+    bool hasCall;
+    int counterUses;
+    vector<ArrayAccess*> arrayReads;
+    vector<AssignStmt*> arrayWrites;
+
+    bool parseIndex(Expr* index, IndexTerm& term) const;
+    bool parseAccess(const void* node, SymbolId array, ExprList& indices, Loop& result);
+};
+
+#endif
@@ -0,0 +1,540 @@
+#include "licm.h"
+#include "induction.h"
+
+// ========== RECORRIDO ==========
+
+void LoopInvariantMotion::run(FunctionDecl* func, Arena* arena, SymbolTable* symbols, const SymbolSet& globals) {
+    this->arena = arena;
+    this->symbols = symbols;
+    functionName = func->name;
+    stridedAccesses.clear();
+    if (!func->body) return;
+    expressions.declareFunction(func, globals);
+
+    // Antes de tocar nada: lo que después CodeGen recorre con punteros
+    collectStrided(func->body.get());
+    processBlock(func->body.get());
+}
+
+void LoopInvariantMotion::processBlock(Block* block) {
+    StmtList& statements = block->statements;
+    vector<vector<StmtPtr>> before(statements.size());
+    bool inserted = false;
+
+    for (size_t i = 0; i < statements.size(); i++) {
+        Stmt* stmt = statements[i].get();
+        switch (stmt->kind) {
+            case NodeKind::WhileStmt:
+            case NodeKind::ForStmt:
+                processLoop(stmt, before[i]);
+                if (!before[i].empty()) inserted = true;
+                break;
+            case NodeKind::IfStmt: {
+                IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+                processBranch(ifStmt->thenBranch);
+                processBranch(ifStmt->elseBranch);
+                break;
+            }
+            case NodeKind::Block:
+                processBlock(static_cast<Block*>(stmt));
+                break;
+            default:
+                break;
+        }
+    }
+    if (!inserted) return;
+
+    // El preheader: las variables nuevas justo antes de su loop
+    StmtList output(arena);
+    for (size_t i = 0; i < statements.size(); i++) {
+        for (auto& decl : before[i]) {
+            output.push_back(move(decl));
+        }
+        output.push_back(move(statements[i]));
+    }
+    block->statements = move(output);
+}
+
+// Rama de un if o cuerpo de un loop: si no es un bloque y hay que declarar
+// algo antes de un loop, pasa a serlo
+void LoopInvariantMotion::processBranch(StmtPtr& branch) {
+    if (!branch) return;
+    if (Block* block = nodeCast<Block>(branch.get())) {
+        processBlock(block);
+        return;
+    }
+
+    StmtList statements(arena);
+    statements.push_back(move(branch));
+    NodePtr<Block> block = arena->make<Block>(move(statements));
+    processBlock(block.get());
+    if (block->statements.size() == 1) {
+        branch = move(block->statements[0]);
+    } else {
+        branch = move(block);
+    }
+}
+
+static bool containsCall(Expr* expr);
+
+void LoopInvariantMotion::processLoop(Stmt* loop, vector<StmtPtr>& before) {
+    varying.clear();
+    hoisted.clear();
+    preheader = &before;
+    collectVarying(loop);
+
+    // La condición se evalúa apenas se llega al loop (en un for, después
+    // del inicializador): ahí puede salir también lo que podría fallar
+    StmtPtr* body;
+    if (loop->kind == NodeKind::WhileStmt) {
+        WhileStmt* whileStmt = static_cast<WhileStmt*>(loop);
+        hoistIn(whileStmt->condition, true);
+        hoistIn(whileStmt->body.get());
+        body = &whileStmt->body;
+    } else {
+        ForStmt* forStmt = static_cast<ForStmt*>(loop);
+        bool firstEvaluated = true;
+        if (VarDecl* varDecl = nodeCast<VarDecl>(forStmt->initializer.get())) {
+            firstEvaluated = !containsCall(varDecl->initializer.get());
+        } else if (AssignStmt* assign = nodeCast<AssignStmt>(forStmt->initializer.get())) {
+            firstEvaluated = !containsCall(assign->value.get());
+        } else if (forStmt->initializer) {
+            firstEvaluated = false;
+        }
+        hoistIn(forStmt->condition, firstEvaluated);
+        hoistIn(forStmt->increment, false);
+        hoistIn(forStmt->body.get());
+        body = &forStmt->body;
+    }
+    preheader = nullptr;
+
+    // Después los loops de adentro, con lo que ya quedó
+    processBranch(*body);
+}
+
+// ========== INVARIANTES ==========
+
+void LoopInvariantMotion::hoistIn(Stmt* stmt) {
+    if (!stmt) return;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            hoistIn(varDecl->initializer, false);
+            for (auto& element : varDecl->arrayInitializer) {
+                hoistIn(element, false);
+            }
+            break;
+        }
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            if (assign->isArrayAssign) splitRow(assign, assign->varSymbol, assign->indices);
+            for (auto& index : assign->indices) {
+                hoistIn(index, false);
+            }
+            hoistIn(assign->value, false);
+            break;
+        }
+        case NodeKind::ExprStmt:
+            hoistIn(static_cast<ExprStmt*>(stmt)->expression, false);
+            break;
+        case NodeKind::ReturnStmt:
+            hoistIn(static_cast<ReturnStmt*>(stmt)->value, false);
+            break;
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                hoistIn(s.get());
+            }
+            break;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            hoistIn(ifStmt->condition, false);
+            hoistIn(ifStmt->thenBranch.get());
+            hoistIn(ifStmt->elseBranch.get());
+            break;
+        }
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            hoistIn(whileStmt->condition, false);
+            hoistIn(whileStmt->body.get());
+            break;
+        }
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            hoistIn(forStmt->initializer.get());
+            hoistIn(forStmt->condition, false);
+            hoistIn(forStmt->increment, false);
+            hoistIn(forStmt->body.get());
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void LoopInvariantMotion::hoistIn(ExprPtr& slot, bool always) {
+    Expr* expr = slot.get();
+    if (!expr) return;
+
+    if (isCandidate(expr)) {
+        string key;
+        if (isInvariant(expr, key)) {
+            DataType type = expressions.typeOf(expr);
+            if (type != DataType::UNKNOWN && (always || isSpeculatable(expr))) {
+                replace(slot, key, type);
+                return;
+            }
+        }
+    }
+
+    switch (expr->kind) {
+        case NodeKind::BinaryOp: {
+            // El lado derecho de && y || puede no evaluarse
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            bool shortCircuit = binary->op.type == TokenType::AND || binary->op.type == TokenType::OR;
+            hoistIn(binary->left, always);
+            hoistIn(binary->right, always && !shortCircuit);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            hoistIn(static_cast<UnaryOp*>(expr)->operand, always);
+            break;
+        case NodeKind::CastExpr:
+            hoistIn(static_cast<CastExpr*>(expr)->expr, always);
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            hoistIn(ternary->condition, always);
+            hoistIn(ternary->exprTrue, false);
+            hoistIn(ternary->exprFalse, false);
+            break;
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                hoistIn(arg, always);
+            }
+            break;
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* access = static_cast<ArrayAccess*>(expr);
+            splitRow(access, access->arraySymbol, access->indices);
+            for (auto& index : access->indices) {
+                hoistIn(index, always);
+            }
+            break;
+        }
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            for (auto& index : assign->indices) {
+                hoistIn(index, always);
+            }
+            hoistIn(assign->value, always);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// m[r][j] con r invariante -> m[t + j], t = r * columnas antes del loop
+void LoopInvariantMotion::splitRow(const void* node, SymbolId array, ExprList& indices) {
+    if (indices.size() != 2 || stridedAccesses.count(node)) return;
+    const vector<int>* dimensions = expressions.dimensionsOf(array);
+    if (!dimensions || dimensions->size() != 2) return;
+
+    // Una fila constante ya la resuelve CodeGen en el offset
+    Expr* row = indices[0].get();
+    string key;
+    if (row->kind == NodeKind::IntLiteral || !isInvariant(row, key) ||
+        expressions.typeOf(row) != DataType::INT || !isSpeculatable(row)) {
+        return;
+    }
+
+    Token multiply(TokenType::MULTIPLY, "*", 0, 0);
+    ExprPtr offset = arena->make<BinaryOp>(move(indices[0]), multiply,
+                                           arena->make<IntLiteral>((*dimensions)[1]));
+    key.clear();
+    vector<SymbolId> reads;
+    expressions.keyOf(offset.get(), key, reads);
+    replace(offset, key, DataType::INT);
+
+    Token plus(TokenType::PLUS, "+", 0, 0);
+    ExprList flat(arena);
+    flat.push_back(arena->make<BinaryOp>(move(offset), plus, move(indices[1])));
+    indices = move(flat);
+    splitIndices++;
+}
+
+// Primera vez: la expresión pasa al preheader; las siguientes leen la variable
+void LoopInvariantMotion::replace(ExprPtr& slot, const string& key, DataType type) {
+    auto it = hoisted.find(key);
+    if (it == hoisted.end()) {
+        string name = string(functionName) + ".licm" + to_string(++temporaries);
+        SymbolId temp = symbols->internCopy(name);
+        expressions.declareTemp(temp, type);
+        preheader->push_back(arena->make<VarDecl>(type, symbols->name(temp), temp, move(slot)));
+        it = hoisted.emplace(key, temp).first;
+        hoistedExpressions++;
+    }
+    slot = arena->make<Variable>(symbols->name(it->second), it->second);
+}
+
+bool LoopInvariantMotion::isInvariant(Expr* expr, string& key) {
+    vector<SymbolId> reads;
+    if (!expressions.keyOf(expr, key, reads) || reads.empty()) return false;
+    for (SymbolId symbol : reads) {
+        if (varying.contains(symbol)) return false;
+    }
+    return true;
+}
+
+// Las comparaciones quedan en su salto; las hojas ya son una lectura
+bool LoopInvariantMotion::isCandidate(Expr* expr) {
+    switch (expr->kind) {
+        case NodeKind::ArrayAccess:
+        case NodeKind::CastExpr:
+        case NodeKind::UnaryOp:
+            return true;
+        case NodeKind::BinaryOp:
+            switch (static_cast<BinaryOp*>(expr)->op.type) {
+                case TokenType::EQ: case TokenType::NE:
+                case TokenType::LT: case TokenType::GT:
+                case TokenType::LE: case TokenType::GE:
+                case TokenType::AND: case TokenType::OR:
+                    return false;
+                default:
+                    return true;
+            }
+        default:
+            return false;
+    }
+}
+
+// Sin divisiones enteras que puedan fallar (divisor 0 o -1 con INT_MIN) y
+// sin leer fuera de un array
+bool LoopInvariantMotion::isSpeculatable(Expr* expr) {
+    switch (expr->kind) {
+        case NodeKind::IntLiteral:
+        case NodeKind::LongLiteral:
+        case NodeKind::FloatLiteral:
+        case NodeKind::Variable:
+            return true;
+
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            TokenType op = binary->op.type;
+            if ((op == TokenType::DIVIDE || op == TokenType::MODULO) &&
+                expressions.typeOf(expr) != DataType::FLOAT) {
+                IntLiteral* divisor = nodeCast<IntLiteral>(binary->right.get());
+                if (!divisor || divisor->value == 0 || divisor->value == -1) return false;
+            }
+            return isSpeculatable(binary->left.get()) && isSpeculatable(binary->right.get());
+        }
+        case NodeKind::UnaryOp:
+            return isSpeculatable(static_cast<UnaryOp*>(expr)->operand.get());
+        case NodeKind::CastExpr:
+            return isSpeculatable(static_cast<CastExpr*>(expr)->expr.get());
+
+        // Solo índices constantes dentro del array
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* access = static_cast<ArrayAccess*>(expr);
+            const vector<int>* dimensions = expressions.dimensionsOf(access->arraySymbol);
+            if (!dimensions || dimensions->empty()) return false;
+            long long position = 0;
+            long long size = 1;
+            for (int dimension : *dimensions) size *= dimension;
+            if (access->indices.size() != 1 && access->indices.size() != dimensions->size()) return false;
+            for (size_t i = 0; i < access->indices.size(); i++) {
+                IntLiteral* index = nodeCast<IntLiteral>(access->indices[i].get());
+                // Un solo índice sobre un array 2D es el plano
+                long long limit = access->indices.size() == 1 ? size : (*dimensions)[i];
+                if (!index || index->value < 0 || index->value >= limit) return false;
+                position = position * limit + index->value;
+            }
+            return position < size;
+        }
+
+        default:
+            return false;
+    }
+}
+
+// ========== ESCRITURAS DEL LOOP ==========
+
+void LoopInvariantMotion::collectVarying(Stmt* stmt) {
+    if (!stmt) return;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            varying.insert(varDecl->symbol);
+            collectVarying(varDecl->initializer.get());
+            for (auto& element : varDecl->arrayInitializer) {
+                collectVarying(element.get());
+            }
+            break;
+        }
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            varying.insert(assign->varSymbol);
+            for (auto& index : assign->indices) {
+                collectVarying(index.get());
+            }
+            collectVarying(assign->value.get());
+            break;
+        }
+        case NodeKind::ExprStmt:
+            collectVarying(static_cast<ExprStmt*>(stmt)->expression.get());
+            break;
+        case NodeKind::ReturnStmt:
+            collectVarying(static_cast<ReturnStmt*>(stmt)->value.get());
+            break;
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                collectVarying(s.get());
+            }
+            break;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            collectVarying(ifStmt->condition.get());
+            collectVarying(ifStmt->thenBranch.get());
+            collectVarying(ifStmt->elseBranch.get());
+            break;
+        }
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            collectVarying(whileStmt->condition.get());
+            collectVarying(whileStmt->body.get());
+            break;
+        }
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            collectVarying(forStmt->initializer.get());
+            collectVarying(forStmt->condition.get());
+            collectVarying(forStmt->increment.get());
+            collectVarying(forStmt->body.get());
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void LoopInvariantMotion::collectVarying(Expr* expr) {
+    if (!expr) return;
+
+    switch (expr->kind) {
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            varying.insert(assign->varSymbol);
+            for (auto& index : assign->indices) {
+                collectVarying(index.get());
+            }
+            collectVarying(assign->value.get());
+            break;
+        }
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            collectVarying(binary->left.get());
+            collectVarying(binary->right.get());
+            break;
+        }
+        case NodeKind::UnaryOp:
+            collectVarying(static_cast<UnaryOp*>(expr)->operand.get());
+            break;
+        case NodeKind::CastExpr:
+            collectVarying(static_cast<CastExpr*>(expr)->expr.get());
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            collectVarying(ternary->condition.get());
+            collectVarying(ternary->exprTrue.get());
+            collectVarying(ternary->exprFalse.get());
+            break;
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                collectVarying(arg.get());
+            }
+            break;
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                collectVarying(index.get());
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static bool containsCall(Expr* expr) {
+    if (!expr) return false;
+
+    switch (expr->kind) {
+        case NodeKind::CallExpr:
+            return true;
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            return containsCall(binary->left.get()) || containsCall(binary->right.get());
+        }
+        case NodeKind::UnaryOp:
+            return containsCall(static_cast<UnaryOp*>(expr)->operand.get());
+        case NodeKind::CastExpr:
+            return containsCall(static_cast<CastExpr*>(expr)->expr.get());
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            return containsCall(ternary->condition.get()) || containsCall(ternary->exprTrue.get()) ||
+                   containsCall(ternary->exprFalse.get());
+        }
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                if (containsCall(index.get())) return true;
+            }
+            return false;
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            for (auto& index : assign->indices) {
+                if (containsCall(index.get())) return true;
+            }
+            return containsCall(assign->value.get());
+        }
+        default:
+            return false;
+    }
+}
+
+// ========== ACCESOS CON PUNTEROS ==========
+
+void LoopInvariantMotion::collectStrided(Stmt* stmt) {
+    if (!stmt) return;
+
+    switch (stmt->kind) {
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                collectStrided(s.get());
+            }
+            break;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            collectStrided(ifStmt->thenBranch.get());
+            collectStrided(ifStmt->elseBranch.get());
+            break;
+        }
+        case NodeKind::WhileStmt:
+            collectStrided(static_cast<WhileStmt*>(stmt)->body.get());
+            break;
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            InductionAnalysis induction;
+            InductionAnalysis::Loop loop;
+            if (induction.analyze(forStmt, loop)) {
+                for (const InductionAnalysis::Access& access : loop.accesses) {
+                    stridedAccesses.insert(access.node);
+                }
+            }
+            collectStrided(forStmt->body.get());
+            break;
+        }
+        default:
+            break;
+    }
+}
@@ -0,0 +1,82 @@
+#ifndef LICM_H
+#define LICM_H
+
+#include "../parser/ast.h"
+#include "gvn.h"
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// ========== MOVIMIENTO DE CÓDIGO INVARIANTE ==========
+// Saca de los loops las expresiones que leen solo variables que el loop no
+// escribe y las calcula una vez, en variables declaradas justo antes del
+// loop (el preheader):
+//
+//   while (i < n * 2) {               int f.licm1 = n * 2;
+//       s = s + v[i] * (k + 1);  ->   int f.licm2 = k + 1;
+//       i = i + 1;                    while (i < f.licm1) {
+//   }                                     s = s + v[i] * f.licm2; ...
+//
+// Los accesos m[r][j] con la fila invariante pasan a m[t + j], con
+// t = r * columnas en el preheader (el índice de una sola posición sobre un
+// array 2D es el plano, ver CodeGen). La base del array es un offset fijo
+// del frame: lo que se repite es la cuenta del índice. Los accesos que
+// CodeGen ya recorre con un puntero (ver induction.h) no se tocan.
+//
+// Un loop puede no dar ninguna vuelta: antes del loop solo se calcula lo
+// que no puede fallar (nada de a / x ni de v[k] con k variable), salvo en
+// la condición del loop, que se evalúa siempre al llegar. Se procesan
+// primero los loops de afuera, así lo invariante en varios niveles sale
+// hasta el más externo. Las claves y los tipos son los de PureExpressions.
+class LoopInvariantMotion {
+public:
+    // Saca lo invariante de los loops de la función
+    void run(FunctionDecl* func, Arena* arena, SymbolTable* symbols, const SymbolSet& globals);
+
+    // Expresiones calculadas antes de un loop / índices 2D partidos
+    int hoistedExpressions = 0;
+    int splitIndices = 0;
+
+private:
+    Arena* arena = nullptr;
+    SymbolTable* symbols = nullptr;
+    string_view functionName;
+    PureExpressions expressions;
+    int temporaries = 0;
+
+    // Accesos que CodeGen recorre con punteros (ArrayAccess* / AssignStmt*)
+    unordered_set<const void*> stridedAccesses;
+
+    // Loop actual: lo que escribe, lo ya sacado (clave -> variable) y las
+    // declaraciones que van antes
+    SymbolSet varying;
+    unordered_map<string, SymbolId> hoisted;
+    vector<StmtPtr>* preheader = nullptr;
+
+    // Recorre los statements buscando loops
+    void processBlock(Block* block);
+    void processBranch(StmtPtr& branch);
+    void processLoop(Stmt* loop, vector<StmtPtr>& before);
+
+    // Saca lo invariante de las expresiones del statement / de `slot`
+    // (always: se evalúa cada vez que se llega al loop)
+    void hoistIn(Stmt* stmt);
+    void hoistIn(ExprPtr& slot, bool always);
+    void splitRow(const void* node, SymbolId array, ExprList& indices);
+    void replace(ExprPtr& slot, const string& key, DataType type);
+
+    // ¿Lee solo lo que el loop no escribe? ¿Se puede calcular aunque el
+    // loop no lo evalúe?
+    bool isInvariant(Expr* expr, string& key);
+    bool isCandidate(Expr* expr);
+    bool isSpeculatable(Expr* expr);
+
+    void collectVarying(Stmt* stmt);
+    void collectVarying(Expr* expr);
+    void collectStrided(Stmt* stmt);
+};
+
+#endif
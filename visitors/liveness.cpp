@@ -0,0 +1,308 @@
+#include "liveness.h"
+
+// ========== CONJUNTOS DE BITS ==========
+
+static bool testBit(const vector<uint64_t>& bits, int i) {
+    return (bits[i >> 6] >> (i & 63)) & 1;
+}
+
+static void setBit(vector<uint64_t>& bits, int i) {
+    bits[i >> 6] |= 1ULL << (i & 63);
+}
+
+static void clearBit(vector<uint64_t>& bits, int i) {
+    bits[i >> 6] &= ~(1ULL << (i & 63));
+}
+
+// ========== VARIABLES ==========
+
+int LivenessAnalysis::slotOf(SymbolId symbol) {
+    int slot = cfg.locals.slotOf(symbol);
+    return slot >= 0 && !cfg.locals.isArray(slot) ? slot : -1;
+}
+
+bool LivenessAnalysis::isLocalArray(SymbolId symbol) {
+    int slot = cfg.locals.slotOf(symbol);
+    return slot >= 0 && cfg.locals.isArray(slot);
+}
+
+void LivenessAnalysis::collectReferences(Expr* expr) {
+    if (!expr) return;
+
+    switch (expr->kind) {
+        case NodeKind::Variable: {
+            SymbolId symbol = static_cast<Variable*>(expr)->symbol;
+            readSymbols.insert(symbol);
+            referencedSymbols.insert(symbol);
+            break;
+        }
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            collectReferences(binary->left.get());
+            collectReferences(binary->right.get());
+            break;
+        }
+        case NodeKind::UnaryOp:
+            collectReferences(static_cast<UnaryOp*>(expr)->operand.get());
+            break;
+        case NodeKind::CastExpr:
+            collectReferences(static_cast<CastExpr*>(expr)->expr.get());
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            collectReferences(ternary->condition.get());
+            collectReferences(ternary->exprTrue.get());
+            collectReferences(ternary->exprFalse.get());
+            break;
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                collectReferences(arg.get());
+            }
+            break;
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* access = static_cast<ArrayAccess*>(expr);
+            readSymbols.insert(access->arraySymbol);
+            referencedSymbols.insert(access->arraySymbol);
+            for (auto& index : access->indices) {
+                collectReferences(index.get());
+            }
+            break;
+        }
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            referencedSymbols.insert(assign->varSymbol);
+            for (auto& index : assign->indices) {
+                collectReferences(index.get());
+            }
+            collectReferences(assign->value.get());
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// ========== ANÁLISIS ==========
+
+void LivenessAnalysis::clear() {
+    cfg.clear();
+    liveIn.clear();
+    liveOut.clear();
+    deadStores.clear();
+    readSymbols.clear();
+    referencedSymbols.clear();
+}
+
+void LivenessAnalysis::analyze(FunctionDecl* func, const SymbolSet& globals) {
+    clear();
+    if (!func->body) return;
+    cfg.build(func, globals);
+
+    // Todo lo que se lee o escribe en la función
+    for (auto& block : cfg.blocks) {
+        for (const Action& action : block.actions) {
+            if (action.expr) {
+                collectReferences(action.expr);
+                continue;
+            }
+            switch (action.stmt->kind) {
+                case NodeKind::VarDecl: {
+                    VarDecl* varDecl = static_cast<VarDecl*>(action.stmt);
+                    collectReferences(varDecl->initializer.get());
+                    for (auto& element : varDecl->arrayInitializer) {
+                        collectReferences(element.get());
+                    }
+                    break;
+                }
+                case NodeKind::AssignStmt: {
+                    AssignStmt* assign = static_cast<AssignStmt*>(action.stmt);
+                    referencedSymbols.insert(assign->varSymbol);
+                    for (auto& index : assign->indices) {
+                        collectReferences(index.get());
+                    }
+                    collectReferences(assign->value.get());
+                    break;
+                }
+                case NodeKind::ExprStmt:
+                    collectReferences(static_cast<ExprStmt*>(action.stmt)->expression.get());
+                    break;
+                case NodeKind::ReturnStmt:
+                    collectReferences(static_cast<ReturnStmt*>(action.stmt)->value.get());
+                    break;
+                default:
+                    break;
+            }
+        }
+        collectReferences(block.condition);
+    }
+
+    // Punto fijo. Recorrer los bloques de atrás hacia adelante converge en
+    // pocas vueltas (el cuerpo de un loop está después de su header)
+    size_t words = (cfg.locals.size() + 63) / 64;
+    liveIn.assign(cfg.blocks.size(), Bits(words, 0));
+    liveOut.assign(cfg.blocks.size(), Bits(words, 0));
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int b = (int)cfg.blocks.size() - 1; b >= 0; b--) {
+            const ControlFlowGraph::BasicBlock& block = cfg.blocks[b];
+            Bits live(words, 0);
+            for (int successor : block.next) {
+                if (successor < 0) continue;
+                for (size_t w = 0; w < words; w++) live[w] |= liveIn[successor][w];
+            }
+            liveOut[b] = live;
+
+            addUses(block.condition, live);
+            for (int i = (int)block.actions.size() - 1; i >= 0; i--) {
+                transfer(block.actions[i], live, false);
+            }
+            if (live != liveIn[b]) {
+                liveIn[b] = live;
+                changed = true;
+            }
+        }
+    }
+
+    // Con los conjuntos finales, anotar las escrituras que nadie lee
+    for (size_t b = 0; b < cfg.blocks.size(); b++) {
+        const ControlFlowGraph::BasicBlock& block = cfg.blocks[b];
+        Bits live = liveOut[b];
+        addUses(block.condition, live);
+        for (int i = (int)block.actions.size() - 1; i >= 0; i--) {
+            transfer(block.actions[i], live, true);
+        }
+    }
+}
+
+void LivenessAnalysis::transfer(const Action& action, Bits& live, bool record) {
+    if (action.expr) {
+        transferExpr(action.expr, live);
+        return;
+    }
+
+    Stmt* stmt = action.stmt;
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            if (varDecl->initializer) {
+                kill(slotOf(varDecl->symbol), live, stmt, record);
+                addUses(varDecl->initializer.get(), live);
+            }
+            for (auto& element : varDecl->arrayInitializer) {
+                addUses(element.get(), live);
+            }
+            break;
+        }
+
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            if (assign->isArrayAssign) {
+                if (record && isLocalArray(assign->varSymbol) && !readSymbols.contains(assign->varSymbol)) {
+                    deadStores.insert(stmt);
+                }
+                for (auto& index : assign->indices) {
+                    addUses(index.get(), live);
+                }
+            } else {
+                kill(slotOf(assign->varSymbol), live, stmt, record);
+            }
+            addUses(assign->value.get(), live);
+            break;
+        }
+
+        case NodeKind::ExprStmt:
+            transferExpr(static_cast<ExprStmt*>(stmt)->expression.get(), live);
+            break;
+
+        case NodeKind::ReturnStmt:
+            addUses(static_cast<ReturnStmt*>(stmt)->value.get(), live);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void LivenessAnalysis::kill(int slot, Bits& live, Stmt* store, bool record) {
+    if (slot < 0) return;
+    if (record && !testBit(live, slot)) deadStores.insert(store);
+    clearBit(live, slot);
+}
+
+// Una asignación en la raíz de la expresión (i = i + 1 de un for) escribe
+// después de leer; las anidadas no matan nada (no se sabe en qué orden se
+// evalúan respecto de las lecturas de al lado)
+void LivenessAnalysis::transferExpr(Expr* expr, Bits& live) {
+    AssignExpr* assign = nodeCast<AssignExpr>(expr);
+    if (assign && !assign->isArrayAssign) {
+        kill(slotOf(assign->varSymbol), live, nullptr, false);
+    }
+    addUses(expr, live);
+}
+
+void LivenessAnalysis::addUses(Expr* expr, Bits& live) {
+    if (!expr) return;
+
+    switch (expr->kind) {
+        case NodeKind::Variable: {
+            int slot = slotOf(static_cast<Variable*>(expr)->symbol);
+            if (slot >= 0) setBit(live, slot);
+            break;
+        }
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            addUses(binary->left.get(), live);
+            addUses(binary->right.get(), live);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            addUses(static_cast<UnaryOp*>(expr)->operand.get(), live);
+            break;
+        case NodeKind::CastExpr:
+            addUses(static_cast<CastExpr*>(expr)->expr.get(), live);
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            addUses(ternary->condition.get(), live);
+            addUses(ternary->exprTrue.get(), live);
+            addUses(ternary->exprFalse.get(), live);
+            break;
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                addUses(arg.get(), live);
+            }
+            break;
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                addUses(index.get(), live);
+            }
+            break;
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            for (auto& index : assign->indices) {
+                addUses(index.get(), live);
+            }
+            addUses(assign->value.get(), live);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// ========== CONSULTAS ==========
+
+bool LivenessAnalysis::isDeadStore(Stmt* stmt) const {
+    return deadStores.count(stmt) > 0;
+}
+
+bool LivenessAnalysis::isRead(SymbolId symbol) const {
+    return readSymbols.contains(symbol);
+}
+
+bool LivenessAnalysis::isReferenced(SymbolId symbol) const {
+    return referencedSymbols.contains(symbol);
+}
@@ -0,0 +1,72 @@
+#ifndef LIVENESS_H
+#define LIVENESS_H
+
+#include "../parser/ast.h"
+#include "cfg.h"
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+// ========== VARIABLES VIVAS ==========
+// Análisis hacia atrás sobre el grafo de control de una función (ver
+// cfg.h). Una variable está viva en un punto si algún camino desde ahí la
+// lee antes de volver a escribirla:
+//
+//   out(B) = unión de in(S) para cada sucesor S de B
+//   in(B)  = use(B) ∪ (out(B) - def(B))
+//
+// iterado hasta el punto fijo (los back-edges de los loops hacen que lo
+// que lee la vuelta siguiente siga vivo al final del cuerpo).
+//
+// Se siguen los parámetros y las locales escalares. Las globales nunca
+// mueren (un call o quien llamó a la función las puede leer) y un
+// elemento de array no mata al array: sus escrituras solo son muertas si
+// el array local no se lee en ningún lado. Un VarDecl sin inicializador
+// no cuenta como escritura (dos scopes con el mismo nombre comparten
+// símbolo).
+class LivenessAnalysis {
+public:
+    // Analiza la función (descarta lo de la anterior)
+    void analyze(FunctionDecl* func, const SymbolSet& globals);
+
+    // Olvida la última función analizada
+    void clear();
+
+    // ¿Nadie lee el valor que escribe el statement? (AssignStmt o VarDecl
+    // con inicializador; false si no estaba en la función analizada)
+    bool isDeadStore(Stmt* stmt) const;
+
+    // ¿Se lee / se lee o escribe el símbolo en algún lado de la función?
+    bool isRead(SymbolId symbol) const;
+    bool isReferenced(SymbolId symbol) const;
+
+private:
+    typedef ControlFlowGraph::Action Action;
+    typedef vector<uint64_t> Bits;
+
+    ControlFlowGraph cfg;
+    vector<Bits> liveIn;
+    vector<Bits> liveOut;
+    unordered_set<const Stmt*> deadStores;
+
+    SymbolSet readSymbols;
+    SymbolSet referencedSymbols;
+
+    // Bit de una local escalar (el slot de cfg.locals; -1 si no se sigue)
+    int slotOf(SymbolId symbol);
+    bool isLocalArray(SymbolId symbol);
+
+    // Lecturas y escrituras de toda la función (readSymbols, referencedSymbols)
+    void collectReferences(Expr* expr);
+
+    // live = (live - def) ∪ use de la acción, de atrás hacia adelante;
+    // con record, anota las escrituras muertas
+    void transfer(const Action& action, Bits& live, bool record);
+    void transferExpr(Expr* expr, Bits& live);
+    void addUses(Expr* expr, Bits& live);
+    void kill(int slot, Bits& live, Stmt* store, bool record);
+};
+
+#endif
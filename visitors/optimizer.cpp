@@ -3,137 +3,195 @@
 //
 
 #include "optimizer.h"
+#include "induction.h"
+#include "vectorizer.h"
 
 
+#include <climits>
 #include <iostream>
 
 // ========== CONSTRUCTOR ==========
 // Se ejecuta cuando creas un Optimizer
-Optimizer::Optimizer() {
-    // Por ahora no necesitamos inicializar nada
-    // Pero aquí podrías inicializar variables si las necesitas
-}
+Optimizer::Optimizer() : arena(nullptr), symbols(nullptr) {}
 
 // ========== MÉTODO PRINCIPAL: optimize ==========
 // Este es el punto de entrada, optimiza todo el programa
 void Optimizer::optimize(Program* program) {
     cout << "  Applying optimizations..." << endl;
+    arena = program->arena.get();
+    symbols = program->symbols;
+    liveVars.reserve(program->symbols->size());
+
+    globalSymbols.clear();
+    for (auto& stmt : program->statements) {
+        if (VarDecl* global = nodeCast<VarDecl>(stmt.get())) {
+            globalSymbols.insert(global->symbol);
+        }
+    }
+
+    // INLINING: primero, así el folding y la eliminación de escrituras
+    // muertas trabajan sobre los cuerpos ya copiados
+    inlineFunctions(program);
+
+    // PROPAGACIÓN ENTRE FUNCIONES: sobre los calls que quedan, antes del
+    // folding (que aprovecha las constantes); al final se borran las
+    // funciones que ya nadie llama (también las originales de las copias)
+    removeDeadFunctions(program);
+    propagateArguments(program);
+    removeDeadFunctions(program);
 
     // Recorrer todos los statements del programa (funciones, declaraciones globales)
     for (auto& stmt : program->statements) {
         optimizeStmt(stmt.get());
     }
 
+    // RECURSIÓN DE COLA: al final (ver optimizer.h)
+    for (auto& stmt : program->statements) {
+        if (FunctionDecl* func = nodeCast<FunctionDecl>(stmt.get())) {
+            eliminateTailRecursion(func);
+        }
+    }
+
+    reusedExpressions = valueNumbering.reusedExpressions;
+    valueTemporaries = valueNumbering.temporaries;
+    hoistedExpressions = invariantMotion.hoistedExpressions;
+    splitIndices = invariantMotion.splitIndices;
+
     cout << "  Optimizations complete!" << endl;
 }
 
 // ========== OPTIMIZAR STATEMENTS ==========
 // Recibe un statement y lo optimiza según su tipo
 void Optimizer::optimizeStmt(Stmt* stmt) {
-    // Intentamos hacer un "cast" para ver qué tipo de statement es
-
-    // ¿Es una declaración de variable? (int x = 2 + 3;)
-    // ¿Es una declaración de variable? (int x = 2 + 3;)
-    if (VarDecl* varDecl = dynamic_cast<VarDecl*>(stmt)) {
-        // Si tiene un inicializador, optimizarlo
-        if (varDecl->initializer) {
-            // Optimizar la expresión y reemplazarla
-            varDecl->initializer = optimizeExpr(varDecl->initializer.get());
-
-            // CONSTANT PROPAGATION: Si el inicializador es un literal, guardarlo
-            int value;
-            if (isIntLiteral(varDecl->initializer.get(), value)) {
-                constantValues[varDecl->name] = value;
-                cout << "    Propagating constant: " << varDecl->name << " = " << value << endl;
+    // Despachamos según el tipo de nodo (un solo switch, sin dynamic_cast)
+    switch (stmt->kind) {
+        // ¿Es una declaración de variable? (int x = 2 + 3;)
+        // ¿Es una declaración de variable? (int x = 2 + 3;)
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            // Si tiene un inicializador, optimizarlo
+            if (varDecl->initializer) {
+                // Optimizar la expresión y reemplazarla
+                varDecl->initializer = optimizeExpr(varDecl->initializer.get());
             }
+            break;
         }
-    }
-
-    // ¿Es una asignación? (x = 2 + 3;)
-    else if (AssignStmt* assign = dynamic_cast<AssignStmt*>(stmt)) {
-        // Optimizar el valor que se está asignando
-        assign->value = optimizeExpr(assign->value.get());
 
-        // CONSTANT PROPAGATION: Si el valor es un literal, guardarlo
-        int value;
-        if (isIntLiteral(assign->value.get(), value)) {
-            constantValues[assign->varName] = value;
-            cout << "    Propagating constant: " << assign->varName << " = " << value << endl;
-        } else {
-            // Si no es literal, eliminar del mapa (ya no es constante)
-            constantValues.erase(assign->varName);
+        // ¿Es una asignación? (x = 2 + 3;)
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            // Optimizar los índices (si es un array) y el valor que se está asignando
+            for (auto& index : assign->indices) {
+                index = optimizeExpr(index.get());
+            }
+            assign->value = optimizeExpr(assign->value.get());
+            break;
         }
-    }
 
-    // ¿Es un bloque de código? ({ ... })
-    else if (Block* block = dynamic_cast<Block*>(stmt)) {
-        optimizeBlock(block);
-    }
+        // ¿Es un bloque de código? ({ ... })
+        case NodeKind::Block: {
+            Block* block = static_cast<Block*>(stmt);
+            optimizeBlock(block);
+            break;
+        }
 
-    // ¿Es un if-statement? (if (condition) { ... })
-    else if (IfStmt* ifStmt = dynamic_cast<IfStmt*>(stmt)) {
-        // Optimizar la condición
-        ifStmt->condition = optimizeExpr(ifStmt->condition.get());
+        // ¿Es un if-statement? (if (condition) { ... })
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            // Optimizar la condición
+            ifStmt->condition = optimizeExpr(ifStmt->condition.get());
 
-        // Optimizar la rama then
-        optimizeStmt(ifStmt->thenBranch.get());
+            // Optimizar la rama then
+            optimizeStmt(ifStmt->thenBranch.get());
 
-        // Si hay rama else, optimizarla también
-        if (ifStmt->elseBranch) {
-            optimizeStmt(ifStmt->elseBranch.get());
+            // Si hay rama else, optimizarla también
+            if (ifStmt->elseBranch) {
+                optimizeStmt(ifStmt->elseBranch.get());
+            }
+            break;
         }
-    }
 
-    // ¿Es un while-loop? (while (condition) { ... })
-    else if (WhileStmt* whileStmt = dynamic_cast<WhileStmt*>(stmt)) {
-        // Optimizar la condición
-        whileStmt->condition = optimizeExpr(whileStmt->condition.get());
-
-        // Optimizar el cuerpo
-        optimizeStmt(whileStmt->body.get());
-    }
+        // ¿Es un while-loop? (while (condition) { ... })
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            // Optimizar la condición
+            whileStmt->condition = optimizeExpr(whileStmt->condition.get());
 
-    // ¿Es un for-loop? (for (init; cond; inc) { ... })
-    else if (ForStmt* forStmt = dynamic_cast<ForStmt*>(stmt)) {
-        // Optimizar inicializador
-        if (forStmt->initializer) {
-            optimizeStmt(forStmt->initializer.get());
+            // Optimizar el cuerpo
+            optimizeStmt(whileStmt->body.get());
+            break;
         }
 
-        // Optimizar condición
-        if (forStmt->condition) {
-            forStmt->condition = optimizeExpr(forStmt->condition.get());
-        }
+        // ¿Es un for-loop? (for (init; cond; inc) { ... })
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            // Optimizar inicializador
+            if (forStmt->initializer) {
+                optimizeStmt(forStmt->initializer.get());
+            }
 
-        // Optimizar incremento
-        if (forStmt->increment) {
-            forStmt->increment = optimizeExpr(forStmt->increment.get());
-        }
+            // Optimizar condición
+            if (forStmt->condition) {
+                forStmt->condition = optimizeExpr(forStmt->condition.get());
+            }
 
-        // Optimizar el cuerpo
-        optimizeStmt(forStmt->body.get());
-    }
+            // Optimizar incremento
+            if (forStmt->increment) {
+                forStmt->increment = optimizeExpr(forStmt->increment.get());
+            }
 
-    // ¿Es un return? (return 2 + 3;)
-    else if (ReturnStmt* returnStmt = dynamic_cast<ReturnStmt*>(stmt)) {
-        if (returnStmt->value) {
-            returnStmt->value = optimizeExpr(returnStmt->value.get());
+            // Optimizar el cuerpo
+            optimizeStmt(forStmt->body.get());
+            break;
         }
-    }
 
-    // ¿Es una declaración de función?
-    // ¿Es una declaración de función?
-    else if (FunctionDecl* funcDecl = dynamic_cast<FunctionDecl*>(stmt)) {
-        // Limpiar valores constantes (nueva función = nuevo scope)
-        constantValues.clear();
+        // ¿Es un return? (return 2 + 3;)
+        case NodeKind::ReturnStmt: {
+            ReturnStmt* returnStmt = static_cast<ReturnStmt*>(stmt);
+            if (returnStmt->value) {
+                returnStmt->value = optimizeExpr(returnStmt->value.get());
+            }
+            break;
+        }
 
-        // Optimizar el cuerpo de la función
-        optimizeBlock(funcDecl->body.get());
-    }
+        // ¿Es una declaración de función?
+        // ¿Es una declaración de función?
+        case NodeKind::FunctionDecl: {
+            FunctionDecl* funcDecl = static_cast<FunctionDecl*>(stmt);
+            currentFunction = funcDecl->name;
+
+            // PROPAGACIÓN DE CONSTANTES (ver sccp.h): sobre el cuerpo
+            // original, y otra vez después del desenrollado, que deja copias
+            // del cuerpo con el contador ya constante
+            propagation.analyze(funcDecl, globalSymbols);
+            optimizeBlock(funcDecl->body.get());
+
+            propagation.analyze(funcDecl, globalSymbols);
+            transformLoops = false;
+            optimizeBlock(funcDecl->body.get());
+            transformLoops = true;
+            propagation.clear();
+
+            // CÓDIGO INVARIANTE: con los loops ya desenrollados y plegados;
+            // antes de las subexpresiones comunes, que reusan lo que sale
+            invariantMotion.run(funcDecl, arena, symbols, globalSymbols);
+
+            // SUBEXPRESIONES COMUNES: con las expresiones ya plegadas
+            valueNumbering.run(funcDecl, arena, symbols, globalSymbols);
+
+            // CÓDIGO MUERTO: con las variables vivas de toda la función
+            eliminateDeadCode(funcDecl);
+            break;
+        }
 
-    // ¿Es un expression statement? (printf(...); suma(a,b);)
-    else if (ExprStmt* exprStmt = dynamic_cast<ExprStmt*>(stmt)) {
-        exprStmt->expression = optimizeExpr(exprStmt->expression.get());
+        // ¿Es un expression statement? (printf(...); suma(a,b);)
+        case NodeKind::ExprStmt: {
+            ExprStmt* exprStmt = static_cast<ExprStmt*>(stmt);
+            exprStmt->expression = optimizeExpr(exprStmt->expression.get());
+            break;
+        }
+        default:
+            break;
     }
 }
 
@@ -143,22 +201,55 @@ void Optimizer::optimizeStmt(Stmt* stmt) {
 // ========== OPTIMIZAR BLOQUES (con Dead Code Elimination y Loop Unrolling) ==========
 void Optimizer::optimizeBlock(Block* block) {
     // Crear un nuevo vector para statements optimizados
-    vector<unique_ptr<Stmt>> optimizedStmts;
+    StmtList optimizedStmts(arena);
 
     // Recorrer cada statement del bloque
     for (auto& stmt : block->statements) {
+        // Código que la propagación de constantes probó inalcanzable
+        // (después de un return, o en una rama que nunca se toma)
+        if (!propagation.isReachable(stmt.get())) {
+            cout << "    Eliminated unreachable code: " << nodeKindName(stmt->kind) << endl;
+            unreachableStatements++;
+            continue;
+        }
+
+        // while / for cuya condición es falsa desde la primera vez: el
+        // cuerpo nunca se ejecuta (del for queda el inicializador)
+        if (WhileStmt* whileStmt = nodeCast<WhileStmt>(stmt.get())) {
+            if (!propagation.branchTaken(whileStmt->condition.get(), true)) {
+                cout << "    Eliminated dead code: loop body never runs" << endl;
+                unreachableStatements++;
+                continue;
+            }
+        }
+        ForStmt* deadFor = nodeCast<ForStmt>(stmt.get());
+        if (deadFor && deadFor->condition && !propagation.branchTaken(deadFor->condition.get(), true)) {
+            cout << "    Eliminated dead code: loop body never runs" << endl;
+            unreachableStatements++;
+            if (deadFor->initializer) {
+                optimizeStmt(deadFor->initializer.get());
+                optimizedStmts.push_back(move(deadFor->initializer));
+            }
+            continue;
+        }
+
         // LOOP UNROLLING: Verificar si es un for-loop desenrollable
-        if (ForStmt* forStmt = dynamic_cast<ForStmt*>(stmt.get())) {
+        ForStmt* forStmt = transformLoops ? nodeCast<ForStmt>(stmt.get()) : nullptr;
+        if (forStmt) {
             // Intentar desenrollar el loop
             if (tryUnrollLoop(forStmt, optimizedStmts)) {
                 // Loop fue desenrollado exitosamente, ya se agregó a optimizedStmts
                 continue;
             }
+            // Si no, desenrollado parcial (cuerpo repetido + loop de resto)
+            if (tryPartialUnroll(forStmt, optimizedStmts)) {
+                continue;
+            }
             // Si no se pudo desenrollar, optimizar normalmente
         }
 
         // DEAD CODE ELIMINATION: Verificar si es un if con condición constante
-        if (IfStmt* ifStmt = dynamic_cast<IfStmt*>(stmt.get())) {
+        if (IfStmt* ifStmt = nodeCast<IfStmt>(stmt.get())) {
             // Optimizar la condición primero
             ifStmt->condition = optimizeExpr(ifStmt->condition.get());
 
@@ -195,137 +286,143 @@ void Optimizer::optimizeBlock(Block* block) {
 
     // Reemplazar los statements del bloque con los optimizados
     block->statements = move(optimizedStmts);
-    
-    // DEAD STORE ELIMINATION: Eliminar escrituras muertas
-    eliminateDeadStores(block);
 }
 // ========== OPTIMIZAR EXPRESIONES ==========
 // Recibe cualquier expresión y la optimiza según su tipo
-unique_ptr<Expr> Optimizer::optimizeExpr(Expr* expr) {
-    // ¿Es un literal entero? (5, 10, 42)
-    if (IntLiteral* lit = dynamic_cast<IntLiteral*>(expr)) {
-        // Los literales ya están optimizados, devolver una copia
-        return make_unique<IntLiteral>(lit->value);
-    }
-
-    // ¿Es un literal float? (3.14, 2.5)
-    else if (FloatLiteral* lit = dynamic_cast<FloatLiteral*>(expr)) {
-        return make_unique<FloatLiteral>(lit->value);
-    }
+ExprPtr Optimizer::optimizeExpr(Expr* expr) {
+    // Sin expresión (p. ej. lo que cloneExpr no sabe copiar): nada que optimizar
+    if (!expr) return nullptr;
 
-    // ¿Es un literal long?
-    else if (LongLiteral* lit = dynamic_cast<LongLiteral*>(expr)) {
-        return make_unique<LongLiteral>(lit->value);
+    // PROPAGACIÓN DE CONSTANTES: la expresión vale siempre lo mismo
+    if (ExprPtr literal = propagatedLiteral(expr)) {
+        return literal;
     }
 
-    // ¿Es un string literal? ("hello")
-    else if (StringLiteral* lit = dynamic_cast<StringLiteral*>(expr)) {
-        return make_unique<StringLiteral>(lit->value);
-    }
+    switch (expr->kind) {
+        // ¿Es un literal entero? (5, 10, 42)
+        case NodeKind::IntLiteral: {
+            IntLiteral* lit = static_cast<IntLiteral*>(expr);
+            // Los literales ya están optimizados, devolver una copia
+            return arena->make<IntLiteral>(lit->value);
+        }
 
-    // ¿Es una variable? (x, y, count)
-    // ¿Es una variable? (x, y, count)
-    else if (Variable* var = dynamic_cast<Variable*>(expr)) {
-        // CONSTANT PROPAGATION: Si conocemos el valor, reemplazarlo
-        if (constantValues.find(var->name) != constantValues.end()) {
-            int value = constantValues[var->name];
-            cout << "    Replacing variable " << var->name << " with " << value << endl;
-            return make_unique<IntLiteral>(value);
+        // ¿Es un literal float? (3.14, 2.5)
+        case NodeKind::FloatLiteral: {
+            FloatLiteral* lit = static_cast<FloatLiteral*>(expr);
+            return arena->make<FloatLiteral>(lit->value);
         }
 
-        // Si no conocemos el valor, devolver la variable
-        return make_unique<Variable>(var->name);
-    }
+        // ¿Es un literal long?
+        case NodeKind::LongLiteral: {
+            LongLiteral* lit = static_cast<LongLiteral*>(expr);
+            return arena->make<LongLiteral>(lit->value);
+        }
 
-    // ¿Es una operación binaria? (2 + 3, x * 4)
-    else if (BinaryOp* binOp = dynamic_cast<BinaryOp*>(expr)) {
-        // ¡AQUÍ APLICAMOS CONSTANT FOLDING!
-        return optimizeBinaryOp(binOp);
-    }
+        // ¿Es un string literal? ("hello")
+        case NodeKind::StringLiteral: {
+            StringLiteral* lit = static_cast<StringLiteral*>(expr);
+            return arena->make<StringLiteral>(lit->value);
+        }
 
-    // ¿Es una operación unaria? (-5, !true)
-    else if (UnaryOp* unOp = dynamic_cast<UnaryOp*>(expr)) {
-        // Optimizar el operando
-        auto optimizedOperand = optimizeExpr(unOp->operand.get());
+        // ¿Es una variable? (x, y, count)
+        // ¿Es una variable? (x, y, count)
+        case NodeKind::Variable: {
+            Variable* var = static_cast<Variable*>(expr);
+            // Si no conocemos el valor (ver propagatedLiteral), devolver la variable
+            return arena->make<Variable>(var->name, var->symbol);
+        }
 
-        // Intentar constant folding si el operando es literal
-        int value;
-        if (isIntLiteral(optimizedOperand.get(), value)) {
-            if (unOp->op.type == TokenType::MINUS) {
-                // -5 → literal(-5)
-                return make_unique<IntLiteral>(-value);
-            }
+        // ¿Es una operación binaria? (2 + 3, x * 4)
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            // ¡AQUÍ APLICAMOS CONSTANT FOLDING!
+            return optimizeBinaryOp(binOp);
         }
 
-        // Si no se puede optimizar, devolver el nodo original
-        return make_unique<UnaryOp>(unOp->op, move(optimizedOperand));
-    }
+        // ¿Es una operación unaria? (-5, !true)
+        case NodeKind::UnaryOp: {
+            UnaryOp* unOp = static_cast<UnaryOp*>(expr);
+            // Optimizar el operando
+            auto optimizedOperand = optimizeExpr(unOp->operand.get());
 
-    // ¿Es un cast? ((float)x)
-    else if (CastExpr* cast = dynamic_cast<CastExpr*>(expr)) {
-        auto optimizedExpr = optimizeExpr(cast->expr.get());
-        return make_unique<CastExpr>(cast->targetType, move(optimizedExpr));
-    }
+            // Intentar constant folding si el operando es literal
+            int value;
+            if (isIntLiteral(optimizedOperand.get(), value)) {
+                if (unOp->op.type == TokenType::MINUS) {
+                    // -5 → literal(-5)
+                    return arena->make<IntLiteral>(-value);
+                }
+            }
 
-    // ¿Es un operador ternario? (cond ? a : b)
-    else if (TernaryExpr* ternary = dynamic_cast<TernaryExpr*>(expr)) {
-        auto optimizedCond = optimizeExpr(ternary->condition.get());
-        auto optimizedTrue = optimizeExpr(ternary->exprTrue.get());
-        auto optimizedFalse = optimizeExpr(ternary->exprFalse.get());
+            // Si no se puede optimizar, devolver el nodo original
+            return arena->make<UnaryOp>(unOp->op, move(optimizedOperand));
+        }
 
-        return make_unique<TernaryExpr>(
-            move(optimizedCond),
-            move(optimizedTrue),
-            move(optimizedFalse)
-        );
-    }
+        // ¿Es un cast? ((float)x)
+        case NodeKind::CastExpr: {
+            CastExpr* cast = static_cast<CastExpr*>(expr);
+            auto optimizedExpr = optimizeExpr(cast->expr.get());
+            return arena->make<CastExpr>(cast->targetType, move(optimizedExpr));
+        }
 
-    // ¿Es una llamada a función? (suma(a, b))
-    else if (CallExpr* call = dynamic_cast<CallExpr*>(expr)) {
-        // Optimizar cada argumento
-        vector<unique_ptr<Expr>> optimizedArgs;
-        for (auto& arg : call->arguments) {
-            optimizedArgs.push_back(optimizeExpr(arg.get()));
+        // ¿Es un operador ternario? (cond ? a : b)
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            auto optimizedCond = optimizeExpr(ternary->condition.get());
+            auto optimizedTrue = optimizeExpr(ternary->exprTrue.get());
+            auto optimizedFalse = optimizeExpr(ternary->exprFalse.get());
+
+            return arena->make<TernaryExpr>(
+                move(optimizedCond),
+                move(optimizedTrue),
+                move(optimizedFalse)
+            );
         }
 
-        return make_unique<CallExpr>(call->functionName, move(optimizedArgs));
-    }
+        // ¿Es una llamada a función? (suma(a, b))
+        case NodeKind::CallExpr: {
+            CallExpr* call = static_cast<CallExpr*>(expr);
+            // Optimizar cada argumento
+            ExprList optimizedArgs(arena);
+            for (auto& arg : call->arguments) {
+                optimizedArgs.push_back(optimizeExpr(arg.get()));
+            }
 
-    // ¿Es un acceso a array? (arr[i])
-    else if (ArrayAccess* arrAccess = dynamic_cast<ArrayAccess*>(expr)) {
-        // Optimizar cada índice
-        vector<unique_ptr<Expr>> optimizedIndices;
-        for (auto& index : arrAccess->indices) {
-            optimizedIndices.push_back(optimizeExpr(index.get()));
+            return arena->make<CallExpr>(call->functionName, call->functionSymbol, move(optimizedArgs));
         }
 
-        return make_unique<ArrayAccess>(arrAccess->arrayName, move(optimizedIndices));
-    }
+        // ¿Es un acceso a array? (arr[i])
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* arrAccess = static_cast<ArrayAccess*>(expr);
+            // Optimizar cada índice
+            ExprList optimizedIndices(arena);
+            for (auto& index : arrAccess->indices) {
+                optimizedIndices.push_back(optimizeExpr(index.get()));
+            }
 
-    // ¿Es una asignación como expresión? (i = i + 1)
-    else if (AssignExpr* assignExpr = dynamic_cast<AssignExpr*>(expr)) {
-        // Optimizar el valor
-        auto optimizedValue = optimizeExpr(assignExpr->value.get());
-        
-        // Constant propagation: si el valor es constante, registrarlo
-        int value;
-        if (isIntLiteral(optimizedValue.get(), value)) {
-            constantValues[assignExpr->varName] = value;
-        } else {
-            // Si la variable se reasigna con un valor no constante, eliminarla
-            constantValues.erase(assignExpr->varName);
+            return arena->make<ArrayAccess>(arrAccess->arrayName, arrAccess->arraySymbol, move(optimizedIndices));
         }
-        
-        if (assignExpr->isArrayAssign) {
-            // Optimizar índices
-            vector<unique_ptr<Expr>> optimizedIndices;
-            for (auto& index : assignExpr->indices) {
-                optimizedIndices.push_back(optimizeExpr(index.get()));
+
+        // ¿Es una asignación como expresión? (i = i + 1)
+        case NodeKind::AssignExpr: {
+            AssignExpr* assignExpr = static_cast<AssignExpr*>(expr);
+            // Optimizar el valor
+            auto optimizedValue = optimizeExpr(assignExpr->value.get());
+
+            if (assignExpr->isArrayAssign) {
+                // Optimizar índices
+                ExprList optimizedIndices(arena);
+                for (auto& index : assignExpr->indices) {
+                    optimizedIndices.push_back(optimizeExpr(index.get()));
+                }
+                return arena->make<AssignExpr>(assignExpr->varName, assignExpr->varSymbol, move(optimizedIndices), move(optimizedValue));
+            } else {
+                return arena->make<AssignExpr>(assignExpr->varName, assignExpr->varSymbol, move(optimizedValue));
             }
-            return make_unique<AssignExpr>(assignExpr->varName, move(optimizedIndices), move(optimizedValue));
-        } else {
-            return make_unique<AssignExpr>(assignExpr->varName, move(optimizedValue));
+            break;
         }
+        default:
+            break;
     }
 
     // Si no reconocemos el tipo, devolver nullptr
@@ -335,7 +432,7 @@ unique_ptr<Expr> Optimizer::optimizeExpr(Expr* expr) {
 // ========== OPTIMIZAR OPERACIONES BINARIAS (CONSTANT FOLDING) ==========
 //
 // ========== OPTIMIZAR OPERACIONES BINARIAS (CONSTANT FOLDING + ALGEBRAIC SIMPLIFICATION) ==========
-unique_ptr<Expr> Optimizer::optimizeBinaryOp(BinaryOp* node) {
+ExprPtr Optimizer::optimizeBinaryOp(BinaryOp* node) {
     // Paso 1: Optimizar recursivamente los operandos izquierdo y derecho
     auto left = optimizeExpr(node->left.get());
     auto right = optimizeExpr(node->right.get());
@@ -346,14 +443,13 @@ unique_ptr<Expr> Optimizer::optimizeBinaryOp(BinaryOp* node) {
     bool rightIsLiteral = isIntLiteral(right.get(), rightValue);
 
     // Paso 3: CONSTANT FOLDING - Si AMBOS son literales
-    if (leftIsLiteral && rightIsLiteral) {
-        int result = calculate(leftValue, node->op.type, rightValue);
-
+    int result;
+    if (leftIsLiteral && rightIsLiteral && calculate(leftValue, node->op.type, rightValue, result)) {
         cout << "    Folded: " << leftValue << " "
              << node->op.lexeme << " " << rightValue
              << " -> " << result << endl;
 
-        return make_unique<IntLiteral>(result);
+        return arena->make<IntLiteral>(result);
     }
 
     // Paso 4: ALGEBRAIC SIMPLIFICATION
@@ -364,11 +460,11 @@ unique_ptr<Expr> Optimizer::optimizeBinaryOp(BinaryOp* node) {
         // x * 0 = 0
         if (rightIsLiteral && rightValue == 0) {
             cout << "    Simplified: x * 0 -> 0" << endl;
-            return make_unique<IntLiteral>(0);
+            return arena->make<IntLiteral>(0);
         }
         if (leftIsLiteral && leftValue == 0) {
             cout << "    Simplified: 0 * x -> 0" << endl;
-            return make_unique<IntLiteral>(0);
+            return arena->make<IntLiteral>(0);
         }
 
         // x * 1 = x
@@ -396,10 +492,10 @@ unique_ptr<Expr> Optimizer::optimizeBinaryOp(BinaryOp* node) {
 
             // Crear token para shift left
             Token shiftToken(TokenType::UNKNOWN, "<<", 0, 0);
-            return make_unique<BinaryOp>(
+            return arena->make<BinaryOp>(
                 move(left),
                 shiftToken,
-                make_unique<IntLiteral>(shiftAmount)
+                arena->make<IntLiteral>(shiftAmount)
             );
         }
     }
@@ -446,22 +542,22 @@ unique_ptr<Expr> Optimizer::optimizeBinaryOp(BinaryOp* node) {
             cout << "    Optimized: x / " << rightValue << " -> x >> " << shiftAmount << endl;
 
             Token shiftToken(TokenType::UNKNOWN, ">>", 0, 0);
-            return make_unique<BinaryOp>(
+            return arena->make<BinaryOp>(
                 move(left),
                 shiftToken,
-                make_unique<IntLiteral>(shiftAmount)
+                arena->make<IntLiteral>(shiftAmount)
             );
         }
     }
 
     // Paso 5: Si no se puede optimizar, devolver el BinaryOp con operandos optimizados
-    return make_unique<BinaryOp>(move(left), node->op, move(right));
+    return arena->make<BinaryOp>(move(left), node->op, move(right));
 }
 
 // ========== HELPER: Verificar si es IntLiteral ==========
 bool Optimizer::isIntLiteral(Expr* expr, int& value) {
     // Intentar hacer cast a IntLiteral
-    if (IntLiteral* lit = dynamic_cast<IntLiteral*>(expr)) {
+    if (IntLiteral* lit = nodeCast<IntLiteral>(expr)) {
         value = lit->value;  // Guardar el valor
         return true;
     }
@@ -469,42 +565,96 @@ bool Optimizer::isIntLiteral(Expr* expr, int& value) {
 }
 
 // ========== HELPER: Calcular operación ==========
-int Optimizer::calculate(int left, TokenType op, int right) {
+// Aritmética de int de C: da la vuelta en 32 bits
+bool Optimizer::calculate(int left, TokenType op, int right, int& result) {
+    unsigned int a = (unsigned int)left;
+    unsigned int b = (unsigned int)right;
     switch(op) {
         case TokenType::PLUS:
-            return left + right;
+            result = (int)(a + b);
+            return true;
 
         case TokenType::MINUS:
-            return left - right;
+            result = (int)(a - b);
+            return true;
 
         case TokenType::MULTIPLY:
-            return left * right;
+            result = (int)(a * b);
+            return true;
 
         case TokenType::DIVIDE:
-            if (right == 0) {
-                cerr << "Warning: Division by zero in constant folding" << endl;
-                return 0;
-            }
-            return left / right;
-
         case TokenType::MODULO:
-            if (right == 0) {
-                cerr << "Warning: Modulo by zero in constant folding" << endl;
-                return 0;
+            // División por cero (o INT_MIN / -1): se deja para runtime
+            if (right == 0 || (left == INT_MIN && right == -1)) {
+                return false;
             }
-            return left % right;
+            result = op == TokenType::DIVIDE ? left / right : left % right;
+            return true;
+
+        // Relacionales y lógicos: 0 o 1
+        case TokenType::EQ: result = left == right; return true;
+        case TokenType::NE: result = left != right; return true;
+        case TokenType::LT: result = left < right; return true;
+        case TokenType::GT: result = left > right; return true;
+        case TokenType::LE: result = left <= right; return true;
+        case TokenType::GE: result = left >= right; return true;
+        case TokenType::AND: result = left && right; return true;
+        case TokenType::OR: result = left || right; return true;
 
         default:
-            // Para operadores relacionales o que no podemos calcular
-            cerr << "Warning: Cannot fold operator" << endl;
-            return 0;
+            // << y >> de la reducción de operaciones, u otros
+            return false;
+    }
+}
+
+// ========== HELPER: Literal de la propagación de constantes ==========
+ExprPtr Optimizer::propagatedLiteral(Expr* expr) {
+    switch (expr->kind) {
+        case NodeKind::IntLiteral:
+        case NodeKind::FloatLiteral:
+        case NodeKind::LongLiteral:
+        case NodeKind::StringLiteral:
+            return nullptr;
+        default:
+            break;
+    }
+    const ConstantPropagation::Value* value = propagation.constantOf(expr);
+    if (!value) return nullptr;
+
+    ExprPtr literal;
+    string text;
+    if (value->type == DataType::FLOAT) {
+        literal = arena->make<FloatLiteral>(value->real);
+        text = to_string(value->real);
+    } else if (value->type == DataType::LONG) {
+        literal = arena->make<LongLiteral>((long)value->integer);
+        text = to_string(value->integer) + "L";
+    } else {
+        literal = arena->make<IntLiteral>((int)value->integer);
+        text = to_string(value->integer);
+    }
+
+    if (Variable* var = nodeCast<Variable>(expr)) {
+        cout << "    Replacing variable " << var->name << " with " << text << endl;
+    } else {
+        cout << "    Folded constant expression -> " << text << endl;
     }
+    constantsPropagated++;
+    return literal;
+}
+
+bool Optimizer::knownInt(Expr* expr, int& value) {
+    if (isIntLiteral(expr, value)) return true;
+    const ConstantPropagation::Value* constant = propagation.constantOf(expr);
+    if (!constant || constant->type != DataType::INT) return false;
+    value = (int)constant->integer;
+    return true;
 }
 
 
 // ========== LOOP UNROLLING ==========
 // Retorna true si el loop fue desenrollado exitosamente
-bool Optimizer::tryUnrollLoop(ForStmt* forStmt, vector<unique_ptr<Stmt>>& output) {
+bool Optimizer::tryUnrollLoop(ForStmt* forStmt, StmtList& output) {
     // Solo desenrollar loops muy simples:
     // - Inicializador: i = 0
     // - Condición: i < N (donde N es literal)
@@ -514,21 +664,21 @@ bool Optimizer::tryUnrollLoop(ForStmt* forStmt, vector<unique_ptr<Stmt>>& output
     // 1. Verificar inicializador: i = 0 (o cualquier literal)
     if (!forStmt->initializer) return false;
 
-    VarDecl* initDecl = dynamic_cast<VarDecl*>(forStmt->initializer.get());
-    AssignStmt* initAssign = dynamic_cast<AssignStmt*>(forStmt->initializer.get());
+    VarDecl* initDecl = nodeCast<VarDecl>(forStmt->initializer.get());
+    AssignStmt* initAssign = nodeCast<AssignStmt>(forStmt->initializer.get());
 
-    string loopVar;
+    SymbolId loopVar;
     int startValue;
 
     if (initDecl) {
         // int i = 0;
         if (!initDecl->initializer) return false;
-        if (!isIntLiteral(initDecl->initializer.get(), startValue)) return false;
-        loopVar = initDecl->name;
+        if (!knownInt(initDecl->initializer.get(), startValue)) return false;
+        loopVar = initDecl->symbol;
     } else if (initAssign) {
         // i = 0;
-        if (!isIntLiteral(initAssign->value.get(), startValue)) return false;
-        loopVar = initAssign->varName;
+        if (!knownInt(initAssign->value.get(), startValue)) return false;
+        loopVar = initAssign->varSymbol;
     } else {
         return false;
     }
@@ -536,33 +686,36 @@ bool Optimizer::tryUnrollLoop(ForStmt* forStmt, vector<unique_ptr<Stmt>>& output
     // 2. Verificar condición: i < N
     if (!forStmt->condition) return false;
 
-    BinaryOp* condition = dynamic_cast<BinaryOp*>(forStmt->condition.get());
+    BinaryOp* condition = nodeCast<BinaryOp>(forStmt->condition.get());
     if (!condition || condition->op.type != TokenType::LT) return false;
 
-    Variable* condVar = dynamic_cast<Variable*>(condition->left.get());
-    if (!condVar || condVar->name != loopVar) return false;
+    Variable* condVar = nodeCast<Variable>(condition->left.get());
+    if (!condVar || condVar->symbol != loopVar) return false;
 
     int endValue;
-    if (!isIntLiteral(condition->right.get(), endValue)) return false;
+    if (!knownInt(condition->right.get(), endValue)) return false;
 
     // 3. Verificar incremento: i = i + 1
     if (!forStmt->increment) return false;
 
     // El incremento es una expresión (AssignExpr)
-    AssignExpr* incAssign = dynamic_cast<AssignExpr*>(forStmt->increment.get());
+    AssignExpr* incAssign = nodeCast<AssignExpr>(forStmt->increment.get());
 
-    if (!incAssign || incAssign->varName != loopVar) return false;
+    if (!incAssign || incAssign->varSymbol != loopVar) return false;
 
-    BinaryOp* incExpr = dynamic_cast<BinaryOp*>(incAssign->value.get());
+    BinaryOp* incExpr = nodeCast<BinaryOp>(incAssign->value.get());
     if (!incExpr || incExpr->op.type != TokenType::PLUS) return false;
 
-    Variable* incVar = dynamic_cast<Variable*>(incExpr->left.get());
-    if (!incVar || incVar->name != loopVar) return false;
+    Variable* incVar = nodeCast<Variable>(incExpr->left.get());
+    if (!incVar || incVar->symbol != loopVar) return false;
 
     int incValue;
     if (!isIntLiteral(incExpr->right.get(), incValue)) return false;
     if (incValue != 1) return false;
 
+    // El cuerpo no puede cambiar el contador
+    if (assignsVariable(forStmt->body.get(), loopVar)) return false;
+
     // 4. Calcular número de iteraciones
     int iterations = (endValue - startValue) / incValue;
 
@@ -572,31 +725,23 @@ bool Optimizer::tryUnrollLoop(ForStmt* forStmt, vector<unique_ptr<Stmt>>& output
     }
 
     cout << "    Unrolling loop: " << iterations << " iterations" << endl;
+    reportUnroll(incAssign->varName, "full unroll (" + to_string(iterations) + " iterations)");
 
     // 5. Agregar el inicializador
     output.push_back(cloneStmt(forStmt->initializer.get()));
 
-    // 6. Desenrollar el cuerpo
+    // 6. Desenrollar el cuerpo: en cada copia el contador es un literal
     for (int i = startValue; i < endValue; i += incValue) {
-        // Guardar valor actual de la variable de loop en constantValues
-        int savedValue = 0;
-        bool hadValue = false;
-
-        if (constantValues.find(loopVar) != constantValues.end()) {
-            savedValue = constantValues[loopVar];
-            hadValue = true;
-        }
-
-        // Establecer valor actual de i
-        constantValues[loopVar] = i;
-
-        // Clonar y optimizar el cuerpo con el valor actual de i
+        unrollCounter = loopVar;
+        unrollValue = i;
         auto bodyClone = cloneStmt(forStmt->body.get());
+        unrollCounter = NO_SYMBOL;
+
         if (bodyClone) {
             optimizeStmt(bodyClone.get());
 
             // Si el cuerpo es un Block, aplanar sus statements
-            if (Block* bodyBlock = dynamic_cast<Block*>(bodyClone.get())) {
+            if (Block* bodyBlock = nodeCast<Block>(bodyClone.get())) {
                 for (auto& s : bodyBlock->statements) {
                     output.push_back(move(s));
                 }
@@ -604,262 +749,1845 @@ bool Optimizer::tryUnrollLoop(ForStmt* forStmt, vector<unique_ptr<Stmt>>& output
                 output.push_back(move(bodyClone));
             }
         }
-
-        // Restaurar valor anterior
-        if (hadValue) {
-            constantValues[loopVar] = savedValue;
-        } else {
-            constantValues.erase(loopVar);
-        }
     }
 
-    // Eliminar la variable de loop del mapa (ya no existe después del loop)
-    constantValues.erase(loopVar);
+    // 7. Un contador declarado fuera del for sigue vivo: su valor final
+    if (initAssign) {
+        output.push_back(arena->make<AssignStmt>(initAssign->varName, loopVar, arena->make<IntLiteral>(endValue)));
+    }
 
     return true;
 }
 
-// ========== CLONACIÓN DE NODOS ==========
-unique_ptr<Stmt> Optimizer::cloneStmt(Stmt* stmt) {
-    if (!stmt) return nullptr;
+// ========== DESENROLLADO PARCIAL ==========
+// Para los for que tryUnrollLoop no puede desenrollar del todo:
+//
+//   for (int i = a; i < n; i = i + 1) { body(i) }
+//
+// se convierte en (con factor 4)
+//
+//   int i = a;
+//   for (; i < n - 3; i = i + 4) { body(i) body(i + 1) body(i + 2) body(i + 3) }
+//   for (; i < n; i = i + 1) { body(i) }       // Resto: menos de 4 iteraciones
+//
+// El límite puede ser un literal o una variable que el cuerpo no asigna.
+
+// Tamaño máximo del cuerpo desenrollado, en nodos del AST
+static const int UNROLL_BODY_BUDGET = 64;
+
+// Solo se desenrollan los loops más internos
+static bool containsLoop(Stmt* stmt) {
+    if (!stmt) return false;
+
+    switch (stmt->kind) {
+        case NodeKind::WhileStmt:
+        case NodeKind::ForStmt:
+            return true;
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                if (containsLoop(s.get())) return true;
+            }
+            return false;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            return containsLoop(ifStmt->thenBranch.get()) || containsLoop(ifStmt->elseBranch.get());
+        }
+        default:
+            return false;
+    }
+}
 
-    // VarDecl
-    if (VarDecl* varDecl = dynamic_cast<VarDecl*>(stmt)) {
-        if (varDecl->initializer) {
-            return make_unique<VarDecl>(
-                varDecl->type,
-                varDecl->name,
-                cloneExpr(varDecl->initializer.get())
-            );
+int Optimizer::chooseUnrollFactor(int bodySize, int knownTrips) {
+    int factor = maxUnrollFactor;
+    while (factor > 1 && bodySize * factor > UNROLL_BODY_BUDGET) {
+        factor /= 2;
+    }
+    // Con pocas iteraciones casi todo terminaría en el loop de resto
+    while (factor > 1 && knownTrips >= 0 && knownTrips < 2 * factor) {
+        factor /= 2;
+    }
+    return factor;
+}
+
+bool Optimizer::tryPartialUnroll(ForStmt* forStmt, StmtList& output) {
+    // 1. Incremento: i = i + c / i = i - c
+    AssignExpr* incAssign = forStmt->increment ? nodeCast<AssignExpr>(forStmt->increment.get()) : nullptr;
+    BinaryOp* incExpr = incAssign && !incAssign->isArrayAssign ? nodeCast<BinaryOp>(incAssign->value.get()) : nullptr;
+    Variable* incVar = incExpr ? nodeCast<Variable>(incExpr->left.get()) : nullptr;
+    int step;
+    if (!incVar || incVar->symbol != incAssign->varSymbol || !isIntLiteral(incExpr->right.get(), step) ||
+        (incExpr->op.type != TokenType::PLUS && incExpr->op.type != TokenType::MINUS)) {
+        if (incAssign) reportUnroll(incAssign->varName, "not unrolled: increment is not i = i +/- constant");
+        return false;
+    }
+    if (incExpr->op.type == TokenType::MINUS) step = -step;
+    SymbolId loopVar = incAssign->varSymbol;
+    string_view loopName = incAssign->varName;
+    if (step == 0) {
+        reportUnroll(loopName, "not unrolled: zero step");
+        return false;
+    }
+
+    // 2. Condición: i < n, i <= n (paso positivo) o i > n, i >= n (negativo)
+    BinaryOp* condition = forStmt->condition ? nodeCast<BinaryOp>(forStmt->condition.get()) : nullptr;
+    Variable* condVar = condition ? nodeCast<Variable>(condition->left.get()) : nullptr;
+    TokenType op = condition ? condition->op.type : TokenType::UNKNOWN;
+    bool upward = op == TokenType::LT || op == TokenType::LE;
+    bool downward = op == TokenType::GT || op == TokenType::GE;
+    if (!condVar || condVar->symbol != loopVar || (step > 0 ? !upward : !downward)) {
+        reportUnroll(loopName, "not unrolled: condition is not i < n / i > n in the step direction");
+        return false;
+    }
+
+    int boundValue = 0;
+    bool boundIsLiteral = isIntLiteral(condition->right.get(), boundValue);
+    Variable* boundVar = nodeCast<Variable>(condition->right.get());
+    if (!boundIsLiteral && (!boundVar || boundVar->symbol == loopVar)) {
+        reportUnroll(loopName, "not unrolled: bound is not a constant or a variable");
+        return false;
+    }
+
+    // 3. Cuerpo sin loops, que no toque ni el contador ni el límite
+    if (containsLoop(forStmt->body.get())) {
+        reportUnroll(loopName, "not unrolled: not an innermost loop");
+        return false;
+    }
+    if (assignsVariable(forStmt->body.get(), loopVar) ||
+        (boundVar && assignsVariable(forStmt->body.get(), boundVar->symbol))) {
+        reportUnroll(loopName, "not unrolled: body assigns the counter or the bound");
+        return false;
+    }
+
+    // Los loops vectorizables los procesa CodeGen de a 4/8 elementos
+    LoopVectorizer::Loop vectorLoop;
+    if (LoopVectorizer::analyze(forStmt, vectorLoop)) {
+        reportUnroll(loopName, "not unrolled: left for the vectorizer");
+        return false;
+    }
+
+    // Si el contador solo indexa arrays y se compara con una constante,
+    // CodeGen lo reemplaza por punteros (ver induction.h). Desenrollado, el
+    // loop de resto necesitaría el contador y no se podría sacar
+    InductionAnalysis induction;
+    InductionAnalysis::Loop inductionLoop;
+    if (induction.analyze(forStmt, inductionLoop) && inductionLoop.counterOnlyIndexes) {
+        reportUnroll(loopName, "not unrolled: left for strength reduction");
+        return false;
+    }
+
+    // 4. Inicializador: int i = a, i = a o ninguno
+    int startValue = 0;
+    bool startIsLiteral = false;
+    if (forStmt->initializer) {
+        VarDecl* initDecl = nodeCast<VarDecl>(forStmt->initializer.get());
+        AssignStmt* initAssign = nodeCast<AssignStmt>(forStmt->initializer.get());
+        if (initDecl && initDecl->symbol == loopVar && !initDecl->isArray && initDecl->initializer) {
+            startIsLiteral = isIntLiteral(initDecl->initializer.get(), startValue);
+        } else if (initAssign && initAssign->varSymbol == loopVar && !initAssign->isArrayAssign) {
+            startIsLiteral = isIntLiteral(initAssign->value.get(), startValue);
         } else {
-            return make_unique<VarDecl>(
-                varDecl->type,
-                varDecl->name,
-                nullptr
-            );
+            reportUnroll(loopName, "not unrolled: initializer does not set the counter");
+            return false;
         }
     }
 
-    // AssignStmt
-    if (AssignStmt* assign = dynamic_cast<AssignStmt*>(stmt)) {
-        return make_unique<AssignStmt>(
-            assign->varName,
-            cloneExpr(assign->value.get())
-        );
+    // 5. Factor según el modelo de costo
+    int knownTrips = -1;
+    if (startIsLiteral && boundIsLiteral) {
+        long span = step > 0 ? (long)boundValue - startValue : (long)startValue - boundValue;
+        if (op == TokenType::LE || op == TokenType::GE) span++;
+        long stride = step > 0 ? step : -step;
+        knownTrips = span <= 0 ? 0 : (int)min<long>((span + stride - 1) / stride, 1 << 30);
+    }
+    int bodySize = countNodes(forStmt->body.get());
+    int factor = chooseUnrollFactor(bodySize, knownTrips);
+    if (factor < 2) {
+        if (maxUnrollFactor < 2) {
+            reportUnroll(loopName, "not unrolled: partial unrolling disabled");
+        } else if (knownTrips >= 0 && knownTrips < 4) {
+            reportUnroll(loopName, "not unrolled: " + to_string(knownTrips) + " iterations");
+        } else {
+            reportUnroll(loopName, "not unrolled: body too large (" + to_string(bodySize) + " nodes)");
+        }
+        return false;
     }
 
-    // Block
-    if (Block* block = dynamic_cast<Block*>(stmt)) {
-        vector<unique_ptr<Stmt>> clonedStmts;
-        for (auto& s : block->statements) {
-            auto cloned = cloneStmt(s.get());
-            if (cloned) {
-                clonedStmts.push_back(move(cloned));
+    cout << "    Partially unrolling loop: factor " << factor << endl;
+    reportUnroll(loopName, "partial unroll x" + to_string(factor) + " (body " + to_string(bodySize) +
+                 " nodes" + (knownTrips >= 0 ? ", " + to_string(knownTrips) + " iterations" : "") +
+                 ") + remainder loop");
+
+    // Loop principal: i op n - (factor - 1) * c, i = i + factor * c
+    int lastOffset = (factor - 1) * step;
+    ExprPtr mainBound;
+    if (boundIsLiteral) {
+        mainBound = arena->make<IntLiteral>(boundValue - lastOffset);
+    } else {
+        bool negative = lastOffset < 0;
+        Token offsetOp(negative ? TokenType::PLUS : TokenType::MINUS, negative ? "+" : "-", 0, 0);
+        mainBound = arena->make<BinaryOp>(
+            arena->make<Variable>(boundVar->name, boundVar->symbol),
+            offsetOp,
+            arena->make<IntLiteral>(negative ? -lastOffset : lastOffset)
+        );
+    }
+    auto mainCondition = arena->make<BinaryOp>(
+        arena->make<Variable>(condVar->name, condVar->symbol),
+        condition->op,
+        move(mainBound)
+    );
+    auto mainIncrement = arena->make<AssignExpr>(
+        incAssign->varName,
+        loopVar,
+        arena->make<BinaryOp>(
+            arena->make<Variable>(incVar->name, incVar->symbol),
+            incExpr->op,
+            arena->make<IntLiteral>(factor * (step > 0 ? step : -step))
+        )
+    );
+
+    // Cuerpo: las copias k = 0..factor-1 con i -> i + k * c
+    StmtList mainBody(arena);
+    cloneCounter = loopVar;
+    for (int k = 0; k < factor; k++) {
+        cloneCounterOffset = k * step;
+        auto copy = cloneStmt(forStmt->body.get());
+        if (Block* copyBlock = nodeCast<Block>(copy.get())) {
+            for (auto& s : copyBlock->statements) {
+                mainBody.push_back(move(s));
             }
+        } else if (copy) {
+            mainBody.push_back(move(copy));
         }
-        return make_unique<Block>(move(clonedStmts));
     }
-
-    // ExprStmt
-    if (ExprStmt* exprStmt = dynamic_cast<ExprStmt*>(stmt)) {
-        return make_unique<ExprStmt>(cloneExpr(exprStmt->expression.get()));
+    cloneCounter = NO_SYMBOL;
+    cloneCounterOffset = 0;
+
+    auto mainLoop = arena->make<ForStmt>(
+        nullptr,
+        move(mainCondition),
+        move(mainIncrement),
+        arena->make<Block>(move(mainBody))
+    );
+
+    // Resto: el loop original sin inicializador
+    auto remainderLoop = arena->make<ForStmt>(
+        nullptr,
+        move(forStmt->condition),
+        move(forStmt->increment),
+        move(forStmt->body)
+    );
+
+    // Se optimizan igual que el for original: inicializador, loops
+    if (forStmt->initializer) {
+        optimizeStmt(forStmt->initializer.get());
+        output.push_back(move(forStmt->initializer));
     }
-
-    return nullptr;
+    optimizeStmt(mainLoop.get());
+    output.push_back(move(mainLoop));
+    optimizeStmt(remainderLoop.get());
+    output.push_back(move(remainderLoop));
+    return true;
 }
 
-unique_ptr<Expr> Optimizer::cloneExpr(Expr* expr) {
-    if (!expr) return nullptr;
-
-    // IntLiteral
-    if (IntLiteral* lit = dynamic_cast<IntLiteral*>(expr)) {
-        return make_unique<IntLiteral>(lit->value);
+// Tamaño del cuerpo: cantidad de nodos
+int Optimizer::countNodes(Stmt* stmt) {
+    if (!stmt) return 0;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl:
+            return 1 + countNodes(static_cast<VarDecl*>(stmt)->initializer.get());
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            int count = 1 + countNodes(assign->value.get());
+            for (auto& index : assign->indices) {
+                count += countNodes(index.get());
+            }
+            return count;
+        }
+        case NodeKind::Block: {
+            int count = 0;
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                count += countNodes(s.get());
+            }
+            return count;
+        }
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            return 1 + countNodes(ifStmt->condition.get()) + countNodes(ifStmt->thenBranch.get()) +
+                   countNodes(ifStmt->elseBranch.get());
+        }
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            return 1 + countNodes(whileStmt->condition.get()) + countNodes(whileStmt->body.get());
+        }
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            return 1 + countNodes(forStmt->initializer.get()) + countNodes(forStmt->condition.get()) +
+                   countNodes(forStmt->increment.get()) + countNodes(forStmt->body.get());
+        }
+        case NodeKind::ReturnStmt:
+            return 1 + countNodes(static_cast<ReturnStmt*>(stmt)->value.get());
+        case NodeKind::ExprStmt:
+            return 1 + countNodes(static_cast<ExprStmt*>(stmt)->expression.get());
+        default:
+            return 1;
     }
+}
 
-    // Variable
-    if (Variable* var = dynamic_cast<Variable*>(expr)) {
-        // IMPORTANTE: Si la variable está en constantValues, reemplazarla
-        if (constantValues.find(var->name) != constantValues.end()) {
-            return make_unique<IntLiteral>(constantValues[var->name]);
+int Optimizer::countNodes(Expr* expr) {
+    if (!expr) return 0;
+
+    switch (expr->kind) {
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            return 1 + countNodes(binOp->left.get()) + countNodes(binOp->right.get());
+        }
+        case NodeKind::UnaryOp:
+            return 1 + countNodes(static_cast<UnaryOp*>(expr)->operand.get());
+        case NodeKind::CastExpr:
+            return 1 + countNodes(static_cast<CastExpr*>(expr)->expr.get());
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            return 1 + countNodes(ternary->condition.get()) + countNodes(ternary->exprTrue.get()) +
+                   countNodes(ternary->exprFalse.get());
+        }
+        case NodeKind::CallExpr: {
+            int count = 1;
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                count += countNodes(arg.get());
+            }
+            return count;
+        }
+        case NodeKind::ArrayAccess: {
+            int count = 1;
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                count += countNodes(index.get());
+            }
+            return count;
         }
-        return make_unique<Variable>(var->name);
+        case NodeKind::AssignExpr: {
+            AssignExpr* assignExpr = static_cast<AssignExpr*>(expr);
+            int count = 1 + countNodes(assignExpr->value.get());
+            for (auto& index : assignExpr->indices) {
+                count += countNodes(index.get());
+            }
+            return count;
+        }
+        default:
+            return 1;
     }
+}
 
-    // BinaryOp
-    if (BinaryOp* binOp = dynamic_cast<BinaryOp*>(expr)) {
-        auto leftClone = cloneExpr(binOp->left.get());
-        auto rightClone = cloneExpr(binOp->right.get());
+bool Optimizer::assignsVariable(Stmt* stmt, SymbolId symbol) {
+    if (!stmt) return false;
 
-        if (leftClone && rightClone) {
-            return make_unique<BinaryOp>(
-                move(leftClone),
-                binOp->op,
-                move(rightClone)
-            );
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            return varDecl->symbol == symbol || assignsVariable(varDecl->initializer.get(), symbol);
+        }
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            if (assign->varSymbol == symbol && !assign->isArrayAssign) return true;
+            for (auto& index : assign->indices) {
+                if (assignsVariable(index.get(), symbol)) return true;
+            }
+            return assignsVariable(assign->value.get(), symbol);
         }
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                if (assignsVariable(s.get(), symbol)) return true;
+            }
+            return false;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            return assignsVariable(ifStmt->condition.get(), symbol) ||
+                   assignsVariable(ifStmt->thenBranch.get(), symbol) ||
+                   assignsVariable(ifStmt->elseBranch.get(), symbol);
+        }
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            return assignsVariable(whileStmt->condition.get(), symbol) ||
+                   assignsVariable(whileStmt->body.get(), symbol);
+        }
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            return assignsVariable(forStmt->initializer.get(), symbol) ||
+                   assignsVariable(forStmt->condition.get(), symbol) ||
+                   assignsVariable(forStmt->increment.get(), symbol) ||
+                   assignsVariable(forStmt->body.get(), symbol);
+        }
+        case NodeKind::ReturnStmt:
+            return assignsVariable(static_cast<ReturnStmt*>(stmt)->value.get(), symbol);
+        case NodeKind::ExprStmt:
+            return assignsVariable(static_cast<ExprStmt*>(stmt)->expression.get(), symbol);
+        default:
+            return false;
     }
+}
 
-    // AssignExpr
-    if (AssignExpr* assignExpr = dynamic_cast<AssignExpr*>(expr)) {
-        if (assignExpr->isArrayAssign) {
-            vector<unique_ptr<Expr>> clonedIndices;
+bool Optimizer::assignsVariable(Expr* expr, SymbolId symbol) {
+    if (!expr) return false;
+
+    switch (expr->kind) {
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            return assignsVariable(binOp->left.get(), symbol) || assignsVariable(binOp->right.get(), symbol);
+        }
+        case NodeKind::UnaryOp:
+            return assignsVariable(static_cast<UnaryOp*>(expr)->operand.get(), symbol);
+        case NodeKind::CastExpr:
+            return assignsVariable(static_cast<CastExpr*>(expr)->expr.get(), symbol);
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            return assignsVariable(ternary->condition.get(), symbol) ||
+                   assignsVariable(ternary->exprTrue.get(), symbol) ||
+                   assignsVariable(ternary->exprFalse.get(), symbol);
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                if (assignsVariable(arg.get(), symbol)) return true;
+            }
+            return false;
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                if (assignsVariable(index.get(), symbol)) return true;
+            }
+            return false;
+        case NodeKind::AssignExpr: {
+            AssignExpr* assignExpr = static_cast<AssignExpr*>(expr);
+            if (assignExpr->varSymbol == symbol && !assignExpr->isArrayAssign) return true;
             for (auto& index : assignExpr->indices) {
-                clonedIndices.push_back(cloneExpr(index.get()));
+                if (assignsVariable(index.get(), symbol)) return true;
             }
-            return make_unique<AssignExpr>(
-                assignExpr->varName,
-                move(clonedIndices),
-                cloneExpr(assignExpr->value.get())
-            );
-        } else {
-            return make_unique<AssignExpr>(
-                assignExpr->varName,
-                cloneExpr(assignExpr->value.get())
-            );
+            return assignsVariable(assignExpr->value.get(), symbol);
         }
+        default:
+            return false;
     }
+}
 
-    return nullptr;
+void Optimizer::reportUnroll(string_view counter, const string& decision) {
+    unrollReport.push_back(string(currentFunction) + ": for (" + string(counter) + "): " + decision);
 }
 
-// ========== DEAD STORE ELIMINATION ==========
-void Optimizer::eliminateDeadStores(Block* block) {
-    // Analizar de atrás hacia adelante
-    set<string> liveVars;  // Variables que se leen después
-    vector<bool> isDead(block->statements.size(), false);
-    
-    // Recorrer de atrás hacia adelante
-    for (int i = block->statements.size() - 1; i >= 0; i--) {
-        Stmt* stmt = block->statements[i].get();
-        
-        // Si es un assignment
-        if (AssignStmt* assign = dynamic_cast<AssignStmt*>(stmt)) {
-            // Si la variable NO se lee después, es una escritura muerta
-            if (liveVars.find(assign->varName) == liveVars.end()) {
-                isDead[i] = true;
-                cout << "    Dead store eliminated: " << assign->varName << endl;
+// ========== CLONACIÓN DE NODOS ==========
+StmtPtr Optimizer::cloneStmt(Stmt* stmt) {
+    if (!stmt) return nullptr;
+
+    switch (stmt->kind) {
+        // VarDecl
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            // El inicializador todavía ve la variable de antes (si la hay)
+            ExprPtr initializer = cloneExpr(varDecl->initializer.get());
+            SymbolId symbol = varDecl->symbol;
+            string_view name = varDecl->name;
+            if (inliningClone) {
+                symbol = inlineLocal(varDecl->symbol, varDecl->name);
+                name = symbols->name(symbol);
+            }
+            if (varDecl->isArray) {
+                NodeList<int> dimensions(arena);
+                for (int dim : varDecl->dimensions) {
+                    dimensions.push_back(dim);
+                }
+                return arena->make<VarDecl>(
+                    varDecl->type,
+                    name,
+                    symbol,
+                    move(dimensions)
+                );
+            } else if (initializer) {
+                return arena->make<VarDecl>(
+                    varDecl->type,
+                    name,
+                    symbol,
+                    move(initializer)
+                );
             } else {
-                // Se lee después, es necesaria
-                // Remover de liveVars (ya encontramos la escritura)
-                liveVars.erase(assign->varName);
+                return arena->make<VarDecl>(
+                    varDecl->type,
+                    name,
+                    symbol,
+                    nullptr
+                );
             }
-            
-            // Agregar variables leídas en el lado derecho
-            getReadVariables(assign->value.get(), liveVars);
+            break;
         }
-        
-        // Si es un VarDecl con inicializador
-        else if (VarDecl* varDecl = dynamic_cast<VarDecl*>(stmt)) {
-            if (varDecl->initializer) {
-                // Si la variable NO se lee después, la inicialización es muerta
-                if (liveVars.find(varDecl->name) == liveVars.end()) {
-                    // No podemos eliminar la declaración, pero sí el inicializador
-                    cout << "    Dead initialization: " << varDecl->name << endl;
-                    varDecl->initializer = nullptr;
-                } else {
-                    liveVars.erase(varDecl->name);
-                    getReadVariables(varDecl->initializer.get(), liveVars);
+
+        // AssignStmt
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            SymbolId symbol = assign->varSymbol;
+            string_view name = assign->varName;
+            renameSymbol(symbol, name);
+            if (assign->isArrayAssign) {
+                ExprList clonedIndices(arena);
+                for (auto& index : assign->indices) {
+                    clonedIndices.push_back(cloneExpr(index.get()));
                 }
+                return arena->make<AssignStmt>(
+                    name,
+                    symbol,
+                    move(clonedIndices),
+                    cloneExpr(assign->value.get())
+                );
             }
+            return arena->make<AssignStmt>(
+                name,
+                symbol,
+                cloneExpr(assign->value.get())
+            );
         }
-        
-        // Para cualquier otro statement, obtener variables leídas
-        else {
-            getReadVariablesInStmt(stmt, liveVars);
+
+        // Block
+        case NodeKind::Block: {
+            Block* block = static_cast<Block*>(stmt);
+            StmtList clonedStmts(arena);
+            for (auto& s : block->statements) {
+                auto cloned = cloneStmt(s.get());
+                if (cloned) {
+                    clonedStmts.push_back(move(cloned));
+                }
+            }
+            return arena->make<Block>(move(clonedStmts));
         }
-    }
-    
-    // Eliminar statements marcados como muertos
-    vector<unique_ptr<Stmt>> aliveStmts;
-    for (size_t i = 0; i < block->statements.size(); i++) {
-        if (!isDead[i]) {
-            aliveStmts.push_back(move(block->statements[i]));
+
+        // IfStmt
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            return arena->make<IfStmt>(
+                cloneExpr(ifStmt->condition.get()),
+                cloneStmt(ifStmt->thenBranch.get()),
+                cloneStmt(ifStmt->elseBranch.get())
+            );
         }
-    }
-    
-    block->statements = move(aliveStmts);
-}
 
-// Helper: Obtiene variables leídas en una expresión
-void Optimizer::getReadVariables(Expr* expr, set<string>& variables) {
-    if (!expr) return;
-    
-    if (Variable* var = dynamic_cast<Variable*>(expr)) {
-        variables.insert(var->name);
-    }
-    else if (BinaryOp* binOp = dynamic_cast<BinaryOp*>(expr)) {
-        getReadVariables(binOp->left.get(), variables);
-        getReadVariables(binOp->right.get(), variables);
-    }
-    else if (UnaryOp* unOp = dynamic_cast<UnaryOp*>(expr)) {
-        getReadVariables(unOp->operand.get(), variables);
-    }
-    else if (CallExpr* call = dynamic_cast<CallExpr*>(expr)) {
-        for (auto& arg : call->arguments) {
-            getReadVariables(arg.get(), variables);
+        // WhileStmt
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            return arena->make<WhileStmt>(
+                cloneExpr(whileStmt->condition.get()),
+                cloneStmt(whileStmt->body.get())
+            );
         }
-    }
-    else if (ArrayAccess* arrAccess = dynamic_cast<ArrayAccess*>(expr)) {
-        variables.insert(arrAccess->arrayName);
-        for (auto& index : arrAccess->indices) {
-            getReadVariables(index.get(), variables);
+
+        // ForStmt
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            // El inicializador primero: si declara el contador, el inliner
+            // registra su renombre antes de copiar los usos (el orden de
+            // evaluación de los argumentos de make<> no está definido)
+            StmtPtr initializer = cloneStmt(forStmt->initializer.get());
+            return arena->make<ForStmt>(
+                move(initializer),
+                cloneExpr(forStmt->condition.get()),
+                cloneExpr(forStmt->increment.get()),
+                cloneStmt(forStmt->body.get())
+            );
         }
-    }
-    else if (TernaryExpr* ternary = dynamic_cast<TernaryExpr*>(expr)) {
-        getReadVariables(ternary->condition.get(), variables);
-        getReadVariables(ternary->exprTrue.get(), variables);
-        getReadVariables(ternary->exprFalse.get(), variables);
-    }
-    else if (CastExpr* cast = dynamic_cast<CastExpr*>(expr)) {
-        getReadVariables(cast->expr.get(), variables);
-    }
-    else if (AssignExpr* assignExpr = dynamic_cast<AssignExpr*>(expr)) {
-        // En una asignación como expresión, solo leemos las variables del lado derecho
-        getReadVariables(assignExpr->value.get(), variables);
-        // También leemos los índices si es array
-        for (auto& index : assignExpr->indices) {
-            getReadVariables(index.get(), variables);
+
+        // ReturnStmt
+        case NodeKind::ReturnStmt: {
+            ReturnStmt* returnStmt = static_cast<ReturnStmt*>(stmt);
+            return arena->make<ReturnStmt>(cloneExpr(returnStmt->value.get()));
+        }
+
+        // ExprStmt
+        case NodeKind::ExprStmt: {
+            ExprStmt* exprStmt = static_cast<ExprStmt*>(stmt);
+            return arena->make<ExprStmt>(cloneExpr(exprStmt->expression.get()));
         }
+        default:
+            break;
     }
+
+    return nullptr;
 }
 
-// Helper: Obtiene variables leídas en un statement
-void Optimizer::getReadVariablesInStmt(Stmt* stmt, set<string>& variables) {
-    if (!stmt) return;
-    
-    if (ExprStmt* exprStmt = dynamic_cast<ExprStmt*>(stmt)) {
-        getReadVariables(exprStmt->expression.get(), variables);
-    }
-    else if (ReturnStmt* retStmt = dynamic_cast<ReturnStmt*>(stmt)) {
-        if (retStmt->value) {
-            getReadVariables(retStmt->value.get(), variables);
+ExprPtr Optimizer::cloneExpr(Expr* expr) {
+    if (!expr) return nullptr;
+
+    switch (expr->kind) {
+        // Literales
+        case NodeKind::IntLiteral: {
+            IntLiteral* lit = static_cast<IntLiteral*>(expr);
+            return arena->make<IntLiteral>(lit->value);
         }
-    }
-    else if (IfStmt* ifStmt = dynamic_cast<IfStmt*>(stmt)) {
-        getReadVariables(ifStmt->condition.get(), variables);
-        // También considerar variables leídas en las ramas
-        getReadVariablesInStmt(ifStmt->thenBranch.get(), variables);
-        if (ifStmt->elseBranch) {
-            getReadVariablesInStmt(ifStmt->elseBranch.get(), variables);
+        case NodeKind::FloatLiteral: {
+            FloatLiteral* lit = static_cast<FloatLiteral*>(expr);
+            return arena->make<FloatLiteral>(lit->value);
         }
-    }
-    else if (WhileStmt* whileStmt = dynamic_cast<WhileStmt*>(stmt)) {
-        getReadVariables(whileStmt->condition.get(), variables);
-        getReadVariablesInStmt(whileStmt->body.get(), variables);
-    }
-    else if (ForStmt* forStmt = dynamic_cast<ForStmt*>(stmt)) {
-        if (forStmt->condition) {
-            getReadVariables(forStmt->condition.get(), variables);
+        case NodeKind::LongLiteral: {
+            LongLiteral* lit = static_cast<LongLiteral*>(expr);
+            return arena->make<LongLiteral>(lit->value);
         }
-        if (forStmt->increment) {
-            getReadVariables(forStmt->increment.get(), variables);
+        case NodeKind::StringLiteral: {
+            StringLiteral* lit = static_cast<StringLiteral*>(expr);
+            return arena->make<StringLiteral>(lit->value);
         }
-        getReadVariablesInStmt(forStmt->body.get(), variables);
+
+        // Variable
+        case NodeKind::Variable: {
+            Variable* var = static_cast<Variable*>(expr);
+            // Desenrollado parcial: i -> i + offset en la copia k del cuerpo
+            if (var->symbol == cloneCounter && cloneCounterOffset != 0) {
+                bool negative = cloneCounterOffset < 0;
+                Token opToken(negative ? TokenType::MINUS : TokenType::PLUS, negative ? "-" : "+", 0, 0);
+                return arena->make<BinaryOp>(
+                    arena->make<Variable>(var->name, var->symbol),
+                    opToken,
+                    arena->make<IntLiteral>(negative ? -cloneCounterOffset : cloneCounterOffset)
+                );
+            }
+            // Desenrollado completo: el contador vale un literal en esta copia
+            if (var->symbol == unrollCounter) {
+                return arena->make<IntLiteral>(unrollValue);
+            }
+            // Constante conocida en el cuerpo original (vale en todas las copias)
+            if (ExprPtr literal = propagatedLiteral(expr)) {
+                return literal;
+            }
+            SymbolId symbol = var->symbol;
+            string_view name = var->name;
+            renameSymbol(symbol, name);
+            return arena->make<Variable>(name, symbol);
+        }
+
+        // BinaryOp
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            auto leftClone = cloneExpr(binOp->left.get());
+            auto rightClone = cloneExpr(binOp->right.get());
+
+            if (leftClone && rightClone) {
+                return arena->make<BinaryOp>(
+                    move(leftClone),
+                    binOp->op,
+                    move(rightClone)
+                );
+            }
+            break;
+        }
+
+        // UnaryOp
+        case NodeKind::UnaryOp: {
+            UnaryOp* unOp = static_cast<UnaryOp*>(expr);
+            return arena->make<UnaryOp>(unOp->op, cloneExpr(unOp->operand.get()));
+        }
+
+        // CastExpr
+        case NodeKind::CastExpr: {
+            CastExpr* cast = static_cast<CastExpr*>(expr);
+            return arena->make<CastExpr>(cast->targetType, cloneExpr(cast->expr.get()));
+        }
+
+        // TernaryExpr
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            return arena->make<TernaryExpr>(
+                cloneExpr(ternary->condition.get()),
+                cloneExpr(ternary->exprTrue.get()),
+                cloneExpr(ternary->exprFalse.get())
+            );
+        }
+
+        // CallExpr
+        case NodeKind::CallExpr: {
+            CallExpr* call = static_cast<CallExpr*>(expr);
+            ExprList clonedArgs(arena);
+            for (auto& arg : call->arguments) {
+                clonedArgs.push_back(cloneExpr(arg.get()));
+            }
+            return arena->make<CallExpr>(call->functionName, call->functionSymbol, move(clonedArgs));
+        }
+
+        // ArrayAccess
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* arrAccess = static_cast<ArrayAccess*>(expr);
+            ExprList clonedIndices(arena);
+            for (auto& index : arrAccess->indices) {
+                clonedIndices.push_back(cloneExpr(index.get()));
+            }
+            SymbolId symbol = arrAccess->arraySymbol;
+            string_view name = arrAccess->arrayName;
+            renameSymbol(symbol, name);
+            return arena->make<ArrayAccess>(name, symbol, move(clonedIndices));
+        }
+
+        // AssignExpr
+        case NodeKind::AssignExpr: {
+            AssignExpr* assignExpr = static_cast<AssignExpr*>(expr);
+            SymbolId symbol = assignExpr->varSymbol;
+            string_view name = assignExpr->varName;
+            renameSymbol(symbol, name);
+            if (assignExpr->isArrayAssign) {
+                ExprList clonedIndices(arena);
+                for (auto& index : assignExpr->indices) {
+                    clonedIndices.push_back(cloneExpr(index.get()));
+                }
+                return arena->make<AssignExpr>(
+                    name,
+                    symbol,
+                    move(clonedIndices),
+                    cloneExpr(assignExpr->value.get())
+                );
+            } else {
+                return arena->make<AssignExpr>(
+                    name,
+                    symbol,
+                    cloneExpr(assignExpr->value.get())
+                );
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return nullptr;
+}
+
+// ========== GRAFO DE LLAMADAS ==========
+// Se arma con los CallExpr de cada cuerpo. printf y las funciones sin
+// cuerpo no son nodos del grafo.
+void Optimizer::buildCallGraph(Program* program, CallGraph& graph) {
+    for (auto& stmt : program->statements) {
+        FunctionDecl* func = nodeCast<FunctionDecl>(stmt.get());
+        if (!func || !func->body) continue;
+        graph.functions[func->symbol] = func;
+        graph.order.push_back(func);
+    }
+
+    for (FunctionDecl* func : graph.order) {
+        vector<CallExpr*> calls;
+        collectCalls(func->body.get(), calls);
+        vector<SymbolId>& targets = graph.callees[func->symbol];
+        for (CallExpr* call : calls) {
+            if (!graph.functions.contains(call->functionSymbol)) continue;
+            targets.push_back(call->functionSymbol);
+            graph.callSites[call->functionSymbol].push_back(call);
+        }
+    }
+}
+
+// Recursivas (directa o mutuamente): se alcanzan a sí mismas
+bool Optimizer::isRecursive(CallGraph& graph, SymbolId function) {
+    SymbolSet visited;
+    vector<SymbolId> pending = {function};
+    while (!pending.empty()) {
+        SymbolId current = pending.back();
+        pending.pop_back();
+        vector<SymbolId>* targets = graph.callees.find(current);
+        if (!targets) continue;
+        for (SymbolId target : *targets) {
+            if (target == function) return true;
+            if (!visited.contains(target)) {
+                visited.insert(target);
+                pending.push_back(target);
+            }
+        }
+    }
+    return false;
+}
+
+// ========== INLINING ==========
+// Una función chica se copia en cada call site:
+//
+//   x = multiplicar(x, y);   ->   int multiplicar.a.1 = x;
+//                                 int multiplicar.b.1 = y;
+//                                 int multiplicar.resultado.1;
+//                                 multiplicar.resultado.1 = multiplicar.a.1 * multiplicar.b.1;
+//                                 int multiplicar.return.1 = multiplicar.resultado.1;
+//                                 x = multiplicar.return.1;
+//
+// Los parámetros y locales del callee se renombran en cada copia. Solo se
+// copian cuerpos con un único return al final, sin arrays, y con
+// parámetros y retorno int/long (los float viajan en registros enteros en
+// la convención de CodeGen). El call tiene que estar en la expresión de
+// un statement (declaración, asignación, if, return o expression
+// statement), en una posición que siempre se evalúa.
+
+// Cuerpos de hasta este tamaño cuestan menos que el call (movs de
+// argumentos, prólogo, epílogo): se copian en todos los call sites
+static const int INLINE_CALL_COST = 12;
+
+// ¿Hay un return en el statement? (fuera del último del cuerpo)
+static bool containsReturn(Stmt* stmt) {
+    if (!stmt) return false;
+
+    switch (stmt->kind) {
+        case NodeKind::ReturnStmt:
+            return true;
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                if (containsReturn(s.get())) return true;
+            }
+            return false;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            return containsReturn(ifStmt->thenBranch.get()) || containsReturn(ifStmt->elseBranch.get());
+        }
+        case NodeKind::WhileStmt:
+            return containsReturn(static_cast<WhileStmt*>(stmt)->body.get());
+        case NodeKind::ForStmt:
+            return containsReturn(static_cast<ForStmt*>(stmt)->body.get());
+        default:
+            return false;
+    }
+}
+
+// ¿Se declara algún array en el statement?
+static bool declaresArray(Stmt* stmt) {
+    if (!stmt) return false;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl:
+            return static_cast<VarDecl*>(stmt)->isArray;
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                if (declaresArray(s.get())) return true;
+            }
+            return false;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            return declaresArray(ifStmt->thenBranch.get()) || declaresArray(ifStmt->elseBranch.get());
+        }
+        case NodeKind::WhileStmt:
+            return declaresArray(static_cast<WhileStmt*>(stmt)->body.get());
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            return declaresArray(forStmt->initializer.get()) || declaresArray(forStmt->body.get());
+        }
+        default:
+            return false;
+    }
+}
+
+static bool isIntegerType(DataType type) {
+    return type == DataType::INT || type == DataType::LONG;
+}
+
+void Optimizer::inlineFunctions(Program* program) {
+    inlineCandidates.clear();
+    if (inlineSizeThreshold <= 0) return;
+
+    CallGraph graph;
+    buildCallGraph(program, graph);
+
+    // Modelo de costo: tamaño del cuerpo contra cantidad de copias
+    for (FunctionDecl* func : graph.order) {
+        if (func->name == "main" || !canInline(func) || isRecursive(graph, func->symbol)) continue;
+        int size = countNodes(func->body.get());
+        vector<CallExpr*>* calls = graph.callSites.find(func->symbol);
+        int sites = calls ? (int)calls->size() : 0;
+        if (sites == 0 || size > inlineSizeThreshold) continue;
+        if (size > INLINE_CALL_COST && sites > inlineCallSites) continue;
+        inlineCandidates[func->symbol] = func;
+        inlinedFunctions++;
+    }
+
+    for (FunctionDecl* func : graph.order) {
+        currentFunction = func->name;
+        inlineCallsInBlock(func->body.get());
+    }
+}
+
+bool Optimizer::canInline(FunctionDecl* func) {
+    if (func->parameters.size() > 6) return false;
+    if (!isIntegerType(func->returnType) && func->returnType != DataType::VOID) return false;
+    for (const Param& param : func->parameters) {
+        if (!isIntegerType(param.type)) return false;
+    }
+    if (declaresArray(func->body.get())) return false;
+
+    // Un solo return, como último statement (opcional si es void)
+    StmtList& body = func->body->statements;
+    size_t count = body.size();
+    ReturnStmt* last = count > 0 ? nodeCast<ReturnStmt>(body[count - 1].get()) : nullptr;
+    if (last) count--;
+    for (size_t i = 0; i < count; i++) {
+        if (containsReturn(body[i].get())) return false;
+    }
+    if (func->returnType == DataType::VOID) return !last || !last->value;
+    return last && last->value;
+}
+
+void Optimizer::collectCalls(Stmt* stmt, vector<CallExpr*>& calls) {
+    if (!stmt) return;
+
+    switch (stmt->kind) {
+        case NodeKind::VarDecl:
+            collectCalls(static_cast<VarDecl*>(stmt)->initializer.get(), calls);
+            break;
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            for (auto& index : assign->indices) {
+                collectCalls(index.get(), calls);
+            }
+            collectCalls(assign->value.get(), calls);
+            break;
+        }
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                collectCalls(s.get(), calls);
+            }
+            break;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            collectCalls(ifStmt->condition.get(), calls);
+            collectCalls(ifStmt->thenBranch.get(), calls);
+            collectCalls(ifStmt->elseBranch.get(), calls);
+            break;
+        }
+        case NodeKind::WhileStmt: {
+            WhileStmt* whileStmt = static_cast<WhileStmt*>(stmt);
+            collectCalls(whileStmt->condition.get(), calls);
+            collectCalls(whileStmt->body.get(), calls);
+            break;
+        }
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt);
+            collectCalls(forStmt->initializer.get(), calls);
+            collectCalls(forStmt->condition.get(), calls);
+            collectCalls(forStmt->increment.get(), calls);
+            collectCalls(forStmt->body.get(), calls);
+            break;
+        }
+        case NodeKind::ReturnStmt:
+            collectCalls(static_cast<ReturnStmt*>(stmt)->value.get(), calls);
+            break;
+        case NodeKind::ExprStmt:
+            collectCalls(static_cast<ExprStmt*>(stmt)->expression.get(), calls);
+            break;
+        default:
+            break;
+    }
+}
+
+void Optimizer::collectCalls(Expr* expr, vector<CallExpr*>& calls) {
+    if (!expr) return;
+
+    switch (expr->kind) {
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            collectCalls(binOp->left.get(), calls);
+            collectCalls(binOp->right.get(), calls);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            collectCalls(static_cast<UnaryOp*>(expr)->operand.get(), calls);
+            break;
+        case NodeKind::CastExpr:
+            collectCalls(static_cast<CastExpr*>(expr)->expr.get(), calls);
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            collectCalls(ternary->condition.get(), calls);
+            collectCalls(ternary->exprTrue.get(), calls);
+            collectCalls(ternary->exprFalse.get(), calls);
+            break;
+        }
+        case NodeKind::CallExpr: {
+            CallExpr* call = static_cast<CallExpr*>(expr);
+            calls.push_back(call);
+            for (auto& arg : call->arguments) {
+                collectCalls(arg.get(), calls);
+            }
+            break;
+        }
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                collectCalls(index.get(), calls);
+            }
+            break;
+        case NodeKind::AssignExpr: {
+            AssignExpr* assignExpr = static_cast<AssignExpr*>(expr);
+            for (auto& index : assignExpr->indices) {
+                collectCalls(index.get(), calls);
+            }
+            collectCalls(assignExpr->value.get(), calls);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void Optimizer::inlineCallsInBlock(Block* block) {
+    StmtList output(arena);
+    for (auto& stmt : block->statements) {
+        inlineCallsInStmt(move(stmt), output);
+    }
+    block->statements = move(output);
+}
+
+// Rama de un if o cuerpo de un loop: si no es un bloque y hay que
+// agregar statements, pasa a serlo
+void Optimizer::inlineCallsInBranch(StmtPtr& branch) {
+    if (!branch) return;
+    if (Block* block = nodeCast<Block>(branch.get())) {
+        inlineCallsInBlock(block);
+        return;
+    }
+
+    StmtList output(arena);
+    inlineCallsInStmt(move(branch), output);
+    if (output.size() == 1) {
+        branch = move(output[0]);
+    } else {
+        branch = arena->make<Block>(move(output));
+    }
+}
+
+void Optimizer::inlineCallsInStmt(StmtPtr stmt, StmtList& output) {
+    // Expresiones que se evalúan una vez, antes que el resto del statement
+    vector<ExprPtr*> roots;
+    switch (stmt->kind) {
+        case NodeKind::VarDecl:
+            roots.push_back(&static_cast<VarDecl*>(stmt.get())->initializer);
+            break;
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt.get());
+            roots.push_back(&assign->value);
+            for (auto& index : assign->indices) {
+                roots.push_back(&index);
+            }
+            break;
+        }
+        case NodeKind::Block:
+            inlineCallsInBlock(static_cast<Block*>(stmt.get()));
+            break;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt.get());
+            roots.push_back(&ifStmt->condition);
+            inlineCallsInBranch(ifStmt->thenBranch);
+            inlineCallsInBranch(ifStmt->elseBranch);
+            break;
+        }
+        case NodeKind::WhileStmt:
+            inlineCallsInBranch(static_cast<WhileStmt*>(stmt.get())->body);
+            break;
+        case NodeKind::ForStmt:
+            inlineCallsInBranch(static_cast<ForStmt*>(stmt.get())->body);
+            break;
+        case NodeKind::ReturnStmt:
+            roots.push_back(&static_cast<ReturnStmt*>(stmt.get())->value);
+            break;
+        case NodeKind::ExprStmt:
+            roots.push_back(&static_cast<ExprStmt*>(stmt.get())->expression);
+            break;
+        default:
+            break;
+    }
+
+    // Un call por vuelta: al copiarlo queda una variable en su lugar
+    bool expanded = true;
+    while (stmt && expanded) {
+        expanded = false;
+        for (ExprPtr* root : roots) {
+            ExprPtr* slot = findInlineCall(*root);
+            if (!slot) continue;
+
+            // Un void solo se puede copiar como expression statement
+            CallExpr* call = static_cast<CallExpr*>(slot->get());
+            ExprStmt* exprStmt = nodeCast<ExprStmt>(stmt.get());
+            bool independent = (*inlineCandidates.find(call->functionSymbol))->returnType != DataType::VOID ||
+                               (exprStmt && &exprStmt->expression == slot);
+            for (ExprPtr* other : roots) {
+                bool seen = false;
+                if (dependsOnOrder(other->get(), slot->get(), seen)) independent = false;
+            }
+            if (independent) {
+                expandCall(slot, stmt, output);
+                expanded = true;
+            }
+            break;
+        }
+    }
+    if (stmt) output.push_back(move(stmt));
+}
+
+ExprPtr* Optimizer::findInlineCall(ExprPtr& expr) {
+    if (!expr) return nullptr;
+
+    switch (expr->kind) {
+        case NodeKind::CallExpr: {
+            CallExpr* call = static_cast<CallExpr*>(expr.get());
+            if (FunctionDecl** callee = inlineCandidates.find(call->functionSymbol)) {
+                if ((*callee)->parameters.size() == call->arguments.size()) return &expr;
+            }
+            for (auto& arg : call->arguments) {
+                if (ExprPtr* found = findInlineCall(arg)) return found;
+            }
+            return nullptr;
+        }
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr.get());
+            if (ExprPtr* found = findInlineCall(binOp->left)) return found;
+            // El lado derecho de && / || puede no evaluarse
+            if (binOp->op.type == TokenType::AND || binOp->op.type == TokenType::OR) return nullptr;
+            return findInlineCall(binOp->right);
+        }
+        case NodeKind::UnaryOp:
+            return findInlineCall(static_cast<UnaryOp*>(expr.get())->operand);
+        case NodeKind::CastExpr:
+            return findInlineCall(static_cast<CastExpr*>(expr.get())->expr);
+        case NodeKind::TernaryExpr:
+            return findInlineCall(static_cast<TernaryExpr*>(expr.get())->condition);
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr.get())->indices) {
+                if (ExprPtr* found = findInlineCall(index)) return found;
+            }
+            return nullptr;
+        case NodeKind::AssignExpr: {
+            AssignExpr* assignExpr = static_cast<AssignExpr*>(expr.get());
+            for (auto& index : assignExpr->indices) {
+                if (ExprPtr* found = findInlineCall(index)) return found;
+            }
+            return findInlineCall(assignExpr->value);
+        }
+        default:
+            return nullptr;
+    }
+}
+
+// `seen` pasa a true al encontrar `call`: los calls que lo contienen se
+// ejecutan después de él y no cuentan
+bool Optimizer::dependsOnOrder(Expr* expr, Expr* call, bool& seen) {
+    if (!expr) return false;
+    if (expr == call) {
+        seen = true;
+        return false;
+    }
+
+    switch (expr->kind) {
+        case NodeKind::Variable:
+            return globalSymbols.contains(static_cast<Variable*>(expr)->symbol);
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            bool left = dependsOnOrder(binOp->left.get(), call, seen);
+            return dependsOnOrder(binOp->right.get(), call, seen) || left;
+        }
+        case NodeKind::UnaryOp:
+            return dependsOnOrder(static_cast<UnaryOp*>(expr)->operand.get(), call, seen);
+        case NodeKind::CastExpr:
+            return dependsOnOrder(static_cast<CastExpr*>(expr)->expr.get(), call, seen);
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            bool condition = dependsOnOrder(ternary->condition.get(), call, seen);
+            bool exprTrue = dependsOnOrder(ternary->exprTrue.get(), call, seen);
+            return dependsOnOrder(ternary->exprFalse.get(), call, seen) || condition || exprTrue;
+        }
+        case NodeKind::CallExpr: {
+            bool before = seen;
+            bool depends = false;
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                if (dependsOnOrder(arg.get(), call, seen)) depends = true;
+            }
+            return depends || seen == before;
+        }
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* arrAccess = static_cast<ArrayAccess*>(expr);
+            bool depends = globalSymbols.contains(arrAccess->arraySymbol);
+            for (auto& index : arrAccess->indices) {
+                if (dependsOnOrder(index.get(), call, seen)) depends = true;
+            }
+            return depends;
+        }
+        case NodeKind::AssignExpr:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void Optimizer::expandCall(ExprPtr* slot, StmtPtr& stmt, StmtList& output) {
+    CallExpr* call = static_cast<CallExpr*>(slot->get());
+    FunctionDecl* callee = *inlineCandidates.find(call->functionSymbol);
+    cout << "    Inlining call: " << callee->name << " into " << currentFunction << endl;
+    inlinedCalls++;
+
+    // Se clona todo antes de seguir inlineando adentro de la copia (eso
+    // vuelve a usar inlineRenames)
+    inlineCopy++;
+    inlineCallee = callee->name;
+    inlineRenames.clear();
+    inliningClone = true;
+
+    // Parámetros: variables inicializadas con los argumentos, en orden
+    vector<StmtPtr> copy;
+    for (size_t i = 0; i < callee->parameters.size(); i++) {
+        const Param& param = callee->parameters[i];
+        SymbolId symbol = inlineLocal(param.symbol, param.name);
+        copy.push_back(arena->make<VarDecl>(param.type, symbols->name(symbol), symbol, move(call->arguments[i])));
+    }
+
+    StmtList& body = callee->body->statements;
+    ExprPtr result;
+    for (auto& s : body) {
+        if (ReturnStmt* ret = nodeCast<ReturnStmt>(s.get())) {
+            result = cloneExpr(ret->value.get());
+        } else {
+            copy.push_back(cloneStmt(s.get()));
+        }
+    }
+
+    // El valor del return reemplaza al call
+    ExprStmt* exprStmt = nodeCast<ExprStmt>(stmt.get());
+    if (exprStmt && &exprStmt->expression == slot) {
+        bool seen = false;
+        if (result && dependsOnOrder(result.get(), nullptr, seen)) {
+            copy.push_back(arena->make<ExprStmt>(move(result)));
+        }
+        stmt = nullptr;
+    } else {
+        SymbolId symbol = inlineLocal(NO_SYMBOL, "return");
+        string_view name = symbols->name(symbol);
+        copy.push_back(arena->make<VarDecl>(callee->returnType, name, symbol, move(result)));
+        *slot = arena->make<Variable>(name, symbol);
+    }
+    inliningClone = false;
+
+    for (StmtPtr& s : copy) {
+        inlineCallsInStmt(move(s), output);
+    }
+}
+
+SymbolId Optimizer::inlineLocal(SymbolId symbol, string_view name) {
+    string copyName = string(inlineCallee) + "." + string(name) + "." + to_string(inlineCopy);
+    SymbolId copySymbol = symbols->internCopy(copyName);
+    if (symbol != NO_SYMBOL) inlineRenames[symbol] = copySymbol;
+    return copySymbol;
+}
+
+void Optimizer::renameSymbol(SymbolId& symbol, string_view& name) {
+    if (!inliningClone) return;
+    if (SymbolId* copySymbol = inlineRenames.find(symbol)) {
+        symbol = *copySymbol;
+        name = symbols->name(symbol);
+    }
+}
+
+// ========== PROPAGACIÓN ENTRE FUNCIONES ==========
+// Un parámetro que recibe el mismo literal en todos los call sites deja de
+// ser parámetro: pasa a ser una variable local inicializada con ese valor
+// (la propagación de constantes la reemplaza en el cuerpo) y los calls ya
+// no lo pasan:
+//
+//   int escalar(int x, int k) { ... }      int escalar(int x) { int k = 8; ... }
+//   escalar(a, 8); escalar(b, 8);     ->   escalar(a); escalar(b);
+//
+// Si los call sites pasan literales distintos, una función chica no
+// recursiva se copia una vez por patrón ("escalar.N"), mientras el total de
+// copias (contando la original si algún call no pasa literales) no supere
+// maxSpecializations. Solo parámetros int que el cuerpo nunca asigna.
+
+// Cuerpos de hasta este tamaño se pueden copiar por patrón de argumentos
+static const int SPECIALIZE_SIZE_LIMIT = 150;
+
+// Argumento literal: 5, -5
+static bool argumentLiteral(Expr* expr, int& value) {
+    if (IntLiteral* literal = nodeCast<IntLiteral>(expr)) {
+        value = literal->value;
+        return true;
+    }
+    UnaryOp* unary = nodeCast<UnaryOp>(expr);
+    if (unary && unary->op.type == TokenType::MINUS) {
+        if (IntLiteral* literal = nodeCast<IntLiteral>(unary->operand.get())) {
+            value = -literal->value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool hasFixedArguments(const Optimizer::ArgumentPattern& pattern) {
+    for (auto& argument : pattern) {
+        if (argument.first) return true;
+    }
+    return false;
+}
+
+void Optimizer::removeDeadFunctions(Program* program) {
+    CallGraph graph;
+    buildCallGraph(program, graph);
+
+    // Sin main (un programa incompleto) no se sabe qué es alcanzable
+    FunctionDecl* mainFunc = nullptr;
+    for (FunctionDecl* func : graph.order) {
+        if (func->name == "main") mainFunc = func;
+    }
+    if (!mainFunc) return;
+
+    SymbolSet reachable;
+    reachable.insert(mainFunc->symbol);
+    vector<SymbolId> pending = {mainFunc->symbol};
+    while (!pending.empty()) {
+        SymbolId current = pending.back();
+        pending.pop_back();
+        for (SymbolId target : graph.callees[current]) {
+            if (!reachable.contains(target)) {
+                reachable.insert(target);
+                pending.push_back(target);
+            }
+        }
+    }
+
+    StmtList kept(arena);
+    for (auto& stmt : program->statements) {
+        FunctionDecl* func = nodeCast<FunctionDecl>(stmt.get());
+        if (func && func->body && !reachable.contains(func->symbol)) {
+            cout << "    Removing dead function: " << func->name << endl;
+            removedFunctions++;
+            continue;
+        }
+        kept.push_back(move(stmt));
+    }
+    program->statements = move(kept);
+}
+
+void Optimizer::propagateArguments(Program* program) {
+    CallGraph graph;
+    buildCallGraph(program, graph);
+
+    vector<FunctionDecl*> order = graph.order;
+    for (FunctionDecl* func : order) {
+        vector<CallExpr*>* sites = graph.callSites.find(func->symbol);
+        if (func->name == "main" || !sites || sites->empty()) continue;
+
+        bool wellFormed = true;
+        for (CallExpr* call : *sites) {
+            if (call->arguments.size() != func->parameters.size()) wellFormed = false;
+        }
+        if (!wellFormed) continue;
+
+        // Literales que comparten todos los call sites
+        ArgumentPattern common = argumentPattern(func, (*sites)[0]);
+        for (CallExpr* call : *sites) {
+            ArgumentPattern pattern = argumentPattern(func, call);
+            for (size_t i = 0; i < common.size(); i++) {
+                if (pattern[i] != common[i]) common[i].first = false;
+            }
+        }
+        if (hasFixedArguments(common)) {
+            bindArguments(func, common);
+            for (CallExpr* call : *sites) {
+                dropArguments(call, common);
+            }
+        }
+
+        // Una copia por patrón de literales
+        if (maxSpecializations < 2 || isRecursive(graph, func->symbol) ||
+            countNodes(func->body.get()) > SPECIALIZE_SIZE_LIMIT) {
+            continue;
+        }
+        vector<ArgumentPattern> patterns;
+        vector<vector<CallExpr*>> groups;
+        bool generic = false;
+        for (CallExpr* call : *sites) {
+            ArgumentPattern pattern = argumentPattern(func, call);
+            if (!hasFixedArguments(pattern)) {
+                generic = true;
+                continue;
+            }
+            size_t k = 0;
+            while (k < patterns.size() && patterns[k] != pattern) k++;
+            if (k == patterns.size()) {
+                patterns.push_back(pattern);
+                groups.emplace_back();
+            }
+            groups[k].push_back(call);
+        }
+        int copies = (int)patterns.size() + (generic ? 1 : 0);
+        if (patterns.empty() || copies > maxSpecializations) continue;
+
+        vector<NodePtr<FunctionDecl>> clones;
+        for (size_t k = 0; k < patterns.size(); k++) {
+            clones.push_back(cloneFunction(func));
+            FunctionDecl* clone = clones.back().get();
+            bindArguments(clone, patterns[k]);
+            for (CallExpr* call : groups[k]) {
+                dropArguments(call, patterns[k]);
+                call->functionName = clone->name;
+                call->functionSymbol = clone->symbol;
+            }
+
+            // Los calls de la copia también son call sites de sus callees
+            vector<CallExpr*> calls;
+            collectCalls(clone->body.get(), calls);
+            for (CallExpr* call : calls) {
+                if (graph.functions.contains(call->functionSymbol)) {
+                    graph.callSites[call->functionSymbol].push_back(call);
+                }
+            }
+        }
+
+        // Las copias van justo después de la original
+        StmtList statements(arena);
+        for (auto& stmt : program->statements) {
+            bool original = stmt.get() == func;
+            statements.push_back(move(stmt));
+            if (!original) continue;
+            for (auto& clone : clones) {
+                statements.push_back(StmtPtr(move(clone)));
+            }
+        }
+        program->statements = move(statements);
+    }
+}
+
+Optimizer::ArgumentPattern Optimizer::argumentPattern(FunctionDecl* func, CallExpr* call) {
+    ArgumentPattern pattern;
+    for (size_t i = 0; i < func->parameters.size(); i++) {
+        const Param& param = func->parameters[i];
+        int value = 0;
+        bool fixed = param.type == DataType::INT &&
+                     argumentLiteral(call->arguments[i].get(), value) &&
+                     !assignsVariable(func->body.get(), param.symbol);
+        pattern.push_back({fixed, fixed ? value : 0});
+    }
+    return pattern;
+}
+
+void Optimizer::bindArguments(FunctionDecl* func, const ArgumentPattern& pattern) {
+    ParamList parameters(arena);
+    StmtList statements(arena);
+    for (size_t i = 0; i < pattern.size(); i++) {
+        Param& param = func->parameters[i];
+        if (!pattern[i].first) {
+            parameters.push_back(param);
+            continue;
+        }
+        cout << "    Constant argument: " << func->name << "." << param.name << " = " << pattern[i].second << endl;
+        constantArguments++;
+        statements.push_back(arena->make<VarDecl>(param.type, param.name, param.symbol,
+                                                  arena->make<IntLiteral>(pattern[i].second)));
+    }
+    for (auto& stmt : func->body->statements) {
+        statements.push_back(move(stmt));
+    }
+    func->parameters = move(parameters);
+    func->body->statements = move(statements);
+}
+
+void Optimizer::dropArguments(CallExpr* call, const ArgumentPattern& pattern) {
+    ExprList arguments(arena);
+    for (size_t i = 0; i < pattern.size(); i++) {
+        if (!pattern[i].first) arguments.push_back(move(call->arguments[i]));
+    }
+    call->arguments = move(arguments);
+}
+
+NodePtr<FunctionDecl> Optimizer::cloneFunction(FunctionDecl* func) {
+    // Los SymbolId son por nombre: la copia puede usar los mismos
+    string name = string(func->name) + "." + to_string(++specializedClones);
+    SymbolId symbol = symbols->internCopy(name);
+    cout << "    Specializing function: " << func->name << " as " << symbols->name(symbol) << endl;
+
+    ParamList parameters(arena);
+    for (const Param& param : func->parameters) {
+        parameters.push_back(param);
+    }
+    StmtList statements(arena);
+    for (auto& stmt : func->body->statements) {
+        statements.push_back(cloneStmt(stmt.get()));
+    }
+    return arena->make<FunctionDecl>(func->returnType, symbols->name(symbol), symbol, move(parameters),
+                                     arena->make<Block>(move(statements)));
+}
+
+// ========== RECURSIÓN DE COLA ==========
+//
+//   int gcd(int a, int b) {          int gcd(int a, int b) {
+//       if (b == 0) {                    while (1) {
+//           return a;                        if (b == 0) {
+//       }                         ->             return a;
+//       return gcd(b, a % b);                } else {
+//   }                                            int gcd.a.tail1 = b;
+//                                                int gcd.b.tail1 = a % b;
+//                                                a = gcd.a.tail1;
+//                                                b = gcd.b.tail1;
+//                                            }
+//                                        }
+//                                    }
+//
+// Solo se reescriben los returns que son lo último que ejecuta el cuerpo,
+// y solo si todos los caminos terminan en return (si no, el loop no
+// terminaría donde terminaba la función).
+void Optimizer::eliminateTailRecursion(FunctionDecl* func) {
+    if (!func->body) return;
+
+    vector<CallExpr*> calls;
+    collectCalls(func->body.get(), calls);
+    bool selfCall = false;
+    for (CallExpr* call : calls) {
+        if (call->functionSymbol == func->symbol) selfCall = true;
+    }
+    if (!selfCall) return;
+
+    moveRestIntoElse(func->body.get());
+    if (!alwaysReturns(func->body.get())) return;
+
+    // El cuerpo pasa a ser el del loop
+    StmtPtr body = arena->make<Block>(move(func->body->statements));
+    int rewritten = rewriteTailCalls(body, func);
+    if (rewritten > 0) {
+        StmtList statements(arena);
+        statements.push_back(arena->make<WhileStmt>(arena->make<IntLiteral>(1), move(body)));
+        func->body->statements = move(statements);
+        cout << "    Tail recursion to loop: " << func->name << " (" << rewritten << " calls)" << endl;
+    } else {
+        func->body->statements = move(static_cast<Block*>(body.get())->statements);
+    }
+}
+
+void Optimizer::moveRestIntoElse(Block* block) {
+    StmtList& statements = block->statements;
+    for (size_t i = 0; i < statements.size(); i++) {
+        IfStmt* ifStmt = nodeCast<IfStmt>(statements[i].get());
+        if (!ifStmt) continue;
+
+        if (!ifStmt->elseBranch && i + 1 < statements.size() && alwaysReturns(ifStmt->thenBranch.get())) {
+            StmtList rest(arena);
+            for (size_t j = i + 1; j < statements.size(); j++) {
+                rest.push_back(move(statements[j]));
+            }
+            ifStmt->elseBranch = arena->make<Block>(move(rest));
+
+            StmtList kept(arena);
+            for (size_t j = 0; j <= i; j++) {
+                kept.push_back(move(statements[j]));
+            }
+            block->statements = move(kept);
+        }
+        if (Block* thenBlock = nodeCast<Block>(ifStmt->thenBranch.get())) moveRestIntoElse(thenBlock);
+        if (Block* elseBlock = nodeCast<Block>(ifStmt->elseBranch.get())) moveRestIntoElse(elseBlock);
+    }
+}
+
+bool Optimizer::alwaysReturns(Stmt* stmt) {
+    if (!stmt) return false;
+
+    switch (stmt->kind) {
+        case NodeKind::ReturnStmt:
+            return true;
+        case NodeKind::Block:
+            for (auto& s : static_cast<Block*>(stmt)->statements) {
+                if (alwaysReturns(s.get())) return true;
+            }
+            return false;
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt);
+            return alwaysReturns(ifStmt->thenBranch.get()) && alwaysReturns(ifStmt->elseBranch.get());
+        }
+        default:
+            return false;
     }
-    else if (Block* block = dynamic_cast<Block*>(stmt)) {
-        // Recorrer recursivamente el bloque
-        for (auto& s : block->statements) {
-            getReadVariablesInStmt(s.get(), variables);
+}
+
+int Optimizer::rewriteTailCalls(StmtPtr& stmt, FunctionDecl* func) {
+    switch (stmt->kind) {
+        case NodeKind::Block: {
+            // La cola es el primer statement que siempre retorna: lo que
+            // sigue nunca se ejecuta y se descarta
+            Block* block = static_cast<Block*>(stmt.get());
+            for (size_t i = 0; i < block->statements.size(); i++) {
+                if (!alwaysReturns(block->statements[i].get())) continue;
+
+                StmtList kept(arena);
+                for (size_t j = 0; j <= i; j++) {
+                    kept.push_back(move(block->statements[j]));
+                }
+                block->statements = move(kept);
+                return rewriteTailCalls(block->statements[i], func);
+            }
+            return 0;
         }
+
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt.get());
+            int count = rewriteTailCalls(ifStmt->thenBranch, func);
+            if (ifStmt->elseBranch) count += rewriteTailCalls(ifStmt->elseBranch, func);
+            return count;
+        }
+
+        case NodeKind::ReturnStmt: {
+            CallExpr* call = nodeCast<CallExpr>(static_cast<ReturnStmt*>(stmt.get())->value.get());
+            if (!call || call->functionSymbol != func->symbol ||
+                call->arguments.size() != func->parameters.size()) {
+                return 0;
+            }
+
+            // Si ningún argumento lee un parámetro ya reasignado, se asignan
+            // directo; si no, primero todos a temporales
+            size_t count = func->parameters.size();
+            bool direct = true;
+            for (size_t i = 1; i < count; i++) {
+                liveVars.clear();
+                getReadVariables(call->arguments[i].get(), liveVars);
+                for (size_t j = 0; j < i; j++) {
+                    if (liveVars.contains(func->parameters[j].symbol)) direct = false;
+                }
+            }
+
+            StmtList assignments(arena);
+            vector<pair<SymbolId, string_view>> temps;
+            for (size_t i = 0; i < count; i++) {
+                const Param& param = func->parameters[i];
+                if (direct) {
+                    // f(a, b - 1) en f(a, b): a no cambia
+                    Variable* same = nodeCast<Variable>(call->arguments[i].get());
+                    if (same && same->symbol == param.symbol) continue;
+                    assignments.push_back(arena->make<AssignStmt>(param.name, param.symbol, move(call->arguments[i])));
+                    continue;
+                }
+                string name = string(func->name) + "." + string(param.name) + ".tail" +
+                              to_string(tailRecursiveCalls + 1);
+                SymbolId symbol = symbols->internCopy(name);
+                temps.push_back({symbol, symbols->name(symbol)});
+                assignments.push_back(arena->make<VarDecl>(param.type, temps.back().second, symbol,
+                                                           move(call->arguments[i])));
+            }
+            for (size_t i = 0; i < temps.size(); i++) {
+                const Param& param = func->parameters[i];
+                assignments.push_back(arena->make<AssignStmt>(param.name, param.symbol,
+                                                              arena->make<Variable>(temps[i].second, temps[i].first)));
+            }
+            stmt = arena->make<Block>(move(assignments));
+            tailRecursiveCalls++;
+            return 1;
+        }
+
+        default:
+            return 0;
     }
-}
\ No newline at end of file
+}
+
+// ========== ELIMINACIÓN DE CÓDIGO MUERTO ==========
+// Sacar una escritura puede dejar muerta a la que calculaba su valor
+// (t = a * b; x = t; con x muerta), así que se repite hasta que una pasada
+// no saca nada. Al final se van las locales que ya nadie usa, y con ellas
+// su registro o su lugar en el stack frame.
+void Optimizer::eliminateDeadCode(FunctionDecl* func) {
+    do {
+        removedDeadCode = false;
+        liveness.analyze(func, globalSymbols);
+        removeDeadCodeInBlock(func->body.get());
+    } while (removedDeadCode);
+    liveness.clear();
+}
+
+void Optimizer::removeDeadCodeInBlock(Block* block) {
+    StmtList alive(arena);
+    for (auto& stmt : block->statements) {
+        removeDeadCode(stmt);
+        if (stmt) alive.push_back(move(stmt));
+    }
+    block->statements = move(alive);
+}
+
+// Rama de un if o cuerpo de un loop: si se vacía queda un bloque vacío
+void Optimizer::removeDeadCodeInBranch(StmtPtr& branch) {
+    if (!branch) return;
+    removeDeadCode(branch);
+    if (!branch) branch = arena->make<Block>(StmtList(arena));
+}
+
+static bool isEmptyBranch(Stmt* stmt) {
+    Block* block = stmt ? nodeCast<Block>(stmt) : nullptr;
+    return !stmt || (block && block->statements.empty());
+}
+
+void Optimizer::removeDeadCode(StmtPtr& stmt) {
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt.get());
+            bool pure = !hasSideEffects(varDecl->initializer.get());
+            for (auto& element : varDecl->arrayInitializer) {
+                pure = pure && !hasSideEffects(element.get());
+            }
+            if (!pure) break;
+
+            // Nadie la lee ni la escribe: fuera la declaración
+            if (!liveness.isReferenced(varDecl->symbol)) {
+                cout << "    Removed unused variable: " << varDecl->name << endl;
+                unusedLocals++;
+                removedDeadCode = true;
+                stmt = nullptr;
+            } else if (varDecl->initializer && liveness.isDeadStore(varDecl)) {
+                // No podemos eliminar la declaración, pero sí el inicializador
+                cout << "    Dead initialization: " << varDecl->name << endl;
+                deadStores++;
+                removedDeadCode = true;
+                varDecl->initializer = nullptr;
+            }
+            break;
+        }
+
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt.get());
+            if (!liveness.isDeadStore(assign)) break;
+
+            // Los calls del valor se siguen ejecutando (en un array, con
+            // los de los índices, se deja el store entero)
+            bool pure = !hasSideEffects(assign->value.get());
+            for (auto& index : assign->indices) {
+                if (hasSideEffects(index.get())) pure = false;
+            }
+            if (!pure && assign->isArrayAssign) break;
+
+            cout << "    Dead store eliminated: " << assign->varName << endl;
+            deadStores++;
+            removedDeadCode = true;
+            stmt = pure ? nullptr : arena->make<ExprStmt>(move(assign->value));
+            break;
+        }
+
+        case NodeKind::ExprStmt: {
+            // Valor descartado y sin efectos: x + 1;
+            ExprStmt* exprStmt = static_cast<ExprStmt*>(stmt.get());
+            if (hasSideEffects(exprStmt->expression.get())) break;
+            cout << "    Removed dead expression" << endl;
+            deadExpressions++;
+            removedDeadCode = true;
+            stmt = nullptr;
+            break;
+        }
+
+        case NodeKind::Block: {
+            Block* block = static_cast<Block*>(stmt.get());
+            removeDeadCodeInBlock(block);
+            if (block->statements.empty()) stmt = nullptr;
+            break;
+        }
+
+        case NodeKind::IfStmt: {
+            IfStmt* ifStmt = static_cast<IfStmt*>(stmt.get());
+            removeDeadCodeInBranch(ifStmt->thenBranch);
+            removeDeadCodeInBranch(ifStmt->elseBranch);
+            if (isEmptyBranch(ifStmt->elseBranch.get())) ifStmt->elseBranch = nullptr;
+            // if (c) {} sin efectos en c
+            if (isEmptyBranch(ifStmt->thenBranch.get()) && !ifStmt->elseBranch &&
+                !hasSideEffects(ifStmt->condition.get())) {
+                cout << "    Removed empty if" << endl;
+                deadExpressions++;
+                removedDeadCode = true;
+                stmt = nullptr;
+            }
+            break;
+        }
+
+        case NodeKind::WhileStmt:
+            removeDeadCodeInBranch(static_cast<WhileStmt*>(stmt.get())->body);
+            break;
+
+        case NodeKind::ForStmt: {
+            ForStmt* forStmt = static_cast<ForStmt*>(stmt.get());
+            if (forStmt->initializer) removeDeadCode(forStmt->initializer);
+            removeDeadCodeInBranch(forStmt->body);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Helper: ¿La expresión llama a una función o asigna algo?
+bool Optimizer::hasSideEffects(Expr* expr) {
+    if (!expr) return false;
+
+    switch (expr->kind) {
+        case NodeKind::CallExpr:
+        case NodeKind::AssignExpr:
+            return true;
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            return hasSideEffects(binOp->left.get()) || hasSideEffects(binOp->right.get());
+        }
+        case NodeKind::UnaryOp:
+            return hasSideEffects(static_cast<UnaryOp*>(expr)->operand.get());
+        case NodeKind::CastExpr:
+            return hasSideEffects(static_cast<CastExpr*>(expr)->expr.get());
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* arrAccess = static_cast<ArrayAccess*>(expr);
+            for (auto& index : arrAccess->indices) {
+                if (hasSideEffects(index.get())) return true;
+            }
+            return false;
+        }
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            return hasSideEffects(ternary->condition.get()) || hasSideEffects(ternary->exprTrue.get()) ||
+                   hasSideEffects(ternary->exprFalse.get());
+        }
+        default:
+            return false;
+    }
+}
+
+// Helper: Obtiene variables leídas en una expresión
+void Optimizer::getReadVariables(Expr* expr, SymbolSet& variables) {
+    if (!expr) return;
+    
+    switch (expr->kind) {
+        case NodeKind::Variable: {
+            Variable* var = static_cast<Variable*>(expr);
+            variables.insert(var->symbol);
+            break;
+        }
+        case NodeKind::BinaryOp: {
+            BinaryOp* binOp = static_cast<BinaryOp*>(expr);
+            getReadVariables(binOp->left.get(), variables);
+            getReadVariables(binOp->right.get(), variables);
+            break;
+        }
+        case NodeKind::UnaryOp: {
+            UnaryOp* unOp = static_cast<UnaryOp*>(expr);
+            getReadVariables(unOp->operand.get(), variables);
+            break;
+        }
+        case NodeKind::CallExpr: {
+            CallExpr* call = static_cast<CallExpr*>(expr);
+            for (auto& arg : call->arguments) {
+                getReadVariables(arg.get(), variables);
+            }
+            break;
+        }
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* arrAccess = static_cast<ArrayAccess*>(expr);
+            variables.insert(arrAccess->arraySymbol);
+            for (auto& index : arrAccess->indices) {
+                getReadVariables(index.get(), variables);
+            }
+            break;
+        }
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            getReadVariables(ternary->condition.get(), variables);
+            getReadVariables(ternary->exprTrue.get(), variables);
+            getReadVariables(ternary->exprFalse.get(), variables);
+            break;
+        }
+        case NodeKind::CastExpr: {
+            CastExpr* cast = static_cast<CastExpr*>(expr);
+            getReadVariables(cast->expr.get(), variables);
+            break;
+        }
+        case NodeKind::AssignExpr: {
+            AssignExpr* assignExpr = static_cast<AssignExpr*>(expr);
+            // En una asignación como expresión, solo leemos las variables del lado derecho
+            getReadVariables(assignExpr->value.get(), variables);
+            // También leemos los índices si es array
+            for (auto& index : assignExpr->indices) {
+                getReadVariables(index.get(), variables);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
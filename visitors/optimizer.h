@@ -6,9 +6,13 @@
 #define PROYECTO_OPTIMIZER_H
 
 #include "../parser/ast.h"
-#include <map>
+#include "gvn.h"
+#include "licm.h"
+#include "liveness.h"
+#include "sccp.h"
 #include <memory>
-#include <set>
+#include <string>
+#include <vector>
 
 using namespace std;
 
@@ -20,29 +24,148 @@ public:
 
     // Método principal: optimiza todo el programa
     // Recibe un puntero al programa (AST completo)
-    map<string, int> constantValues;
     void optimize(Program* program);
 
+    // Desenrollado parcial: factor máximo (--unroll=N, 1 = solo el completo)
+    int maxUnrollFactor = 4;
+
+    // Decisión tomada para cada for (--unroll-report)
+    vector<string> unrollReport;
+
+    // Inlining: tamaño máximo del cuerpo (--inline-size=N, 0 = sin inlining)
+    // y call sites hasta los que se copia un cuerpo más caro que el call
+    // (--inline-sites=N)
+    int inlineSizeThreshold = 40;
+    int inlineCallSites = 3;
+    int inlinedCalls = 0;
+    int inlinedFunctions = 0;
+
+    // return f(...) dentro de f reemplazados por un loop
+    int tailRecursiveCalls = 0;
+
+    // Propagación de constantes: expresiones reemplazadas por su valor y
+    // statements que nunca se ejecutan
+    int constantsPropagated = 0;
+    int unreachableStatements = 0;
+
+    // Subexpresiones comunes: apariciones que leen un valor ya calculado y
+    // variables nuevas que lo guardan
+    int reusedExpressions = 0;
+    int valueTemporaries = 0;
+
+    // Código invariante: expresiones calculadas una vez antes de su loop e
+    // índices m[r][j] partidos en una fila invariante + columna
+    int hoistedExpressions = 0;
+    int splitIndices = 0;
+
+    // Código muerto: escrituras que nadie lee, expresiones sin efectos
+    // cuyo valor se descarta y locales sin usos
+    int deadStores = 0;
+    int deadExpressions = 0;
+    int unusedLocals = 0;
+
+    // Propagación entre funciones: copias por patrón de argumentos
+    // literales (--specialize=N, contando la original; < 2 = sin copias)
+    int maxSpecializations = 2;
+    int constantArguments = 0;
+    int specializedClones = 0;
+    int removedFunctions = 0;
+
+    // Argumento i: (¿literal en el call?, valor)
+    typedef vector<pair<bool, int>> ArgumentPattern;
+
 private:
+    // Arena del programa: los nodos nuevos se crean ahí
+    Arena* arena;
+
+    // Nombres del programa (para las copias de las variables al inlinear)
+    SymbolTable* symbols;
+
+    // Variables leídas por los argumentos de un call (recursión de cola)
+    SymbolSet liveVars;
+
+    // Variables vivas de la función que se está limpiando (ver liveness.h)
+    LivenessAnalysis liveness;
+    bool removedDeadCode = false;
+
+    // Variables globales: se pueden leer después del return
+    SymbolSet globalSymbols;
+
+    // Función que se está optimizando (para el reporte de desenrollado)
+    string_view currentFunction;
+
+    // Constantes de la función que se está optimizando (ver sccp.h)
+    ConstantPropagation propagation;
+
+    // Subexpresiones comunes de la función (ver gvn.h)
+    ValueNumbering valueNumbering;
+
+    // Código invariante de los loops de la función (ver licm.h)
+    LoopInvariantMotion invariantMotion;
+
+    // Segunda vuelta sobre una función: sin desenrollar otra vez los loops
+    bool transformLoops = true;
+
+    // Desenrollado completo: el contador vale unrollValue en la copia
+    SymbolId unrollCounter = NO_SYMBOL;
+    int unrollValue = 0;
+
+    // Al clonar, el contador del loop se reemplaza por contador + offset
+    SymbolId cloneCounter = NO_SYMBOL;
+    int cloneCounterOffset = 0;
+
+    // Inlining: funciones que se pueden copiar en sus call sites y
+    // variables del callee -> variables de la copia que se está clonando
+    SymbolMap<FunctionDecl*> inlineCandidates;
+    SymbolMap<SymbolId> inlineRenames;
+    string_view inlineCallee;
+    int inlineCopy = 0;
+    bool inliningClone = false;
+
     // ========== MÉTODOS PRIVADOS (solo para uso interno) ==========
     // Intenta desenrollar un for-loop si cumple ciertas condiciones
-    unique_ptr<Stmt> tryUnrollLoop(ForStmt* forStmt);
+    StmtPtr tryUnrollLoop(ForStmt* forStmt);
 
     // Clona un statement (necesario para duplicar el cuerpo del loop)
-    unique_ptr<Stmt> cloneStmt(Stmt* stmt);
+    StmtPtr cloneStmt(Stmt* stmt);
 
     // Clona una expresión
-    unique_ptr<Expr> cloneExpr(Expr* expr);
+    ExprPtr cloneExpr(Expr* expr);
     // Intenta desenrollar un for-loop si cumple ciertas condiciones
     // Retorna true si fue desenrollado, y agrega los statements a output
-    bool tryUnrollLoop(ForStmt* forStmt, vector<unique_ptr<Stmt>>& output);
+    bool tryUnrollLoop(ForStmt* forStmt, StmtList& output);
+
+    // Desenrollado parcial con loop de resto, para loops con límite en
+    // runtime o demasiadas iteraciones para el desenrollado completo
+    bool tryPartialUnroll(ForStmt* forStmt, StmtList& output);
+
+    // Modelo de costo: factor según el tamaño del cuerpo (y las iteraciones
+    // si se conocen, -1 si no)
+    int chooseUnrollFactor(int bodySize, int knownTrips);
+
+    // Nodos del AST de un statement / expresión (tamaño del cuerpo)
+    int countNodes(Stmt* stmt);
+    int countNodes(Expr* expr);
+
+    // ¿El statement / expresión asigna o declara la variable?
+    bool assignsVariable(Stmt* stmt, SymbolId symbol);
+    bool assignsVariable(Expr* expr, SymbolId symbol);
+
+    void reportUnroll(string_view counter, const string& decision);
     // Intenta optimizar una expresión binaria (2 + 3, x * 4, etc.)
     // Devuelve un nuevo nodo optimizado (o el mismo si no se puede optimizar)
-    unique_ptr<Expr> optimizeBinaryOp(BinaryOp* node);
+    ExprPtr optimizeBinaryOp(BinaryOp* node);
+
+    // Literal con el valor que la propagación de constantes conoce para la
+    // expresión (nullptr si no se conoce)
+    ExprPtr propagatedLiteral(Expr* expr);
+
+    // Literal entero, o expresión con valor int conocido
+    bool knownInt(Expr* expr, int& value);
 
     // Optimiza cualquier tipo de expresión recursivamente
     // Devuelve la versión optimizada de la expresión
-    unique_ptr<Expr> optimizeExpr(Expr* expr);
+    ExprPtr optimizeExpr(Expr* expr);
 
     // Optimiza un statement (VarDecl, AssignStmt, IfStmt, etc.)
     void optimizeStmt(Stmt* stmt);
@@ -50,15 +173,93 @@ private:
     // Optimiza un bloque de código (lista de statements)
     void optimizeBlock(Block* block);
 
-    // ========== DEAD STORE ELIMINATION ==========
-    // Elimina escrituras muertas (variables que se sobrescriben sin leerse)
-    void eliminateDeadStores(Block* block);
-    
+    // ========== GRAFO DE LLAMADAS ==========
+    struct CallGraph {
+        vector<FunctionDecl*> order;              // Funciones con cuerpo, en orden
+        SymbolMap<FunctionDecl*> functions;
+        SymbolMap<vector<SymbolId>> callees;      // f -> funciones que llama
+        SymbolMap<vector<CallExpr*>> callSites;   // f -> calls a f
+    };
+    void buildCallGraph(Program* program, CallGraph& graph);
+    bool isRecursive(CallGraph& graph, SymbolId function);
+
+    // ========== INLINING ==========
+    // Copia los cuerpos de funciones chicas en sus call sites
+    void inlineFunctions(Program* program);
+
+    // ¿El cuerpo tiene la forma que sabemos copiar? (un solo return, al final)
+    bool canInline(FunctionDecl* func);
+
+    // Calls de un statement / expresión
+    void collectCalls(Stmt* stmt, vector<CallExpr*>& calls);
+    void collectCalls(Expr* expr, vector<CallExpr*>& calls);
+
+    void inlineCallsInBlock(Block* block);
+    void inlineCallsInBranch(StmtPtr& branch);
+    void inlineCallsInStmt(StmtPtr stmt, StmtList& output);
+
+    // Call inlineable más externo de la expresión (nullptr si no hay)
+    ExprPtr* findInlineCall(ExprPtr& expr);
+
+    // ¿Algo fuera de `call` depende del orden de evaluación? (otros calls,
+    // asignaciones o globales, que el callee podría leer o escribir)
+    bool dependsOnOrder(Expr* expr, Expr* call, bool& seen);
+
+    // Copia el callee antes de `stmt` y reemplaza el call por su resultado
+    void expandCall(ExprPtr* slot, StmtPtr& stmt, StmtList& output);
+
+    // Variable de la copia: "multiplicar.a.1"
+    SymbolId inlineLocal(SymbolId symbol, string_view name);
+    void renameSymbol(SymbolId& symbol, string_view& name);
+
+    // ========== PROPAGACIÓN ENTRE FUNCIONES ==========
+    // Borra las funciones que no se alcanzan desde main
+    void removeDeadFunctions(Program* program);
+
+    // Literales comunes a todos los call sites y copias por patrón
+    void propagateArguments(Program* program);
+
+    ArgumentPattern argumentPattern(FunctionDecl* func, CallExpr* call);
+
+    // Los parámetros fijos pasan a ser locales con su valor / salen del call
+    void bindArguments(FunctionDecl* func, const ArgumentPattern& pattern);
+    void dropArguments(CallExpr* call, const ArgumentPattern& pattern);
+
+    // Copia "f.N" de la función (con los mismos parámetros)
+    NodePtr<FunctionDecl> cloneFunction(FunctionDecl* func);
+
+    // ========== RECURSIÓN DE COLA ==========
+    // f con "return f(args)" pasa a ser while (1) { cuerpo } y esos returns
+    // reasignan los parámetros (después del resto de los pases: la
+    // eliminación de escrituras muertas no ve el loop)
+    void eliminateTailRecursion(FunctionDecl* func);
+
+    // if (c) { ...; return x; } resto  ->  if (c) { ...; return x; } else { resto }
+    void moveRestIntoElse(Block* block);
+
+    // ¿Todos los caminos del statement terminan en return?
+    bool alwaysReturns(Stmt* stmt);
+
+    // Reemplaza los return f(args) en posición de cola (devuelve cuántos)
+    int rewriteTailCalls(StmtPtr& stmt, FunctionDecl* func);
+
+    // ========== ELIMINACIÓN DE CÓDIGO MUERTO ==========
+    // Con las variables vivas de toda la función (ver liveness.h) saca las
+    // escrituras que nadie lee, las expresiones sin efectos cuyo valor se
+    // descarta y las locales que no se usan
+    void eliminateDeadCode(FunctionDecl* func);
+    void removeDeadCodeInBlock(Block* block);
+    void removeDeadCodeInBranch(StmtPtr& branch);
+
+    // Deja stmt en nullptr si hay que sacarlo
+    void removeDeadCode(StmtPtr& stmt);
+
     // Helper: Obtiene todas las variables leídas en una expresión
-    void getReadVariables(Expr* expr, set<string>& variables);
-    
-    // Helper: Obtiene todas las variables leídas en un statement
-    void getReadVariablesInStmt(Stmt* stmt, set<string>& variables);
+    void getReadVariables(Expr* expr, SymbolSet& variables);
+
+    // Helper: ¿La expresión llama a una función o asigna algo? (entonces
+    // hay que evaluarla aunque su valor no se use)
+    bool hasSideEffects(Expr* expr);
 
     // ========== HELPER FUNCTIONS ==========
 
@@ -68,6 +269,7 @@ private:
 
     // Aplica constant folding a dos enteros con un operador
     // Ejemplo: calcular(2, TokenType::PLUS, 3) = 5
-    int calculate(int left, TokenType op, int right);
+    // false si no se puede plegar (división por cero, operador desconocido)
+    bool calculate(int left, TokenType op, int right, int& result);
 };
 #endif //PROYECTO_OPTIMIZER_H
\ No newline at end of file
@@ -0,0 +1,772 @@
+#include "peephole.h"
+#include <unordered_set>
+#include <climits>
+
+// Orden de aplicación en cada posición
+const PeepholeOptimizer::Pattern PeepholeOptimizer::patterns[] = {
+    {"jmp-next",         &PeepholeOptimizer::jumpToNext},
+    {"unreachable",      &PeepholeOptimizer::unreachable},
+    {"push-immediate",   &PeepholeOptimizer::pushImmediate},
+    {"push-pop",         &PeepholeOptimizer::pushPop},
+    {"self-move",        &PeepholeOptimizer::selfMove},
+    {"store-load",       &PeepholeOptimizer::storeLoad},
+    {"load-store",       &PeepholeOptimizer::loadStore},
+    {"load-extend",      &PeepholeOptimizer::loadExtend},
+    {"copy-propagation", &PeepholeOptimizer::copyPropagation},
+    {"store-immediate",  &PeepholeOptimizer::storeImmediate},
+    {"immediate-operand", &PeepholeOptimizer::immediateOperand},
+    {"setcc-branch",     &PeepholeOptimizer::setccBranch},
+};
+
+PeepholeOptimizer::PeepholeOptimizer() {
+    for (const Pattern& pattern : patterns) {
+        PatternStats stats;
+        stats.name = pattern.name;
+        patternStats.push_back(stats);
+    }
+}
+
+int PeepholeOptimizer::totalRemoved() const {
+    int total = 0;
+    for (const PatternStats& stats : patternStats) total += stats.removed;
+    return total;
+}
+
+// ========== REGISTROS Y OPERANDOS ==========
+
+static const int RAX = 0, RSP = 4;
+
+struct RegName {
+    int family;     // 0-15: rax..r15, 16-31: xmm0..xmm15
+    int width;      // 8, 16, 32, 64 (128 para xmm)
+};
+
+static const unordered_map<string, RegName>& registerTable() {
+    static unordered_map<string, RegName> table;
+    if (table.empty()) {
+        const char* legacy[8][4] = {
+            {"rax", "eax", "ax", "al"}, {"rcx", "ecx", "cx", "cl"},
+            {"rdx", "edx", "dx", "dl"}, {"rbx", "ebx", "bx", "bl"},
+            {"rsp", "esp", "sp", "spl"}, {"rbp", "ebp", "bp", "bpl"},
+            {"rsi", "esi", "si", "sil"}, {"rdi", "edi", "di", "dil"}
+        };
+        for (int family = 0; family < 8; family++) {
+            table[legacy[family][0]] = {family, 64};
+            table[legacy[family][1]] = {family, 32};
+            table[legacy[family][2]] = {family, 16};
+            table[legacy[family][3]] = {family, 8};
+        }
+        table["ah"] = {0, 8};
+        table["ch"] = {1, 8};
+        table["dh"] = {2, 8};
+        table["bh"] = {3, 8};
+        for (int n = 8; n < 16; n++) {
+            string name = "r" + to_string(n);
+            table[name] = {n, 64};
+            table[name + "d"] = {n, 32};
+            table[name + "w"] = {n, 16};
+            table[name + "b"] = {n, 8};
+        }
+        for (int n = 0; n < 16; n++) {
+            table["xmm" + to_string(n)] = {16 + n, 128};
+        }
+    }
+    return table;
+}
+
+static bool parseRegister(const string& operand, RegName& reg) {
+    const auto& table = registerTable();
+    auto it = table.find(operand);
+    if (it == table.end()) return false;
+    reg = it->second;
+    return true;
+}
+
+static bool isGPR(const string& operand, RegName& reg) {
+    return parseRegister(operand, reg) && reg.family < 16;
+}
+
+// Nombre de un registro de propósito general con otro ancho (32 o 64)
+static string registerName(int family, int width) {
+    static const char* legacy[8][2] = {
+        {"rax", "eax"}, {"rcx", "ecx"}, {"rdx", "edx"}, {"rbx", "ebx"},
+        {"rsp", "esp"}, {"rbp", "ebp"}, {"rsi", "esi"}, {"rdi", "edi"}
+    };
+    if (family < 8) return legacy[family][width == 64 ? 0 : 1];
+    return "r" + to_string(family) + (width == 64 ? "" : "d");
+}
+
+static bool isMemory(const string& operand) {
+    return operand.find('[') != string::npos;
+}
+
+static bool isImmediate(const string& operand) {
+    size_t start = operand[0] == '-' ? 1 : 0;
+    return start < operand.size() && isdigit((unsigned char)operand[start]);
+}
+
+// "dword [rbp - 8]" -> "[rbp - 8]"
+static string stripSize(const string& operand) {
+    size_t bracket = operand.find('[');
+    return bracket == string::npos ? operand : operand.substr(bracket);
+}
+
+// Registros que aparecen en un operando (los de una dirección se leen)
+static uint32_t registersIn(const string& operand) {
+    RegName reg;
+    if (!isMemory(operand)) {
+        return parseRegister(operand, reg) ? 1u << reg.family : 0;
+    }
+    uint32_t mask = 0;
+    string word;
+    for (char c : stripSize(operand) + " ") {
+        if (isalnum((unsigned char)c)) {
+            word += c;
+        } else {
+            if (!word.empty() && parseRegister(word, reg)) mask |= 1u << reg.family;
+            word.clear();
+        }
+    }
+    return mask;
+}
+
+static bool isJump(const string& mnemonic) {
+    return !mnemonic.empty() && mnemonic[0] == 'j';
+}
+
+static uint32_t familyMask(initializer_list<int> families) {
+    uint32_t mask = 0;
+    for (int family : families) mask |= 1u << family;
+    return mask;
+}
+
+// ========== PARSEO ==========
+
+static string trim(const string& text) {
+    size_t start = text.find_first_not_of(" \t");
+    if (start == string::npos) return "";
+    size_t end = text.find_last_not_of(" \t");
+    return text.substr(start, end - start + 1);
+}
+
+void PeepholeOptimizer::parse(const string& text) {
+    code.clear();
+    labelIndex.clear();
+
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == string::npos) end = text.size();
+        string line = text.substr(start, end - start);
+        start = end + 1;
+
+        AsmInstr instr;
+        string body = trim(line);
+        if (!body.empty() && body.back() == ':' && body.find(' ') == string::npos) {
+            instr.label = body.substr(0, body.size() - 1);
+            labelIndex[instr.label] = code.size();
+        } else if (body.empty() || body[0] == ';' || body.rfind("extern", 0) == 0 ||
+                   body.rfind("global", 0) == 0 || body.rfind("section", 0) == 0 ||
+                   body.rfind("align", 0) == 0 ||
+                   body.find(';') != string::npos) {
+            instr.text = line;
+        } else {
+            size_t space = body.find(' ');
+            instr.mnemonic = body.substr(0, space);
+            if (space != string::npos) {
+                // Separar por comas fuera de los corchetes
+                string operand;
+                int depth = 0;
+                for (char c : body.substr(space + 1)) {
+                    if (c == '[') depth++;
+                    if (c == ']') depth--;
+                    if (c == ',' && depth == 0) {
+                        instr.operands.push_back(trim(operand));
+                        operand.clear();
+                    } else {
+                        operand += c;
+                    }
+                }
+                instr.operands.push_back(trim(operand));
+            }
+        }
+        code.push_back(instr);
+    }
+}
+
+string PeepholeOptimizer::render() const {
+    string result;
+    for (const AsmInstr& instr : code) {
+        if (instr.deleted) continue;
+        if (!instr.label.empty()) {
+            result += instr.label + ":\n";
+        } else if (!instr.mnemonic.empty()) {
+            result += "    " + instr.mnemonic;
+            for (size_t i = 0; i < instr.operands.size(); i++) {
+                result += (i ? ", " : " ") + instr.operands[i];
+            }
+            result += "\n";
+        } else {
+            result += instr.text + "\n";
+        }
+    }
+    return result;
+}
+
+// ========== NAVEGACIÓN Y VIDA DE REGISTROS ==========
+
+// Líneas que no cambian nada para el análisis: vacías y "align N"
+static bool isBlank(const string& text) {
+    size_t start = text.find_first_not_of(" \t");
+    return start == string::npos || text.compare(start, 6, "align ") == 0;
+}
+
+size_t PeepholeOptimizer::nextEntry(size_t i) const {
+    size_t j = i + 1;
+    while (j < code.size() &&
+           (code[j].deleted || (code[j].label.empty() && code[j].mnemonic.empty() && isBlank(code[j].text)))) {
+        j++;
+    }
+    return j;
+}
+
+size_t PeepholeOptimizer::nextInstr(size_t i) const {
+    size_t j = nextEntry(i);
+    return j < code.size() && code[j].isInstr() ? j : code.size();
+}
+
+PeepholeOptimizer::Effects PeepholeOptimizer::effectsOf(const AsmInstr& instr) const {
+    Effects effects;
+    const string& m = instr.mnemonic;
+    const vector<string>& ops = instr.operands;
+
+    auto read = [&](const string& operand) { effects.reads |= registersIn(operand); };
+    auto write = [&](const string& operand) {
+        if (isMemory(operand)) {
+            read(operand);
+            return;
+        }
+        RegName reg;
+        if (!parseRegister(operand, reg)) return;
+        uint32_t bit = 1u << reg.family;
+        effects.modifies |= bit;
+        // 32 bits extiende con ceros; 8/16 bits y xmm conservan el resto
+        if (reg.width == 32 || reg.width == 64) {
+            effects.kills |= bit;
+        } else {
+            effects.reads |= bit;
+        }
+    };
+    auto clobber = [&](uint32_t mask) {
+        effects.kills |= mask;
+        effects.modifies |= mask;
+    };
+    const uint32_t stack = 1u << RSP;
+
+    if ((m == "mov" || m == "movsx" || m == "movsxd" || m == "movzx" || m == "lea" ||
+         m == "cvttss2si" || m == "cvtss2si" || m == "movss" || m == "movsd" ||
+         m == "cvtsi2ss" || m == "cvtss2sd" || m == "cvtsi2sd" || m == "movd" || m == "movq" ||
+         m == "movaps") &&
+        ops.size() == 2) {
+        read(ops[1]);
+        write(ops[0]);
+    } else if (m.rfind("set", 0) == 0 && ops.size() == 1) {
+        write(ops[0]);
+    } else if (m == "push" && ops.size() == 1) {
+        read(ops[0]);
+        effects.reads |= stack;
+        effects.modifies |= stack;
+    } else if (m == "pop" && ops.size() == 1) {
+        write(ops[0]);
+        effects.reads |= stack;
+        effects.modifies |= stack;
+    } else if (m == "cmp" || m == "test" || m == "ucomiss" || m == "comiss" || m == "bt") {
+        for (const string& op : ops) read(op);
+    } else if ((m == "xor" || m == "sub") && ops.size() == 2 && ops[0] == ops[1] && !isMemory(ops[0])) {
+        write(ops[0]);  // xor eax, eax: no depende del valor anterior
+    } else if ((m == "add" || m == "sub" || m == "and" || m == "or" || m == "xor" ||
+                m == "adc" || m == "sbb" || m == "shl" || m == "shr" || m == "sar" ||
+                m == "addss" || m == "subss" || m == "mulss" || m == "divss" ||
+                m == "xorps" || m == "andps" || m == "orps" || m == "sqrtss" ||
+                (m == "imul" && ops.size() == 2)) && ops.size() == 2) {
+        read(ops[0]);
+        read(ops[1]);
+        write(ops[0]);
+    } else if (m == "imul" && ops.size() == 3) {
+        read(ops[1]);
+        write(ops[0]);
+    } else if ((m == "neg" || m == "not" || m == "inc" || m == "dec") && ops.size() == 1) {
+        read(ops[0]);
+        write(ops[0]);
+    } else if (m == "cdq" || m == "cqo") {
+        effects.reads |= 1u << RAX;
+        clobber(familyMask({2}));
+    } else if (m == "cdqe") {
+        effects.reads |= 1u << RAX;
+        clobber(1u << RAX);
+    } else if ((m == "idiv" || m == "div" || m == "mul" || m == "imul") && ops.size() == 1) {
+        read(ops[0]);
+        effects.reads |= familyMask({0, 2});
+        clobber(familyMask({0, 2}));
+    } else if (m == "call") {
+        // Argumentos (rax = cantidad de xmm en varargs) y registros caller-saved
+        effects.reads |= familyMask({0, 1, 2, 4, 6, 7, 8, 9}) | 0xff0000u;
+        clobber(familyMask({0, 1, 2, 6, 7, 8, 9, 10, 11}) | 0xffff0000u);
+    } else if (m == "ret") {
+        // Valor de retorno y callee-saved
+        effects.reads |= familyMask({0, 2, 3, 4, 5, 12, 13, 14, 15, 16, 17});
+    } else if (isJump(m)) {
+        // Solo flags
+    } else {
+        // Instrucción desconocida: puede leer y escribir cualquier cosa
+        effects.reads = effects.modifies = 0xffffffffu;
+    }
+    return effects;
+}
+
+// Sigue todos los caminos desde start (incluidos los saltos a etiquetas
+// del trozo) hasta encontrar una lectura (vivo) o una escritura completa
+bool PeepholeOptimizer::isDeadFrom(size_t start, int family) const {
+    uint32_t bit = 1u << family;
+    vector<size_t> worklist = {start};
+    unordered_set<size_t> seenLabels;
+    int steps = 0;
+
+    while (!worklist.empty()) {
+        size_t p = worklist.back();
+        worklist.pop_back();
+        for (;; p++) {
+            if (p >= code.size()) return false;  // Sale del trozo: no se sabe
+            const AsmInstr& instr = code[p];
+            if (instr.deleted) continue;
+            if (!instr.label.empty()) {
+                if (!seenLabels.insert(p).second) break;
+                continue;
+            }
+            if (instr.mnemonic.empty()) {
+                if (isBlank(instr.text)) continue;
+                return false;
+            }
+            if (++steps > 1000) return false;
+
+            Effects effects = effectsOf(instr);
+            if (effects.reads & bit) return false;
+            if (effects.kills & bit) break;
+            if (instr.mnemonic == "ret") break;
+            if (isJump(instr.mnemonic)) {
+                auto target = labelIndex.find(instr.operands.empty() ? "" : instr.operands[0]);
+                if (target == labelIndex.end()) return false;
+                worklist.push_back(target->second);
+                if (instr.mnemonic == "jmp") break;
+            }
+        }
+    }
+    return true;
+}
+
+void PeepholeOptimizer::remove(size_t i) {
+    code[i].deleted = true;
+}
+
+void PeepholeOptimizer::replace(size_t i, const string& mnemonic, const vector<string>& operands) {
+    code[i].mnemonic = mnemonic;
+    code[i].operands = operands;
+}
+
+// ========== PATRONES ==========
+
+// jmp L seguido (solo con etiquetas en el medio) de L:
+int PeepholeOptimizer::jumpToNext(size_t i) {
+    if (code[i].mnemonic != "jmp" || code[i].operands.size() != 1) return -1;
+    for (size_t j = nextEntry(i); j < code.size() && code[j].isLabel(); j = nextEntry(j)) {
+        if (code[j].label == code[i].operands[0]) {
+            remove(i);
+            return 1;
+        }
+    }
+    return -1;
+}
+
+// Nada llega a lo que sigue a un jmp/ret antes de la próxima etiqueta
+int PeepholeOptimizer::unreachable(size_t i) {
+    if (code[i].mnemonic != "jmp" && code[i].mnemonic != "ret") return -1;
+    int removed = 0;
+    for (size_t j = nextInstr(i); j < code.size(); j = nextInstr(j)) {
+        remove(j);
+        removed++;
+    }
+    return removed > 0 ? removed : -1;
+}
+
+// mov A, imm; push A (A muerto después)  ->  push imm
+int PeepholeOptimizer::pushImmediate(size_t i) {
+    const AsmInstr& def = code[i];
+    RegName a;
+    if (def.mnemonic != "mov" || def.operands.size() != 2 || !isGPR(def.operands[0], a) ||
+        a.width < 32 || !isImmediate(def.operands[1])) {
+        return -1;
+    }
+    size_t j = nextInstr(i);
+    if (j >= code.size() || code[j].mnemonic != "push" || code[j].operands.size() != 1 ||
+        code[j].operands[0] != registerName(a.family, 64)) {
+        return -1;
+    }
+
+    // push imm extiende el signo de 32 bits; mov eax, imm extiende con ceros
+    long value = stol(def.operands[1]);
+    if (a.width == 32 ? (value < 0 || value > INT_MAX) : (value < INT_MIN || value > INT_MAX)) return -1;
+    if (!isDeadFrom(nextEntry(j), a.family)) return -1;
+
+    replace(j, "push", {to_string(value)});
+    remove(i);
+    return 1;
+}
+
+// push R; ...; pop S  ->  mov S, R  (donde el valor de R siga disponible)
+int PeepholeOptimizer::pushPop(size_t i) {
+    RegName source, target;
+    bool immediate = code[i].operands.size() == 1 && isImmediate(code[i].operands[0]);
+    if (code[i].mnemonic != "push" || code[i].operands.size() != 1 ||
+        (!immediate && (!isGPR(code[i].operands[0], source) || source.width != 64 || source.family == RSP))) {
+        return -1;
+    }
+
+    uint32_t reads = 0, modifies = 0;
+    size_t j = nextInstr(i);
+    for (int window = 0; j < code.size() && window < 8; window++, j = nextInstr(j)) {
+        const string& m = code[j].mnemonic;
+        if (m == "pop") break;
+        if (m == "push" || m == "call" || m == "ret" || isJump(m)) return -1;
+        Effects effects = effectsOf(code[j]);
+        if ((effects.reads | effects.modifies) & (1u << RSP)) return -1;
+        reads |= effects.reads;
+        modifies |= effects.modifies;
+    }
+    if (j >= code.size() || code[j].mnemonic != "pop" ||
+        !isGPR(code[j].operands[0], target) || target.width != 64) {
+        return -1;
+    }
+
+    string sourceName = code[i].operands[0];
+    string targetName = code[j].operands[0];
+    if (immediate) {
+        // La constante no depende de nada: se carga donde estaba el pop
+        remove(i);
+        replace(j, "mov", {targetName, sourceName});
+        return 1;
+    }
+
+    uint32_t sourceBit = 1u << source.family;
+    uint32_t targetBit = 1u << target.family;
+
+    if (source.family == target.family) {
+        if (modifies & sourceBit) return -1;
+        remove(i);
+        remove(j);
+        return 2;
+    }
+    if (!(modifies & sourceBit)) {
+        // R no cambia: la copia va en lugar del pop
+        remove(i);
+        replace(j, "mov", {targetName, sourceName});
+        return 1;
+    }
+    if (!((reads | modifies) & targetBit)) {
+        // S no se usa en el medio: la copia va en lugar del push
+        replace(i, "mov", {targetName, sourceName});
+        remove(j);
+        return 1;
+    }
+    return -1;
+}
+
+// mov rax, rax (una copia de 32 bits limpia la parte alta, esa se queda)
+int PeepholeOptimizer::selfMove(size_t i) {
+    const AsmInstr& instr = code[i];
+    RegName reg;
+    if ((instr.mnemonic != "mov" && instr.mnemonic != "movss") || instr.operands.size() != 2 ||
+        instr.operands[0] != instr.operands[1] || !parseRegister(instr.operands[0], reg) ||
+        reg.width == 32) {
+        return -1;
+    }
+    remove(i);
+    return 1;
+}
+
+// mov [M], R; mov R2, [M]  ->  el valor ya está en R
+int PeepholeOptimizer::storeLoad(size_t i) {
+    const AsmInstr& store = code[i];
+    if ((store.mnemonic != "mov" && store.mnemonic != "movss") || store.operands.size() != 2 ||
+        !isMemory(store.operands[0])) {
+        return -1;
+    }
+    size_t j = nextInstr(i);
+    if (j >= code.size()) return -1;
+    const AsmInstr& load = code[j];
+    if (load.mnemonic != store.mnemonic || load.operands.size() != 2 ||
+        stripSize(load.operands[1]) != stripSize(store.operands[0])) {
+        return -1;
+    }
+
+    if (load.operands[0] == store.operands[1]) {
+        remove(j);
+        return 1;
+    }
+    // Con otro registro del mismo ancho: copia de registro (solo enteros;
+    // movss entre registros no limpia la parte alta como la carga)
+    RegName source, target;
+    if (store.mnemonic == "mov" && isGPR(store.operands[1], source) &&
+        isGPR(load.operands[0], target) && source.width == target.width) {
+        replace(j, "mov", {load.operands[0], store.operands[1]});
+        return 0;
+    }
+    return -1;
+}
+
+// mov R, [M]; mov [M], R  ->  el store no cambia nada
+int PeepholeOptimizer::loadStore(size_t i) {
+    const AsmInstr& load = code[i];
+    if ((load.mnemonic != "mov" && load.mnemonic != "movss") || load.operands.size() != 2 ||
+        !isMemory(load.operands[1]) || isMemory(load.operands[0])) {
+        return -1;
+    }
+    size_t j = nextInstr(i);
+    if (j >= code.size()) return -1;
+    const AsmInstr& store = code[j];
+    RegName reg;
+    if (store.mnemonic != load.mnemonic || store.operands.size() != 2 ||
+        store.operands[1] != load.operands[0] ||
+        stripSize(store.operands[0]) != stripSize(load.operands[1]) ||
+        !parseRegister(load.operands[0], reg) ||
+        (registersIn(load.operands[1]) & (1u << reg.family))) {
+        return -1;
+    }
+    remove(j);
+    return 1;
+}
+
+// mov eax, X; movsxd rax, eax  ->  movsxd rax, X
+int PeepholeOptimizer::loadExtend(size_t i) {
+    const AsmInstr& load = code[i];
+    RegName narrow, wide;
+    if (load.mnemonic != "mov" || load.operands.size() != 2 ||
+        !isGPR(load.operands[0], narrow) || narrow.width != 32) {
+        return -1;
+    }
+    size_t j = nextInstr(i);
+    if (j >= code.size()) return -1;
+    const AsmInstr& extend = code[j];
+    if ((extend.mnemonic != "movsxd" && extend.mnemonic != "movsx") || extend.operands.size() != 2 ||
+        extend.operands[1] != load.operands[0] || !isGPR(extend.operands[0], wide) ||
+        wide.family != narrow.family || wide.width != 64) {
+        return -1;
+    }
+
+    string wideName = extend.operands[0];
+    string source = load.operands[1];
+    RegName sourceReg;
+    if (isImmediate(source)) {
+        replace(i, "mov", {wideName, to_string((int)stol(source))});
+    } else if (isMemory(source)) {
+        replace(i, "movsxd", {wideName, "dword " + stripSize(source)});
+    } else if (isGPR(source, sourceReg) && sourceReg.width == 32) {
+        replace(i, "movsxd", {wideName, source});
+    } else {
+        return -1;
+    }
+    remove(j);
+    return 1;
+}
+
+// mov A, X; mov B, A (A muerto después)  ->  mov B, X
+int PeepholeOptimizer::copyPropagation(size_t i) {
+    const AsmInstr& def = code[i];
+    const string& m = def.mnemonic;
+    RegName a;
+    if ((m != "mov" && m != "movsx" && m != "movsxd" && m != "movzx" && m != "lea" && m != "cvttss2si") ||
+        def.operands.size() != 2 || !isGPR(def.operands[0], a) || a.width < 32) {
+        return -1;
+    }
+    size_t j = nextInstr(i);
+    if (j >= code.size()) return -1;
+    const AsmInstr& copy = code[j];
+    RegName use, b;
+    if (copy.mnemonic != "mov" || copy.operands.size() != 2 ||
+        !isGPR(copy.operands[1], use) || use.family != a.family ||
+        !isGPR(copy.operands[0], b) || b.family == a.family || b.family == RSP || b.family == 5) {
+        return -1;
+    }
+
+    string newMnemonic = m;
+    string newTarget;
+    string newSource = def.operands[1];
+    if (use.width == a.width && b.width == use.width) {
+        newTarget = copy.operands[0];
+    } else if (a.width == 32 && use.width == 64 && b.width == 64) {
+        // La definición de 32 bits ya limpió la parte alta
+        newTarget = registerName(b.family, 32);
+    } else if ((m == "movsx" || m == "movsxd") && a.width == 64 && use.width == 32 && b.width == 32) {
+        // Solo se copian los 32 bits bajos del valor extendido
+        RegName sourceReg;
+        bool source32 = isMemory(newSource) ? m == "movsxd" || newSource.rfind("dword", 0) == 0
+                                            : isGPR(newSource, sourceReg) && sourceReg.width == 32;
+        if (!source32) return -1;
+        newMnemonic = "mov";
+        newTarget = copy.operands[0];
+        newSource = stripSize(newSource);
+    } else {
+        return -1;
+    }
+
+    if (!isDeadFrom(nextEntry(j), a.family)) return -1;
+    replace(i, newMnemonic, {newTarget, newSource});
+    remove(j);
+    return 1;
+}
+
+// mov A, imm; mov [M], A (A muerto después)  ->  mov dword [M], imm
+int PeepholeOptimizer::storeImmediate(size_t i) {
+    const AsmInstr& def = code[i];
+    RegName a;
+    if (def.mnemonic != "mov" || def.operands.size() != 2 || !isGPR(def.operands[0], a) ||
+        a.width < 32 || !isImmediate(def.operands[1])) {
+        return -1;
+    }
+    size_t j = nextInstr(i);
+    if (j >= code.size()) return -1;
+    const AsmInstr& store = code[j];
+    if (store.mnemonic != "mov" || store.operands.size() != 2 || !isMemory(store.operands[0]) ||
+        store.operands[1] != def.operands[0] || (registersIn(store.operands[0]) & (1u << a.family))) {
+        return -1;
+    }
+
+    long value = stol(def.operands[1]);
+    if (a.width == 64 && (value < INT_MIN || value > INT_MAX)) return -1;
+    if (!isDeadFrom(nextEntry(j), a.family)) return -1;
+
+    string size = a.width == 64 ? "qword " : "dword ";
+    replace(j, "mov", {size + stripSize(store.operands[0]), a.width == 64 ? to_string(value) : to_string((int)value)});
+    remove(i);
+    return 1;
+}
+
+// mov A, imm; ...; op X, A (A muerto después)  ->  ...; op X, imm
+int PeepholeOptimizer::immediateOperand(size_t i) {
+    const AsmInstr& def = code[i];
+    RegName a;
+    if (def.mnemonic != "mov" || def.operands.size() != 2 || !isGPR(def.operands[0], a) ||
+        a.width < 32 || !isImmediate(def.operands[1])) {
+        return -1;
+    }
+    long value = stol(def.operands[1]);
+    if (a.width == 64 && (value < INT_MIN || value > INT_MAX)) return -1;
+    if (a.width == 32) value = (unsigned)value;  // El registro queda extendido con ceros
+    uint32_t bit = 1u << a.family;
+
+    // El primer uso de A tiene que ser el operando fuente de una operación
+    size_t j = nextInstr(i);
+    for (int window = 0; j < code.size() && window < 4; window++, j = nextInstr(j)) {
+        Effects effects = effectsOf(code[j]);
+        if ((effects.reads | effects.modifies) & bit) break;
+        if (isJump(code[j].mnemonic) || code[j].mnemonic == "ret" || code[j].mnemonic == "call") return -1;
+    }
+    if (j >= code.size()) return -1;
+
+    AsmInstr& use = code[j];
+    const string& m = use.mnemonic;
+    RegName target, operand;
+    if ((m != "add" && m != "sub" && m != "and" && m != "or" && m != "xor" &&
+         m != "cmp" && m != "imul") || use.operands.size() != 2 ||
+        !isGPR(use.operands[1], operand) || operand.family != a.family || operand.width < 32 ||
+        !isGPR(use.operands[0], target) || target.family == a.family) {
+        return -1;
+    }
+    // El inmediato de 32 bits se extiende con signo al ancho de la operación
+    if (operand.width == 32) value = (int)value;
+    if (value < INT_MIN || value > INT_MAX) return -1;
+    if (!isDeadFrom(nextEntry(j), a.family)) return -1;
+
+    use.operands[1] = to_string(value);
+    remove(i);
+    return 1;
+}
+
+static string negateCondition(const string& cc) {
+    static const char* pairs[][2] = {
+        {"e", "ne"}, {"z", "nz"}, {"l", "ge"}, {"g", "le"}, {"b", "ae"},
+        {"a", "be"}, {"s", "ns"}, {"p", "np"}, {"o", "no"}, {"c", "nc"}
+    };
+    for (auto& pair : pairs) {
+        if (cc == pair[0]) return pair[1];
+        if (cc == pair[1]) return pair[0];
+    }
+    return "";
+}
+
+// setcc al; movzx eax, al; test rax, rax; jz L  ->  jncc L  (rax muerto)
+int PeepholeOptimizer::setccBranch(size_t i) {
+    const AsmInstr& set = code[i];
+    if (set.mnemonic.rfind("set", 0) != 0 || set.operands.size() != 1 || set.operands[0] != "al") {
+        return -1;
+    }
+    string cc = set.mnemonic.substr(3);
+    if (negateCondition(cc).empty()) return -1;
+
+    size_t j = nextInstr(i);
+    if (j >= code.size() || code[j].mnemonic != "movzx" || code[j].operands.size() != 2 ||
+        code[j].operands[0] != "eax" || code[j].operands[1] != "al") {
+        return -1;
+    }
+    size_t k = nextInstr(j);
+    if (k >= code.size()) return -1;
+    const AsmInstr& test = code[k];
+    bool isTest = test.mnemonic == "test" && test.operands.size() == 2 &&
+                  test.operands[0] == test.operands[1] &&
+                  (test.operands[0] == "rax" || test.operands[0] == "eax");
+    bool isCmpZero = test.mnemonic == "cmp" && test.operands.size() == 2 &&
+                     (test.operands[0] == "rax" || test.operands[0] == "eax") && test.operands[1] == "0";
+    if (!isTest && !isCmpZero) return -1;
+
+    size_t l = nextInstr(k);
+    if (l >= code.size() || code[l].operands.size() != 1) return -1;
+    const string& jump = code[l].mnemonic;
+    string newJump;
+    if (jump == "jz" || jump == "je") {
+        newJump = "j" + negateCondition(cc);
+    } else if (jump == "jnz" || jump == "jne") {
+        newJump = "j" + cc;
+    } else {
+        return -1;
+    }
+
+    // El 0/1 no tiene que usarse en ninguno de los dos caminos
+    if (!isDeadFrom(l, RAX)) return -1;
+
+    string target = code[l].operands[0];
+    replace(i, newJump, {target});
+    remove(j);
+    remove(k);
+    remove(l);
+    return 3;
+}
+
+// ========== PASE ==========
+
+string PeepholeOptimizer::optimize(const string& text) {
+    parse(text);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < code.size(); i++) {
+            for (size_t p = 0; p < patternStats.size() && code[i].isInstr(); p++) {
+                int removed = (this->*patterns[p].apply)(i);
+                if (removed < 0) continue;
+                patternStats[p].matches++;
+                patternStats[p].removed += removed;
+                changed = true;
+            }
+        }
+    }
+    return render();
+}
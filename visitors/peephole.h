@@ -0,0 +1,104 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+using namespace std;
+
+// ========== OPTIMIZACIÓN PEEPHOLE ==========
+// Pase sobre el ensamblador ya generado (un trozo de .text por función).
+// El texto se parsea a una lista de instrucciones (etiqueta / mnemónico /
+// operandos) y se aplica una tabla de patrones hasta que ninguno cambia
+// nada:
+//   jmp-next          jmp L justo antes de L:
+//   unreachable       código después de jmp/ret hasta la próxima etiqueta
+//   push-immediate    mov A, imm; push A (A muerto)  ->  push imm
+//   push-pop          push R ... pop S  ->  mov S, R
+//   self-move         mov rax, rax
+//   store-load        mov [M], R; mov R2, [M]  ->  mov [M], R; mov R2, R
+//   load-store        mov R, [M]; mov [M], R   ->  mov R, [M]
+//   load-extend       mov eax, X; movsxd rax, eax  ->  movsxd rax, X
+//   copy-propagation  mov A, X; mov B, A (A muerto)  ->  mov B, X
+//   store-immediate   mov A, imm; mov [M], A (A muerto)  ->  mov [M], imm
+//   immediate-operand mov A, imm; ...; add X, A (A muerto)  ->  add X, imm
+//   setcc-branch      setcc al; movzx eax, al; test rax, rax; jz L  ->  jncc L
+// Los patrones que dependen de que un registro esté muerto usan un
+// análisis de vida conservador que sigue los saltos dentro del trozo.
+class PeepholeOptimizer {
+public:
+    struct PatternStats {
+        const char* name;
+        int matches = 0;
+        int removed = 0;    // Instrucciones eliminadas
+    };
+
+    PeepholeOptimizer();
+
+    // Optimiza un trozo de código (las líneas que no entiende las deja igual)
+    string optimize(const string& code);
+
+    const vector<PatternStats>& stats() const { return patternStats; }
+    int totalRemoved() const;
+
+private:
+    struct AsmInstr {
+        string label;             // "L1" para la línea "L1:"
+        string mnemonic;          // "" si no es una instrucción
+        vector<string> operands;
+        string text;              // Línea original (directivas, vacías)
+        bool deleted = false;
+
+        bool isInstr() const { return !deleted && !mnemonic.empty(); }
+        bool isLabel() const { return !deleted && !label.empty(); }
+    };
+
+    // Registros que lee / pisa entera / modifica una instrucción.
+    // Bits 0-15: rax..r15, 16-31: xmm0..xmm15
+    struct Effects {
+        uint32_t reads = 0;
+        uint32_t kills = 0;       // Escritura completa (el valor anterior muere)
+        uint32_t modifies = 0;    // Cualquier escritura (incluye parciales)
+    };
+
+    // Un patrón: devuelve -1 si no aplica en i, o cuántas instrucciones borró
+    struct Pattern {
+        const char* name;
+        int (PeepholeOptimizer::*apply)(size_t i);
+    };
+    static const Pattern patterns[];
+
+    vector<AsmInstr> code;
+    unordered_map<string, size_t> labelIndex;
+    vector<PatternStats> patternStats;
+
+    // Parseo y salida
+    void parse(const string& text);
+    string render() const;
+
+    // Navegación
+    size_t nextEntry(size_t i) const;      // Siguiente instrucción o etiqueta
+    size_t nextInstr(size_t i) const;      // Siguiente instrucción (o size() si hay una etiqueta antes)
+    Effects effectsOf(const AsmInstr& instr) const;
+    bool isDeadFrom(size_t start, int family) const;  // ¿El registro está muerto desde start?
+    void remove(size_t i);
+    void replace(size_t i, const string& mnemonic, const vector<string>& operands);
+
+    // Patrones
+    int jumpToNext(size_t i);
+    int unreachable(size_t i);
+    int pushImmediate(size_t i);
+    int pushPop(size_t i);
+    int selfMove(size_t i);
+    int storeLoad(size_t i);
+    int loadStore(size_t i);
+    int loadExtend(size_t i);
+    int copyPropagation(size_t i);
+    int storeImmediate(size_t i);
+    int immediateOperand(size_t i);
+    int setccBranch(size_t i);
+};
+
+#endif
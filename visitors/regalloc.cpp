@@ -0,0 +1,422 @@
+#include "regalloc.h"
+#include <algorithm>
+
+// ========== API ==========
+
+void RegisterAllocator::allocate(FunctionDecl* func) {
+    intervals.clear();
+    currentInterval.clear();  // O(1): solo sube la generación
+    callPositions.clear();
+    loops.clear();
+    declRegs.clear();
+    calleeSavedUsed.clear();
+    registersUsed.clear();
+    position = 0;
+
+    // Los parámetros están vivos desde la entrada de la función
+    for (size_t i = 0; i < func->parameters.size() && i < 6; i++) {
+        Param& param = func->parameters[i];
+        if (param.type == DataType::FLOAT) {
+            // Llegan en registros enteros (ver CodeGen): se quedan en memoria
+            currentInterval.erase(param.symbol);
+            continue;
+        }
+        addInterval(param.type, param.symbol, nullptr, (int)i);
+    }
+
+    visit(func->body.get());
+
+    extendOverLoops();
+    markCallCrossings();
+    linearScan(func->parameters.size());
+}
+
+string RegisterAllocator::registerFor(VarDecl* decl) const {
+    auto it = declRegs.find(decl);
+    return it != declRegs.end() ? it->second : "";
+}
+
+string RegisterAllocator::registerForParam(size_t index) const {
+    return index < paramRegs.size() ? paramRegs[index] : "";
+}
+
+bool RegisterAllocator::isLeafArgument(Expr* arg) {
+    switch (arg->kind) {
+        case NodeKind::IntLiteral:
+        case NodeKind::LongLiteral:
+        case NodeKind::StringLiteral:
+        case NodeKind::Variable:
+            return true;
+        default:
+            return false;
+    }
+}
+
+int RegisterAllocator::registerNeed(Expr* expr) {
+    switch (expr->kind) {
+        case NodeKind::IntLiteral:
+        case NodeKind::FloatLiteral:
+        case NodeKind::LongLiteral:
+        case NodeKind::StringLiteral:
+        case NodeKind::Variable:
+            return 1;
+        case NodeKind::UnaryOp:
+            return registerNeed(static_cast<UnaryOp*>(expr)->operand.get());
+        case NodeKind::CastExpr:
+            return registerNeed(static_cast<CastExpr*>(expr)->expr.get());
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* node = static_cast<TernaryExpr*>(expr);
+            return max({registerNeed(node->condition.get()), registerNeed(node->exprTrue.get()),
+                        registerNeed(node->exprFalse.get())});
+        }
+        case NodeKind::ArrayAccess:
+            return indexNeed(static_cast<ArrayAccess*>(expr)->indices);
+        case NodeKind::BinaryOp: {
+            BinaryOp* node = static_cast<BinaryOp*>(expr);
+            if (node->registerNeed == 0) {
+                int left = registerNeed(node->left.get());
+                int right = registerNeed(node->right.get());
+                int need = left == right ? left + 1 : max(left, right);
+                if (isShortCircuit(node)) need = max(left, right);  // No guarda nada entre los dos
+                node->registerNeed = min(need, UNBOUNDED_NEED);
+            }
+            return node->registerNeed;
+        }
+        default:
+            return UNBOUNDED_NEED;
+    }
+}
+
+int RegisterAllocator::indexNeed(ExprList& indices) {
+    // arr[i][j]: i queda guardado mientras se evalúa j
+    int need = 1;
+    for (size_t i = 0; i < indices.size(); i++) {
+        need = max(need, registerNeed(indices[i].get()) + (int)i);
+    }
+    return min(need, UNBOUNDED_NEED);
+}
+
+bool RegisterAllocator::isShortCircuit(BinaryOp* node) {
+    return node->op.type == TokenType::AND || node->op.type == TokenType::OR;
+}
+
+bool RegisterAllocator::evaluatesLeftFirst(BinaryOp* node) {
+    if (isShortCircuit(node)) return true;
+    int left = registerNeed(node->left.get());
+    int right = registerNeed(node->right.get());
+    return left > right && left < UNBOUNDED_NEED;
+}
+
+// ========== INTERVALOS ==========
+
+bool RegisterAllocator::isCandidateType(DataType type) {
+    return type == DataType::INT || type == DataType::LONG ||
+           type == DataType::UNSIGNED_INT || type == DataType::FLOAT;
+}
+
+void RegisterAllocator::addInterval(DataType type, SymbolId symbol, VarDecl* decl, int paramIndex) {
+    Interval interval;
+    interval.type = type;
+    interval.start = position;
+    interval.end = position;
+    interval.crossesCall = false;
+    interval.decl = decl;
+    interval.paramIndex = paramIndex;
+
+    currentInterval[symbol] = intervals.size();
+    intervals.push_back(interval);
+}
+
+// Registra un uso (lectura o escritura) de la declaración vigente
+void RegisterAllocator::touch(SymbolId symbol) {
+    position++;
+    if (int* index = currentInterval.find(symbol)) {
+        intervals[*index].end = position;
+    }
+}
+
+// Una variable viva al entrar a un loop y usada dentro sigue viva en todo
+// el loop (el salto hacia atrás vuelve a usarla). Los loops están en orden
+// de cierre, así que un loop interno se procesa antes que el externo.
+void RegisterAllocator::extendOverLoops() {
+    for (Interval& interval : intervals) {
+        for (auto& loop : loops) {
+            if (interval.start < loop.first && interval.end >= loop.first && interval.end < loop.second) {
+                interval.end = loop.second;
+            }
+        }
+    }
+}
+
+void RegisterAllocator::markCallCrossings() {
+    for (Interval& interval : intervals) {
+        auto call = upper_bound(callPositions.begin(), callPositions.end(), interval.start);
+        interval.crossesCall = call != callPositions.end() && *call < interval.end;
+    }
+}
+
+// ========== LINEAR SCAN ==========
+
+namespace {
+struct PhysReg {
+    const char* name;
+    bool isFloat;
+    bool calleeSaved;
+    int owner;  // Intervalo que lo ocupa (-1 = libre)
+};
+}
+
+void RegisterAllocator::linearScan(size_t paramCount) {
+    // Orden de preferencia: primero los caller-saved (no hay que guardarlos)
+    vector<PhysReg> regs;
+    const char* callerSaved[] = {"r8", "r9", "r10", "r11"};
+    for (int i = 0; i < 4; i++) {
+        // r8/r9 traen el 5.º/6.º parámetro: no se reutilizan en esa función
+        if ((i == 0 && paramCount >= 5) || (i == 1 && paramCount >= 6)) continue;
+        regs.push_back({callerSaved[i], false, false, -1});
+    }
+    for (const char* name : {"rbx", "r12", "r13", "r14", "r15"}) {
+        regs.push_back({name, false, true, -1});
+    }
+    for (const char* name : {"xmm8", "xmm9", "xmm10", "xmm11", "xmm12", "xmm13", "xmm14", "xmm15"}) {
+        regs.push_back({name, true, false, -1});
+    }
+
+    auto allowed = [&](const Interval& interval, const PhysReg& reg) {
+        bool isFloat = interval.type == DataType::FLOAT;
+        if (isFloat != reg.isFloat) return false;
+        return reg.calleeSaved || !interval.crossesCall;
+    };
+
+    vector<int> order(intervals.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return intervals[a].start < intervals[b].start;
+    });
+
+    vector<int> regOf(intervals.size(), -1);
+    for (int current : order) {
+        Interval& interval = intervals[current];
+
+        // Liberar los registros de intervalos que ya terminaron
+        for (PhysReg& reg : regs) {
+            if (reg.owner >= 0 && intervals[reg.owner].end < interval.start) {
+                reg.owner = -1;
+            }
+        }
+
+        // Buscar un registro libre
+        int chosen = -1;
+        for (size_t r = 0; r < regs.size(); r++) {
+            if (regs[r].owner < 0 && allowed(interval, regs[r])) {
+                chosen = r;
+                break;
+            }
+        }
+
+        // Sin registros libres: sacar al que termina más tarde
+        if (chosen < 0) {
+            int victim = -1;
+            for (size_t r = 0; r < regs.size(); r++) {
+                if (regs[r].owner < 0 || !allowed(interval, regs[r])) continue;
+                if (victim < 0 || intervals[regs[r].owner].end > intervals[regs[victim].owner].end) {
+                    victim = r;
+                }
+            }
+            if (victim >= 0 && intervals[regs[victim].owner].end > interval.end) {
+                regOf[regs[victim].owner] = -1;
+                chosen = victim;
+            }
+        }
+
+        if (chosen >= 0) {
+            regs[chosen].owner = current;
+            regOf[current] = chosen;
+        }
+    }
+
+    // Publicar el resultado
+    paramRegs.assign(paramCount, "");
+    vector<bool> calleeSavedTouched(regs.size(), false);
+    for (size_t i = 0; i < intervals.size(); i++) {
+        Interval& interval = intervals[i];
+        if (regOf[i] < 0) {
+            varsSpilled++;
+            continue;
+        }
+        interval.reg = regs[regOf[i]].name;
+        if (regs[regOf[i]].calleeSaved) calleeSavedTouched[regOf[i]] = true;
+        varsInRegisters++;
+
+        if (interval.decl) {
+            declRegs[interval.decl] = interval.reg;
+        } else {
+            paramRegs[interval.paramIndex] = interval.reg;
+        }
+    }
+    for (size_t r = 0; r < regs.size(); r++) {
+        if (calleeSavedTouched[r]) calleeSavedUsed.push_back(regs[r].name);
+    }
+    for (const Interval& interval : intervals) {
+        if (!interval.reg.empty() &&
+            find(registersUsed.begin(), registersUsed.end(), interval.reg) == registersUsed.end()) {
+            registersUsed.push_back(interval.reg);
+        }
+    }
+}
+
+// ========== RECORRIDO (mismo orden que CodeGen) ==========
+
+void RegisterAllocator::visitVariable(Variable* node) {
+    touch(node->symbol);
+}
+
+void RegisterAllocator::visitBinaryOp(BinaryOp* node) {
+    // Mismo orden que CodeGen (Sethi-Ullman)
+    if (evaluatesLeftFirst(node)) {
+        visit(node->left.get());
+        visit(node->right.get());
+    } else {
+        visit(node->right.get());
+        visit(node->left.get());
+    }
+    position++;
+}
+
+void RegisterAllocator::visitUnaryOp(UnaryOp* node) {
+    visit(node->operand.get());
+}
+
+void RegisterAllocator::visitCastExpr(CastExpr* node) {
+    visit(node->expr.get());
+}
+
+void RegisterAllocator::visitTernaryExpr(TernaryExpr* node) {
+    visit(node->condition.get());
+    visit(node->exprTrue.get());
+    visit(node->exprFalse.get());
+}
+
+void RegisterAllocator::visitCallExpr(CallExpr* node) {
+    if (node->functionName == "printf") {
+        // CodeGen solo usa el formato y el primer valor
+        if (node->arguments.size() > 0) {
+            if (nodeIs<StringLiteral>(node->arguments[0].get())) {
+                if (node->arguments.size() > 1) visit(node->arguments[1].get());
+            } else {
+                visit(node->arguments[0].get());
+            }
+        }
+    } else {
+        // Primero los argumentos compuestos, después las hojas
+        for (size_t i = 0; i < node->arguments.size() && i < 6; i++) {
+            if (!isLeafArgument(node->arguments[i].get())) visit(node->arguments[i].get());
+        }
+        // Con 5 o 6 argumentos, r8/r9 se cargan antes de evaluar las hojas:
+        // desde acá cuenta como si ya hubiera un call
+        if (node->arguments.size() > 4) {
+            callPositions.push_back(++position);
+        }
+        for (size_t i = 0; i < node->arguments.size() && i < 6; i++) {
+            if (isLeafArgument(node->arguments[i].get())) visit(node->arguments[i].get());
+        }
+    }
+
+    position++;
+    callPositions.push_back(position);
+}
+
+void RegisterAllocator::visitArrayAccess(ArrayAccess* node) {
+    for (auto& index : node->indices) {
+        visit(index.get());
+    }
+}
+
+void RegisterAllocator::visitAssignExpr(AssignExpr* node) {
+    visit(node->value.get());
+    if (node->isArrayAssign) {
+        for (auto& index : node->indices) {
+            visit(index.get());
+        }
+    } else {
+        touch(node->varSymbol);
+    }
+}
+
+void RegisterAllocator::visitVarDecl(VarDecl* node) {
+    if (node->isArray || !isCandidateType(node->type)) {
+        // Arrays y tipos raros viven siempre en memoria
+        currentInterval.erase(node->symbol);
+        return;
+    }
+
+    if (node->initializer) {
+        visit(node->initializer.get());
+    }
+    position++;
+    addInterval(node->type, node->symbol, node, -1);
+}
+
+void RegisterAllocator::visitAssignStmt(AssignStmt* node) {
+    visit(node->value.get());
+    if (node->isArrayAssign) {
+        for (auto& index : node->indices) {
+            visit(index.get());
+        }
+    } else {
+        touch(node->varSymbol);
+    }
+}
+
+void RegisterAllocator::visitBlock(Block* node) {
+    for (auto& stmt : node->statements) {
+        visit(stmt.get());
+    }
+}
+
+void RegisterAllocator::visitIfStmt(IfStmt* node) {
+    visit(node->condition.get());
+    visit(node->thenBranch.get());
+    if (node->elseBranch) {
+        visit(node->elseBranch.get());
+    }
+}
+
+// CodeGen rota los loops: la condición aparece antes de entrar (guarda)
+// y otra vez al final del cuerpo
+void RegisterAllocator::visitWhileStmt(WhileStmt* node) {
+    visit(node->condition.get());
+    int loopStart = ++position;
+    visit(node->body.get());
+    visit(node->condition.get());
+    loops.push_back({loopStart, ++position});
+}
+
+void RegisterAllocator::visitForStmt(ForStmt* node) {
+    if (node->initializer) {
+        visit(node->initializer.get());
+    }
+
+    if (node->condition) {
+        visit(node->condition.get());
+    }
+    int loopStart = ++position;
+    visit(node->body.get());
+    if (node->increment) {
+        visit(node->increment.get());
+    }
+    if (node->condition) {
+        visit(node->condition.get());
+    }
+    loops.push_back({loopStart, ++position});
+}
+
+void RegisterAllocator::visitReturnStmt(ReturnStmt* node) {
+    if (node->value) {
+        visit(node->value.get());
+    }
+}
+
+void RegisterAllocator::visitExprStmt(ExprStmt* node) {
+    visit(node->expression.get());
+}
@@ -0,0 +1,123 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include "../parser/ast.h"
+#include "../parser/ast_visitor.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+using namespace std;
+
+// ========== ASIGNACIÓN DE REGISTROS (LINEAR SCAN) ==========
+// Pase previo a CodeGen que recorre cada función en el mismo orden en que
+// CodeGen emite el código, numera las posiciones y calcula el intervalo de
+// vida [primer uso, último uso] de cada variable escalar local. Los
+// intervalos que cruzan un loop se extienden hasta el final del loop.
+//
+// Después asigna registros con linear scan:
+//   - int/long que cruzan un call: callee-saved (rbx, r12-r15)
+//   - int/long que no cruzan un call: r8-r11, y si no hay, callee-saved
+//   - float que no cruzan un call: xmm8-xmm15 (en SysV no hay xmm
+//     callee-saved, así que los float que cruzan un call quedan en memoria)
+// Cuando no quedan registros se manda a memoria el intervalo que termina
+// más tarde (el actual o uno activo).
+//
+// Registros que CodeGen usa como scratch y nunca se asignan: rax, rcx,
+// rdx, rsi, rdi, xmm0, xmm1.
+class RegisterAllocator : public StaticVisitor<RegisterAllocator> {
+public:
+    // Estadísticas acumuladas de todas las funciones
+    int varsInRegisters = 0;
+    int varsSpilled = 0;
+
+    // Calcula los intervalos y asigna registros para una función
+    void allocate(FunctionDecl* func);
+
+    // Registro asignado a una variable o parámetro ("" = vive en memoria)
+    string registerFor(VarDecl* decl) const;
+    string registerForParam(size_t index) const;
+
+    // Registros callee-saved usados (la función debe guardarlos)
+    const vector<string>& usedCalleeSaved() const { return calleeSavedUsed; }
+
+    // Todos los registros asignados en la función (los demás quedan libres
+    // para los temporales de CodeGen)
+    const vector<string>& usedRegisters() const { return registersUsed; }
+
+    // Argumentos "hoja" de una llamada: se cargan solo con rax, así que
+    // CodeGen los evalúa al final, directo a su registro de argumento
+    static bool isLeafArgument(Expr* arg);
+
+    // Número de Sethi-Ullman: registros que necesita evaluar la expresión
+    // sin tocar memoria. Los calls (y las asignaciones dentro de una
+    // expresión) devuelven UNBOUNDED_NEED: pisan los scratch y su orden
+    // de evaluación no se puede cambiar.
+    static constexpr int UNBOUNDED_NEED = 1 << 20;
+    static int registerNeed(Expr* expr);
+    static int indexNeed(ExprList& indices);   // Índices de arr[i] / arr[i][j]
+
+    // Orden de evaluación de una operación binaria que usa CodeGen: el
+    // operando que necesita más registros primero; si no, el derecho.
+    // && y || siempre evalúan primero el izquierdo.
+    static bool evaluatesLeftFirst(BinaryOp* node);
+    static bool isShortCircuit(BinaryOp* node);
+
+    // Visit methods - Expresiones
+    void visitIntLiteral(IntLiteral*) {}
+    void visitFloatLiteral(FloatLiteral*) {}
+    void visitLongLiteral(LongLiteral*) {}
+    void visitStringLiteral(StringLiteral*) {}
+    void visitVariable(Variable* node);
+    void visitBinaryOp(BinaryOp* node);
+    void visitUnaryOp(UnaryOp* node);
+    void visitCastExpr(CastExpr* node);
+    void visitTernaryExpr(TernaryExpr* node);
+    void visitCallExpr(CallExpr* node);
+    void visitArrayAccess(ArrayAccess* node);
+    void visitAssignExpr(AssignExpr* node);
+
+    // Visit methods - Statements
+    void visitVarDecl(VarDecl* node);
+    void visitAssignStmt(AssignStmt* node);
+    void visitBlock(Block* node);
+    void visitIfStmt(IfStmt* node);
+    void visitWhileStmt(WhileStmt* node);
+    void visitForStmt(ForStmt* node);
+    void visitReturnStmt(ReturnStmt* node);
+    void visitExprStmt(ExprStmt* node);
+    void visitFunctionDecl(FunctionDecl*) {}
+
+private:
+    // Intervalo de vida de una declaración (VarDecl o parámetro)
+    struct Interval {
+        DataType type;
+        int start;
+        int end;
+        bool crossesCall;
+        VarDecl* decl;      // nullptr si es un parámetro
+        int paramIndex;     // -1 si es una variable local
+        string reg;
+    };
+
+    vector<Interval> intervals;
+    SymbolMap<int> currentInterval;   // SymbolId -> intervalo de la declaración vigente
+    vector<int> callPositions;        // Posición de cada call (ordenadas)
+    vector<pair<int, int>> loops;     // [inicio, fin] de cada loop (internos primero)
+    int position = 0;
+
+    // Resultado de la última función
+    unordered_map<VarDecl*, string> declRegs;
+    vector<string> paramRegs;
+    vector<string> calleeSavedUsed;
+    vector<string> registersUsed;
+
+    static bool isCandidateType(DataType type);
+    void addInterval(DataType type, SymbolId symbol, VarDecl* decl, int paramIndex);
+    void touch(SymbolId symbol);
+    void extendOverLoops();
+    void markCallCrossings();
+    void linearScan(size_t paramCount);
+};
+
+#endif
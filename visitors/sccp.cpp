@@ -0,0 +1,523 @@
+#include "sccp.h"
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+typedef ConstantPropagation::Value Value;
+
+// ========== RED DE VALORES ==========
+
+static Value varying() {
+    Value value;
+    value.state = Value::VARYING;
+    return value;
+}
+
+// INT se guarda ya truncado a 32 bits (la aritmética da la vuelta)
+static Value integerConstant(DataType type, long long integer) {
+    Value value;
+    value.state = Value::CONSTANT;
+    value.type = type;
+    value.integer = type == DataType::INT ? (long long)(int32_t)(uint32_t)integer : integer;
+    return value;
+}
+
+// inf y nan no se pliegan (no hay literal que los escriba)
+static Value floatConstant(float real) {
+    if (!isfinite(real)) return varying();
+    Value value;
+    value.state = Value::CONSTANT;
+    value.type = DataType::FLOAT;
+    value.real = real;
+    return value;
+}
+
+static bool isTracked(DataType type) {
+    return type == DataType::INT || type == DataType::LONG || type == DataType::FLOAT;
+}
+
+static bool sameValue(const Value& a, const Value& b) {
+    if (a.state != b.state) return false;
+    if (a.state != Value::CONSTANT) return true;
+    if (a.type != b.type) return false;
+    if (a.type != DataType::FLOAT) return a.integer == b.integer;
+    // -0.0 y 0.0 son valores distintos
+    return memcmp(&a.real, &b.real, sizeof(float)) == 0;
+}
+
+static Value meet(const Value& a, const Value& b) {
+    if (a.state == Value::UNDEFINED) return b;
+    if (b.state == Value::UNDEFINED) return a;
+    if (a.state == Value::VARYING || b.state == Value::VARYING) return varying();
+    return sameValue(a, b) ? a : varying();
+}
+
+static bool truthy(const Value& value) {
+    return value.type == DataType::FLOAT ? value.real != 0 : value.integer != 0;
+}
+
+// Conversión implícita (asignación) o explícita (cast), como en C
+static Value convert(const Value& value, DataType type) {
+    if (value.state != Value::CONSTANT || value.type == type) return value;
+    if (!isTracked(type)) return varying();
+
+    if (type == DataType::FLOAT) {
+        return floatConstant((float)value.integer);
+    }
+    if (value.type == DataType::FLOAT) {
+        // Fuera de rango es comportamiento indefinido: no se pliega
+        double truncated = trunc((double)value.real);
+        double low = type == DataType::INT ? (double)INT_MIN : -9223372036854775808.0;
+        double high = type == DataType::INT ? (double)INT_MAX : 9223372036854775807.0;
+        if (truncated < low || truncated >= high + 1) return varying();
+        return integerConstant(type, (long long)truncated);
+    }
+    return integerConstant(type, value.integer);
+}
+
+// Tipo de una operación aritmética con operandos a y b
+static DataType arithmeticType(const Value& a, const Value& b) {
+    if (a.type == DataType::FLOAT || b.type == DataType::FLOAT) return DataType::FLOAT;
+    if (a.type == DataType::LONG || b.type == DataType::LONG) return DataType::LONG;
+    return DataType::INT;
+}
+
+static bool isComparison(TokenType op) {
+    return op == TokenType::EQ || op == TokenType::NE || op == TokenType::LT ||
+           op == TokenType::GT || op == TokenType::LE || op == TokenType::GE;
+}
+
+template<typename T>
+static bool compare(TokenType op, T a, T b) {
+    switch (op) {
+        case TokenType::EQ: return a == b;
+        case TokenType::NE: return a != b;
+        case TokenType::LT: return a < b;
+        case TokenType::GT: return a > b;
+        case TokenType::LE: return a <= b;
+        default: return a >= b;
+    }
+}
+
+// ========== VARIABLES ==========
+
+int ConstantPropagation::slotOf(SymbolId symbol) {
+    int slot = cfg.locals.slotOf(symbol);
+    if (slot < 0 || cfg.locals.isArray(slot) || !isTracked(cfg.locals.type(slot))) return -1;
+    return slot;
+}
+
+// ========== ANÁLISIS ==========
+
+void ConstantPropagation::clear() {
+    cfg.clear();
+    states.clear();
+    constants.clear();
+}
+
+void ConstantPropagation::analyze(FunctionDecl* func, const SymbolSet& globals) {
+    clear();
+    if (!func->body) return;
+    cfg.build(func, globals);
+    states.resize(cfg.blocks.size());
+
+    // Los parámetros llegan con cualquier valor; las locales, sin definir
+    vector<Value> initial(cfg.locals.size());
+    for (const Param& param : func->parameters) {
+        int slot = slotOf(param.symbol);
+        if (slot >= 0) initial[slot] = varying();
+    }
+
+    vector<int> worklist;
+    flowTo(0, initial, worklist);
+    while (!worklist.empty()) {
+        int current = worklist.back();
+        worklist.pop_back();
+        states[current].queued = false;
+
+        vector<Value> state = states[current].in;
+        for (const Action& action : cfg.blocks[current].actions) {
+            transfer(action, state);
+        }
+
+        const ControlFlowGraph::BasicBlock& block = cfg.blocks[current];
+        bool feasible[2] = {true, true};
+        if (block.condition) {
+            Value condition = run(block.condition, state);
+            if (condition.state == Value::CONSTANT) {
+                feasible[0] = truthy(condition);
+                feasible[1] = !feasible[0];
+            }
+        }
+        for (int k = 0; k < 2; k++) {
+            int target = block.next[k];
+            if (!feasible[k] || target < 0) continue;
+            states[current].taken[k] = true;
+            flowTo(target, state, worklist);
+        }
+    }
+
+    // Con el estado final, anotar las constantes de lo que se ejecuta
+    recording = true;
+    for (size_t i = 0; i < cfg.blocks.size(); i++) {
+        if (!states[i].reached) continue;
+        vector<Value> state = states[i].in;
+        for (const Action& action : cfg.blocks[i].actions) {
+            transfer(action, state);
+        }
+        if (cfg.blocks[i].condition) run(cfg.blocks[i].condition, state);
+    }
+    recording = false;
+}
+
+void ConstantPropagation::flowTo(int target, const vector<Value>& state, vector<int>& worklist) {
+    BlockState& block = states[target];
+    bool changed = false;
+    if (!block.reached) {
+        block.reached = true;
+        block.in = state;
+        changed = true;
+    } else {
+        for (size_t i = 0; i < state.size(); i++) {
+            Value merged = meet(block.in[i], state[i]);
+            if (!sameValue(merged, block.in[i])) {
+                block.in[i] = merged;
+                changed = true;
+            }
+        }
+    }
+    if (changed && !block.queued) {
+        block.queued = true;
+        worklist.push_back(target);
+    }
+}
+
+void ConstantPropagation::transfer(const Action& action, vector<Value>& state) {
+    if (action.expr) {
+        run(action.expr, state);
+        return;
+    }
+
+    Stmt* stmt = action.stmt;
+    switch (stmt->kind) {
+        case NodeKind::VarDecl: {
+            VarDecl* varDecl = static_cast<VarDecl*>(stmt);
+            for (auto& element : varDecl->arrayInitializer) {
+                run(element.get(), state);
+            }
+            // Sin inicializador: cualquier valor
+            Value value = varDecl->initializer ? run(varDecl->initializer.get(), state) : varying();
+            int slot = slotOf(varDecl->symbol);
+            if (slot >= 0) state[slot] = convert(value, cfg.locals.type(slot));
+            break;
+        }
+
+        case NodeKind::AssignStmt: {
+            AssignStmt* assign = static_cast<AssignStmt*>(stmt);
+            for (auto& index : assign->indices) {
+                run(index.get(), state);
+            }
+            Value value = run(assign->value.get(), state);
+            int slot = assign->isArrayAssign ? -1 : slotOf(assign->varSymbol);
+            if (slot >= 0) state[slot] = convert(value, cfg.locals.type(slot));
+            break;
+        }
+
+        case NodeKind::ExprStmt:
+            run(static_cast<ExprStmt*>(stmt)->expression.get(), state);
+            break;
+
+        case NodeKind::ReturnStmt: {
+            ReturnStmt* returnStmt = static_cast<ReturnStmt*>(stmt);
+            if (returnStmt->value) run(returnStmt->value.get(), state);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Evalúa una expresión completa y aplica sus asignaciones. Las variables
+// que la expresión asigna por dentro no se leen como constantes en ella
+// (el orden de evaluación no está fijo) y después quedan en VARYING; una
+// asignación en la raíz (i = i + 1) sí lee el valor de antes.
+Value ConstantPropagation::run(Expr* expr, vector<Value>& state) {
+    vector<int> clobbered;
+    AssignExpr* assign = nodeCast<AssignExpr>(expr);
+    if (assign) {
+        for (auto& index : assign->indices) {
+            collectAssigned(index.get(), clobbered);
+        }
+        collectAssigned(assign->value.get(), clobbered);
+    } else {
+        collectAssigned(expr, clobbered);
+    }
+
+    Value value;
+    if (assign) {
+        for (auto& index : assign->indices) {
+            evaluate(index.get(), state, clobbered);
+        }
+        value = evaluate(assign->value.get(), state, clobbered);
+        record(expr, varying());
+    } else {
+        value = evaluate(expr, state, clobbered);
+    }
+
+    for (int slot : clobbered) {
+        state[slot] = varying();
+    }
+    if (!assign) return value;
+
+    int slot = assign->isArrayAssign ? -1 : slotOf(assign->varSymbol);
+    if (slot >= 0) {
+        bool nested = false;
+        for (int other : clobbered) nested = nested || other == slot;
+        state[slot] = nested ? varying() : convert(value, cfg.locals.type(slot));
+    }
+    // La asignación tiene efectos: su valor no reemplaza a la expresión
+    return varying();
+}
+
+void ConstantPropagation::collectAssigned(Expr* expr, vector<int>& assigned) {
+    if (!expr) return;
+
+    switch (expr->kind) {
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            collectAssigned(binary->left.get(), assigned);
+            collectAssigned(binary->right.get(), assigned);
+            break;
+        }
+        case NodeKind::UnaryOp:
+            collectAssigned(static_cast<UnaryOp*>(expr)->operand.get(), assigned);
+            break;
+        case NodeKind::CastExpr:
+            collectAssigned(static_cast<CastExpr*>(expr)->expr.get(), assigned);
+            break;
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            collectAssigned(ternary->condition.get(), assigned);
+            collectAssigned(ternary->exprTrue.get(), assigned);
+            collectAssigned(ternary->exprFalse.get(), assigned);
+            break;
+        }
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                collectAssigned(arg.get(), assigned);
+            }
+            break;
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                collectAssigned(index.get(), assigned);
+            }
+            break;
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            for (auto& index : assign->indices) {
+                collectAssigned(index.get(), assigned);
+            }
+            collectAssigned(assign->value.get(), assigned);
+            int slot = assign->isArrayAssign ? -1 : slotOf(assign->varSymbol);
+            if (slot >= 0) assigned.push_back(slot);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// ========== EVALUACIÓN ==========
+
+Value ConstantPropagation::evaluate(Expr* expr, const vector<Value>& state, const vector<int>& clobbered) {
+    Value value = varying();
+
+    switch (expr->kind) {
+        case NodeKind::IntLiteral:
+            return integerConstant(DataType::INT, static_cast<IntLiteral*>(expr)->value);
+        case NodeKind::LongLiteral:
+            return integerConstant(DataType::LONG, static_cast<LongLiteral*>(expr)->value);
+        case NodeKind::FloatLiteral:
+            return floatConstant(static_cast<FloatLiteral*>(expr)->value);
+        case NodeKind::StringLiteral:
+            return varying();
+
+        case NodeKind::Variable: {
+            int slot = slotOf(static_cast<Variable*>(expr)->symbol);
+            bool assigned = false;
+            for (int other : clobbered) assigned = assigned || other == slot;
+            // UNDEFINED: se lee sin haberse definido en ningún camino
+            if (slot >= 0 && !assigned && state[slot].state == Value::CONSTANT) {
+                value = state[slot];
+            }
+            break;
+        }
+
+        case NodeKind::BinaryOp:
+            value = evaluateBinary(static_cast<BinaryOp*>(expr), state, clobbered);
+            break;
+
+        case NodeKind::UnaryOp: {
+            UnaryOp* unary = static_cast<UnaryOp*>(expr);
+            Value operand = evaluate(unary->operand.get(), state, clobbered);
+            if (operand.state != Value::CONSTANT) break;
+            if (unary->op.type == TokenType::NOT) {
+                value = integerConstant(DataType::INT, !truthy(operand));
+            } else if (unary->op.type == TokenType::MINUS) {
+                value = operand.type == DataType::FLOAT
+                    ? floatConstant(-operand.real)
+                    : integerConstant(operand.type, (long long)(0ULL - (unsigned long long)operand.integer));
+            }
+            break;
+        }
+
+        case NodeKind::CastExpr: {
+            CastExpr* cast = static_cast<CastExpr*>(expr);
+            value = convert(evaluate(cast->expr.get(), state, clobbered), cast->targetType);
+            break;
+        }
+
+        case NodeKind::TernaryExpr: {
+            TernaryExpr* ternary = static_cast<TernaryExpr*>(expr);
+            Value condition = evaluate(ternary->condition.get(), state, clobbered);
+            if (condition.state == Value::CONSTANT) {
+                // La otra rama no se evalúa
+                value = evaluate(truthy(condition) ? ternary->exprTrue.get() : ternary->exprFalse.get(),
+                                 state, clobbered);
+            } else {
+                Value whenTrue = evaluate(ternary->exprTrue.get(), state, clobbered);
+                Value whenFalse = evaluate(ternary->exprFalse.get(), state, clobbered);
+                value = meet(whenTrue, whenFalse);
+            }
+            break;
+        }
+
+        // Con efectos o valores en memoria: nunca constantes
+        case NodeKind::CallExpr:
+            for (auto& arg : static_cast<CallExpr*>(expr)->arguments) {
+                evaluate(arg.get(), state, clobbered);
+            }
+            break;
+        case NodeKind::ArrayAccess:
+            for (auto& index : static_cast<ArrayAccess*>(expr)->indices) {
+                evaluate(index.get(), state, clobbered);
+            }
+            break;
+        case NodeKind::AssignExpr: {
+            AssignExpr* assign = static_cast<AssignExpr*>(expr);
+            for (auto& index : assign->indices) {
+                evaluate(index.get(), state, clobbered);
+            }
+            evaluate(assign->value.get(), state, clobbered);
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    if (value.state != Value::CONSTANT) value = varying();
+    record(expr, value);
+    return value;
+}
+
+Value ConstantPropagation::evaluateBinary(BinaryOp* binary, const vector<Value>& state, const vector<int>& clobbered) {
+    TokenType op = binary->op.type;
+
+    // && y ||: la derecha solo se evalúa si hace falta
+    if (op == TokenType::AND || op == TokenType::OR) {
+        Value left = evaluate(binary->left.get(), state, clobbered);
+        if (left.state != Value::CONSTANT) {
+            evaluate(binary->right.get(), state, clobbered);
+            return varying();
+        }
+        if (truthy(left) == (op == TokenType::OR)) {
+            return integerConstant(DataType::INT, op == TokenType::OR);
+        }
+        Value right = evaluate(binary->right.get(), state, clobbered);
+        if (right.state != Value::CONSTANT) return varying();
+        return integerConstant(DataType::INT, truthy(right));
+    }
+
+    Value left = evaluate(binary->left.get(), state, clobbered);
+    Value right = evaluate(binary->right.get(), state, clobbered);
+    if (left.state != Value::CONSTANT || right.state != Value::CONSTANT) return varying();
+
+    // x << k y x >> k (los genera la reducción de multiplicaciones y
+    // divisiones: x >> k es x / 2^k, trunca hacia cero)
+    if (op == TokenType::UNKNOWN) {
+        bool shiftLeft = binary->op.lexeme == "<<";
+        if ((!shiftLeft && binary->op.lexeme != ">>") || left.type == DataType::FLOAT ||
+            right.type == DataType::FLOAT) {
+            return varying();
+        }
+        int bits = left.type == DataType::LONG ? 64 : 32;
+        if (right.integer < 0 || right.integer >= bits) return varying();
+        if (shiftLeft) {
+            return integerConstant(left.type, (long long)((unsigned long long)left.integer << right.integer));
+        }
+        return integerConstant(left.type, left.integer / (1LL << right.integer));
+    }
+
+    DataType type = arithmeticType(left, right);
+    Value a = convert(left, type);
+    Value b = convert(right, type);
+    if (a.state != Value::CONSTANT || b.state != Value::CONSTANT) return varying();
+
+    if (type == DataType::FLOAT) {
+        if (isComparison(op)) return integerConstant(DataType::INT, compare(op, a.real, b.real));
+        switch (op) {
+            case TokenType::PLUS: return floatConstant(a.real + b.real);
+            case TokenType::MINUS: return floatConstant(a.real - b.real);
+            case TokenType::MULTIPLY: return floatConstant(a.real * b.real);
+            case TokenType::DIVIDE: return floatConstant(a.real / b.real);
+            default: return varying();
+        }
+    }
+
+    if (isComparison(op)) return integerConstant(DataType::INT, compare(op, a.integer, b.integer));
+    unsigned long long x = (unsigned long long)a.integer;
+    unsigned long long y = (unsigned long long)b.integer;
+    switch (op) {
+        case TokenType::PLUS: return integerConstant(type, (long long)(x + y));
+        case TokenType::MINUS: return integerConstant(type, (long long)(x - y));
+        case TokenType::MULTIPLY: return integerConstant(type, (long long)(x * y));
+        case TokenType::DIVIDE:
+        case TokenType::MODULO: {
+            // División por cero y MIN / -1: se dejan para runtime
+            long long minimum = type == DataType::INT ? INT_MIN : LLONG_MIN;
+            if (b.integer == 0 || (a.integer == minimum && b.integer == -1)) return varying();
+            return integerConstant(type, op == TokenType::DIVIDE ? a.integer / b.integer : a.integer % b.integer);
+        }
+        default:
+            return varying();
+    }
+}
+
+void ConstantPropagation::record(Expr* expr, const Value& value) {
+    if (!recording) return;
+    if (value.state == Value::CONSTANT) {
+        constants[expr] = value;
+    } else {
+        constants.erase(expr);
+    }
+}
+
+// ========== CONSULTAS ==========
+
+const Value* ConstantPropagation::constantOf(Expr* expr) const {
+    auto it = constants.find(expr);
+    return it != constants.end() ? &it->second : nullptr;
+}
+
+bool ConstantPropagation::isReachable(Stmt* stmt) const {
+    int block = cfg.blockOf(stmt);
+    return block < 0 || states[block].reached;
+}
+
+bool ConstantPropagation::branchTaken(Expr* condition, bool outcome) const {
+    int block = cfg.blockOf(condition);
+    return block < 0 || states[block].taken[outcome ? 0 : 1];
+}
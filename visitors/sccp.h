@@ -0,0 +1,92 @@
+#ifndef SCCP_H
+#define SCCP_H
+
+#include "../parser/ast.h"
+#include "cfg.h"
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// ========== PROPAGACIÓN CONDICIONAL DE CONSTANTES ==========
+// Propagación de constantes de Wegman-Zadeck sobre el grafo de control de
+// una función (ver cfg.h), recorrido con una worklist:
+//
+//   - El estado a la entrada de un bloque es el meet de lo que llega por
+//     las aristas ejecutables: en los merges de un if y en el back-edge de
+//     un loop una variable solo sigue constante si vale lo mismo por todos
+//     los caminos.
+//   - Una condición constante marca ejecutable solo la rama que toma: la
+//     otra (y lo que solo se alcanza por ella) no aporta al meet.
+//
+// Cada variable está en UNDEFINED (ningún camino ejecutable la definió),
+// CONSTANT (int, long o float) o VARYING. Al terminar, constantOf() da el
+// valor de las expresiones que valen siempre lo mismo, y isReachable() /
+// branchTaken() el código que nunca se ejecuta.
+//
+// Solo se siguen los parámetros y las locales escalares de la función: las
+// globales (un call puede cambiarlas) y los arrays no. El AST no está en
+// SSA, así que el estado es por bloque y no por definición.
+class ConstantPropagation {
+public:
+    struct Value {
+        enum State : unsigned char { UNDEFINED, CONSTANT, VARYING };
+        State state = UNDEFINED;
+        DataType type = DataType::INT;
+        long long integer = 0;   // INT y LONG
+        float real = 0;          // FLOAT
+    };
+
+    // Analiza la función (descarta lo de la anterior)
+    void analyze(FunctionDecl* func, const SymbolSet& globals);
+
+    // Olvida la última función analizada
+    void clear();
+
+    // Valor constante de la expresión cada vez que se evalúa (nullptr si
+    // no es constante, o si el nodo no estaba en la función analizada)
+    const Value* constantOf(Expr* expr) const;
+
+    // ¿Se ejecuta alguna vez el statement? (true si no se analizó)
+    bool isReachable(Stmt* stmt) const;
+
+    // ¿Se toma alguna vez la rama verdadera / falsa de la condición?
+    bool branchTaken(Expr* condition, bool outcome) const;
+
+private:
+    typedef ControlFlowGraph::Action Action;
+
+    // Estado del análisis en cada bloque de cfg
+    struct BlockState {
+        bool reached = false;
+        bool queued = false;
+        bool taken[2] = {false, false};
+        vector<Value> in;            // Estado a la entrada, por slot
+    };
+
+    ControlFlowGraph cfg;
+    vector<BlockState> states;
+    unordered_map<const Expr*, Value> constants;
+
+    // Aplica una acción / condición al estado
+    void transfer(const Action& action, vector<Value>& state);
+    Value run(Expr* expr, vector<Value>& state);
+    void flowTo(int target, const vector<Value>& state, vector<int>& worklist);
+
+    // Slots asignados por AssignExpr dentro de la expresión
+    void collectAssigned(Expr* expr, vector<int>& assigned);
+
+    // Valor de la expresión en el estado (anota las constantes)
+    Value evaluate(Expr* expr, const vector<Value>& state, const vector<int>& clobbered);
+    Value evaluateBinary(BinaryOp* binary, const vector<Value>& state, const vector<int>& clobbered);
+    void record(Expr* expr, const Value& value);
+
+    // Las constantes solo se anotan en la última pasada, con el estado final
+    bool recording = false;
+
+    // Slot del estado de una local escalar int, long o float (el de
+    // cfg.locals; -1 si no se sigue)
+    int slotOf(SymbolId symbol);
+};
+
+#endif
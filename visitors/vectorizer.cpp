@@ -0,0 +1,142 @@
+#include "vectorizer.h"
+
+// ========== ANÁLISIS ==========
+
+bool LoopVectorizer::analyze(ForStmt* loop, Loop& result) {
+    result = Loop();
+
+    // Condición: i < n, i <= n (n literal o variable)
+    BinaryOp* condition = loop->condition ? nodeCast<BinaryOp>(loop->condition.get()) : nullptr;
+    if (!condition) return false;
+    TokenType op = condition->op.type;
+    Variable* counter = nodeCast<Variable>(condition->left.get());
+    if (!counter || (op != TokenType::LT && op != TokenType::LE)) return false;
+    Variable* boundVar = nodeCast<Variable>(condition->right.get());
+    if (!nodeCast<IntLiteral>(condition->right.get()) && (!boundVar || boundVar->symbol == counter->symbol)) {
+        return false;
+    }
+    result.counter = counter;
+    result.compareOp = op;
+    result.bound = condition->right.get();
+
+    // Incremento: i = i + 1
+    AssignExpr* increment = loop->increment ? nodeCast<AssignExpr>(loop->increment.get()) : nullptr;
+    int step = 0;
+    if (!increment || increment->isArrayAssign || increment->varSymbol != counter->symbol ||
+        !counterOffset(increment->value.get(), counter->symbol, step) || step != 1) {
+        return false;
+    }
+
+    // Cuerpo: solo x[i] = valor
+    Stmt* body = loop->body.get();
+    if (AssignStmt* single = nodeCast<AssignStmt>(body)) {
+        result.stores.push_back(single);
+    } else if (Block* block = nodeCast<Block>(body)) {
+        for (auto& stmt : block->statements) {
+            AssignStmt* store = nodeCast<AssignStmt>(stmt.get());
+            if (!store) return false;
+            result.stores.push_back(store);
+        }
+    } else {
+        return false;
+    }
+    if (result.stores.empty()) return false;
+
+    for (AssignStmt* store : result.stores) {
+        int offset;
+        if (!store->isArrayAssign || store->indices.size() != 1 ||
+            !counterOffset(store->indices[0].get(), counter->symbol, offset) || offset != 0) {
+            return false;
+        }
+        if (!collect(store->value.get(), counter->symbol, result)) return false;
+    }
+
+    // Leer x[i + 1] de un array que el loop escribe sería una dependencia
+    for (ArrayAccess* load : result.loads) {
+        int offset;
+        counterOffset(load->indices[0].get(), counter->symbol, offset);
+        if (offset == 0) continue;
+        for (AssignStmt* store : result.stores) {
+            if (store->varSymbol == load->arraySymbol) return false;
+        }
+    }
+    return true;
+}
+
+bool LoopVectorizer::counterOffset(Expr* index, SymbolId counter, int& offset) {
+    offset = 0;
+    if (Variable* var = nodeCast<Variable>(index)) {
+        return var->symbol == counter;
+    }
+
+    BinaryOp* binary = nodeCast<BinaryOp>(index);
+    if (!binary) return false;
+    TokenType op = binary->op.type;
+    Variable* var = nodeCast<Variable>(binary->left.get());
+    IntLiteral* literal = nodeCast<IntLiteral>(binary->right.get());
+    if (!var && op == TokenType::PLUS) {
+        var = nodeCast<Variable>(binary->right.get());
+        literal = nodeCast<IntLiteral>(binary->left.get());
+    }
+    if (!var || !literal || var->symbol != counter) return false;
+    if (op == TokenType::PLUS) {
+        offset = literal->value;
+        return true;
+    }
+    if (op == TokenType::MINUS) {
+        offset = -literal->value;
+        return true;
+    }
+    return false;
+}
+
+bool LoopVectorizer::collect(Expr* expr, SymbolId counter, Loop& result) {
+    switch (expr->kind) {
+        case NodeKind::IntLiteral:
+        case NodeKind::FloatLiteral:
+            return true;
+
+        // Constante negativa: -5, -2.5
+        case NodeKind::UnaryOp: {
+            UnaryOp* unary = static_cast<UnaryOp*>(expr);
+            NodeKind operand = unary->operand->kind;
+            return unary->op.type == TokenType::MINUS &&
+                   (operand == NodeKind::IntLiteral || operand == NodeKind::FloatLiteral);
+        }
+
+        case NodeKind::Variable: {
+            Variable* var = static_cast<Variable*>(expr);
+            if (var->symbol == counter) return false;
+            result.invariants.push_back(var);
+            return true;
+        }
+
+        case NodeKind::ArrayAccess: {
+            ArrayAccess* access = static_cast<ArrayAccess*>(expr);
+            int offset;
+            if (access->indices.size() != 1 || !counterOffset(access->indices[0].get(), counter, offset)) {
+                return false;
+            }
+            result.loads.push_back(access);
+            return true;
+        }
+
+        case NodeKind::BinaryOp: {
+            BinaryOp* binary = static_cast<BinaryOp*>(expr);
+            TokenType op = binary->op.type;
+            // a[i] * 4 ya llega como a[i] << 2 desde la reducción de fuerza
+            if (op == TokenType::UNKNOWN) {
+                return binary->op.lexeme == "<<" && binary->right->kind == NodeKind::IntLiteral &&
+                       collect(binary->left.get(), counter, result);
+            }
+            if (op != TokenType::PLUS && op != TokenType::MINUS &&
+                op != TokenType::MULTIPLY && op != TokenType::DIVIDE) {
+                return false;
+            }
+            return collect(binary->left.get(), counter, result) && collect(binary->right.get(), counter, result);
+        }
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef VECTORIZER_H
+#define VECTORIZER_H
+
+#include "../parser/ast.h"
+#include <vector>
+
+using namespace std;
+
+// ========== VECTORIZACIÓN DE LOOPS ==========
+// Reconoce los for contados cuyo cuerpo son solo asignaciones a arrays:
+//
+//   for (int i = a; i < n; i = i + 1) {
+//       x[i] = y[i] * 2.0 + z[i + 1];
+//       w[i] = x[i] - k;
+//   }
+//
+// Cada asignación escribe el elemento [i] y su valor combina elementos de
+// arrays (en [i], o en [i ± c] si el loop no escribe ese array),
+// constantes y variables que el loop no asigna, con + - * /. Así ninguna
+// iteración depende de otra y CodeGen puede procesar 4 (SSE2) u 8 (AVX2)
+// elementos por vez, con el for original como epílogo escalar.
+//
+// El análisis es solo sintáctico: los tipos los revisa CodeGen.
+class LoopVectorizer {
+public:
+    struct Loop {
+        Variable* counter = nullptr;                // El de la condición
+        TokenType compareOp = TokenType::UNKNOWN;   // LT o LE
+        Expr* bound = nullptr;                      // IntLiteral o Variable
+        vector<AssignStmt*> stores;
+        vector<ArrayAccess*> loads;
+        vector<Variable*> invariants;
+    };
+
+    // false si el loop no tiene esa forma
+    static bool analyze(ForStmt* loop, Loop& result);
+
+    // Desplazamiento de un índice i, i + c, i - c (false si es otra cosa)
+    static bool counterOffset(Expr* index, SymbolId counter, int& offset);
+
+private:
+    static bool collect(Expr* expr, SymbolId counter, Loop& result);
+};
+
+#endif